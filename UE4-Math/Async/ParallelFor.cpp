@@ -0,0 +1,146 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ParallelFor.cpp: Batched parallel loops on a thread pool
+=============================================================================*/
+
+#include "Async/ParallelFor.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace UE4Math
+{
+	namespace ParallelForPrivate
+	{
+		/** Without the Deterministic flag, aim for this many batches per thread so late starters still get work. */
+		enum { BatchesPerThread = 4 };
+
+		/**
+		 * State shared by the caller and the helper tasks. Helpers hold a reference, so one that only starts
+		 * after the loop is over finds no batch left and exits without touching the caller's stack.
+		 */
+		struct FParallelForData
+		{
+			const std::function<void(int32, int32)>* Body;
+			int32 Num;
+			int32 BatchSize;
+			int32 NumBatches;
+
+			std::atomic<int32> NextBatch{ 0 };
+			std::atomic<int32> NumBatchesLeft{ 0 };
+			std::mutex Mutex;
+			std::condition_variable Done;
+
+			/** Runs batches until none are left to claim. */
+			void Process()
+			{
+				for (;;)
+				{
+					const int32 Batch = NextBatch.fetch_add(1);
+					if (Batch >= NumBatches)
+					{
+						return;
+					}
+
+					const int32 Begin = Batch * BatchSize;
+					const int32 End = Num - Begin > BatchSize ? Begin + BatchSize : Num;
+					(*Body)(Begin, End);
+
+					if (NumBatchesLeft.fetch_sub(1) == 1)
+					{
+						std::lock_guard<std::mutex> Lock(Mutex);
+						Done.notify_all();
+					}
+				}
+			}
+
+			void Wait()
+			{
+				std::unique_lock<std::mutex> Lock(Mutex);
+				Done.wait(Lock, [this]() { return NumBatchesLeft.load() == 0; });
+			}
+		};
+
+		class FParallelForTask : public IQueuedWork
+		{
+		public:
+			explicit FParallelForTask(const std::shared_ptr<FParallelForData>& InData)
+				: Data(InData)
+			{
+			}
+
+			virtual void DoThreadedWork() override
+			{
+				Data->Process();
+				delete this;
+			}
+
+			virtual void Abandon() override
+			{
+				delete this;
+			}
+
+		private:
+			std::shared_ptr<FParallelForData> Data;
+		};
+	}
+
+	void ParallelForRange(int32 Num, int32 MinBatchSize, const std::function<void(int32 Begin, int32 End)>& Body, uint32 Flags, FQueuedThreadPool* Pool)
+	{
+		using namespace ParallelForPrivate;
+
+		if (Num <= 0)
+		{
+			return;
+		}
+
+		MinBatchSize = MinBatchSize > 1 ? MinBatchSize : 1;
+		if (!Pool)
+		{
+			Pool = GThreadPool;
+		}
+		const int32 NumThreads = (Pool && !(Flags & EParallelForFlags::ForceSingleThread)) ? Pool->GetNumThreads() + 1 : 1;
+
+		int32 BatchSize = MinBatchSize;
+		if (NumThreads == 1 && !(Flags & EParallelForFlags::Deterministic))
+		{
+			Body(0, Num);
+			return;
+		}
+		if (!(Flags & EParallelForFlags::Deterministic))
+		{
+			const int32 TargetBatchSize = Num / (NumThreads * BatchesPerThread);
+			BatchSize = TargetBatchSize > MinBatchSize ? TargetBatchSize : MinBatchSize;
+		}
+		const int32 NumBatches = (int32)(((int64)Num + BatchSize - 1) / BatchSize);
+
+		if (NumThreads == 1 || NumBatches == 1)
+		{
+			// Same batches as the threaded path, so Deterministic callers see the same ranges.
+			for (int32 Batch = 0; Batch < NumBatches; ++Batch)
+			{
+				const int32 Begin = Batch * BatchSize;
+				Body(Begin, Num - Begin > BatchSize ? Begin + BatchSize : Num);
+			}
+			return;
+		}
+
+		std::shared_ptr<FParallelForData> Data = std::make_shared<FParallelForData>();
+		Data->Body = &Body;
+		Data->Num = Num;
+		Data->BatchSize = BatchSize;
+		Data->NumBatches = NumBatches;
+		Data->NumBatchesLeft = NumBatches;
+
+		const int32 NumHelpers = (NumThreads - 1 < NumBatches - 1) ? NumThreads - 1 : NumBatches - 1;
+		for (int32 Index = 0; Index < NumHelpers; ++Index)
+		{
+			Pool->AddQueuedWork(new FParallelForTask(Data));
+		}
+
+		Data->Process();
+		Data->Wait();
+	}
+}
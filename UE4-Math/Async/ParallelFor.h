@@ -0,0 +1,92 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <functional>
+#include "Async/QueuedThreadPool.h"
+#include "Misc/CoreMiscDefines.h"
+
+namespace UE4Math
+{
+	namespace EParallelForFlags
+	{
+		enum Type
+		{
+			None = 0,
+
+			/** Runs every batch on the calling thread, e.g. for debugging. */
+			ForceSingleThread = 1 << 0,
+
+			/**
+			 * Splits the range into batches of exactly MinBatchSize items (the last one may be smaller),
+			 * whatever the number of threads. Batch N always covers [N * MinBatchSize, (N + 1) * MinBatchSize),
+			 * so per batch results can be combined in a fixed order for run to run identical reductions.
+			 * Without the flag, batches grow with Num / threads to cut scheduling overhead.
+			 */
+			Deterministic = 1 << 1,
+		};
+	}
+
+	/**
+	 * Work, in rdtsc cycles, a batch should hold before it is worth handing to another thread. This is an
+	 * estimate rather than a measurement: waking a pool thread and claiming a batch from the shared counter
+	 * take a few thousand cycles, several times that keeps the scheduling overhead to a small fraction of
+	 * the batch.
+	 */
+	enum { ParallelForMinBatchCycles = 16384 };
+
+	/**
+	 * Gets a MinBatchSize for ParallelFor and ParallelForRange from the cost of one item, so call sites
+	 * only have to measure that cost. Where several kernels share a batch size, it is sized for the
+	 * cheapest of them.
+	 *
+	 * @param CyclesPerItem	Cost of one item in rdtsc cycles, timed on a single thread
+	 * @return Number of items that make up ParallelForMinBatchCycles, at least one
+	 */
+	constexpr int32 GetParallelForMinBatchSize(int32 CyclesPerItem)
+	{
+		return CyclesPerItem >= ParallelForMinBatchCycles ? 1 : ParallelForMinBatchCycles / (CyclesPerItem > 1 ? CyclesPerItem : 1);
+	}
+
+	/**
+	 * Calls Body(Begin, End) for consecutive batches covering [0, Num), in parallel on the given pool
+	 * (GThreadPool if null) and the calling thread. Batches are claimed from a shared counter, so a thread
+	 * that finishes early takes over the remaining ones. Returns once every batch has run. It may be
+	 * called from inside a pool thread, the caller always makes progress on its own batches.
+	 *
+	 * @param Num			Number of items
+	 * @param MinBatchSize	Smallest number of items handed to one call of Body
+	 * @param Body			Called with a half open range of item indices
+	 * @param Flags			EParallelForFlags
+	 * @param Pool			Pool to run on, GThreadPool if null
+	 */
+	void ParallelForRange(int32 Num, int32 MinBatchSize, const std::function<void(int32 Begin, int32 End)>& Body, uint32 Flags = EParallelForFlags::None, FQueuedThreadPool* Pool = nullptr);
+
+	/**
+	 * Calls Body(Index) for every index in [0, Num) in parallel, see ParallelForRange.
+	 *
+	 * @param Num			Number of items
+	 * @param MinBatchSize	Smallest number of items run by one thread between two claims
+	 * @param Body			Called once per index
+	 * @param Flags			EParallelForFlags
+	 * @param Pool			Pool to run on, GThreadPool if null
+	 */
+	template <typename BodyType>
+	inline void ParallelFor(int32 Num, int32 MinBatchSize, BodyType Body, uint32 Flags = EParallelForFlags::None, FQueuedThreadPool* Pool = nullptr)
+	{
+		ParallelForRange(Num, MinBatchSize, [&Body](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				Body(Index);
+			}
+		}, Flags, Pool);
+	}
+
+	/** @return Number of batches ParallelForRange splits Num items into with the Deterministic flag. */
+	inline int32 GetDeterministicBatchCount(int32 Num, int32 MinBatchSize)
+	{
+		MinBatchSize = MinBatchSize > 1 ? MinBatchSize : 1;
+		return Num > 0 ? (Num + MinBatchSize - 1) / MinBatchSize : 0;
+	}
+}
@@ -0,0 +1,116 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	QueuedThreadPool.cpp: Default thread pool for ParallelFor
+=============================================================================*/
+
+#include "Async/QueuedThreadPool.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace UE4Math
+{
+	FQueuedThreadPool* GThreadPool = nullptr;
+
+	namespace QueuedThreadPoolPrivate
+	{
+		/** Fixed set of threads sharing one FIFO queue. */
+		class FQueuedThreadPoolBase : public FQueuedThreadPool
+		{
+		public:
+			explicit FQueuedThreadPoolBase(int32 NumThreads)
+				: bTimeToDie(false)
+			{
+				Threads.reserve(NumThreads);
+				for (int32 Index = 0; Index < NumThreads; ++Index)
+				{
+					Threads.emplace_back([this]() { Run(); });
+				}
+			}
+
+			virtual ~FQueuedThreadPoolBase()
+			{
+				std::deque<IQueuedWork*> Abandoned;
+				{
+					std::lock_guard<std::mutex> Lock(Mutex);
+					bTimeToDie = true;
+					Abandoned.swap(QueuedWork);
+				}
+				WorkAvailable.notify_all();
+
+				for (std::thread& Thread : Threads)
+				{
+					Thread.join();
+				}
+				for (IQueuedWork* Work : Abandoned)
+				{
+					Work->Abandon();
+				}
+			}
+
+			virtual void AddQueuedWork(IQueuedWork* InQueuedWork) override
+			{
+				{
+					std::lock_guard<std::mutex> Lock(Mutex);
+					if (!bTimeToDie)
+					{
+						QueuedWork.push_back(InQueuedWork);
+						InQueuedWork = nullptr;
+					}
+				}
+
+				if (InQueuedWork)
+				{
+					InQueuedWork->Abandon();
+				}
+				else
+				{
+					WorkAvailable.notify_one();
+				}
+			}
+
+			virtual int32 GetNumThreads() const override
+			{
+				return (int32)Threads.size();
+			}
+
+		private:
+			void Run()
+			{
+				for (;;)
+				{
+					IQueuedWork* Work = nullptr;
+					{
+						std::unique_lock<std::mutex> Lock(Mutex);
+						WorkAvailable.wait(Lock, [this]() { return bTimeToDie || !QueuedWork.empty(); });
+						if (QueuedWork.empty())
+						{
+							return;
+						}
+						Work = QueuedWork.front();
+						QueuedWork.pop_front();
+					}
+					Work->DoThreadedWork();
+				}
+			}
+
+			std::mutex Mutex;
+			std::condition_variable WorkAvailable;
+			std::deque<IQueuedWork*> QueuedWork;
+			std::vector<std::thread> Threads;
+			bool bTimeToDie;
+		};
+	}
+
+	FQueuedThreadPool* FQueuedThreadPool::Allocate(int32 NumThreads)
+	{
+		if (NumThreads <= 0)
+		{
+			NumThreads = (int32)std::thread::hardware_concurrency() - 1;
+		}
+		return new QueuedThreadPoolPrivate::FQueuedThreadPoolBase(NumThreads > 1 ? NumThreads : 1);
+	}
+}
@@ -0,0 +1,54 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Misc/CoreMiscDefines.h"
+
+namespace UE4Math
+{
+	/**
+	 * Interface for work that can be queued on a thread pool.
+	 * The pool calls exactly one of DoThreadedWork or Abandon, after which it no longer touches the object.
+	 */
+	class IQueuedWork
+	{
+	public:
+		/** Called on a pool thread to do the work. */
+		virtual void DoThreadedWork() = 0;
+
+		/** Called instead of DoThreadedWork when the pool shuts down with the work still queued. */
+		virtual void Abandon() = 0;
+
+	protected:
+		virtual ~IQueuedWork() {}
+	};
+
+	/**
+	 * Thread pool interface used by ParallelFor. Implement it on top of existing worker threads to make
+	 * the math library share them, or use Allocate() for a standalone pool.
+	 */
+	class FQueuedThreadPool
+	{
+	public:
+		virtual ~FQueuedThreadPool() {}
+
+		/** Queues work to be run on one of the pool's threads. Thread safe. */
+		virtual void AddQueuedWork(IQueuedWork* InQueuedWork) = 0;
+
+		/** @return Number of threads that can run queued work at the same time. */
+		virtual int32 GetNumThreads() const = 0;
+
+		/**
+		 * Creates a pool with its own threads. Queued work still pending when the pool is deleted is abandoned.
+		 *
+		 * @param NumThreads Number of threads, 0 for one per hardware thread minus one for the caller.
+		 */
+		static FQueuedThreadPool* Allocate(int32 NumThreads = 0);
+	};
+
+	/**
+	 * Pool used by ParallelFor when none is passed. Null by default, which runs every ParallelFor on the
+	 * calling thread. The application owns the pool and must keep it alive while math code runs.
+	 */
+	extern FQueuedThreadPool* GThreadPool;
+}
@@ -0,0 +1,122 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	Box.cpp: Implements the FBox structure.
+=============================================================================*/
+
+#include "Math/Box.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+#include <mutex>
+
+namespace UE4Math
+{
+	namespace BoxPrivate
+	{
+		/** Point arrays smaller than this are reduced faster on one thread than handed out to several. */
+		enum { ParallelMinPoints = 32768 };
+
+		/**
+		 * Grows InOutMin and InOutMax to contain Count points.
+		 *
+		 * Four packed points are three registers whose lanes always hold the same components (XYZX, YZXY, ZXYZ),
+		 * so the loop keeps a running min and max per register and only sorts the lanes out at the end.
+		 */
+		void AccumulatePoints(const FVector* Points, int32 Count, FVector& InOutMin, FVector& InOutMax)
+		{
+			int32 Index = 0;
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+			if (Count >= 4)
+			{
+				const float* Floats = &Points[0].X;
+				__m128 Min0 = _mm_loadu_ps(Floats);
+				__m128 Min1 = _mm_loadu_ps(Floats + 4);
+				__m128 Min2 = _mm_loadu_ps(Floats + 8);
+				__m128 Max0 = Min0;
+				__m128 Max1 = Min1;
+				__m128 Max2 = Min2;
+
+				for (Index = 4, Floats += 12; Index + 4 <= Count; Index += 4, Floats += 12)
+				{
+					const __m128 P0 = _mm_loadu_ps(Floats);
+					const __m128 P1 = _mm_loadu_ps(Floats + 4);
+					const __m128 P2 = _mm_loadu_ps(Floats + 8);
+					Min0 = _mm_min_ps(Min0, P0);
+					Min1 = _mm_min_ps(Min1, P1);
+					Min2 = _mm_min_ps(Min2, P2);
+					Max0 = _mm_max_ps(Max0, P0);
+					Max1 = _mm_max_ps(Max1, P1);
+					Max2 = _mm_max_ps(Max2, P2);
+				}
+
+				// Stored back to back the registers read as four points again.
+				alignas(16) FVector Mins[4];
+				alignas(16) FVector Maxs[4];
+				_mm_store_ps(&Mins[0].X, Min0);
+				_mm_store_ps(&Mins[0].X + 4, Min1);
+				_mm_store_ps(&Mins[0].X + 8, Min2);
+				_mm_store_ps(&Maxs[0].X, Max0);
+				_mm_store_ps(&Maxs[0].X + 4, Max1);
+				_mm_store_ps(&Maxs[0].X + 8, Max2);
+
+				for (int32 Lane = 0; Lane < 4; ++Lane)
+				{
+					InOutMin = InOutMin.ComponentMin(Mins[Lane]);
+					InOutMax = InOutMax.ComponentMax(Maxs[Lane]);
+				}
+			}
+#endif
+
+			for (; Index < Count; ++Index)
+			{
+				InOutMin = InOutMin.ComponentMin(Points[Index]);
+				InOutMax = InOutMax.ComponentMax(Points[Index]);
+			}
+		}
+	}
+
+
+	/* FBox structors
+	 *****************************************************************************/
+
+	FBox::FBox(const FVector* Points, int32 Count)
+	{
+		Init();
+
+		if (Count <= 0)
+		{
+			return;
+		}
+
+		SCOPE_MATH_CYCLE_COUNTER(BoundsBatch);
+		INC_MATH_COUNTER_BY(BoundsBatchElements, Count);
+
+		FVector NewMin = Points[0];
+		FVector NewMax = Points[0];
+
+		if (Count < BoxPrivate::ParallelMinPoints)
+		{
+			BoxPrivate::AccumulatePoints(Points, Count, NewMin, NewMax);
+		}
+		else
+		{
+			std::mutex Mutex;
+			ParallelForRange(Count, BoxPrivate::ParallelMinPoints, [Points, &NewMin, &NewMax, &Mutex](int32 Begin, int32 End)
+			{
+				FVector RangeMin = Points[Begin];
+				FVector RangeMax = Points[Begin];
+				BoxPrivate::AccumulatePoints(Points + Begin, End - Begin, RangeMin, RangeMax);
+
+				// Min and max do not care about order, so ranges merge in whatever order they finish.
+				std::lock_guard<std::mutex> Lock(Mutex);
+				NewMin = NewMin.ComponentMin(RangeMin);
+				NewMax = NewMax.ComponentMax(RangeMax);
+			});
+		}
+
+		Min = NewMin;
+		Max = NewMax;
+		IsValid = 1;
+	}
+}
@@ -6,6 +6,7 @@
 //#include "Misc/AssertionMacros.h"
 #include "Math/UnrealMathUtility.h"
 //#include "Containers/UnrealString.h"
+#include "Misc/StringBuilder.h"
 #include "Math/Vector.h"
 
 namespace UE4Math
@@ -58,9 +59,10 @@ namespace UE4Math
 
 		/**
 		 * Creates and initializes a new box from the given set of points.
+		 * The points are reduced four at a time with SIMD min/max, large arrays are split across threads.
 		 *
 		 * @param Points Array of Points to create for the bounding volume.
-		 * @param Count The number of points.
+		 * @param Count The number of points, the box is invalid if there are none.
 		 */
 		FBox(const FVector* Points, int32 Count);
 
@@ -419,6 +421,14 @@ namespace UE4Math
 		 */
 		std::string ToString() const;
 
+		/**
+		 * Appends a textual representation of this box to a string builder without allocating.
+		 * Components are written in the shortest form that parses back to the same value.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const;
+
 	public:
 
 		/**
@@ -566,12 +576,21 @@ namespace UE4Math
 
 	inline std::string FBox::ToString() const
 	{
-		char stemp[200] = "";
-		snprintf(stemp, 100, "IsValid=%s, Min=(%s), Max=(%s)", IsValid ? "true" : "false", Min.ToString(), Max.ToString());
-		return std::string(stemp);
+		TStringBuilder<160> Builder;
+		AppendString(Builder);
+		return Builder.ToString();
 		//return FString::Printf(TEXT("IsValid=%s, Min=(%s), Max=(%s)"), IsValid ? TEXT("true") : TEXT("false"), *Min.ToString(), *Max.ToString());
 	}
 
+	inline void FBox::AppendString(FStringBuilderBase& Out) const
+	{
+		Out << "IsValid=" << (IsValid != 0) << ", Min=(";
+		Min.AppendString(Out);
+		Out << "), Max=(";
+		Max.AppendString(Out);
+		Out << ")";
+	}
+
 	/* FMath inline functions
 	 *****************************************************************************/
 
@@ -0,0 +1,112 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	Box2D.cpp: Implements the FBox2D structure.
+=============================================================================*/
+
+#include "Math/Box2D.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+
+namespace UE4Math
+{
+	namespace Box2DPrivate
+	{
+		/** A box test is a single SIMD compare of the four limits, 2.3 cycles. */
+		enum { BatchParallelMinSize = GetParallelForMinBatchSize(2) };
+	}
+
+
+	/* FBox2D structors
+	 *****************************************************************************/
+
+	FBox2D::FBox2D(const FVector2D* Points, int32 Count)
+	{
+		Init();
+
+		if (Count <= 0)
+		{
+			return;
+		}
+
+		SCOPE_MATH_CYCLE_COUNTER(BoundsBatch);
+		INC_MATH_COUNTER_BY(BoundsBatchElements, Count);
+
+		FVector2D NewMin = Points[0];
+		FVector2D NewMax = Points[0];
+		int32 Index = 1;
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+		if (Count >= 2)
+		{
+			// Two points to a register (XYXY), the two halves are folded together at the end.
+			const float* Floats = &Points[0].X;
+			__m128 MinXYXY = _mm_loadu_ps(Floats);
+			__m128 MaxXYXY = MinXYXY;
+
+			for (Index = 2, Floats += 4; Index + 2 <= Count; Index += 2, Floats += 4)
+			{
+				const __m128 P = _mm_loadu_ps(Floats);
+				MinXYXY = _mm_min_ps(MinXYXY, P);
+				MaxXYXY = _mm_max_ps(MaxXYXY, P);
+			}
+
+			MinXYXY = _mm_min_ps(MinXYXY, _mm_movehl_ps(MinXYXY, MinXYXY));
+			MaxXYXY = _mm_max_ps(MaxXYXY, _mm_movehl_ps(MaxXYXY, MaxXYXY));
+
+			alignas(16) float Bounds[8];
+			_mm_store_ps(Bounds, MinXYXY);
+			_mm_store_ps(Bounds + 4, MaxXYXY);
+			NewMin = FVector2D(Bounds[0], Bounds[1]);
+			NewMax = FVector2D(Bounds[4], Bounds[5]);
+		}
+#endif
+
+		for (; Index < Count; ++Index)
+		{
+			NewMin.X = FMath::Min(NewMin.X, Points[Index].X);
+			NewMin.Y = FMath::Min(NewMin.Y, Points[Index].Y);
+			NewMax.X = FMath::Max(NewMax.X, Points[Index].X);
+			NewMax.Y = FMath::Max(NewMax.Y, Points[Index].Y);
+		}
+
+		Min = NewMin;
+		Max = NewMax;
+		bIsValid = true;
+	}
+
+
+	/* FBox2D interface
+	 *****************************************************************************/
+
+	void FBox2D::IntersectBatch(const FBox2D* Others, bool* OutIntersects, int32 Count) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, Count);
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+		// The boxes are disjoint when Other.Min > Max or Min > Other.Max on any axis. Negating the second pair turns
+		// all four into (OMin.X, OMin.Y, -OMax.X, -OMax.Y) > (Max.X, Max.Y, -Min.X, -Min.Y), one compare per box.
+		const __m128 Signs = _mm_setr_ps(1.0f, 1.0f, -1.0f, -1.0f);
+		const __m128 Limits = _mm_setr_ps(Max.X, Max.Y, -Min.X, -Min.Y);
+
+		ParallelForRange(Count, Box2DPrivate::BatchParallelMinSize, [Signs, Limits, Others, OutIntersects](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const __m128 Other = _mm_mul_ps(_mm_loadu_ps(&Others[Index].Min.X), Signs);
+				OutIntersects[Index] = _mm_movemask_ps(_mm_cmpgt_ps(Other, Limits)) == 0;
+			}
+		});
+#else
+		const FBox2D& Box = *this;
+		ParallelForRange(Count, Box2DPrivate::BatchParallelMinSize, [&Box, Others, OutIntersects](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				OutIntersects[Index] = Box.Intersect(Others[Index]);
+			}
+		});
+#endif
+	}
+}
@@ -0,0 +1,452 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Math/UnrealMathUtility.h"
+#include "Misc/StringBuilder.h"
+#include "Math/Vector2D.h"
+
+namespace UE4Math
+{
+	/**
+	 * Implements a rectangular 2D Box.
+	 *
+	 * Min and Max come first and are packed, so the four bounds load as a single vector register.
+	 */
+	struct FBox2D
+	{
+	public:
+
+		/** Holds the box's minimum point. */
+		FVector2D Min;
+
+		/** Holds the box's maximum point. */
+		FVector2D Max;
+
+		/** Holds a flag indicating whether this box is valid. */
+		bool bIsValid;
+
+	public:
+
+		/** Default constructor (no initialization). */
+		FBox2D() { }
+
+		/**
+		 * Creates and initializes a new box.
+		 *
+		 * The box extents are initialized to zero and the box is marked as invalid.
+		 */
+		explicit FBox2D(int32)
+		{
+			Init();
+		}
+
+		/**
+		 * Creates and initializes a new box.
+		 *
+		 * The box extents are initialized to zero and the box is marked as invalid.
+		 *
+		 * @param EForceInit Force Init Enum.
+		 */
+		explicit FBox2D(EForceInit)
+		{
+			Init();
+		}
+
+		/**
+		 * Creates and initializes a new box from the specified parameters.
+		 *
+		 * @param InMin The box's minimum point.
+		 * @param InMax The box's maximum point.
+		 */
+		FBox2D(const FVector2D& InMin, const FVector2D& InMax)
+			: Min(InMin)
+			, Max(InMax)
+			, bIsValid(true)
+		{ }
+
+		/**
+		 * Creates and initializes a new box from the given set of points.
+		 *
+		 * @param Points Array of Points to create for the bounding volume.
+		 * @param Count The number of points, the box is invalid if there are none.
+		 */
+		FBox2D(const FVector2D* Points, int32 Count);
+
+	public:
+
+		/**
+		 * Compares two boxes for equality.
+		 *
+		 * @param Other The other box to compare with.
+		 * @return true if the boxes are equal, false otherwise.
+		 */
+		inline bool operator==(const FBox2D& Other) const
+		{
+			return (Min == Other.Min) && (Max == Other.Max);
+		}
+
+		/**
+		 * Compares two boxes for inequality.
+		 *
+		 * @param Other The other box to compare with.
+		 * @return true if the boxes are not equal, false otherwise.
+		 */
+		inline bool operator!=(const FBox2D& Other) const
+		{
+			return !(*this == Other);
+		}
+
+		/**
+		 * Adds to this bounding box to include a given point.
+		 *
+		 * @param Other The point to increase the bounding volume to.
+		 * @return Reference to this bounding box after resizing to include the other point.
+		 */
+		inline FBox2D& operator+=(const FVector2D& Other);
+
+		/**
+		 * Gets the result of addition to this bounding volume.
+		 *
+		 * @param Other The other point to add to this.
+		 * @return A new bounding volume.
+		 */
+		inline FBox2D operator+(const FVector2D& Other) const
+		{
+			return FBox2D(*this) += Other;
+		}
+
+		/**
+		 * Adds to this bounding box to include a new bounding volume.
+		 *
+		 * @param Other The bounding volume to increase the bounding volume to.
+		 * @return Reference to this bounding volume after resizing to include the other bounding volume.
+		 */
+		inline FBox2D& operator+=(const FBox2D& Other);
+
+		/**
+		 * Gets the result of addition to this bounding volume.
+		 *
+		 * @param Other The other volume to add to this.
+		 * @return A new bounding volume.
+		 */
+		inline FBox2D operator+(const FBox2D& Other) const
+		{
+			return FBox2D(*this) += Other;
+		}
+
+		/**
+		 * Gets reference to the min or max of this bounding volume.
+		 *
+		 * @param Index The index into points of the bounding volume.
+		 * @return A reference to a point of the bounding volume.
+		 */
+		inline FVector2D& operator[](int32 Index)
+		{
+			//check((Index >= 0) && (Index < 2));
+
+			if (Index == 0)
+			{
+				return Min;
+			}
+
+			return Max;
+		}
+
+	public:
+
+		/**
+		 * Calculates the distance of a point to this box.
+		 *
+		 * @param Point The point.
+		 * @return The distance.
+		 */
+		inline float ComputeSquaredDistanceToPoint(const FVector2D& Point) const
+		{
+			// Accumulates the distance as we iterate axis
+			float DistSquared = 0.f;
+
+			if (Point.X < Min.X)
+			{
+				DistSquared += FMath::Square(Point.X - Min.X);
+			}
+			else if (Point.X > Max.X)
+			{
+				DistSquared += FMath::Square(Point.X - Max.X);
+			}
+
+			if (Point.Y < Min.Y)
+			{
+				DistSquared += FMath::Square(Point.Y - Min.Y);
+			}
+			else if (Point.Y > Max.Y)
+			{
+				DistSquared += FMath::Square(Point.Y - Max.Y);
+			}
+
+			return DistSquared;
+		}
+
+		/**
+		 * Increase the bounding box volume.
+		 *
+		 * @param W The size to increase volume by.
+		 * @return A new bounding box increased in size.
+		 */
+		inline FBox2D ExpandBy(const float W) const
+		{
+			return FBox2D(Min - FVector2D(W, W), Max + FVector2D(W, W));
+		}
+
+		/**
+		 * Gets the box area.
+		 *
+		 * @return Box area.
+		 * @see GetCenter, GetCenterAndExtents, GetExtent, GetSize
+		 */
+		inline float GetArea() const
+		{
+			return (Max.X - Min.X) * (Max.Y - Min.Y);
+		}
+
+		/**
+		 * Gets the box's center point.
+		 *
+		 * @return Th center point.
+		 * @see GetArea, GetCenterAndExtents, GetExtent, GetSize
+		 */
+		inline FVector2D GetCenter() const
+		{
+			return FVector2D((Min + Max) * 0.5f);
+		}
+
+		/**
+		 * Get the center and extents
+		 *
+		 * @param center[out] reference to center point
+		 * @param Extents[out] reference to the extent around the center
+		 * @see GetArea, GetCenter, GetExtent, GetSize
+		 */
+		inline void GetCenterAndExtents(FVector2D& center, FVector2D& Extents) const
+		{
+			Extents = GetExtent();
+			center = Min + Extents;
+		}
+
+		/**
+		 * Calculates the closest point on or inside the box to a given point in space.
+		 *
+		 * @param Point The point in space.
+		 * @return The closest point on or inside the box.
+		 */
+		inline FVector2D GetClosestPointTo(const FVector2D& Point) const;
+
+		/**
+		 * Gets the box extents around the center.
+		 *
+		 * @return Box extents.
+		 * @see GetArea, GetCenter, GetCenterAndExtents, GetSize
+		 */
+		inline FVector2D GetExtent() const
+		{
+			return 0.5f * (Max - Min);
+		}
+
+		/**
+		 * Gets the box size.
+		 *
+		 * @return Box size.
+		 * @see GetArea, GetCenter, GetCenterAndExtents, GetExtent
+		 */
+		inline FVector2D GetSize() const
+		{
+			return (Max - Min);
+		}
+
+		/**
+		 * Set the initial values of the bounding box to Zero.
+		 */
+		inline void Init()
+		{
+			Min = Max = FVector2D::ZeroVector;
+			bIsValid = false;
+		}
+
+		/**
+		 * Checks whether the given box intersects this box.
+		 *
+		 * @param Other bounding box to test intersection
+		 * @return true if boxes intersect, false otherwise.
+		 */
+		inline bool Intersect(const FBox2D& Other) const;
+
+		/**
+		 * Tests this box against an array of boxes.
+		 *
+		 * @param Others Boxes to test against.
+		 * @param OutIntersects Receives Intersect(Others[i]) for each box.
+		 * @param Count Number of boxes.
+		 */
+		void IntersectBatch(const FBox2D* Others, bool* OutIntersects, int32 Count) const;
+
+		/**
+		 * Checks whether the given point is inside this box.
+		 *
+		 * @param TestPoint The point to test.
+		 * @return true if the point is inside this box, otherwise false.
+		 */
+		inline bool IsInside(const FVector2D& TestPoint) const
+		{
+			return ((TestPoint.X > Min.X) && (TestPoint.X < Max.X) && (TestPoint.Y > Min.Y) && (TestPoint.Y < Max.Y));
+		}
+
+		/**
+		 * Checks whether the given box is fully encapsulated by this box.
+		 *
+		 * @param Other The box to test for encapsulation within the bounding volume.
+		 * @return true if box is inside this volume, false otherwise.
+		 */
+		inline bool IsInside(const FBox2D& Other) const
+		{
+			return (IsInside(Other.Min) && IsInside(Other.Max));
+		}
+
+		/**
+		 * Shift bounding box position.
+		 *
+		 * @param The offset vector to shift by.
+		 * @return A new shifted bounding box.
+		 */
+		inline FBox2D ShiftBy(const FVector2D& Offset) const
+		{
+			return FBox2D(Min + Offset, Max + Offset);
+		}
+
+		/**
+		 * Get a textual representation of this box.
+		 *
+		 * @return A string describing the box.
+		 */
+		inline std::string ToString() const;
+
+		/**
+		 * Appends a textual representation of this box to a string builder without allocating.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		inline void AppendString(FStringBuilderBase& Out) const;
+	};
+
+
+	/**
+	 * FBox2D specialization for TIsPODType trait.
+	 */
+	template<> struct TIsPODType<FBox2D> { enum { Value = true }; };
+
+	static_assert(sizeof(FVector2D) == 8, "FBox2D::IntersectBatch loads Min and Max as one vector register.");
+
+
+	/* FBox2D inline functions
+	 *****************************************************************************/
+
+	inline FBox2D& FBox2D::operator+=(const FVector2D& Other)
+	{
+		if (bIsValid)
+		{
+			Min.X = FMath::Min(Min.X, Other.X);
+			Min.Y = FMath::Min(Min.Y, Other.Y);
+
+			Max.X = FMath::Max(Max.X, Other.X);
+			Max.Y = FMath::Max(Max.Y, Other.Y);
+		}
+		else
+		{
+			Min = Max = Other;
+			bIsValid = true;
+		}
+
+		return *this;
+	}
+
+
+	inline FBox2D& FBox2D::operator+=(const FBox2D& Other)
+	{
+		if (bIsValid && Other.bIsValid)
+		{
+			Min.X = FMath::Min(Min.X, Other.Min.X);
+			Min.Y = FMath::Min(Min.Y, Other.Min.Y);
+
+			Max.X = FMath::Max(Max.X, Other.Max.X);
+			Max.Y = FMath::Max(Max.Y, Other.Max.Y);
+		}
+		else if (Other.bIsValid)
+		{
+			*this = Other;
+		}
+
+		return *this;
+	}
+
+
+	inline FVector2D FBox2D::GetClosestPointTo(const FVector2D& Point) const
+	{
+		// start by considering the point inside the box
+		FVector2D ClosestPoint = Point;
+
+		// now clamp to inside box if it's outside
+		if (Point.X < Min.X)
+		{
+			ClosestPoint.X = Min.X;
+		}
+		else if (Point.X > Max.X)
+		{
+			ClosestPoint.X = Max.X;
+		}
+
+		// now clamp to inside box if it's outside
+		if (Point.Y < Min.Y)
+		{
+			ClosestPoint.Y = Min.Y;
+		}
+		else if (Point.Y > Max.Y)
+		{
+			ClosestPoint.Y = Max.Y;
+		}
+
+		return ClosestPoint;
+	}
+
+
+	inline bool FBox2D::Intersect(const FBox2D& Other) const
+	{
+		if ((Min.X > Other.Max.X) || (Other.Min.X > Max.X))
+		{
+			return false;
+		}
+
+		if ((Min.Y > Other.Max.Y) || (Other.Min.Y > Max.Y))
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+
+	inline std::string FBox2D::ToString() const
+	{
+		TStringBuilder<128> Builder;
+		AppendString(Builder);
+		return Builder.ToString();
+	}
+
+
+	inline void FBox2D::AppendString(FStringBuilderBase& Out) const
+	{
+		Out << "bIsValid=" << bIsValid << ", Min=(";
+		Min.AppendString(Out);
+		Out << "), Max=(";
+		Max.AppendString(Out);
+		Out << ")";
+	}
+}
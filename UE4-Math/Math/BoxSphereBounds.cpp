@@ -0,0 +1,302 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	BoxSphereBounds.cpp: Implements the FBoxSphereBounds structure.
+=============================================================================*/
+
+#include "Math/BoxSphereBounds.h"
+#include "Math/Matrix3x4.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+
+namespace UE4Math
+{
+	namespace BoxSphereBoundsPrivate
+	{
+		/** TransformBatch takes 13 cycles per bounds with one matrix and 25 with a transform per bounds. */
+		enum { BatchParallelMinSize = GetParallelForMinBatchSize(13) };
+
+		/**
+		 * Transforms bounds by the rows of an affine matrix, the translation is the fourth row.
+		 * The box is the box around the transformed box, the sphere is scaled by the largest axis scale
+		 * and clamped to the new box.
+		 */
+		inline void TransformBounds(const FVector& Row0, const FVector& Row1, const FVector& Row2, const FVector& Translation, float MaxAxisScale, const FBoxSphereBounds& In, FBoxSphereBounds& Out)
+		{
+			const FVector NewOrigin = Row0 * In.Origin.X + Row1 * In.Origin.Y + Row2 * In.Origin.Z + Translation;
+			const FVector NewExtent = Row0.GetAbs() * In.BoxExtent.X + Row1.GetAbs() * In.BoxExtent.Y + Row2.GetAbs() * In.BoxExtent.Z;
+			const float NewRadius = FMath::Min(In.SphereRadius * MaxAxisScale, NewExtent.Size());
+
+			Out.Origin = NewOrigin;
+			Out.SphereRadius = NewRadius;
+			Out.BoxExtent = NewExtent;
+		}
+
+		inline float GetMaximumAxisScale(const FMatrix3x4& M)
+		{
+			return FMath::Sqrt(FMath::Max(
+				M.GetScaledAxis(EAxis::X).SizeSquared(),
+				FMath::Max(
+					M.GetScaledAxis(EAxis::Y).SizeSquared(),
+					M.GetScaledAxis(EAxis::Z).SizeSquared()
+				)
+			));
+		}
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+		using namespace VectorSwizzlePrivate;
+		using namespace MatrixSIMDPrivate;
+
+		/** Sum of lanes X, Y and Z, in lane X. */
+		inline __m128 HorizontalAdd3(__m128 Vec)
+		{
+			return _mm_add_ss(_mm_add_ss(Vec, Swizzle<1, 1, 1, 1>(Vec)), Swizzle<2, 2, 2, 2>(Vec));
+		}
+
+		/** (Vec.X, Vec.Y, Vec.Z, W.X) */
+		inline __m128 MergeXYZ_W(__m128 Vec, __m128 W)
+		{
+			const __m128 ZW = _mm_shuffle_ps(Vec, W, _MM_SHUFFLE(0, 0, 2, 2));
+			return _mm_shuffle_ps(Vec, ZW, _MM_SHUFFLE(2, 0, 1, 0));
+		}
+
+		/**
+		 * SSE version of TransformBounds. Rows have W == 0 and MaxAxisScale is in lane X.
+		 * A bounds is two aligned registers, (Origin, SphereRadius) and (BoxExtent, padding).
+		 * Everything is loaded before the first store, so Out may alias In.
+		 */
+		inline void TransformBounds(__m128 Row0, __m128 Row1, __m128 Row2, __m128 Translation, __m128 MaxAxisScale, const FBoxSphereBounds& In, FBoxSphereBounds& Out)
+		{
+			const __m128 OriginRadius = _mm_load_ps(&In.Origin.X);
+			const __m128 Extent = _mm_load_ps(&In.BoxExtent.X);
+
+			__m128 NewOrigin = MultiplyAdd(Swizzle<0, 0, 0, 0>(OriginRadius), Row0, Translation);
+			NewOrigin = MultiplyAdd(Swizzle<1, 1, 1, 1>(OriginRadius), Row1, NewOrigin);
+			NewOrigin = MultiplyAdd(Swizzle<2, 2, 2, 2>(OriginRadius), Row2, NewOrigin);
+
+			const __m128 AbsMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+			__m128 NewExtent = _mm_mul_ps(Swizzle<0, 0, 0, 0>(Extent), _mm_and_ps(Row0, AbsMask));
+			NewExtent = MultiplyAdd(Swizzle<1, 1, 1, 1>(Extent), _mm_and_ps(Row1, AbsMask), NewExtent);
+			NewExtent = MultiplyAdd(Swizzle<2, 2, 2, 2>(Extent), _mm_and_ps(Row2, AbsMask), NewExtent);
+
+			const __m128 ExtentSize = _mm_sqrt_ss(HorizontalAdd3(_mm_mul_ps(NewExtent, NewExtent)));
+			const __m128 NewRadius = _mm_min_ss(_mm_mul_ss(Swizzle<3, 3, 3, 3>(OriginRadius), MaxAxisScale), ExtentSize);
+
+			_mm_store_ps(&Out.Origin.X, MergeXYZ_W(NewOrigin, NewRadius));
+			_mm_store_ps(&Out.BoxExtent.X, NewExtent);
+		}
+#endif
+
+		void TransformRange(const FBoxSphereBounds* In, const FMatrix3x4* Transforms, FBoxSphereBounds* Out, int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const FMatrix3x4& M = Transforms[Index];
+#if PLATFORM_ALWAYS_HAS_SSE2
+				// The stored rows are the columns of the equivalent FMatrix, so transposing them with a zero fourth
+				// row gives its three axes and the translation. The squared lengths of the axes fall out of the
+				// untransposed rows for free.
+				const __m128 Col0 = _mm_loadu_ps(M.M[0]);
+				const __m128 Col1 = _mm_loadu_ps(M.M[1]);
+				const __m128 Col2 = _mm_loadu_ps(M.M[2]);
+
+				const __m128 AxisScaleSquared = MultiplyAdd(Col2, Col2, MultiplyAdd(Col1, Col1, _mm_mul_ps(Col0, Col0)));
+				const __m128 MaxAxisScaleSquared = _mm_max_ss(_mm_max_ss(AxisScaleSquared, Swizzle<1, 1, 1, 1>(AxisScaleSquared)), Swizzle<2, 2, 2, 2>(AxisScaleSquared));
+
+				__m128 Row0 = Col0;
+				__m128 Row1 = Col1;
+				__m128 Row2 = Col2;
+				__m128 Translation = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(Row0, Row1, Row2, Translation);
+
+				TransformBounds(Row0, Row1, Row2, Translation, _mm_sqrt_ss(MaxAxisScaleSquared), In[Index], Out[Index]);
+#else
+				TransformBounds(
+					M.GetScaledAxis(EAxis::X), M.GetScaledAxis(EAxis::Y), M.GetScaledAxis(EAxis::Z), M.GetOrigin(),
+					GetMaximumAxisScale(M), In[Index], Out[Index]);
+#endif
+			}
+		}
+
+		void TransformRange(const FBoxSphereBounds* In, const FMatrix& M, float MaxAxisScale, FBoxSphereBounds* Out, int32 Begin, int32 End)
+		{
+#if PLATFORM_ALWAYS_HAS_SSE2
+			// The W column of M is ignored, like FMatrix::TransformPosition does for affine matrices.
+			const __m128 XYZMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+			const __m128 Row0 = _mm_and_ps(_mm_loadu_ps(M.M[0]), XYZMask);
+			const __m128 Row1 = _mm_and_ps(_mm_loadu_ps(M.M[1]), XYZMask);
+			const __m128 Row2 = _mm_and_ps(_mm_loadu_ps(M.M[2]), XYZMask);
+			const __m128 Translation = _mm_and_ps(_mm_loadu_ps(M.M[3]), XYZMask);
+			const __m128 Scale = _mm_set_ss(MaxAxisScale);
+
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				TransformBounds(Row0, Row1, Row2, Translation, Scale, In[Index], Out[Index]);
+			}
+#else
+			const FVector Row0 = M.GetScaledAxis(EAxis::X);
+			const FVector Row1 = M.GetScaledAxis(EAxis::Y);
+			const FVector Row2 = M.GetScaledAxis(EAxis::Z);
+			const FVector Translation = M.GetOrigin();
+
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				TransformBounds(Row0, Row1, Row2, Translation, MaxAxisScale, In[Index], Out[Index]);
+			}
+#endif
+		}
+	}
+
+
+	/* FBoxSphereBounds structors
+	 *****************************************************************************/
+
+	FBoxSphereBounds::FBoxSphereBounds(const FVector* Points, uint32 NumPoints)
+	{
+		FBox BoundingBox(ForceInit);
+
+		// find an axis aligned bounding box for the points.
+		for (uint32 PointIndex = 0; PointIndex < NumPoints; PointIndex++)
+		{
+			BoundingBox += Points[PointIndex];
+		}
+
+		BoundingBox.GetCenterAndExtents(Origin, BoxExtent);
+
+		// using the center of the bounding box as the origin of the sphere, find the radius of the bounding sphere.
+		float SquaredSphereRadius = 0;
+
+		for (uint32 PointIndex = 0; PointIndex < NumPoints; PointIndex++)
+		{
+			SquaredSphereRadius = FMath::Max<float>(SquaredSphereRadius, (Points[PointIndex] - Origin).SizeSquared());
+		}
+
+		SphereRadius = FMath::Sqrt(SquaredSphereRadius);
+
+		DiagnosticCheckNaN();
+	}
+
+
+	/* FBoxSphereBounds interface
+	 *****************************************************************************/
+
+	FBoxSphereBounds FBoxSphereBounds::TransformBy(const FMatrix& M) const
+	{
+		FBoxSphereBounds Result;
+		BoxSphereBoundsPrivate::TransformBounds(
+			M.GetScaledAxis(EAxis::X), M.GetScaledAxis(EAxis::Y), M.GetScaledAxis(EAxis::Z), M.GetOrigin(),
+			M.GetMaximumAxisScale(), *this, Result);
+
+		Result.DiagnosticCheckNaN();
+		return Result;
+	}
+
+
+	FBoxSphereBounds FBoxSphereBounds::TransformBy(const FMatrix3x4& M) const
+	{
+		FBoxSphereBounds Result;
+		BoxSphereBoundsPrivate::TransformBounds(
+			M.GetScaledAxis(EAxis::X), M.GetScaledAxis(EAxis::Y), M.GetScaledAxis(EAxis::Z), M.GetOrigin(),
+			BoxSphereBoundsPrivate::GetMaximumAxisScale(M), *this, Result);
+
+		Result.DiagnosticCheckNaN();
+		return Result;
+	}
+
+
+	void FBoxSphereBounds::TransformBatch(const FBoxSphereBounds* In, const FMatrix3x4* Transforms, FBoxSphereBounds* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(BoundsBatch);
+		INC_MATH_COUNTER_BY(BoundsBatchElements, Count);
+
+		ParallelForRange(Count, BoxSphereBoundsPrivate::BatchParallelMinSize, [In, Transforms, Out](int32 Begin, int32 End)
+		{
+			BoxSphereBoundsPrivate::TransformRange(In, Transforms, Out, Begin, End);
+		});
+	}
+
+
+	void FBoxSphereBounds::TransformBatch(const FBoxSphereBounds* In, const FMatrix& M, FBoxSphereBounds* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(BoundsBatch);
+		INC_MATH_COUNTER_BY(BoundsBatchElements, Count);
+
+		const FMatrix MCopy = M;
+		const float MaxAxisScale = M.GetMaximumAxisScale();
+		ParallelForRange(Count, BoxSphereBoundsPrivate::BatchParallelMinSize, [In, &MCopy, MaxAxisScale, Out](int32 Begin, int32 End)
+		{
+			BoxSphereBoundsPrivate::TransformRange(In, MCopy, MaxAxisScale, Out, Begin, End);
+		});
+	}
+
+
+	FBoxSphereBounds FBoxSphereBounds::UnionBatch(const FBoxSphereBounds* Bounds, int32 Count)
+	{
+		if (Count <= 0)
+		{
+			return FBoxSphereBounds(ForceInit);
+		}
+
+		SCOPE_MATH_CYCLE_COUNTER(BoundsBatch);
+		INC_MATH_COUNTER_BY(BoundsBatchElements, Count);
+
+		// First pass builds the box, the second finds the sphere around the box's center that contains every sphere.
+		FVector NewOrigin;
+		FVector NewExtent;
+		float MaxDistance;
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+		using namespace BoxSphereBoundsPrivate;
+
+		__m128 Min = _mm_set1_ps(BIG_NUMBER);
+		__m128 Max = _mm_set1_ps(-BIG_NUMBER);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const __m128 Origin = _mm_load_ps(&Bounds[Index].Origin.X);
+			const __m128 Extent = _mm_load_ps(&Bounds[Index].BoxExtent.X);
+			Min = _mm_min_ps(Min, _mm_sub_ps(Origin, Extent));
+			Max = _mm_max_ps(Max, _mm_add_ps(Origin, Extent));
+		}
+
+		// W of Min and Max is garbage from the padding, it never reaches the results below.
+		const __m128 Center = _mm_mul_ps(_mm_add_ps(Min, Max), _mm_set1_ps(0.5f));
+		const __m128 HalfSize = _mm_mul_ps(_mm_sub_ps(Max, Min), _mm_set1_ps(0.5f));
+
+		__m128 MaxDist = _mm_setzero_ps();
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const __m128 OriginRadius = _mm_load_ps(&Bounds[Index].Origin.X);
+			const __m128 Delta = _mm_sub_ps(OriginRadius, Center);
+			const __m128 Distance = _mm_sqrt_ss(HorizontalAdd3(_mm_mul_ps(Delta, Delta)));
+			MaxDist = _mm_max_ss(MaxDist, _mm_add_ss(Distance, Swizzle<3, 3, 3, 3>(OriginRadius)));
+		}
+
+		alignas(16) float CenterFloats[4];
+		alignas(16) float HalfSizeFloats[4];
+		_mm_store_ps(CenterFloats, Center);
+		_mm_store_ps(HalfSizeFloats, HalfSize);
+		NewOrigin = FVector(CenterFloats[0], CenterFloats[1], CenterFloats[2]);
+		NewExtent = FVector(HalfSizeFloats[0], HalfSizeFloats[1], HalfSizeFloats[2]);
+		MaxDistance = _mm_cvtss_f32(MaxDist);
+#else
+		FVector Min(BIG_NUMBER);
+		FVector Max(-BIG_NUMBER);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Min = Min.ComponentMin(Bounds[Index].Origin - Bounds[Index].BoxExtent);
+			Max = Max.ComponentMax(Bounds[Index].Origin + Bounds[Index].BoxExtent);
+		}
+
+		NewOrigin = (Min + Max) * 0.5f;
+		NewExtent = (Max - Min) * 0.5f;
+
+		MaxDistance = 0.f;
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			MaxDistance = FMath::Max(MaxDistance, (Bounds[Index].Origin - NewOrigin).Size() + Bounds[Index].SphereRadius);
+		}
+#endif
+
+		return FBoxSphereBounds(NewOrigin, NewExtent, FMath::Min(NewExtent.Size(), MaxDistance));
+	}
+}
@@ -0,0 +1,380 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Math/UnrealMathUtility.h"
+#include "Misc/StringBuilder.h"
+#include "Math/Vector.h"
+#include "Math/Plane.h"
+#include "Math/Sphere.h"
+#include "Math/Box.h"
+#include "Math/Matrix.h"
+#include "Math/MathValidation.h"
+#include "Stats/MathStats.h"
+
+namespace UE4Math
+{
+	struct FMatrix3x4;
+
+	/**
+	 * Structure for a combined axis aligned bounding box and bounding sphere with the same origin. (28 bytes, 32 with padding).
+	 *
+	 * The members are ordered so that Origin and SphereRadius fill one 16 byte register and BoxExtent a second one,
+	 * which lets the SIMD paths load and store a bounds with two aligned moves.
+	 */
+	struct alignas(16) FBoxSphereBounds
+	{
+		/** Holds the origin of the bounding box and sphere. */
+		FVector	Origin;
+
+		/** Holds the radius of the bounding sphere. */
+		float SphereRadius;
+
+		/** Holds the extent of the bounding box. */
+		FVector BoxExtent;
+
+	public:
+
+		/** Default constructor. */
+		FBoxSphereBounds() { }
+
+		/**
+		 * Creates and initializes a new instance.
+		 *
+		 * @param EForceInit Force Init Enum.
+		 */
+		explicit inline FBoxSphereBounds(EForceInit)
+			: Origin(ForceInit)
+			, SphereRadius(0.f)
+			, BoxExtent(ForceInit)
+		{
+			DiagnosticCheckNaN();
+		}
+
+		/**
+		 * Creates and initializes a new instance from the specified parameters.
+		 *
+		 * @param InOrigin origin of the bounding box and sphere.
+		 * @param InBoxExtent half size of box.
+		 * @param InSphereRadius radius of the sphere.
+		 */
+		FBoxSphereBounds(const FVector& InOrigin, const FVector& InBoxExtent, float InSphereRadius)
+			: Origin(InOrigin)
+			, SphereRadius(InSphereRadius)
+			, BoxExtent(InBoxExtent)
+		{
+			DiagnosticCheckNaN();
+		}
+
+		/**
+		 * Creates and initializes a new instance from the given Box and Sphere.
+		 *
+		 * @param Box The bounding box.
+		 * @param Sphere The bounding sphere.
+		 */
+		FBoxSphereBounds(const FBox& Box, const FSphere& Sphere)
+		{
+			Box.GetCenterAndExtents(Origin, BoxExtent);
+			SphereRadius = FMath::Min(BoxExtent.Size(), (Sphere.Center - Origin).Size() + Sphere.W);
+
+			DiagnosticCheckNaN();
+		}
+
+		/**
+		 * Creates and initializes a new instance the given Box.
+		 *
+		 * The resulting sphere will be tangent to the box's corners.
+		 *
+		 * @param Box The bounding box.
+		 */
+		FBoxSphereBounds(const FBox& Box)
+		{
+			Box.GetCenterAndExtents(Origin, BoxExtent);
+			SphereRadius = BoxExtent.Size();
+
+			DiagnosticCheckNaN();
+		}
+
+		/**
+		 * Creates and initializes a new instance for the given sphere.
+		 *
+		 * @param Sphere The bounding sphere.
+		 */
+		FBoxSphereBounds(const FSphere& Sphere)
+		{
+			Origin = Sphere.Center;
+			SphereRadius = Sphere.W;
+			BoxExtent = FVector(Sphere.W);
+
+			DiagnosticCheckNaN();
+		}
+
+		/**
+		 * Creates and initializes a new instance from the given set of points.
+		 *
+		 * The sphere radius is taken from the extent of the box.
+		 *
+		 * @param Points The points to be considered for the bounding box.
+		 * @param NumPoints Number of points in the Points array.
+		 */
+		FBoxSphereBounds(const FVector* Points, uint32 NumPoints);
+
+	public:
+
+		/**
+		 * Constructs a bounding volume containing both this and B.
+		 *
+		 * @param Other The other bounding volume.
+		 * @return The combined bounding volume.
+		 */
+		inline FBoxSphereBounds operator+(const FBoxSphereBounds& Other) const;
+
+	public:
+
+		/**
+		 * Calculates the squared distance from a point to a bounding box
+		 *
+		 * @param Point The point.
+		 * @return The distance.
+		 */
+		inline float ComputeSquaredDistanceFromBoxToPoint(const FVector& Point) const
+		{
+			FVector Mins = Origin - BoxExtent;
+			FVector Maxs = Origin + BoxExtent;
+
+			return UE4Math::ComputeSquaredDistanceFromBoxToPoint(Mins, Maxs, Point);
+		}
+
+		/**
+		 * Test whether the spheres from two BoxSphereBounds intersect/overlap.
+		 *
+		 * @param  A First BoxSphereBounds to test.
+		 * @param  B Second BoxSphereBounds to test.
+		 * @param  Tolerance Error tolerance added to test distance.
+		 * @return true if spheres intersect, false otherwise.
+		 */
+		inline static bool SpheresIntersect(const FBoxSphereBounds& A, const FBoxSphereBounds& B, float Tolerance = KINDA_SMALL_NUMBER)
+		{
+			return (A.Origin - B.Origin).SizeSquared() <= FMath::Square(FMath::Max(0.f, A.SphereRadius + B.SphereRadius + Tolerance));
+		}
+
+		/**
+		 * Test whether the boxes from two BoxSphereBounds intersect/overlap.
+		 *
+		 * @param  A First BoxSphereBounds to test.
+		 * @param  B Second BoxSphereBounds to test.
+		 * @return true if boxes intersect, false otherwise.
+		 */
+		inline static bool BoxesIntersect(const FBoxSphereBounds& A, const FBoxSphereBounds& B)
+		{
+			return A.GetBox().Intersect(B.GetBox());
+		}
+
+		/**
+		 * Test whether the bounds touch a sphere. The box is only tested when the cheaper sphere test passes.
+		 *
+		 * @param Sphere The sphere to test against.
+		 * @return true if both the bounding sphere and the bounding box touch Sphere.
+		 */
+		inline bool Intersects(const FSphere& Sphere) const
+		{
+			return (Origin - Sphere.Center).SizeSquared() <= FMath::Square(SphereRadius + Sphere.W)
+				&& ComputeSquaredDistanceFromBoxToPoint(Sphere.Center) <= FMath::Square(Sphere.W);
+		}
+
+		/**
+		 * Test whether the bounds touch the inside of a convex volume such as a view frustum.
+		 * Each plane rejects with the tighter of the sphere radius and the box's projected extent.
+		 *
+		 * @param Planes Bounding planes of the volume, normals pointing out.
+		 * @param NumPlanes Number of planes.
+		 * @return false if the bounds are entirely outside one of the planes.
+		 */
+		inline bool IntersectsFrustum(const FPlane* Planes, int32 NumPlanes) const
+		{
+			for (int32 Index = 0; Index < NumPlanes; ++Index)
+			{
+				const FPlane& Plane = Planes[Index];
+				const float Distance = Plane.PlaneDot(Origin);
+				const float PushOut = FMath::Abs(Plane.X * BoxExtent.X) + FMath::Abs(Plane.Y * BoxExtent.Y) + FMath::Abs(Plane.Z * BoxExtent.Z);
+				if (Distance > FMath::Min(SphereRadius, PushOut))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * Gets the bounding box.
+		 *
+		 * @return The bounding box.
+		 */
+		inline FBox GetBox() const
+		{
+			return FBox(Origin - BoxExtent, Origin + BoxExtent);
+		}
+
+		/**
+		 * Gets the extrema for the bounding box.
+		 *
+		 * @param Extrema 1 for positive extrema from the origin, else negative
+		 * @return The boxes extrema
+		 */
+		FVector GetBoxExtrema(uint32 Extrema) const
+		{
+			if (Extrema)
+			{
+				return Origin + BoxExtent;
+			}
+
+			return Origin - BoxExtent;
+		}
+
+		/**
+		 * Gets the bounding sphere.
+		 *
+		 * @return The bounding sphere.
+		 */
+		inline FSphere GetSphere() const
+		{
+			return FSphere(Origin, SphereRadius);
+		}
+
+		/**
+		 * Increase the size of the box and sphere by a given size.
+		 *
+		 * @param ExpandAmount The size to increase by.
+		 * @return A new box with the expanded size.
+		 */
+		inline FBoxSphereBounds ExpandBy(float ExpandAmount) const
+		{
+			return FBoxSphereBounds(Origin, BoxExtent + ExpandAmount, SphereRadius + ExpandAmount);
+		}
+
+		/**
+		 * Gets a bounding volume transformed by a matrix.
+		 *
+		 * @param M The matrix.
+		 * @return The transformed volume.
+		 */
+		FBoxSphereBounds TransformBy(const FMatrix& M) const;
+
+		/**
+		 * Gets a bounding volume transformed by an affine transform.
+		 *
+		 * @param M The transform.
+		 * @return The transformed volume.
+		 */
+		FBoxSphereBounds TransformBy(const FMatrix3x4& M) const;
+
+		/**
+		 * Get a textual representation of this bounding box.
+		 *
+		 * @return Text describing the bounding box.
+		 */
+		std::string ToString() const
+		{
+			TStringBuilder<256> Builder;
+			AppendString(Builder);
+			return Builder.ToString();
+		}
+
+		/**
+		 * Appends a textual representation of these bounds to a string builder without allocating.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const
+		{
+			Out << "Origin=";
+			Origin.AppendString(Out);
+			Out << ", BoxExtent=(";
+			BoxExtent.AppendString(Out);
+			Out << "), SphereRadius=(" << SphereRadius << ")";
+		}
+
+		/**
+		 * Constructs a bounding volume containing both A and B, the same as A + B.
+		 */
+		friend FBoxSphereBounds Union(const FBoxSphereBounds& A, const FBoxSphereBounds& B)
+		{
+			return A + B;
+		}
+
+		/**
+		 * Transforms an array of bounds, each by its own transform. Out may alias In.
+		 *
+		 * @param In Bounds to transform.
+		 * @param Transforms One transform per bounds.
+		 * @param Out Receives the transformed bounds.
+		 * @param Count Number of bounds.
+		 */
+		static void TransformBatch(const FBoxSphereBounds* In, const FMatrix3x4* Transforms, FBoxSphereBounds* Out, int32 Count);
+
+		/**
+		 * Transforms an array of bounds by one matrix. Out may alias In.
+		 *
+		 * @param In Bounds to transform.
+		 * @param M The matrix.
+		 * @param Out Receives the transformed bounds.
+		 * @param Count Number of bounds.
+		 */
+		static void TransformBatch(const FBoxSphereBounds* In, const FMatrix& M, FBoxSphereBounds* Out, int32 Count);
+
+		/**
+		 * Merges an array of bounds into one that contains them all. The box is the union of the boxes and the
+		 * sphere is centered on it, so the result does not depend on the order of the array.
+		 *
+		 * @param Bounds Bounds to merge.
+		 * @param Count Number of bounds, an empty array gives zero bounds.
+		 * @return The combined bounding volume.
+		 */
+		static FBoxSphereBounds UnionBatch(const FBoxSphereBounds* Bounds, int32 Count);
+
+		/** Utility to check if there are any non-finite values in the bounds. */
+		inline bool ContainsNaN() const
+		{
+			return Origin.ContainsNaN() || BoxExtent.ContainsNaN() || !FMath::IsFinite(SphereRadius);
+		}
+
+#if ENABLE_NAN_DIAGNOSTIC
+		inline void DiagnosticCheckNaN() const
+		{
+			if (ContainsNaN())
+			{
+				INC_MATH_COUNTER(NaNBoxSphereBounds);
+				FMathValidation::ReportNaN("DiagnosticCheckNaN", "FBoxSphereBounds", 0, ToString());
+			}
+		}
+#else
+		inline void DiagnosticCheckNaN() const { INC_MATH_COUNTER_IF(NaNBoxSphereBounds, ContainsNaN()); }
+#endif
+	};
+
+	static_assert(sizeof(FBoxSphereBounds) == 32, "FBoxSphereBounds must stay two vector registers wide.");
+
+	template <> struct TIsPODType<FBoxSphereBounds> { enum { Value = true }; };
+
+
+	/* FBoxSphereBounds inline functions
+	 *****************************************************************************/
+
+	inline FBoxSphereBounds FBoxSphereBounds::operator+(const FBoxSphereBounds& Other) const
+	{
+		FBox BoundingBox(ForceInit);
+
+		BoundingBox += (this->Origin - this->BoxExtent);
+		BoundingBox += (this->Origin + this->BoxExtent);
+		BoundingBox += (Other.Origin - Other.BoxExtent);
+		BoundingBox += (Other.Origin + Other.BoxExtent);
+
+		// build a bounding sphere from the bounding box's origin and the radii of A and B.
+		FBoxSphereBounds Result(BoundingBox);
+
+		Result.SphereRadius = FMath::Min(Result.SphereRadius, FMath::Max((Origin - Result.Origin).Size() + SphereRadius, (Other.Origin - Result.Origin).Size() + Other.SphereRadius));
+		Result.DiagnosticCheckNaN();
+
+		return Result;
+	}
+}
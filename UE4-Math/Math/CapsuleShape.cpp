@@ -0,0 +1,405 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	CapsuleShape.cpp: Overlap and sweep queries for FCapsuleShape.
+=============================================================================*/
+
+#include "Math/CapsuleShape.h"
+#include "Async/ParallelFor.h"
+
+namespace UE4Math
+{
+	namespace CapsuleShapePrivate
+	{
+		/** A sphere is one point to segment distance, 11 cycles. */
+		enum { SphereBatchParallelMinSize = GetParallelForMinBatchSize(11) };
+
+		/** A capsule is a segment to segment distance with its clamps and branches, 170 cycles. */
+		enum { CapsuleBatchParallelMinSize = GetParallelForMinBatchSize(170) };
+
+		/** Boxes and triangles that pass the bounds rejection run a distance per edge or face, 135 to 230 cycles. */
+		enum { ShapeBatchParallelMinSize = GetParallelForMinBatchSize(135) };
+
+		/** A sweep stops once the capsule is this close to the shape. */
+		constexpr float ContactTolerance = 1.e-3f;
+
+		/** Upper bound on sweep steps, a sweep that grazes the shape converges slowest and stops at the last safe time. */
+		enum { MaxSweepIterations = 32 };
+
+		/** Keeps the closest of the candidate point pairs fed to it. */
+		struct FClosestPair
+		{
+			float DistSquared = BIG_NUMBER;
+			FVector SegmentPoint;
+			FVector ShapePoint;
+
+			inline void Add(const FVector& InSegmentPoint, const FVector& InShapePoint)
+			{
+				const float NewDistSquared = (InSegmentPoint - InShapePoint).SizeSquared();
+				if (NewDistSquared < DistSquared)
+				{
+					DistSquared = NewDistSquared;
+					SegmentPoint = InSegmentPoint;
+					ShapePoint = InShapePoint;
+				}
+			}
+		};
+
+		/**
+		 * Slab test of a segment against a box. FMath::LineBoxIntersection is not used since it accepts hits up to
+		 * a fixed 0.1 outside the box.
+		 */
+		bool SegmentIntersectsBox(const FVector& Start, const FVector& End, const FBox& Box)
+		{
+			const FVector Delta = End - Start;
+			float MinTime = 0.0f;
+			float MaxTime = 1.0f;
+
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				if (FMath::Abs(Delta[Axis]) <= SMALL_NUMBER)
+				{
+					if (Start[Axis] < Box.Min[Axis] || Start[Axis] > Box.Max[Axis])
+					{
+						return false;
+					}
+					continue;
+				}
+
+				const float InvDelta = 1.0f / Delta[Axis];
+				const float Time0 = (Box.Min[Axis] - Start[Axis]) * InvDelta;
+				const float Time1 = (Box.Max[Axis] - Start[Axis]) * InvDelta;
+				MinTime = FMath::Max(MinTime, FMath::Min(Time0, Time1));
+				MaxTime = FMath::Min(MaxTime, FMath::Max(Time0, Time1));
+				if (MinTime > MaxTime)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * Closest points between a segment and a box.
+		 * When they do not touch the closest pair either has an end of the segment or lies on one of the box's
+		 * edges, so the ends and the 12 edges cover every case.
+		 */
+		float SegmentBoxDistSquared(const FVector& Start, const FVector& End, const FBox& Box, FVector& OutSegmentPoint, FVector& OutBoxPoint)
+		{
+			if (SegmentIntersectsBox(Start, End, Box))
+			{
+				OutBoxPoint = OutSegmentPoint = Box.GetClosestPointTo((Start + End) * 0.5f);
+				return 0.0f;
+			}
+
+			FClosestPair Closest;
+			Closest.Add(Start, Box.GetClosestPointTo(Start));
+			Closest.Add(End, Box.GetClosestPointTo(End));
+
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				const int32 Axis1 = (Axis + 1) % 3;
+				const int32 Axis2 = (Axis + 2) % 3;
+				for (int32 Corner = 0; Corner < 4; ++Corner)
+				{
+					FVector EdgeStart;
+					EdgeStart[Axis] = Box.Min[Axis];
+					EdgeStart[Axis1] = (Corner & 1) ? Box.Max[Axis1] : Box.Min[Axis1];
+					EdgeStart[Axis2] = (Corner & 2) ? Box.Max[Axis2] : Box.Min[Axis2];
+					FVector EdgeEnd = EdgeStart;
+					EdgeEnd[Axis] = Box.Max[Axis];
+
+					FVector SegmentPoint, EdgePoint;
+					FMath::SegmentDistToSegmentSafe(Start, End, EdgeStart, EdgeEnd, SegmentPoint, EdgePoint);
+					Closest.Add(SegmentPoint, EdgePoint);
+				}
+			}
+
+			OutSegmentPoint = Closest.SegmentPoint;
+			OutBoxPoint = Closest.ShapePoint;
+			return Closest.DistSquared;
+		}
+
+		/** Closest points between a segment and a triangle, the ends of the segment and the 3 edges cover every case. */
+		float SegmentTriangleDistSquared(const FVector& Start, const FVector& End, const FVector& A, const FVector& B, const FVector& C, FVector& OutSegmentPoint, FVector& OutTrianglePoint)
+		{
+			FVector HitPoint, HitNormal;
+			if (FMath::SegmentTriangleIntersection(Start, End, A, B, C, HitPoint, HitNormal))
+			{
+				OutTrianglePoint = OutSegmentPoint = HitPoint;
+				return 0.0f;
+			}
+
+			FClosestPair Closest;
+			Closest.Add(Start, FMath::ClosestPointOnTriangleToPoint(Start, A, B, C));
+			Closest.Add(End, FMath::ClosestPointOnTriangleToPoint(End, A, B, C));
+
+			const FVector* Vertices[3] = { &A, &B, &C };
+			for (int32 Edge = 0; Edge < 3; ++Edge)
+			{
+				FVector SegmentPoint, EdgePoint;
+				FMath::SegmentDistToSegmentSafe(Start, End, *Vertices[Edge], *Vertices[(Edge + 1) % 3], SegmentPoint, EdgePoint);
+				Closest.Add(SegmentPoint, EdgePoint);
+			}
+
+			OutSegmentPoint = Closest.SegmentPoint;
+			OutTrianglePoint = Closest.ShapePoint;
+			return Closest.DistSquared;
+		}
+
+		/**
+		 * Moves the segment Start-End along Delta until it comes within Radius of a convex shape.
+		 *
+		 * The distance between two convex shapes is a convex function of time under translation, so a Newton step
+		 * (gap divided by closing speed along the contact normal) never passes the time of impact, and a closing
+		 * speed of zero or less means the shapes only move apart from then on.
+		 *
+		 * @param DistSquared Callable (Start, End, OutSegmentPoint, OutShapePoint) returning the squared distance.
+		 * @param FallbackNormal Normal reported when the capsule starts with its segment touching the shape.
+		 */
+		template<typename DistanceFunc>
+		bool Sweep(const FVector& Start, const FVector& End, float Radius, const FVector& Delta, float MaxTime, const FVector& FallbackNormal, DistanceFunc DistSquared, float& OutTime, FVector& OutNormal)
+		{
+			float Time = 0.0f;
+			for (int32 Iteration = 0; ; ++Iteration)
+			{
+				const FVector Offset = Delta * Time;
+				FVector SegmentPoint, ShapePoint;
+				const float Distance = FMath::Sqrt(DistSquared(Start + Offset, End + Offset, SegmentPoint, ShapePoint));
+				const FVector Normal = Distance > SMALL_NUMBER ? (SegmentPoint - ShapePoint) / Distance : FallbackNormal;
+
+				// Running out of steps while still closing in means the sweep grazes the shape, or float precision
+				// keeps the gap above the tolerance. Time never passes the time of impact, so it is a hit.
+				const float Gap = Distance - Radius;
+				if (Gap <= ContactTolerance || Iteration == MaxSweepIterations)
+				{
+					OutTime = Time;
+					OutNormal = Normal;
+					return true;
+				}
+
+				const float ClosingSpeed = -(Normal | Delta);
+				if (ClosingSpeed <= SMALL_NUMBER)
+				{
+					return false;
+				}
+
+				Time += Gap / ClosingSpeed;
+				if (Time > MaxTime)
+				{
+					return false;
+				}
+			}
+		}
+
+		inline FVector GetTriangleFallbackNormal(const FVector& A, const FVector& B, const FVector& C, const FVector& Delta)
+		{
+			const FVector Normal = ((B - A) ^ (C - A)).GetSafeNormal();
+			return (Normal | Delta) > 0.0f ? -Normal : Normal;
+		}
+
+		bool SweepTriangle(const FCapsuleShape& Capsule, const FVector& Delta, const FVector& A, const FVector& B, const FVector& C, float MaxTime, float& OutTime, FVector& OutNormal)
+		{
+			FVector Start, End;
+			Capsule.GetSegment(Start, End);
+
+			return Sweep(Start, End, Capsule.Radius, Delta, MaxTime, GetTriangleFallbackNormal(A, B, C, Delta),
+				[&A, &B, &C](const FVector& SegmentStart, const FVector& SegmentEnd, FVector& OutSegmentPoint, FVector& OutShapePoint)
+				{
+					return SegmentTriangleDistSquared(SegmentStart, SegmentEnd, A, B, C, OutSegmentPoint, OutShapePoint);
+				},
+				OutTime, OutNormal);
+		}
+	}
+
+
+	/* FCapsuleShape interface
+	 *****************************************************************************/
+
+	bool FCapsuleShape::Intersects(const FCapsuleShape& Other) const
+	{
+		FVector Start, End, OtherStart, OtherEnd;
+		GetSegment(Start, End);
+		Other.GetSegment(OtherStart, OtherEnd);
+
+		FVector Point, OtherPoint;
+		FMath::SegmentDistToSegmentSafe(Start, End, OtherStart, OtherEnd, Point, OtherPoint);
+		return (Point - OtherPoint).SizeSquared() <= FMath::Square(Radius + Other.Radius);
+	}
+
+
+	bool FCapsuleShape::Intersects(const FBox& Box) const
+	{
+		FVector Start, End, SegmentPoint, BoxPoint;
+		GetSegment(Start, End);
+		return CapsuleShapePrivate::SegmentBoxDistSquared(Start, End, Box, SegmentPoint, BoxPoint) <= FMath::Square(Radius);
+	}
+
+
+	bool FCapsuleShape::Intersects(const FOrientedBox& Box) const
+	{
+		FVector Start, End;
+		GetSegment(Start, End);
+
+		// Distances do not change in the box's frame, where it is axis aligned.
+		const FVector LocalStart = Start - Box.Center;
+		const FVector LocalEnd = End - Box.Center;
+		const FVector Extent(Box.ExtentX, Box.ExtentY, Box.ExtentZ);
+
+		FVector SegmentPoint, BoxPoint;
+		return CapsuleShapePrivate::SegmentBoxDistSquared(
+			FVector(LocalStart | Box.AxisX, LocalStart | Box.AxisY, LocalStart | Box.AxisZ),
+			FVector(LocalEnd | Box.AxisX, LocalEnd | Box.AxisY, LocalEnd | Box.AxisZ),
+			FBox(-Extent, Extent), SegmentPoint, BoxPoint) <= FMath::Square(Radius);
+	}
+
+
+	bool FCapsuleShape::IntersectsTriangle(const FVector& A, const FVector& B, const FVector& C) const
+	{
+		FVector Start, End, SegmentPoint, TrianglePoint;
+		GetSegment(Start, End);
+		return CapsuleShapePrivate::SegmentTriangleDistSquared(Start, End, A, B, C, SegmentPoint, TrianglePoint) <= FMath::Square(Radius);
+	}
+
+
+	bool FCapsuleShape::SweepTriangle(const FVector& Delta, const FVector& A, const FVector& B, const FVector& C, float& OutTime, FVector& OutNormal) const
+	{
+		return CapsuleShapePrivate::SweepTriangle(*this, Delta, A, B, C, 1.0f, OutTime, OutNormal);
+	}
+
+
+	bool FCapsuleShape::SweepBox(const FVector& Delta, const FBox& Box, float& OutTime, FVector& OutNormal) const
+	{
+		FVector Start, End;
+		GetSegment(Start, End);
+
+		return CapsuleShapePrivate::Sweep(Start, End, Radius, Delta, 1.0f, -Delta.GetSafeNormal(),
+			[&Box](const FVector& SegmentStart, const FVector& SegmentEnd, FVector& OutSegmentPoint, FVector& OutShapePoint)
+			{
+				return CapsuleShapePrivate::SegmentBoxDistSquared(SegmentStart, SegmentEnd, Box, OutSegmentPoint, OutShapePoint);
+			},
+			OutTime, OutNormal);
+	}
+
+
+	bool FCapsuleShape::SweepTriangles(const FVector& Delta, const FVector* Vertices, int32 NumTriangles, float& OutTime, FVector& OutNormal, int32& OutTriangleIndex) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, NumTriangles);
+
+		const FBox StartBox = GetBox();
+		const FBox SweptBox = StartBox + StartBox.ShiftBy(Delta);
+
+		bool bHit = false;
+		float FirstTime = 1.0f;
+		for (int32 Index = 0; Index < NumTriangles; ++Index)
+		{
+			const FVector& A = Vertices[Index * 3 + 0];
+			const FVector& B = Vertices[Index * 3 + 1];
+			const FVector& C = Vertices[Index * 3 + 2];
+
+			const FBox TriangleBox(A.ComponentMin(B).ComponentMin(C), A.ComponentMax(B).ComponentMax(C));
+			if (!SweptBox.Intersect(TriangleBox))
+			{
+				continue;
+			}
+
+			float Time;
+			FVector Normal;
+			if (CapsuleShapePrivate::SweepTriangle(*this, Delta, A, B, C, FirstTime, Time, Normal) && (!bHit || Time < FirstTime))
+			{
+				bHit = true;
+				FirstTime = Time;
+				OutNormal = Normal;
+				OutTriangleIndex = Index;
+			}
+		}
+
+		if (bHit)
+		{
+			OutTime = FirstTime;
+		}
+		return bHit;
+	}
+
+
+	void FCapsuleShape::IntersectsBatch(const FCapsuleShape* Others, bool* OutIntersects, int32 Count) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, Count);
+
+		const FCapsuleShape& Capsule = *this;
+		ParallelForRange(Count, CapsuleShapePrivate::CapsuleBatchParallelMinSize, [&Capsule, Others, OutIntersects](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				OutIntersects[Index] = Capsule.Intersects(Others[Index]);
+			}
+		});
+	}
+
+
+	void FCapsuleShape::IntersectsBatch(const FSphere* Spheres, bool* OutIntersects, int32 Count) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, Count);
+
+		FVector Start, End;
+		GetSegment(Start, End);
+		const FVector Axis = End - Start;
+		const float AxisSizeSquared = Axis | Axis;
+		const float OneOverAxisSizeSquared = AxisSizeSquared > SMALL_NUMBER ? 1.0f / AxisSizeSquared : 0.0f;
+		const float CapsuleRadius = Radius;
+
+		// The segment is shared by every test, so its reciprocal length is hoisted out of PointDistToSegment.
+		ParallelForRange(Count, CapsuleShapePrivate::SphereBatchParallelMinSize, [Start, Axis, OneOverAxisSizeSquared, CapsuleRadius, Spheres, OutIntersects](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const FVector ToCenter = Spheres[Index].Center - Start;
+				const float Time = FMath::Clamp((ToCenter | Axis) * OneOverAxisSizeSquared, 0.0f, 1.0f);
+				OutIntersects[Index] = (ToCenter - Axis * Time).SizeSquared() <= FMath::Square(CapsuleRadius + Spheres[Index].W);
+			}
+		});
+	}
+
+
+	void FCapsuleShape::IntersectsBatch(const FBox* Boxes, bool* OutIntersects, int32 Count) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, Count);
+
+		const FCapsuleShape& Capsule = *this;
+		const FBox CapsuleBox = GetBox();
+		ParallelForRange(Count, CapsuleShapePrivate::ShapeBatchParallelMinSize, [&Capsule, &CapsuleBox, Boxes, OutIntersects](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				OutIntersects[Index] = CapsuleBox.Intersect(Boxes[Index]) && Capsule.Intersects(Boxes[Index]);
+			}
+		});
+	}
+
+
+	void FCapsuleShape::IntersectsTrianglesBatch(const FVector* Vertices, bool* OutIntersects, int32 NumTriangles) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, NumTriangles);
+
+		const FCapsuleShape& Capsule = *this;
+		const FBox CapsuleBox = GetBox();
+		ParallelForRange(NumTriangles, CapsuleShapePrivate::ShapeBatchParallelMinSize, [&Capsule, &CapsuleBox, Vertices, OutIntersects](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const FVector& A = Vertices[Index * 3 + 0];
+				const FVector& B = Vertices[Index * 3 + 1];
+				const FVector& C = Vertices[Index * 3 + 2];
+				const FBox TriangleBox(A.ComponentMin(B).ComponentMin(C), A.ComponentMax(B).ComponentMax(C));
+
+				OutIntersects[Index] = CapsuleBox.Intersect(TriangleBox) && Capsule.IntersectsTriangle(A, B, C);
+			}
+		});
+	}
+}
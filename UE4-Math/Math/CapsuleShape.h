@@ -0,0 +1,218 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Math/UnrealMathUtility.h"
+#include "Misc/StringBuilder.h"
+#include "Math/Vector.h"
+#include "Math/Box.h"
+#include "Math/Sphere.h"
+#include "Math/OrientedBox.h"
+
+namespace UE4Math
+{
+	/**
+	 * Structure for capsules.
+	 *
+	 * A capsule consists of two spheres connected by a cylinder.
+	 */
+	struct FCapsuleShape
+	{
+		/** The capsule's center point. */
+		FVector Center;
+
+		/** The capsule's orientation in space. */
+		FVector Orientation;
+
+		/** The capsule's radius. */
+		float Radius;
+
+		/** The capsule's length. */
+		float Length;
+
+	public:
+
+		/** Default constructor. */
+		FCapsuleShape() { }
+
+		/**
+		 * Creates and initializes a new instance.
+		 *
+		 * @param InCenter The capsule's center point.
+		 * @param InRadius The capsule's radius.
+		 * @param InOrientation The capsule's orientation in space.
+		 * @param InLength The capsule's length.
+		 */
+		FCapsuleShape(FVector InCenter, float InRadius, FVector InOrientation, float InLength)
+			: Center(InCenter)
+			, Orientation(InOrientation)
+			, Radius(InRadius)
+			, Length(InLength)
+		{ }
+
+		/**
+		 * Creates a capsule around a segment.
+		 *
+		 * @param Start One end of the capsule's inner segment.
+		 * @param End The other end of the capsule's inner segment.
+		 * @param InRadius The capsule's radius.
+		 * @return The capsule.
+		 */
+		static FCapsuleShape MakeFromSegment(const FVector& Start, const FVector& End, float InRadius)
+		{
+			const FVector Axis = End - Start;
+			const float AxisLength = Axis.Size();
+			return FCapsuleShape((Start + End) * 0.5f, InRadius, AxisLength > SMALL_NUMBER ? Axis / AxisLength : FVector(0.0f, 0.0f, 1.0f), AxisLength);
+		}
+
+	public:
+
+		/**
+		 * Gets the ends of the segment at the core of the capsule, the capsule is every point within Radius of it.
+		 *
+		 * @param OutStart Receives Center - Orientation * Length / 2.
+		 * @param OutEnd Receives Center + Orientation * Length / 2.
+		 */
+		inline void GetSegment(FVector& OutStart, FVector& OutEnd) const
+		{
+			const FVector HalfAxis = Orientation * (Length * 0.5f);
+			OutStart = Center - HalfAxis;
+			OutEnd = Center + HalfAxis;
+		}
+
+		/** @return The axis aligned box around the capsule. */
+		inline FBox GetBox() const
+		{
+			const FVector HalfAxis = Orientation * (Length * 0.5f);
+			const FVector Extent = HalfAxis.GetAbs() + Radius;
+			return FBox(Center - Extent, Center + Extent);
+		}
+
+		/**
+		 * Checks whether the given location is inside this capsule.
+		 *
+		 * @param Point The location to test.
+		 * @return true if the location is inside the capsule, otherwise false.
+		 */
+		inline bool IsInside(const FVector& Point) const
+		{
+			FVector Start, End;
+			GetSegment(Start, End);
+			return FMath::PointDistToSegmentSquared(Point, Start, End) <= FMath::Square(Radius);
+		}
+
+		/** @return true if this capsule overlaps Other. */
+		bool Intersects(const FCapsuleShape& Other) const;
+
+		/** @return true if this capsule overlaps Sphere. */
+		inline bool Intersects(const FSphere& Sphere) const
+		{
+			FVector Start, End;
+			GetSegment(Start, End);
+			return FMath::PointDistToSegmentSquared(Sphere.Center, Start, End) <= FMath::Square(Radius + Sphere.W);
+		}
+
+		/** @return true if this capsule overlaps Box. */
+		bool Intersects(const FBox& Box) const;
+
+		/** @return true if this capsule overlaps Box. */
+		bool Intersects(const FOrientedBox& Box) const;
+
+		/** @return true if this capsule overlaps the triangle ABC. */
+		bool IntersectsTriangle(const FVector& A, const FVector& B, const FVector& C) const;
+
+		/**
+		 * Sweeps the capsule along Delta against the triangle ABC.
+		 *
+		 * The time of impact is found by conservative advancement: each step moves the capsule by the gap still
+		 * separating it from the triangle divided by its closing speed along the contact normal, until the gap
+		 * falls under a small contact tolerance, so a hit leaves the capsule just short of touching. A sweep that
+		 * is still closing in after a fixed number of steps reports a hit at the last step, which is never past
+		 * the time of impact.
+		 *
+		 * @param Delta Movement of the capsule.
+		 * @param A First vertex of the triangle.
+		 * @param B Second vertex of the triangle.
+		 * @param C Third vertex of the triangle.
+		 * @param OutTime Receives the fraction of Delta travelled before the hit, zero if the capsule starts overlapping.
+		 * @param OutNormal Receives the unit contact normal, pointing from the triangle towards the capsule.
+		 * @return true if the capsule hits the triangle before the end of Delta.
+		 */
+		bool SweepTriangle(const FVector& Delta, const FVector& A, const FVector& B, const FVector& C, float& OutTime, FVector& OutNormal) const;
+
+		/**
+		 * Sweeps the capsule along Delta against Box, see SweepTriangle.
+		 *
+		 * @param Delta Movement of the capsule.
+		 * @param Box The box.
+		 * @param OutTime Receives the fraction of Delta travelled before the hit, zero if the capsule starts overlapping.
+		 * @param OutNormal Receives the unit contact normal, pointing from the box towards the capsule.
+		 * @return true if the capsule hits the box before the end of Delta.
+		 */
+		bool SweepBox(const FVector& Delta, const FBox& Box, float& OutTime, FVector& OutNormal) const;
+
+		/**
+		 * Sweeps the capsule along Delta against a triangle list and finds the first hit.
+		 * Triangles whose box does not touch the box around the whole sweep are skipped, and once a hit is
+		 * found the remaining triangles are only advanced up to its time.
+		 *
+		 * @param Delta Movement of the capsule.
+		 * @param Vertices Three vertices per triangle.
+		 * @param NumTriangles Number of triangles.
+		 * @param OutTime Receives the fraction of Delta travelled before the first hit.
+		 * @param OutNormal Receives the unit contact normal of the first hit.
+		 * @param OutTriangleIndex Receives the index of the triangle hit first.
+		 * @return true if any triangle is hit before the end of Delta.
+		 */
+		bool SweepTriangles(const FVector& Delta, const FVector* Vertices, int32 NumTriangles, float& OutTime, FVector& OutNormal, int32& OutTriangleIndex) const;
+
+		/**
+		 * Tests this capsule against an array of primitives.
+		 *
+		 * @param Others Primitives to test against.
+		 * @param OutIntersects Receives Intersects(Others[i]) for each primitive.
+		 * @param Count Number of primitives.
+		 */
+		void IntersectsBatch(const FCapsuleShape* Others, bool* OutIntersects, int32 Count) const;
+		void IntersectsBatch(const FSphere* Spheres, bool* OutIntersects, int32 Count) const;
+		void IntersectsBatch(const FBox* Boxes, bool* OutIntersects, int32 Count) const;
+
+		/**
+		 * Tests this capsule against a triangle list.
+		 *
+		 * @param Vertices Three vertices per triangle.
+		 * @param OutIntersects Receives IntersectsTriangle() for each triangle.
+		 * @param NumTriangles Number of triangles.
+		 */
+		void IntersectsTrianglesBatch(const FVector* Vertices, bool* OutIntersects, int32 NumTriangles) const;
+
+		/**
+		 * Get a textual representation of the capsule.
+		 *
+		 * @return Text describing the capsule.
+		 */
+		std::string ToString() const
+		{
+			TStringBuilder<192> Builder;
+			AppendString(Builder);
+			return Builder.ToString();
+		}
+
+		/**
+		 * Appends a textual representation of this capsule to a string builder without allocating.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const
+		{
+			Out << "Center=(";
+			Center.AppendString(Out);
+			Out << ") Orientation=(";
+			Orientation.AppendString(Out);
+			Out << ") Radius=" << Radius << " Length=" << Length;
+		}
+	};
+
+
+	template <> struct TIsPODType<FCapsuleShape> { enum { Value = true }; };
+}
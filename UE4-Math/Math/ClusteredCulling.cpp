@@ -0,0 +1,404 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ClusteredCulling.cpp: Assignment of sphere and cone volumes to view clusters.
+=============================================================================*/
+
+#include "Math/ClusteredCulling.h"
+#include "Math/IntRect.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+#include <algorithm>
+
+namespace UE4Math
+{
+	namespace ClusteredCullingPrivate
+	{
+		/** Setting up a volume, its transform, scissor rectangle and slice range, takes 470 cycles. */
+		enum { VolumeParallelMinSize = GetParallelForMinBatchSize(470) };
+
+		/** Smallest cone sine used, zero angle cones are widened to it so the tests never divide by zero. */
+		constexpr float MinConeSin = 1.e-4f;
+
+		/** @return Lanes of a group of four clusters starting at column First that lie in [Min, Max). */
+		inline uint32 GetColumnMask(int32 First, int32 Min, int32 Max)
+		{
+			uint32 Mask = 0xf;
+			if (First < Min)
+			{
+				Mask &= 0xfu << (Min - First);
+			}
+			if (First + 4 > Max)
+			{
+				Mask &= 0xfu >> (First + 4 - Max);
+			}
+			return Mask & 0xf;
+		}
+
+		/** @return Distance from Value to the interval [Min, Max], zero inside. */
+		inline float GetIntervalDistance(float Value, float Min, float Max)
+		{
+			return FMath::Max3(Min - Value, Value - Max, 0.0f);
+		}
+	}
+
+
+	FClusteredVolumeGrid::FClusteredVolumeGrid(int32 InSizeX, int32 InSizeY, int32 InSizeZ)
+		: NearDepth(1.0f)
+		, FarDepth(2.0f)
+	{
+		SizeX = FMath::Max(InSizeX, 1);
+		SizeY = FMath::Max(InSizeY, 1);
+		SizeZ = FMath::Max(InSizeZ, 1);
+		PaddedSizeX = (SizeX + 3) & ~3;
+
+		ColumnMinX.resize(PaddedSizeX * SizeZ, 0.0f);
+		ColumnMaxX.resize(PaddedSizeX * SizeZ, 0.0f);
+		RowMinY.resize(SizeY * SizeZ, 0.0f);
+		RowMaxY.resize(SizeY * SizeZ, 0.0f);
+		SliceDepths.resize(SizeZ + 1, 0.0f);
+		SliceHits.resize(SizeZ);
+		ClusterStarts.resize(GetNumClusters() + 1, 0);
+	}
+
+	void FClusteredVolumeGrid::Build(const FMatrix& ViewMatrix, const FMatrix& ProjMatrix, float InNearDepth, float InFarDepth, const FSphere* Spheres, int32 NumSpheres, const FConeVolume* Cones, int32 NumCones)
+	{
+		using namespace ClusteredCullingPrivate;
+
+		SCOPE_MATH_CYCLE_COUNTER(ClusterBuild);
+		INC_MATH_COUNTER_BY(ClusterBuildVolumes, NumSpheres + NumCones);
+
+		std::fill(ClusterStarts.begin(), ClusterStarts.end(), 0);
+		ClusterVolumes.clear();
+		if (!ensure(InNearDepth > 0.0f && InFarDepth > InNearDepth))
+		{
+			return;
+		}
+
+		NearDepth = InNearDepth;
+		FarDepth = InFarDepth;
+		for (int32 Slice = 0; Slice < SizeZ; ++Slice)
+		{
+			SliceDepths[Slice] = NearDepth * FMath::Pow(FarDepth / NearDepth, (float)Slice / SizeZ);
+		}
+		SliceDepths[SizeZ] = FarDepth;
+
+		// Clip space W is Z * M[2][3] + M[3][3] in view space, which covers both perspective and orthographic
+		// projections. The view space X of a point at a given NDC X and depth is then linear in the depth, so the
+		// bounds of a tile column over a slice are reached at the slice's near or far depth.
+		const FMatrix& P = ProjMatrix;
+		auto GetViewX = [&P](float NDCX, float Depth)
+		{
+			return (NDCX * (Depth * P.M[2][3] + P.M[3][3]) - Depth * P.M[2][0] - P.M[3][0]) / P.M[0][0];
+		};
+		auto GetViewY = [&P](float NDCY, float Depth)
+		{
+			return (NDCY * (Depth * P.M[2][3] + P.M[3][3]) - Depth * P.M[2][1] - P.M[3][1]) / P.M[1][1];
+		};
+
+		for (int32 Slice = 0; Slice < SizeZ; ++Slice)
+		{
+			const float Depth0 = SliceDepths[Slice];
+			const float Depth1 = SliceDepths[Slice + 1];
+
+			for (int32 Column = 0; Column < SizeX; ++Column)
+			{
+				const float NDC0 = -1.0f + 2.0f * Column / SizeX;
+				const float NDC1 = -1.0f + 2.0f * (Column + 1) / SizeX;
+				const float X00 = GetViewX(NDC0, Depth0);
+				const float X01 = GetViewX(NDC0, Depth1);
+				const float X10 = GetViewX(NDC1, Depth0);
+				const float X11 = GetViewX(NDC1, Depth1);
+				ColumnMinX[Slice * PaddedSizeX + Column] = FMath::Min(FMath::Min(X00, X01), FMath::Min(X10, X11));
+				ColumnMaxX[Slice * PaddedSizeX + Column] = FMath::Max(FMath::Max(X00, X01), FMath::Max(X10, X11));
+			}
+
+			// Row zero is at the top of the screen, where NDC Y is one.
+			for (int32 Row = 0; Row < SizeY; ++Row)
+			{
+				const float NDC0 = 1.0f - 2.0f * Row / SizeY;
+				const float NDC1 = 1.0f - 2.0f * (Row + 1) / SizeY;
+				const float Y00 = GetViewY(NDC0, Depth0);
+				const float Y01 = GetViewY(NDC0, Depth1);
+				const float Y10 = GetViewY(NDC1, Depth0);
+				const float Y11 = GetViewY(NDC1, Depth1);
+				RowMinY[Slice * SizeY + Row] = FMath::Min(FMath::Min(Y00, Y01), FMath::Min(Y10, Y11));
+				RowMaxY[Slice * SizeY + Row] = FMath::Max(FMath::Max(Y00, Y01), FMath::Max(Y10, Y11));
+			}
+		}
+
+		// The scissor rectangle is only derived for perspective projections, orthographic ones start from the whole
+		// screen and leave the culling to the slice tests.
+		const bool bPerspective = P.M[3][3] == 0.0f;
+
+		const int32 NumVolumes = NumSpheres + NumCones;
+		Volumes.resize(NumVolumes);
+		ParallelFor(NumVolumes, VolumeParallelMinSize, [&](int32 VolumeIndex)
+		{
+			FVolumeBounds& Bounds = Volumes[VolumeIndex];
+			if (VolumeIndex < NumSpheres)
+			{
+				const FSphere& Sphere = Spheres[VolumeIndex];
+				Bounds.Center = ViewMatrix.TransformPosition(Sphere.Center);
+				Bounds.Radius = Sphere.W;
+				Bounds.Origin = Bounds.Center;
+				Bounds.Axis = FVector::ZeroVector;
+				Bounds.CosAngle = 0.0f;
+				Bounds.SinAngle = 0.0f;
+			}
+			else
+			{
+				const FConeVolume& Cone = Cones[VolumeIndex - NumSpheres];
+				Bounds.Origin = ViewMatrix.TransformPosition(Cone.Origin);
+				Bounds.Axis = ViewMatrix.TransformVector(Cone.Direction);
+				if (Cone.CosAngle > 0.0f)
+				{
+					Bounds.SinAngle = FMath::Max(Cone.SinAngle, MinConeSin);
+					Bounds.CosAngle = Cone.SinAngle < MinConeSin ? FMath::Sqrt(1.0f - FMath::Square(MinConeSin)) : Cone.CosAngle;
+					const FSphere Sphere = FMath::ComputeBoundingSphereForCone(Bounds.Origin, Bounds.Axis, Cone.Range, Bounds.CosAngle, Bounds.SinAngle);
+					Bounds.Center = Sphere.Center;
+					Bounds.Radius = Sphere.W;
+				}
+				else
+				{
+					Bounds.Center = Bounds.Origin;
+					Bounds.Radius = Cone.Range;
+					Bounds.CosAngle = 0.0f;
+					Bounds.SinAngle = 0.0f;
+				}
+			}
+
+			Bounds.TileMinX = 0;
+			Bounds.TileMinY = 0;
+			Bounds.TileMaxX = 0;
+			Bounds.TileMaxY = 0;
+			Bounds.SliceMin = 0;
+			Bounds.SliceMax = -1;
+
+			const float MinDepth = Bounds.Center.Z - Bounds.Radius;
+			const float MaxDepth = Bounds.Center.Z + Bounds.Radius;
+			if (MaxDepth < NearDepth || MinDepth > FarDepth)
+			{
+				return;
+			}
+
+			FIntRect Rect(0, 0, SizeX, SizeY);
+			if (bPerspective)
+			{
+				if (FMath::ComputeProjectedSphereScissorRect(Rect, Bounds.Center, Bounds.Radius, FVector::ZeroVector, FMatrix::Identity, ProjMatrix) == 0)
+				{
+					return;
+				}
+
+				// The tangent planes are found with a few rounding errors, a tile of margin keeps the rectangle conservative.
+				Rect.Min.X = FMath::Max(Rect.Min.X - 1, 0);
+				Rect.Min.Y = FMath::Max(Rect.Min.Y - 1, 0);
+				Rect.Max.X = FMath::Min(Rect.Max.X + 1, SizeX);
+				Rect.Max.Y = FMath::Min(Rect.Max.Y + 1, SizeY);
+			}
+
+			Bounds.TileMinX = Rect.Min.X;
+			Bounds.TileMinY = Rect.Min.Y;
+			Bounds.TileMaxX = Rect.Max.X;
+			Bounds.TileMaxY = Rect.Max.Y;
+			Bounds.SliceMin = MinDepth <= NearDepth ? 0 : GetSlice(MinDepth);
+			Bounds.SliceMax = MaxDepth >= FarDepth ? SizeZ - 1 : GetSlice(MaxDepth);
+		});
+
+		// Slices own their clusters, so they count and later store their hits without synchronization.
+		ParallelFor(SizeZ, 1, [this](int32 Slice)
+		{
+			CullSlice(Slice);
+		});
+
+		const int32 NumClusters = GetNumClusters();
+		int32 NumHits = 0;
+		for (int32 Cluster = 0; Cluster < NumClusters; ++Cluster)
+		{
+			const int32 Count = ClusterStarts[Cluster];
+			ClusterStarts[Cluster] = NumHits;
+			NumHits += Count;
+		}
+
+		// Hits are stored in volume order, which keeps every list sorted. After the stores every start has moved to
+		// the end of its list, shifting them by one puts them back.
+		ClusterVolumes.resize(NumHits);
+		ParallelFor(SizeZ, 1, [this](int32 Slice)
+		{
+			for (const FClusterVolume& Hit : SliceHits[Slice])
+			{
+				ClusterVolumes[ClusterStarts[Hit.Cluster]++] = Hit.Volume;
+			}
+		});
+
+		for (int32 Cluster = NumClusters; Cluster > 0; --Cluster)
+		{
+			ClusterStarts[Cluster] = ClusterStarts[Cluster - 1];
+		}
+		ClusterStarts[0] = 0;
+	}
+
+	void FClusteredVolumeGrid::CullSlice(int32 Slice)
+	{
+		using namespace ClusteredCullingPrivate;
+
+		std::vector<FClusterVolume>& Hits = SliceHits[Slice];
+		Hits.clear();
+
+		const float MinZ = SliceDepths[Slice];
+		const float MaxZ = SliceDepths[Slice + 1];
+		const float ClusterCenterZ = (MinZ + MaxZ) * 0.5f;
+		const float ClusterExtentZSquared = FMath::Square((MaxZ - MinZ) * 0.5f);
+		const float* MinX = ColumnMinX.data() + Slice * PaddedSizeX;
+		const float* MaxX = ColumnMaxX.data() + Slice * PaddedSizeX;
+		const float* MinY = RowMinY.data() + Slice * SizeY;
+		const float* MaxY = RowMaxY.data() + Slice * SizeY;
+		const int32 FirstCluster = Slice * SizeX * SizeY;
+
+		for (int32 VolumeIndex = 0; VolumeIndex < (int32)Volumes.size(); ++VolumeIndex)
+		{
+			const FVolumeBounds& Bounds = Volumes[VolumeIndex];
+			if (Slice < Bounds.SliceMin || Slice > Bounds.SliceMax)
+			{
+				continue;
+			}
+
+			// The distance from the sphere's center to a cluster box splits into one term per axis.
+			const float RadiusSquared = FMath::Square(Bounds.Radius);
+			const float DistanceZSquared = FMath::Square(GetIntervalDistance(Bounds.Center.Z, MinZ, MaxZ));
+			if (DistanceZSquared > RadiusSquared)
+			{
+				continue;
+			}
+
+			// Cones are also tested against the bounding spheres of the clusters, with the tip at the origin.
+			const bool bCone = Bounds.CosAngle > 0.0f;
+			const FVector Axis = Bounds.Axis;
+			const FVector Tip = Bounds.Origin;
+			const float ClusterCenterZFromTip = ClusterCenterZ - Tip.Z;
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+			const __m128 CenterX = _mm_set1_ps(Bounds.Center.X);
+			const __m128 RadiusSquared4 = _mm_set1_ps(RadiusSquared);
+			const __m128 Zero = _mm_setzero_ps();
+			const __m128 Half = _mm_set1_ps(0.5f);
+			const __m128 AxisX = _mm_set1_ps(Axis.X);
+			const __m128 AxisY = _mm_set1_ps(Axis.Y);
+			const __m128 AxisZ = _mm_set1_ps(Axis.Z);
+			const __m128 InvSin = _mm_set1_ps(bCone ? 1.0f / Bounds.SinAngle : 0.0f);
+			const __m128 CosSquared = _mm_set1_ps(FMath::Square(Bounds.CosAngle));
+			const __m128 SinSquared = _mm_set1_ps(FMath::Square(Bounds.SinAngle));
+#endif
+
+			const int32 FirstColumn = Bounds.TileMinX & ~3;
+			for (int32 Row = Bounds.TileMinY; Row < Bounds.TileMaxY; ++Row)
+			{
+				const float DistanceYZSquared = FMath::Square(GetIntervalDistance(Bounds.Center.Y, MinY[Row], MaxY[Row])) + DistanceZSquared;
+				if (DistanceYZSquared > RadiusSquared)
+				{
+					continue;
+				}
+
+				const float ClusterCenterYFromTip = (MinY[Row] + MaxY[Row]) * 0.5f - Tip.Y;
+				const float ClusterExtentYZSquared = FMath::Square((MaxY[Row] - MinY[Row]) * 0.5f) + ClusterExtentZSquared;
+				const int32 RowCluster = FirstCluster + Row * SizeX;
+
+				for (int32 Column = FirstColumn; Column < Bounds.TileMaxX; Column += 4)
+				{
+					uint32 Mask = GetColumnMask(Column, Bounds.TileMinX, Bounds.TileMaxX);
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+					const __m128 ColumnMin = _mm_loadu_ps(MinX + Column);
+					const __m128 ColumnMax = _mm_loadu_ps(MaxX + Column);
+					const __m128 DistanceX = _mm_max_ps(_mm_max_ps(_mm_sub_ps(ColumnMin, CenterX), _mm_sub_ps(CenterX, ColumnMax)), Zero);
+					const __m128 DistanceSquared = _mm_add_ps(_mm_mul_ps(DistanceX, DistanceX), _mm_set1_ps(DistanceYZSquared));
+					Mask &= (uint32)_mm_movemask_ps(_mm_cmple_ps(DistanceSquared, RadiusSquared4));
+
+					if (bCone && Mask)
+					{
+						// FMath::SphereConeIntersection, four clusters at a time.
+						const __m128 ClusterX = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(ColumnMin, ColumnMax), Half), _mm_set1_ps(Tip.X));
+						const __m128 ClusterY = _mm_set1_ps(ClusterCenterYFromTip);
+						const __m128 ClusterZ = _mm_set1_ps(ClusterCenterZFromTip);
+						const __m128 ExtentX = _mm_mul_ps(_mm_sub_ps(ColumnMax, ColumnMin), Half);
+						const __m128 ClusterRadiusSquared = _mm_add_ps(_mm_mul_ps(ExtentX, ExtentX), _mm_set1_ps(ClusterExtentYZSquared));
+						const __m128 Offset = _mm_mul_ps(_mm_sqrt_ps(ClusterRadiusSquared), InvSin);
+
+						const __m128 DX = _mm_add_ps(ClusterX, _mm_mul_ps(AxisX, Offset));
+						const __m128 DY = _mm_add_ps(ClusterY, _mm_mul_ps(AxisY, Offset));
+						const __m128 DZ = _mm_add_ps(ClusterZ, _mm_mul_ps(AxisZ, Offset));
+						const __m128 DSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(DX, DX), _mm_mul_ps(DY, DY)), _mm_mul_ps(DZ, DZ));
+						const __m128 E = _mm_add_ps(_mm_add_ps(_mm_mul_ps(AxisX, DX), _mm_mul_ps(AxisY, DY)), _mm_mul_ps(AxisZ, DZ));
+						const __m128 InExpandedCone = _mm_and_ps(_mm_cmpgt_ps(E, Zero), _mm_cmpge_ps(_mm_mul_ps(E, E), _mm_mul_ps(DSquared, CosSquared)));
+
+						const __m128 CenterSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ClusterX, ClusterX), _mm_mul_ps(ClusterY, ClusterY)), _mm_mul_ps(ClusterZ, ClusterZ));
+						const __m128 EBack = _mm_sub_ps(Zero, _mm_add_ps(_mm_add_ps(_mm_mul_ps(AxisX, ClusterX), _mm_mul_ps(AxisY, ClusterY)), _mm_mul_ps(AxisZ, ClusterZ)));
+						const __m128 BehindTip = _mm_and_ps(_mm_cmpgt_ps(EBack, Zero), _mm_cmpge_ps(_mm_mul_ps(EBack, EBack), _mm_mul_ps(CenterSquared, SinSquared)));
+						const __m128 MissesTip = _mm_and_ps(BehindTip, _mm_cmpgt_ps(CenterSquared, ClusterRadiusSquared));
+
+						Mask &= (uint32)_mm_movemask_ps(_mm_andnot_ps(MissesTip, InExpandedCone));
+					}
+#else
+					for (int32 Lane = 0; Lane < 4; ++Lane)
+					{
+						if (!(Mask & (1u << Lane)))
+						{
+							continue;
+						}
+
+						const int32 LaneColumn = Column + Lane;
+						const float DistanceX = GetIntervalDistance(Bounds.Center.X, MinX[LaneColumn], MaxX[LaneColumn]);
+						bool bHit = FMath::Square(DistanceX) + DistanceYZSquared <= RadiusSquared;
+						if (bHit && bCone)
+						{
+							const FVector ClusterCenter((MinX[LaneColumn] + MaxX[LaneColumn]) * 0.5f - Tip.X, ClusterCenterYFromTip, ClusterCenterZFromTip);
+							const float ClusterRadius = FMath::Sqrt(FMath::Square((MaxX[LaneColumn] - MinX[LaneColumn]) * 0.5f) + ClusterExtentYZSquared);
+							bHit = FMath::SphereConeIntersection(ClusterCenter, ClusterRadius, Axis, Bounds.SinAngle, Bounds.CosAngle);
+						}
+						if (!bHit)
+						{
+							Mask &= ~(1u << Lane);
+						}
+					}
+#endif
+
+					while (Mask)
+					{
+						const int32 Lane = (int32)FMath::CountTrailingZeros(Mask);
+						Mask &= Mask - 1;
+						const int32 Cluster = RowCluster + Column + Lane;
+						Hits.push_back({ Cluster, VolumeIndex });
+						++ClusterStarts[Cluster];
+					}
+				}
+			}
+		}
+	}
+
+	int32 FClusteredVolumeGrid::GetSlice(float Depth) const
+	{
+		if (!(Depth >= NearDepth && Depth <= FarDepth))
+		{
+			return INDEX_NONE;
+		}
+
+		// The logarithm finds the slice up to rounding, the stored depths settle it.
+		int32 Slice = FMath::Clamp(FMath::FloorToInt(FMath::Loge(Depth / NearDepth) / FMath::Loge(FarDepth / NearDepth) * SizeZ), 0, SizeZ - 1);
+		while (Slice > 0 && Depth < SliceDepths[Slice])
+		{
+			--Slice;
+		}
+		while (Slice < SizeZ - 1 && Depth >= SliceDepths[Slice + 1])
+		{
+			++Slice;
+		}
+		return Slice;
+	}
+
+	FBox FClusteredVolumeGrid::GetClusterBounds(int32 X, int32 Y, int32 Z) const
+	{
+		return FBox(
+			FVector(ColumnMinX[Z * PaddedSizeX + X], RowMinY[Z * SizeY + Y], SliceDepths[Z]),
+			FVector(ColumnMaxX[Z * PaddedSizeX + X], RowMaxY[Z * SizeY + Y], SliceDepths[Z + 1]));
+	}
+}
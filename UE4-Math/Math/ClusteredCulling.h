@@ -0,0 +1,211 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+#include "Math/Sphere.h"
+#include "Math/Box.h"
+#include "Math/Matrix.h"
+
+namespace UE4Math
+{
+	/**
+	 * A cone shaped volume, such as a spot light's: the part of the sphere of radius Range around Origin that lies
+	 * within Angle of Direction.
+	 */
+	struct FConeVolume
+	{
+		/** Tip of the cone. */
+		FVector Origin;
+
+		/** Axis of the cone, normalized. */
+		FVector Direction;
+
+		/** Distance from the tip the volume reaches. */
+		float Range;
+
+		/** Cosine and sine of the half angle. Cones wider than 90 degrees are culled as their whole sphere. */
+		float CosAngle;
+		float SinAngle;
+
+		FConeVolume() { }
+
+		FConeVolume(const FVector& InOrigin, const FVector& InDirection, float InRange, float InAngle)
+			: Origin(InOrigin)
+			, Direction(InDirection)
+			, Range(InRange)
+			, CosAngle(FMath::Cos(InAngle))
+			, SinAngle(FMath::Sin(InAngle))
+		{ }
+	};
+
+	/**
+	 * Assigns sphere and cone volumes to the clusters of a view frustum, also known as froxels.
+	 *
+	 * The screen is cut into SizeX by SizeY tiles, and the depth between the near and far distances into SizeZ
+	 * slices whose thickness grows exponentially, so clusters keep roughly the same proportions at every depth.
+	 * Every cluster gets the list of volumes that may overlap it.
+	 *
+	 * Clusters are tested through their view space bounding boxes. The bounds of a tile column only depend on the
+	 * slice, so testing a sphere against a row of clusters is a few SIMD operations per four clusters. Volumes are
+	 * first limited to the tiles of their projected scissor rectangle and the slices of their depth range, cones are
+	 * then also tested with FMath::SphereConeIntersection against the bounding spheres of the clusters. Results are
+	 * conservative: a listed volume may miss the cluster, an overlapping one is never left out.
+	 *
+	 * Slices are processed in parallel and the lists are packed in a single array, every list sorted by volume index.
+	 */
+	class FClusteredVolumeGrid
+	{
+	public:
+		/**
+		 * Creates a grid.
+		 *
+		 * @param InSizeX Number of tile columns.
+		 * @param InSizeY Number of tile rows, row zero is at the top of the screen.
+		 * @param InSizeZ Number of depth slices.
+		 */
+		FClusteredVolumeGrid(int32 InSizeX, int32 InSizeY, int32 InSizeZ);
+
+		/**
+		 * Builds the volume lists of all clusters.
+		 *
+		 * Volume indices in the lists are sphere indices, followed by cone indices offset by NumSpheres.
+		 *
+		 * @param ViewMatrix World to view space, a rigid transform with Z pointing forward.
+		 * @param ProjMatrix View to clip space, perspective or orthographic.
+		 * @param InNearDepth View space depth where the first slice starts, greater than zero.
+		 * @param InFarDepth View space depth where the last slice ends.
+		 * @param Spheres Spheres in world space.
+		 * @param NumSpheres Number of spheres.
+		 * @param Cones Cones in world space.
+		 * @param NumCones Number of cones.
+		 */
+		void Build(const FMatrix& ViewMatrix, const FMatrix& ProjMatrix, float InNearDepth, float InFarDepth, const FSphere* Spheres, int32 NumSpheres, const FConeVolume* Cones, int32 NumCones);
+
+		/** @return Index of the cluster in tile column X, tile row Y and slice Z. */
+		inline int32 GetClusterIndex(int32 X, int32 Y, int32 Z) const
+		{
+			return (Z * SizeY + Y) * SizeX + X;
+		}
+
+		/** @return Number of volumes listed for a cluster. */
+		inline int32 GetNumVolumes(int32 ClusterIndex) const
+		{
+			return ClusterStarts[ClusterIndex + 1] - ClusterStarts[ClusterIndex];
+		}
+
+		/** @return The volumes listed for a cluster, GetNumVolumes of them in increasing order. */
+		inline const int32* GetVolumes(int32 ClusterIndex) const
+		{
+			return ClusterVolumes.data() + ClusterStarts[ClusterIndex];
+		}
+
+		/** @return Start of each cluster's list in GetAllVolumes, with one extra entry at the end. */
+		inline const std::vector<int32>& GetClusterStarts() const
+		{
+			return ClusterStarts;
+		}
+
+		/** @return The lists of all clusters packed together. */
+		inline const std::vector<int32>& GetAllVolumes() const
+		{
+			return ClusterVolumes;
+		}
+
+		/**
+		 * Gets the slice containing a view space depth.
+		 *
+		 * @param Depth View space depth.
+		 * @return The slice index, INDEX_NONE outside the near and far distances of the last build.
+		 */
+		int32 GetSlice(float Depth) const;
+
+		/** @return View space bounding box of a cluster, as tested by the last build. */
+		FBox GetClusterBounds(int32 X, int32 Y, int32 Z) const;
+
+		inline int32 GetSizeX() const
+		{
+			return SizeX;
+		}
+
+		inline int32 GetSizeY() const
+		{
+			return SizeY;
+		}
+
+		inline int32 GetSizeZ() const
+		{
+			return SizeZ;
+		}
+
+		inline int32 GetNumClusters() const
+		{
+			return SizeX * SizeY * SizeZ;
+		}
+
+	private:
+		/** A volume moved to view space, with the clusters it may touch. */
+		struct FVolumeBounds
+		{
+			FVector Center;
+			float Radius;
+
+			/** Cone axis in view space, and the cone's cosine and sine. Zero cosine for spheres. */
+			FVector Axis;
+			float CosAngle;
+			float SinAngle;
+
+			/** Tip of the cone in view space. */
+			FVector Origin;
+
+			/** Tiles touched, Max exclusive, and slices touched, SliceMax inclusive. Empty when off screen. */
+			int32 TileMinX;
+			int32 TileMinY;
+			int32 TileMaxX;
+			int32 TileMaxY;
+			int32 SliceMin;
+			int32 SliceMax;
+		};
+
+		/** A volume found in a cluster of a slice. */
+		struct FClusterVolume
+		{
+			int32 Cluster;
+			int32 Volume;
+		};
+
+		/** Tests the volumes against the clusters of a slice and counts the hits in ClusterStarts. */
+		void CullSlice(int32 Slice);
+
+		int32 SizeX;
+		int32 SizeY;
+		int32 SizeZ;
+
+		/** Row length of the column bounds, SizeX rounded up to a multiple of four. */
+		int32 PaddedSizeX;
+
+		float NearDepth;
+		float FarDepth;
+
+		/** View space X bounds of every tile column in every slice, PaddedSizeX per slice. */
+		std::vector<float> ColumnMinX;
+		std::vector<float> ColumnMaxX;
+
+		/** View space Y bounds of every tile row in every slice, SizeY per slice. */
+		std::vector<float> RowMinY;
+		std::vector<float> RowMaxY;
+
+		/** Depth at which each slice starts, with one extra entry at the end. */
+		std::vector<float> SliceDepths;
+
+		std::vector<FVolumeBounds> Volumes;
+
+		/** Hits of each slice, in volume order. */
+		std::vector<std::vector<FClusterVolume>> SliceHits;
+
+		std::vector<int32> ClusterStarts;
+		std::vector<int32> ClusterVolumes;
+	};
+}
@@ -12,6 +12,7 @@
 namespace UE4Math
 {
 	class FFloat16Color;
+	struct FColor;
 
 	/**
 	 * Enum for the different kinds of gamma spaces we expect to need to convert from/to.
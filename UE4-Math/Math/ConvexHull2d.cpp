@@ -0,0 +1,406 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ConvexHull2d.cpp: 2D convex hull and convex polygon utilities.
+=============================================================================*/
+
+#include "Math/ConvexHull2d.h"
+#include "Async/ParallelFor.h"
+#include <algorithm>
+#include <numeric>
+
+namespace UE4Math
+{
+	namespace ConvexHull2DPrivate
+	{
+		/** Point sets smaller than this are sorted on one thread, larger ones are sorted in chunks of this size. */
+		enum { ParallelSortMinPoints = 16384 };
+
+		/**
+		 * Twice the signed area of the triangle O, A, B, positive when it turns counter-clockwise.
+		 *
+		 * Computed in double, in float the hull of points far from the origin drops or keeps nearly collinear
+		 * points depending on rounding.
+		 */
+		inline double Orient(const FVector2D& O, const FVector2D& A, const FVector2D& B)
+		{
+			return ((double)A.X - O.X) * ((double)B.Y - O.Y) - ((double)A.Y - O.Y) * ((double)B.X - O.X);
+		}
+
+		/**
+		 * Cross product of A and B in double. Products of two floats are exact in double, so a point lying on an
+		 * edge gives exactly zero even when the compiler contracts the float version into a fused multiply-add.
+		 */
+		inline double Cross(const FVector2D& A, const FVector2D& B)
+		{
+			return (double)A.X * B.Y - (double)A.Y * B.X;
+		}
+
+		/** Sorts point indices by X then Y, ties on equal points go by index so the hull does not depend on thread timing. */
+		void SortPointIndices(const FVector2D* Points, std::vector<int32>& Indices)
+		{
+			const int32 NumPoints = (int32)Indices.size();
+			auto Less = [Points](int32 A, int32 B)
+			{
+				const FVector2D& PA = Points[A];
+				const FVector2D& PB = Points[B];
+				return PA.X < PB.X || (PA.X == PB.X && (PA.Y < PB.Y || (PA.Y == PB.Y && A < B)));
+			};
+
+			if (NumPoints < ParallelSortMinPoints)
+			{
+				std::sort(Indices.begin(), Indices.end(), Less);
+				return;
+			}
+
+			// Sort fixed size chunks in parallel, then merge neighbouring runs pairwise, doubling the run length each pass.
+			int32* Data = Indices.data();
+			ParallelForRange(NumPoints, ParallelSortMinPoints, [Data, &Less](int32 Begin, int32 End)
+			{
+				std::sort(Data + Begin, Data + End, Less);
+			}, EParallelForFlags::Deterministic);
+
+			std::vector<int32> Scratch(NumPoints);
+			int32* Source = Indices.data();
+			int32* Dest = Scratch.data();
+			for (int32 RunLength = ParallelSortMinPoints; RunLength < NumPoints; RunLength *= 2)
+			{
+				const int32 NumPairs = (NumPoints + 2 * RunLength - 1) / (2 * RunLength);
+				ParallelFor(NumPairs, 1, [Source, Dest, RunLength, NumPoints, &Less](int32 Pair)
+				{
+					const int32 Begin = Pair * 2 * RunLength;
+					const int32 Middle = FMath::Min(Begin + RunLength, NumPoints);
+					const int32 End = FMath::Min(Begin + 2 * RunLength, NumPoints);
+					std::merge(Source + Begin, Source + Middle, Source + Middle, Source + End, Dest + Begin, Less);
+				});
+				std::swap(Source, Dest);
+			}
+
+			if (Source != Indices.data())
+			{
+				Indices.swap(Scratch);
+			}
+		}
+
+		/** @return The point where segment A-B crosses the clipping edge, given the signed side of A and B. */
+		inline FVector2D IntersectEdge(const FVector2D& A, float SideA, const FVector2D& B, float SideB)
+		{
+			return A + (B - A) * (SideA / (SideA - SideB));
+		}
+
+		/** @return true if the projections of the two point sets on Axis do not overlap. */
+		bool IsSeparatingAxis(const FVector2D& Axis, const FVector2D& Origin, const FVector2D* PolygonA, int32 NumA, const FVector2D* PolygonB, int32 NumB)
+		{
+			float MinA = BIG_NUMBER, MaxA = -BIG_NUMBER;
+			for (int32 Index = 0; Index < NumA; ++Index)
+			{
+				const float Projection = Axis | (PolygonA[Index] - Origin);
+				MinA = FMath::Min(MinA, Projection);
+				MaxA = FMath::Max(MaxA, Projection);
+			}
+
+			float MinB = BIG_NUMBER, MaxB = -BIG_NUMBER;
+			for (int32 Index = 0; Index < NumB; ++Index)
+			{
+				const float Projection = Axis | (PolygonB[Index] - Origin);
+				MinB = FMath::Min(MinB, Projection);
+				MaxB = FMath::Max(MaxB, Projection);
+			}
+
+			return MaxA < MinB || MaxB < MinA;
+		}
+
+		/**
+		 * @return true if an edge normal of Polygon separates it from Other. Segments also try their direction,
+		 * the only other axis that can separate them from a polygon.
+		 */
+		bool HasSeparatingEdge(const FVector2D* Polygon, int32 NumVertices, const FVector2D* Other, int32 NumOther)
+		{
+			for (int32 Index = 0; Index < NumVertices; ++Index)
+			{
+				const FVector2D& Start = Polygon[Index];
+				const FVector2D Edge = Polygon[Index + 1 < NumVertices ? Index + 1 : 0] - Start;
+				if (IsSeparatingAxis(FVector2D(Edge.Y, -Edge.X), Start, Polygon, NumVertices, Other, NumOther))
+				{
+					return true;
+				}
+				if (NumVertices == 2 && IsSeparatingAxis(Edge, Start, Polygon, NumVertices, Other, NumOther))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+	}
+
+
+	void ConvexHull2D::ComputeConvexHull(const FVector2D* Points, int32 NumPoints, std::vector<int32>& OutIndices)
+	{
+		using namespace ConvexHull2DPrivate;
+
+		OutIndices.clear();
+		if (NumPoints <= 0)
+		{
+			return;
+		}
+
+		SCOPE_MATH_CYCLE_COUNTER(ConvexHull2D);
+		INC_MATH_COUNTER_BY(ConvexHull2DPoints, NumPoints);
+
+		std::vector<int32> Sorted(NumPoints);
+		std::iota(Sorted.begin(), Sorted.end(), 0);
+		SortPointIndices(Points, Sorted);
+
+		const FVector2D& First = Points[Sorted.front()];
+		const FVector2D& Last = Points[Sorted.back()];
+		if (First == Last)
+		{
+			OutIndices.push_back(Sorted.front());
+			return;
+		}
+
+		// Lower hull left to right then upper hull right to left, popping every vertex that does not turn left.
+		OutIndices.resize(2 * NumPoints);
+		int32 NumHull = 0;
+		for (int32 Index = 0; Index < NumPoints; ++Index)
+		{
+			const FVector2D& Point = Points[Sorted[Index]];
+			while (NumHull >= 2 && Orient(Points[OutIndices[NumHull - 2]], Points[OutIndices[NumHull - 1]], Point) <= 0.0)
+			{
+				--NumHull;
+			}
+			OutIndices[NumHull++] = Sorted[Index];
+		}
+
+		const int32 LowerHullSize = NumHull + 1;
+		for (int32 Index = NumPoints - 2; Index >= 0; --Index)
+		{
+			const FVector2D& Point = Points[Sorted[Index]];
+			while (NumHull >= LowerHullSize && Orient(Points[OutIndices[NumHull - 2]], Points[OutIndices[NumHull - 1]], Point) <= 0.0)
+			{
+				--NumHull;
+			}
+			OutIndices[NumHull++] = Sorted[Index];
+		}
+
+		// The upper hull ends on the first vertex again.
+		OutIndices.resize(NumHull - 1);
+	}
+
+
+	bool ConvexHull2D::IsPointInConvexPolygon(const FVector2D* Polygon, int32 NumVertices, const FVector2D& Point)
+	{
+		using namespace ConvexHull2DPrivate;
+
+		if (NumVertices <= 0)
+		{
+			return false;
+		}
+
+		const FVector2D& Origin = Polygon[0];
+		const FVector2D ToPoint = Point - Origin;
+		if (NumVertices == 1)
+		{
+			return ToPoint.IsZero();
+		}
+
+		if (NumVertices == 2)
+		{
+			const FVector2D Edge = Polygon[1] - Origin;
+			const float Along = Edge | ToPoint;
+			return Cross(Edge, ToPoint) == 0.0 && Along >= 0.0f && Along <= (Edge | Edge);
+		}
+
+		// Outside the wedge spanned by the first and last edge.
+		if (Cross(Polygon[1] - Origin, ToPoint) < 0.0 || Cross(Polygon[NumVertices - 1] - Origin, ToPoint) > 0.0)
+		{
+			return false;
+		}
+
+		// Find the fan triangle (Origin, Polygon[Low], Polygon[Low + 1]) the point's direction falls in.
+		int32 Low = 1;
+		int32 High = NumVertices - 1;
+		while (High - Low > 1)
+		{
+			const int32 Middle = (Low + High) / 2;
+			if (Cross(Polygon[Middle] - Origin, ToPoint) >= 0.0)
+			{
+				Low = Middle;
+			}
+			else
+			{
+				High = Middle;
+			}
+		}
+
+		return Cross(Polygon[Low + 1] - Polygon[Low], Point - Polygon[Low]) >= 0.0;
+	}
+
+
+	bool ConvexHull2D::ConvexPolygonsIntersect(const FVector2D* PolygonA, int32 NumA, const FVector2D* PolygonB, int32 NumB)
+	{
+		using namespace ConvexHull2DPrivate;
+
+		if (NumA <= 0 || NumB <= 0)
+		{
+			return false;
+		}
+
+		if (NumA == 1 && NumB == 1)
+		{
+			return PolygonA[0] == PolygonB[0];
+		}
+
+		return !HasSeparatingEdge(PolygonA, NumA, PolygonB, NumB) && !HasSeparatingEdge(PolygonB, NumB, PolygonA, NumA);
+	}
+
+
+	bool ConvexHull2D::IntersectConvexPolygons(const FVector2D* PolygonA, int32 NumA, const FVector2D* PolygonB, int32 NumB, std::vector<FVector2D>& OutPolygon)
+	{
+		using namespace ConvexHull2DPrivate;
+
+		OutPolygon.assign(PolygonA, PolygonA + FMath::Max(NumA, 0));
+		if (NumB < 3)
+		{
+			OutPolygon.clear();
+			return false;
+		}
+
+		// Sutherland-Hodgman, each edge of B keeps the part of the polygon on its left.
+		std::vector<FVector2D> Clipped;
+		Clipped.reserve(NumA + NumB);
+		for (int32 EdgeIndex = 0; EdgeIndex < NumB && !OutPolygon.empty(); ++EdgeIndex)
+		{
+			const FVector2D& EdgeStart = PolygonB[EdgeIndex];
+			const FVector2D Edge = PolygonB[EdgeIndex + 1 < NumB ? EdgeIndex + 1 : 0] - EdgeStart;
+
+			Clipped.clear();
+			const int32 NumVertices = (int32)OutPolygon.size();
+			FVector2D Previous = OutPolygon[NumVertices - 1];
+			float PreviousSide = Edge ^ (Previous - EdgeStart);
+			for (int32 Index = 0; Index < NumVertices; ++Index)
+			{
+				const FVector2D& Current = OutPolygon[Index];
+				const float CurrentSide = Edge ^ (Current - EdgeStart);
+				if (CurrentSide >= 0.0f)
+				{
+					if (PreviousSide < 0.0f)
+					{
+						Clipped.push_back(IntersectEdge(Previous, PreviousSide, Current, CurrentSide));
+					}
+					Clipped.push_back(Current);
+				}
+				else if (PreviousSide > 0.0f)
+				{
+					Clipped.push_back(IntersectEdge(Previous, PreviousSide, Current, CurrentSide));
+				}
+				Previous = Current;
+				PreviousSide = CurrentSide;
+			}
+			OutPolygon.swap(Clipped);
+		}
+
+		return !OutPolygon.empty();
+	}
+
+
+	float ConvexHull2D::ComputePolygonArea(const FVector2D* Polygon, int32 NumVertices)
+	{
+		// Relative to the first vertex, which keeps the cross products small for polygons far from the origin.
+		float DoubleArea = 0.0f;
+		for (int32 Index = 2; Index < NumVertices; ++Index)
+		{
+			DoubleArea += (Polygon[Index - 1] - Polygon[0]) ^ (Polygon[Index] - Polygon[0]);
+		}
+		return 0.5f * DoubleArea;
+	}
+
+
+	float ConvexHull2D::ComputeMinAreaRectangle(const FVector2D* Hull, int32 NumVertices, FVector2D& OutCenter, FVector2D& OutAxisX, FVector2D& OutExtent)
+	{
+		OutAxisX = FVector2D(1.0f, 0.0f);
+		OutExtent = FVector2D::ZeroVector;
+		OutCenter = NumVertices > 0 ? Hull[0] : FVector2D::ZeroVector;
+		if (NumVertices < 2)
+		{
+			return 0.0f;
+		}
+
+		if (NumVertices == 2)
+		{
+			const FVector2D Edge = Hull[1] - Hull[0];
+			OutCenter = Hull[0] + 0.5f * Edge;
+			OutExtent.X = 0.5f * Edge.Size();
+			OutAxisX = Edge.GetSafeNormal();
+			if (OutAxisX.IsZero())
+			{
+				OutAxisX = FVector2D(1.0f, 0.0f);
+			}
+			return 0.0f;
+		}
+
+		auto Next = [NumVertices](int32 Index)
+		{
+			return Index + 1 < NumVertices ? Index + 1 : 0;
+		};
+
+		// Right, Top and Left are the vertices furthest along the edge, away from it and against it. They only ever
+		// move forward as the edge turns, so all of them together go around the hull once.
+		int32 Right = 1;
+		int32 Top = 1;
+		int32 Left = 1;
+		float BestArea = BIG_NUMBER;
+
+		for (int32 Index = 0; Index < NumVertices; ++Index)
+		{
+			const FVector2D& Origin = Hull[Index];
+			const FVector2D AxisX = (Hull[Next(Index)] - Origin).GetSafeNormal();
+			if (AxisX.IsZero())
+			{
+				continue;
+			}
+			const FVector2D AxisY(-AxisX.Y, AxisX.X);
+
+			if (Index == 0)
+			{
+				Right = Next(Index);
+			}
+			for (int32 Step = 0; Step < NumVertices && (AxisX | (Hull[Next(Right)] - Origin)) > (AxisX | (Hull[Right] - Origin)); ++Step)
+			{
+				Right = Next(Right);
+			}
+
+			if (Index == 0)
+			{
+				Top = Right;
+			}
+			for (int32 Step = 0; Step < NumVertices && (AxisY | (Hull[Next(Top)] - Origin)) > (AxisY | (Hull[Top] - Origin)); ++Step)
+			{
+				Top = Next(Top);
+			}
+
+			if (Index == 0)
+			{
+				Left = Top;
+			}
+			for (int32 Step = 0; Step < NumVertices && (AxisX | (Hull[Next(Left)] - Origin)) < (AxisX | (Hull[Left] - Origin)); ++Step)
+			{
+				Left = Next(Left);
+			}
+
+			const float MaxX = AxisX | (Hull[Right] - Origin);
+			const float MinX = AxisX | (Hull[Left] - Origin);
+			const float MaxY = AxisY | (Hull[Top] - Origin);
+			const float Area = (MaxX - MinX) * MaxY;
+			if (Area < BestArea)
+			{
+				BestArea = Area;
+				OutAxisX = AxisX;
+				OutExtent = FVector2D(0.5f * (MaxX - MinX), 0.5f * MaxY);
+				OutCenter = Origin + AxisX * (0.5f * (MaxX + MinX)) + AxisY * OutExtent.Y;
+			}
+		}
+
+		return BestArea < BIG_NUMBER ? BestArea : 0.0f;
+	}
+}
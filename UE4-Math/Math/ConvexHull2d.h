@@ -0,0 +1,87 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector2D.h"
+
+namespace UE4Math
+{
+	/**
+	 * Convex hull and convex polygon utilities in 2D.
+	 *
+	 * Polygons are arrays of vertices in counter-clockwise order without repeated or collinear vertices, which is
+	 * what ComputeConvexHull produces. Points on a polygon's boundary count as inside.
+	 */
+	namespace ConvexHull2D
+	{
+		/**
+		 * Computes the convex hull of a set of points with Andrew's monotone chain.
+		 *
+		 * The points are sorted by X then Y first, large sets are sorted in parallel chunks that are then merged.
+		 * Duplicated and collinear points are left out of the hull. A set of identical points gives one index and
+		 * a set of collinear points gives the two ends.
+		 *
+		 * @param Points The points.
+		 * @param NumPoints Number of points.
+		 * @param OutIndices Receives the indices of the hull vertices in counter-clockwise order.
+		 */
+		void ComputeConvexHull(const FVector2D* Points, int32 NumPoints, std::vector<int32>& OutIndices);
+
+		/**
+		 * Tests whether a point is inside a convex polygon, in O(log n) by binary searching the fan of triangles
+		 * around the first vertex.
+		 *
+		 * @param Polygon Vertices in counter-clockwise order.
+		 * @param NumVertices Number of vertices.
+		 * @param Point The point to test.
+		 * @return true if the point is inside or on the boundary.
+		 */
+		bool IsPointInConvexPolygon(const FVector2D* Polygon, int32 NumVertices, const FVector2D& Point);
+
+		/**
+		 * Tests whether two convex polygons overlap by looking for a separating axis among their edge normals.
+		 *
+		 * @param PolygonA Vertices of the first polygon in counter-clockwise order.
+		 * @param NumA Number of vertices of the first polygon.
+		 * @param PolygonB Vertices of the second polygon in counter-clockwise order.
+		 * @param NumB Number of vertices of the second polygon.
+		 * @return true if the polygons overlap or touch.
+		 */
+		bool ConvexPolygonsIntersect(const FVector2D* PolygonA, int32 NumA, const FVector2D* PolygonB, int32 NumB);
+
+		/**
+		 * Computes the intersection of two convex polygons by clipping the first against each edge of the second.
+		 *
+		 * @param PolygonA Vertices of the first polygon in counter-clockwise order.
+		 * @param NumA Number of vertices of the first polygon.
+		 * @param PolygonB Vertices of the second polygon in counter-clockwise order, at least three.
+		 * @param NumB Number of vertices of the second polygon.
+		 * @param OutPolygon Receives the intersection in counter-clockwise order, empty if the polygons are disjoint.
+		 * @return true if the intersection is not empty.
+		 */
+		bool IntersectConvexPolygons(const FVector2D* PolygonA, int32 NumA, const FVector2D* PolygonB, int32 NumB, std::vector<FVector2D>& OutPolygon);
+
+		/**
+		 * Computes the signed area of a polygon, positive when its vertices are counter-clockwise.
+		 *
+		 * @param Polygon The vertices.
+		 * @param NumVertices Number of vertices.
+		 */
+		float ComputePolygonArea(const FVector2D* Polygon, int32 NumVertices);
+
+		/**
+		 * Computes the smallest area rectangle enclosing a convex polygon with rotating calipers. One side of the
+		 * smallest rectangle is always collinear with an edge of the hull, the calipers visit every edge in O(n).
+		 *
+		 * @param Hull Vertices of the convex hull in counter-clockwise order.
+		 * @param NumVertices Number of vertices.
+		 * @param OutCenter Receives the center of the rectangle.
+		 * @param OutAxisX Receives the unit direction of the rectangle's X axis, its Y axis is OutAxisX rotated by 90 degrees.
+		 * @param OutExtent Receives the half size of the rectangle along its axes.
+		 * @return The area of the rectangle.
+		 */
+		float ComputeMinAreaRectangle(const FVector2D* Hull, int32 NumVertices, FVector2D& OutCenter, FVector2D& OutAxisX, FVector2D& OutExtent);
+	}
+}
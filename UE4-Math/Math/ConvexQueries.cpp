@@ -0,0 +1,999 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ConvexQueries.cpp: GJK distance and EPA penetration between convex shapes.
+=============================================================================*/
+
+#include "Math/ConvexQueries.h"
+#include "Math/Vector4.h"
+#include "Math/VectorRegister.h"
+
+namespace UE4Math
+{
+	namespace ConvexQueriesPrivate
+	{
+		/** Upper bound on GJK iterations, polytopes converge in a handful and the cap only matters for bad input. */
+		enum { MaxGJKIterations = 64 };
+
+		/** GJK has converged once a new support point gets |V|^2 less than this fraction closer to its lower bound. */
+		constexpr float GJKRelativeTolerance = 1.e-5f;
+
+		/** Cores closer than the square root of this are overlapping. */
+		constexpr float OverlapDistSquared = SMALL_NUMBER;
+
+		/** Vertices whose barycentric weight in the closest point is at most this are dropped from the simplex. */
+		constexpr float BarycentricEpsilon = 1.e-5f;
+
+		/** Triangles and tetrahedra flatter than this, relative to the size of their edges, are degenerate. */
+		constexpr float DegenerateEpsilon = 1.e-10f;
+
+		/** Upper bounds on EPA's polytope, each iteration adds one vertex and two faces. */
+		enum { MaxEPAIterations = 64 };
+		enum { MaxEPAVertices = 4 + MaxEPAIterations };
+		enum { MaxEPAFaces = 4 + 2 * MaxEPAIterations };
+		enum { MaxEPAEdges = 3 * MaxEPAFaces };
+
+		/** EPA stops once the support point along the nearest face's normal is at most this much past the face. */
+		constexpr float EPATolerance = 1.e-4f;
+
+		/**
+		 * A new EPA vertex only replaces the faces it is further than this in front of, relative to the size of the
+		 * polytope. Points of boxes and other flat sided shapes land on the planes of existing faces, rounding must
+		 * not decide whether those faces go.
+		 */
+		constexpr float EPAPlaneEpsilon = 1.e-5f;
+
+		FVector GetBoxSupport(const void* Shape, const FVector& Direction)
+		{
+			const FBox& Box = *static_cast<const FBox*>(Shape);
+			return FVector(
+				Direction.X >= 0.0f ? Box.Max.X : Box.Min.X,
+				Direction.Y >= 0.0f ? Box.Max.Y : Box.Min.Y,
+				Direction.Z >= 0.0f ? Box.Max.Z : Box.Min.Z);
+		}
+
+		FVector GetSphereSupport(const void* Shape, const FVector& /*Direction*/)
+		{
+			return static_cast<const FSphere*>(Shape)->Center;
+		}
+
+		FVector GetCapsuleSupport(const void* Shape, const FVector& Direction)
+		{
+			const FCapsuleShape& Capsule = *static_cast<const FCapsuleShape*>(Shape);
+			const float HalfLength = Capsule.Length * 0.5f;
+			return Capsule.Center + Capsule.Orientation * ((Direction | Capsule.Orientation) >= 0.0f ? HalfLength : -HalfLength);
+		}
+
+		FVector GetOrientedBoxSupport(const void* Shape, const FVector& Direction)
+		{
+			const FOrientedBox& Box = *static_cast<const FOrientedBox*>(Shape);
+			return Box.Center
+				+ Box.AxisX * ((Direction | Box.AxisX) >= 0.0f ? Box.ExtentX : -Box.ExtentX)
+				+ Box.AxisY * ((Direction | Box.AxisY) >= 0.0f ? Box.ExtentY : -Box.ExtentY)
+				+ Box.AxisZ * ((Direction | Box.AxisZ) >= 0.0f ? Box.ExtentZ : -Box.ExtentZ);
+		}
+
+		/** Finds the point furthest along Direction by brute force, which beats hill climbing for small clouds. */
+		FVector GetPointCloudSupport(const void* Shape, const FVector& Direction)
+		{
+			const FConvexPointCloud& Cloud = *static_cast<const FConvexPointCloud*>(Shape);
+
+			int32 BestIndex = 0;
+			float BestDot = -BIG_NUMBER;
+			int32 Index = 0;
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+			if (Cloud.NumPoints >= 4)
+			{
+				const __m128 DirX = _mm_set1_ps(Direction.X);
+				const __m128 DirY = _mm_set1_ps(Direction.Y);
+				const __m128 DirZ = _mm_set1_ps(Direction.Z);
+				const __m128i Four = _mm_set1_epi32(4);
+				__m128i Indices = _mm_setr_epi32(0, 1, 2, 3);
+				__m128i LaneBestIndex = _mm_setzero_si128();
+				__m128 LaneBestDot = _mm_set1_ps(-BIG_NUMBER);
+
+				const float* Floats = &Cloud.Points[0].X;
+				for (; Index + 4 <= Cloud.NumPoints; Index += 4, Floats += 12)
+				{
+					// Four packed points are 12 floats, transpose them to one register per component.
+					const __m128 P0 = _mm_loadu_ps(Floats);
+					const __m128 P1 = _mm_loadu_ps(Floats + 4);
+					const __m128 P2 = _mm_loadu_ps(Floats + 8);
+					const __m128 X = _mm_shuffle_ps(P0, _mm_shuffle_ps(P1, P2, _MM_SHUFFLE(1, 0, 3, 2)), _MM_SHUFFLE(3, 0, 3, 0));
+					const __m128 Y = _mm_shuffle_ps(_mm_shuffle_ps(P0, P1, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(P1, P2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+					const __m128 Z = _mm_shuffle_ps(_mm_shuffle_ps(P0, P1, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(P2, P2, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+
+					const __m128 Dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, DirX), _mm_mul_ps(Y, DirY)), _mm_mul_ps(Z, DirZ));
+					const __m128i Better = _mm_castps_si128(_mm_cmpgt_ps(Dot, LaneBestDot));
+					LaneBestDot = _mm_max_ps(Dot, LaneBestDot);
+					LaneBestIndex = _mm_or_si128(_mm_and_si128(Better, Indices), _mm_andnot_si128(Better, LaneBestIndex));
+					Indices = _mm_add_epi32(Indices, Four);
+				}
+
+				alignas(16) float Dots[4];
+				alignas(16) int32 DotIndices[4];
+				_mm_store_ps(Dots, LaneBestDot);
+				_mm_store_si128((__m128i*)DotIndices, LaneBestIndex);
+				for (int32 Lane = 0; Lane < 4; ++Lane)
+				{
+					if (Dots[Lane] > BestDot)
+					{
+						BestDot = Dots[Lane];
+						BestIndex = DotIndices[Lane];
+					}
+				}
+			}
+#endif
+
+			for (; Index < Cloud.NumPoints; ++Index)
+			{
+				const float Dot = Cloud.Points[Index] | Direction;
+				if (Dot > BestDot)
+				{
+					BestDot = Dot;
+					BestIndex = Index;
+				}
+			}
+
+			return Cloud.Points[BestIndex];
+		}
+
+		/** A point of the Minkowski difference A - B with the points of A and B it came from. */
+		struct FSupportVertex
+		{
+			FVector A;
+			FVector B;
+			FVector W;
+
+			/** The direction the vertex was found along, which is all a warm start needs to find it again. */
+			FVector Direction;
+		};
+
+		inline FSupportVertex MakeVertex(const FConvexSupport& A, const FConvexSupport& B, const FVector& Direction)
+		{
+			FSupportVertex Vertex;
+			Vertex.A = A.GetSupport(Direction);
+			Vertex.B = B.GetSupport(-Direction);
+			Vertex.W = Vertex.A - Vertex.B;
+			Vertex.Direction = Direction;
+			return Vertex;
+		}
+
+		/** The GJK simplex, one to four vertices of A - B with the weights of the point closest to the origin. */
+		struct FSimplex
+		{
+			FSupportVertex Vertices[4];
+			float Lambdas[4];
+			int32 Num;
+
+			FSimplex()
+				: Num(0)
+			{ }
+
+			bool Contains(const FVector& W) const
+			{
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					if (FVector::DistSquared(Vertices[Index].W, W) <= OverlapDistSquared)
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+
+			/** @return The point of A the closest point of the simplex is made of. */
+			FVector GetPointA() const
+			{
+				FVector Result = FVector::ZeroVector;
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					Result += Vertices[Index].A * Lambdas[Index];
+				}
+				return Result;
+			}
+
+			/** @return The point of B the closest point of the simplex is made of. */
+			FVector GetPointB() const
+			{
+				FVector Result = FVector::ZeroVector;
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					Result += Vertices[Index].B * Lambdas[Index];
+				}
+				return Result;
+			}
+
+			/**
+			 * Finds the point of the simplex closest to the origin and drops the vertices it does not depend on.
+			 *
+			 * @param OutClosest Receives the closest point.
+			 * @return true if the simplex is a tetrahedron containing the origin.
+			 */
+			bool Solve(FVector& OutClosest)
+			{
+				switch (Num)
+				{
+				case 1:
+					Lambdas[0] = 1.0f;
+					OutClosest = Vertices[0].W;
+					return false;
+				case 2:
+					OutClosest = SolveSegment();
+					return false;
+				case 3:
+					OutClosest = SolveTriangle();
+					return false;
+				default:
+					return SolveTetrahedron(OutClosest);
+				}
+			}
+
+		private:
+
+			/** Keeps the vertices whose weight is above BarycentricEpsilon, false if none is. */
+			bool Reduce(const float* Weights)
+			{
+				int32 NewNum = 0;
+				float WeightSum = 0.0f;
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					if (Weights[Index] > BarycentricEpsilon)
+					{
+						Vertices[NewNum] = Vertices[Index];
+						Lambdas[NewNum] = Weights[Index];
+						WeightSum += Weights[Index];
+						++NewNum;
+					}
+				}
+
+				if (NewNum == 0)
+				{
+					return false;
+				}
+
+				Num = NewNum;
+				for (int32 Index = 0; Index < Num; ++Index)
+				{
+					Lambdas[Index] /= WeightSum;
+				}
+				return true;
+			}
+
+			/** Replaces a degenerate simplex by whichever of its faces is closest to the origin. */
+			FVector SolveFaces(const int32 (*Faces)[3], int32 NumFaces, int32 FaceSize)
+			{
+				FSimplex Best;
+				FVector BestClosest = FVector::ZeroVector;
+				float BestDistSquared = BIG_NUMBER;
+				for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+				{
+					FSimplex Face;
+					Face.Num = FaceSize;
+					for (int32 Index = 0; Index < FaceSize; ++Index)
+					{
+						Face.Vertices[Index] = Vertices[Faces[FaceIndex][Index]];
+					}
+
+					FVector Closest;
+					Face.Solve(Closest);
+					if (Closest.SizeSquared() < BestDistSquared)
+					{
+						BestDistSquared = Closest.SizeSquared();
+						BestClosest = Closest;
+						Best = Face;
+					}
+				}
+
+				*this = Best;
+				return BestClosest;
+			}
+
+			FVector SolveSegment()
+			{
+				const FVector& W0 = Vertices[0].W;
+				const FVector Edge = Vertices[1].W - W0;
+				const float LengthSquared = Edge.SizeSquared();
+				const float T = LengthSquared > 0.0f ? -(W0 | Edge) / LengthSquared : 0.0f;
+
+				if (T <= 0.0f)
+				{
+					Num = 1;
+					Lambdas[0] = 1.0f;
+					return Vertices[0].W;
+				}
+				if (T >= 1.0f)
+				{
+					Vertices[0] = Vertices[1];
+					Num = 1;
+					Lambdas[0] = 1.0f;
+					return Vertices[0].W;
+				}
+
+				Lambdas[0] = 1.0f - T;
+				Lambdas[1] = T;
+				return W0 + Edge * T;
+			}
+
+			FVector SolveTriangle()
+			{
+				const FVector& W0 = Vertices[0].W;
+				const FVector& W1 = Vertices[1].W;
+				const FVector& W2 = Vertices[2].W;
+				const FVector Normal = (W1 - W0) ^ (W2 - W0);
+				const float MaxEdgeSquared = FMath::Max3(FVector::DistSquared(W0, W1), FVector::DistSquared(W1, W2), FVector::DistSquared(W2, W0));
+
+				if (Normal.SizeSquared() > DegenerateEpsilon * FMath::Square(MaxEdgeSquared))
+				{
+					const FVector Closest = FMath::ClosestPointOnTriangleToPoint(FVector::ZeroVector, W0, W1, W2);
+					const FVector Bary = FMath::ComputeBaryCentric2D(Closest, W0, W1, W2);
+					const float Weights[3] = { Bary.X, Bary.Y, Bary.Z };
+					if (Reduce(Weights))
+					{
+						return Closest;
+					}
+				}
+
+				// Collinear, the closest point is on one of the edges.
+				static const int32 Edges[3][3] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
+				return SolveFaces(Edges, 3, 2);
+			}
+
+			bool SolveTetrahedron(FVector& OutClosest)
+			{
+				const FVector& W0 = Vertices[0].W;
+				const FVector& W1 = Vertices[1].W;
+				const FVector& W2 = Vertices[2].W;
+				const FVector& W3 = Vertices[3].W;
+				const FVector E1 = W1 - W0;
+				const FVector E2 = W2 - W0;
+				const FVector E3 = W3 - W0;
+				const float Volume = E1 | (E2 ^ E3);
+
+				if (FMath::Square(Volume) > DegenerateEpsilon * E1.SizeSquared() * E2.SizeSquared() * E3.SizeSquared())
+				{
+					OutClosest = FMath::ClosestPointOnTetrahedronToPoint(FVector::ZeroVector, W0, W1, W2, W3);
+					const FVector4 Bary = FMath::ComputeBaryCentric3D(OutClosest, W0, W1, W2, W3);
+					float Weights[4] = { Bary.X, Bary.Y, Bary.Z, Bary.W };
+
+					if (OutClosest.IsZero())
+					{
+						// The origin is inside, the weights only serve to find a point common to both shapes.
+						float WeightSum = 0.0f;
+						for (int32 Index = 0; Index < 4; ++Index)
+						{
+							Weights[Index] = FMath::Max(Weights[Index], 0.0f);
+							WeightSum += Weights[Index];
+						}
+						for (int32 Index = 0; Index < 4; ++Index)
+						{
+							Lambdas[Index] = WeightSum > 0.0f ? Weights[Index] / WeightSum : 0.25f;
+						}
+						return true;
+					}
+
+					// The closest point is on a face, rounding can leave every weight above the epsilon.
+					int32 Smallest = 0;
+					for (int32 Index = 1; Index < 4; ++Index)
+					{
+						if (Weights[Index] < Weights[Smallest])
+						{
+							Smallest = Index;
+						}
+					}
+					Weights[Smallest] = 0.0f;
+
+					if (Reduce(Weights))
+					{
+						return false;
+					}
+				}
+
+				// Flat, the closest point is on one of the faces.
+				static const int32 Faces[4][3] = { { 0, 1, 2 }, { 0, 1, 3 }, { 0, 2, 3 }, { 1, 2, 3 } };
+				OutClosest = SolveFaces(Faces, 4, 3);
+				return false;
+			}
+		};
+
+		enum class EGJKMode
+		{
+			/** Runs until the closest points of the cores are found. */
+			Distance,
+
+			/** Stops as soon as the shapes, margins included, are known to overlap or not. */
+			Intersect,
+		};
+
+		/**
+		 * Runs GJK on the cores of A and B.
+		 *
+		 * @param OutSimplex Receives the final simplex, its closest point is OutClosest.
+		 * @param OutClosest Receives the point of the core difference closest to the origin.
+		 * @param OutIterations Receives the number of support points evaluated.
+		 * @return In Distance mode, true if the cores are apart. In Intersect mode, true if the shapes are apart.
+		 */
+		bool SolveGJK(const FConvexSupport& A, const FConvexSupport& B, EGJKMode Mode, FGJKSimplex* InOutSimplex, FSimplex& OutSimplex, FVector& OutClosest, int32& OutIterations)
+		{
+			FSimplex& Simplex = OutSimplex;
+			Simplex.Num = 0;
+
+			if (InOutSimplex != nullptr && InOutSimplex->NumVertices > 0)
+			{
+				for (int32 Index = 0; Index < InOutSimplex->NumVertices; ++Index)
+				{
+					const FSupportVertex Vertex = MakeVertex(A, B, InOutSimplex->Directions[Index]);
+					if (!Simplex.Contains(Vertex.W))
+					{
+						Simplex.Vertices[Simplex.Num++] = Vertex;
+					}
+				}
+			}
+			else
+			{
+				Simplex.Vertices[Simplex.Num++] = MakeVertex(A, B, FVector(1.0f, 0.0f, 0.0f));
+			}
+
+			int32 Iterations = Simplex.Num;
+			FVector Closest;
+			bool bOverlapping = Simplex.Solve(Closest);
+			float ClosestSizeSquared = Closest.SizeSquared();
+			bOverlapping |= ClosestSizeSquared <= OverlapDistSquared;
+
+			const float MarginsSquared = FMath::Square(A.Margin + B.Margin);
+			bool bSeparated = false;
+
+			while (!bOverlapping && Iterations < MaxGJKIterations)
+			{
+				// |Closest| is an upper bound on the distance between the cores.
+				if (Mode == EGJKMode::Intersect && ClosestSizeSquared <= MarginsSquared)
+				{
+					break;
+				}
+
+				const FSupportVertex Vertex = MakeVertex(A, B, -Closest);
+				++Iterations;
+
+				// Closest | W / |Closest| is a lower bound on it.
+				const float ClosestDotW = Closest | Vertex.W;
+				if (Mode == EGJKMode::Intersect && ClosestDotW > 0.0f && FMath::Square(ClosestDotW) > MarginsSquared * ClosestSizeSquared)
+				{
+					bSeparated = true;
+					break;
+				}
+
+				if (ClosestSizeSquared - ClosestDotW <= GJKRelativeTolerance * ClosestSizeSquared || Simplex.Contains(Vertex.W))
+				{
+					break;
+				}
+
+				Simplex.Vertices[Simplex.Num++] = Vertex;
+				FVector NewClosest;
+				bOverlapping = Simplex.Solve(NewClosest);
+
+				const float NewClosestSizeSquared = NewClosest.SizeSquared();
+				const bool bProgress = NewClosestSizeSquared < ClosestSizeSquared;
+				Closest = NewClosest;
+				ClosestSizeSquared = NewClosestSizeSquared;
+				bOverlapping |= ClosestSizeSquared <= OverlapDistSquared;
+
+				if (!bProgress)
+				{
+					// Rounding, the previous point was as close as it gets.
+					break;
+				}
+			}
+
+			if (InOutSimplex != nullptr)
+			{
+				InOutSimplex->NumVertices = Simplex.Num;
+				for (int32 Index = 0; Index < Simplex.Num; ++Index)
+				{
+					InOutSimplex->Directions[Index] = Simplex.Vertices[Index].Direction;
+				}
+			}
+
+			OutClosest = Closest;
+			OutIterations = Iterations;
+
+			if (Mode == EGJKMode::Intersect)
+			{
+				return bSeparated || (!bOverlapping && ClosestSizeSquared > MarginsSquared);
+			}
+			return !bOverlapping;
+		}
+
+		/** A triangle of the EPA polytope, wound so its normal points away from the origin. */
+		struct FEPAFace
+		{
+			int32 Vertices[3];
+			FVector Normal;
+			float Distance;
+		};
+
+		/** A polytope of A - B containing the origin, grown by EPA towards the boundary nearest the origin. */
+		struct FPolytope
+		{
+			FSupportVertex Vertices[MaxEPAVertices];
+			FEPAFace Faces[MaxEPAFaces];
+			int32 Edges[MaxEPAEdges][2];
+			int32 NumVertices;
+			int32 NumFaces;
+
+			/** Largest absolute coordinate of the vertices, the scale plane tests are relative to. */
+			float Scale;
+
+			/** @return true if the triangle VA, VB, VC is too thin for its normal to be trusted. */
+			bool IsFlat(int32 VA, int32 VB, int32 VC) const
+			{
+				const FVector& WA = Vertices[VA].W;
+				const FVector AB = Vertices[VB].W - WA;
+				const FVector AC = Vertices[VC].W - WA;
+				return (AB ^ AC).SizeSquared() <= DegenerateEpsilon * AB.SizeSquared() * AC.SizeSquared();
+			}
+
+			/** Adds the face VA, VB, VC, false if it is flat or there is no room for it. */
+			bool AddFace(int32 VA, int32 VB, int32 VC)
+			{
+				if (NumFaces == MaxEPAFaces || IsFlat(VA, VB, VC))
+				{
+					return false;
+				}
+
+				const FVector& WA = Vertices[VA].W;
+				FEPAFace& Face = Faces[NumFaces++];
+				Face.Vertices[0] = VA;
+				Face.Vertices[1] = VB;
+				Face.Vertices[2] = VC;
+				Face.Normal = ((Vertices[VB].W - WA) ^ (Vertices[VC].W - WA)).GetUnsafeNormal();
+				Face.Distance = Face.Normal | WA;
+				return true;
+			}
+
+			/**
+			 * Grows the simplex GJK stopped on into a tetrahedron. GJK stops short of a tetrahedron when the origin
+			 * is on the simplex, which then only needs a point off its line or plane.
+			 *
+			 * @param OutFlatNormal Receives a unit direction perpendicular to A - B when it is flat.
+			 * @return false if A - B is flat, the cores then only touch.
+			 */
+			bool CompleteTetrahedron(const FConvexSupport& A, const FConvexSupport& B, FVector& OutFlatNormal)
+			{
+				static const FVector Axes[6] =
+				{
+					FVector(1.0f, 0.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f),
+					FVector(0.0f, 1.0f, 0.0f), FVector(0.0f, -1.0f, 0.0f),
+					FVector(0.0f, 0.0f, 1.0f), FVector(0.0f, 0.0f, -1.0f),
+				};
+
+				if (NumVertices == 1)
+				{
+					for (const FVector& Axis : Axes)
+					{
+						const FSupportVertex Vertex = MakeVertex(A, B, Axis);
+						if (FVector::DistSquared(Vertex.W, Vertices[0].W) > OverlapDistSquared)
+						{
+							Vertices[NumVertices++] = Vertex;
+							break;
+						}
+					}
+					if (NumVertices == 1)
+					{
+						OutFlatNormal = FVector::UpVector;
+						return false;
+					}
+				}
+
+				if (NumVertices == 2)
+				{
+					// Turn a direction perpendicular to the line around it until it finds a point off the line.
+					const FVector Line = Vertices[1].W - Vertices[0].W;
+					const FVector AbsLine = Line.GetAbs();
+					const FVector& LeastAligned = AbsLine.X <= AbsLine.Y && AbsLine.X <= AbsLine.Z ? Axes[0] : (AbsLine.Y <= AbsLine.Z ? Axes[2] : Axes[4]);
+					const FVector Perpendicular1 = (Line ^ LeastAligned).GetSafeNormal();
+					const FVector Perpendicular2 = (Line ^ Perpendicular1).GetSafeNormal();
+
+					for (int32 Step = 0; Step < 6; ++Step)
+					{
+						float Sin, Cos;
+						FMath::SinCos(&Sin, &Cos, Step * (PI / 3.0f));
+						const FSupportVertex Vertex = MakeVertex(A, B, Perpendicular1 * Cos + Perpendicular2 * Sin);
+						if (((Vertex.W - Vertices[0].W) ^ Line).SizeSquared() > OverlapDistSquared * Line.SizeSquared())
+						{
+							Vertices[NumVertices++] = Vertex;
+							break;
+						}
+					}
+					if (NumVertices == 2)
+					{
+						OutFlatNormal = Perpendicular1;
+						return false;
+					}
+				}
+
+				if (NumVertices == 3)
+				{
+					const FVector Normal = ((Vertices[1].W - Vertices[0].W) ^ (Vertices[2].W - Vertices[0].W)).GetSafeNormal();
+					for (const FVector& Direction : { Normal, -Normal })
+					{
+						const FSupportVertex Vertex = MakeVertex(A, B, Direction);
+						if (FMath::Square((Vertex.W - Vertices[0].W) | Normal) > OverlapDistSquared)
+						{
+							Vertices[NumVertices++] = Vertex;
+							break;
+						}
+					}
+					if (NumVertices == 3)
+					{
+						OutFlatNormal = Normal;
+						return false;
+					}
+				}
+
+				return true;
+			}
+
+			/** Adds an edge of a face being removed, an edge shared with another removed face cancels out. */
+			bool AddHorizonEdge(int32& NumEdges, int32 VA, int32 VB)
+			{
+				for (int32 Index = 0; Index < NumEdges; ++Index)
+				{
+					if (Edges[Index][0] == VB && Edges[Index][1] == VA)
+					{
+						--NumEdges;
+						Edges[Index][0] = Edges[NumEdges][0];
+						Edges[Index][1] = Edges[NumEdges][1];
+						return true;
+					}
+				}
+
+				if (NumEdges == MaxEPAEdges)
+				{
+					return false;
+				}
+
+				Edges[NumEdges][0] = VA;
+				Edges[NumEdges][1] = VB;
+				++NumEdges;
+				return true;
+			}
+
+			/** Marks a face for removal and adds its edges to the horizon, false if the horizon is full. */
+			bool RemoveFace(int32 FaceIndex, bool* Removed, int32& NumRemoved, int32& NumEdges)
+			{
+				const FEPAFace& Face = Faces[FaceIndex];
+				Removed[FaceIndex] = true;
+				++NumRemoved;
+				return AddHorizonEdge(NumEdges, Face.Vertices[0], Face.Vertices[1])
+					&& AddHorizonEdge(NumEdges, Face.Vertices[1], Face.Vertices[2])
+					&& AddHorizonEdge(NumEdges, Face.Vertices[2], Face.Vertices[0]);
+			}
+
+			/** @return The face that is not being removed and has the edge VA, VB, or INDEX_NONE. */
+			int32 FindFaceWithEdge(int32 VA, int32 VB, const bool* Removed) const
+			{
+				for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+				{
+					const FEPAFace& Face = Faces[FaceIndex];
+					if (!Removed[FaceIndex]
+						&& ((Face.Vertices[0] == VA && Face.Vertices[1] == VB)
+							|| (Face.Vertices[1] == VA && Face.Vertices[2] == VB)
+							|| (Face.Vertices[2] == VA && Face.Vertices[0] == VB)))
+					{
+						return FaceIndex;
+					}
+				}
+				return INDEX_NONE;
+			}
+
+			/**
+			 * Replaces the faces the new vertex is in front of with a fan from the horizon to it. The polytope is only
+			 * changed once the whole fan is known to fit and have no flat triangles.
+			 *
+			 * @param NewVertex The vertex, already added to Vertices.
+			 * @param Nearest The face the vertex was found from, always replaced.
+			 * @return false if the polytope could not be grown, it is then left as it was.
+			 */
+			bool AddVertex(int32 NewVertex, int32 Nearest)
+			{
+				const FVector& W = Vertices[NewVertex].W;
+				const float PlaneTolerance = EPAPlaneEpsilon * Scale;
+
+				bool Removed[MaxEPAFaces];
+				int32 NumRemoved = 0;
+				int32 NumEdges = 0;
+				for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+				{
+					Removed[FaceIndex] = false;
+				}
+				for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+				{
+					if ((FaceIndex == Nearest || (Faces[FaceIndex].Normal | W) - Faces[FaceIndex].Distance > PlaneTolerance)
+						&& !RemoveFace(FaceIndex, Removed, NumRemoved, NumEdges))
+					{
+						return false;
+					}
+				}
+
+				// A fan triangle is flat when the new vertex is on the line of its horizon edge, and so in the plane of
+				// the face behind that edge. That face goes too, which moves the horizon past the edge.
+				for (int32 EdgeIndex = 0; EdgeIndex < NumEdges; )
+				{
+					if (!IsFlat(Edges[EdgeIndex][0], Edges[EdgeIndex][1], NewVertex))
+					{
+						++EdgeIndex;
+						continue;
+					}
+
+					const int32 Behind = FindFaceWithEdge(Edges[EdgeIndex][1], Edges[EdgeIndex][0], Removed);
+					if (Behind == INDEX_NONE || !RemoveFace(Behind, Removed, NumRemoved, NumEdges))
+					{
+						return false;
+					}
+					EdgeIndex = 0;
+				}
+
+				const int32 NumKept = NumFaces - NumRemoved;
+				if (NumEdges < 3 || NumKept + NumEdges > MaxEPAFaces)
+				{
+					return false;
+				}
+
+				int32 NumKeptSoFar = 0;
+				for (int32 FaceIndex = 0; FaceIndex < NumFaces; ++FaceIndex)
+				{
+					if (!Removed[FaceIndex])
+					{
+						Faces[NumKeptSoFar++] = Faces[FaceIndex];
+					}
+				}
+				NumFaces = NumKept;
+
+				for (int32 EdgeIndex = 0; EdgeIndex < NumEdges; ++EdgeIndex)
+				{
+					AddFace(Edges[EdgeIndex][0], Edges[EdgeIndex][1], NewVertex);
+				}
+				return true;
+			}
+
+			/**
+			 * Runs EPA from the completed tetrahedron.
+			 *
+			 * @param OutFace Receives the face nearest the origin when EPA stopped. If the polytope cannot be grown
+			 *				  any further, e.g. it ran out of room, that is the nearest face of the last valid polytope.
+			 * @param OutIterations Receives the number of support points evaluated.
+			 * @return false if the tetrahedron is degenerate.
+			 */
+			bool Expand(const FConvexSupport& A, const FConvexSupport& B, FEPAFace& OutFace, int32& OutIterations)
+			{
+				// Wind the tetrahedron so that its faces point outwards.
+				if ((((Vertices[1].W - Vertices[0].W) ^ (Vertices[2].W - Vertices[0].W)) | (Vertices[3].W - Vertices[0].W)) > 0.0f)
+				{
+					std::swap(Vertices[1], Vertices[2]);
+				}
+
+				Scale = 0.0f;
+				for (int32 Index = 0; Index < 4; ++Index)
+				{
+					Scale = FMath::Max(Scale, Vertices[Index].W.GetAbsMax());
+				}
+
+				NumFaces = 0;
+				if (!AddFace(0, 1, 2) || !AddFace(0, 3, 1) || !AddFace(0, 2, 3) || !AddFace(1, 3, 2))
+				{
+					return false;
+				}
+
+				OutIterations = 0;
+				for (;;)
+				{
+					int32 Nearest = 0;
+					for (int32 FaceIndex = 1; FaceIndex < NumFaces; ++FaceIndex)
+					{
+						if (Faces[FaceIndex].Distance < Faces[Nearest].Distance)
+						{
+							Nearest = FaceIndex;
+						}
+					}
+					OutFace = Faces[Nearest];
+
+					if (OutIterations == MaxEPAIterations || NumVertices == MaxEPAVertices)
+					{
+						return true;
+					}
+
+					const FSupportVertex Vertex = MakeVertex(A, B, OutFace.Normal);
+					++OutIterations;
+
+					if ((Vertex.W | OutFace.Normal) - OutFace.Distance <= EPATolerance * FMath::Max(1.0f, OutFace.Distance))
+					{
+						return true;
+					}
+
+					Vertices[NumVertices] = Vertex;
+					Scale = FMath::Max(Scale, Vertex.W.GetAbsMax());
+					if (!AddVertex(NumVertices, Nearest))
+					{
+						return true;
+					}
+					++NumVertices;
+				}
+			}
+		};
+	}
+
+
+	/* FConvexSupport constructors
+	 *****************************************************************************/
+
+	FConvexSupport::FConvexSupport(const FBox& Box)
+		: Shape(&Box)
+		, SupportFunction(&ConvexQueriesPrivate::GetBoxSupport)
+		, Margin(0.0f)
+	{ }
+
+
+	FConvexSupport::FConvexSupport(const FSphere& Sphere)
+		: Shape(&Sphere)
+		, SupportFunction(&ConvexQueriesPrivate::GetSphereSupport)
+		, Margin(Sphere.W)
+	{ }
+
+
+	FConvexSupport::FConvexSupport(const FCapsuleShape& Capsule)
+		: Shape(&Capsule)
+		, SupportFunction(&ConvexQueriesPrivate::GetCapsuleSupport)
+		, Margin(Capsule.Radius)
+	{ }
+
+
+	FConvexSupport::FConvexSupport(const FOrientedBox& Box)
+		: Shape(&Box)
+		, SupportFunction(&ConvexQueriesPrivate::GetOrientedBoxSupport)
+		, Margin(0.0f)
+	{ }
+
+
+	FConvexSupport::FConvexSupport(const FConvexPointCloud& PointCloud)
+		: Shape(&PointCloud)
+		, SupportFunction(&ConvexQueriesPrivate::GetPointCloudSupport)
+		, Margin(0.0f)
+	{
+		ensure(PointCloud.NumPoints > 0);
+	}
+
+
+	/* FConvexQueries implementation
+	 *****************************************************************************/
+
+	bool FConvexQueries::GJKDistance(const FConvexSupport& A, const FConvexSupport& B, FGJKResult& OutResult, FGJKSimplex* InOutSimplex)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(GJKQuery);
+
+		ConvexQueriesPrivate::FSimplex Simplex;
+		FVector Closest;
+		const bool bCoresApart = ConvexQueriesPrivate::SolveGJK(A, B, ConvexQueriesPrivate::EGJKMode::Distance, InOutSimplex, Simplex, Closest, OutResult.Iterations);
+		INC_MATH_COUNTER_BY(GJKQueryIterations, OutResult.Iterations);
+
+		const FVector CoreA = Simplex.GetPointA();
+		const FVector CoreB = Simplex.GetPointB();
+		const float CoreDistance = bCoresApart ? Closest.Size() : 0.0f;
+		const float Margins = A.Margin + B.Margin;
+
+		if (CoreDistance > Margins)
+		{
+			const FVector Normal = -Closest / CoreDistance;
+			OutResult.Distance = CoreDistance - Margins;
+			OutResult.Normal = Normal;
+			OutResult.PointA = CoreA + Normal * A.Margin;
+			OutResult.PointB = CoreB - Normal * B.Margin;
+			return true;
+		}
+
+		// Report a point common to both shapes, the middle of where they overlap along the line between the cores.
+		FVector Common = CoreA;
+		if (CoreDistance > 0.0f)
+		{
+			const float OverlapStart = FMath::Max(-A.Margin, CoreDistance - B.Margin);
+			const float OverlapEnd = FMath::Min(A.Margin, CoreDistance + B.Margin);
+			Common = CoreA - Closest * ((OverlapStart + OverlapEnd) * 0.5f / CoreDistance);
+		}
+
+		OutResult.Distance = 0.0f;
+		OutResult.Normal = FVector::ZeroVector;
+		OutResult.PointA = Common;
+		OutResult.PointB = Common;
+		return false;
+	}
+
+
+	bool FConvexQueries::GJKIntersect(const FConvexSupport& A, const FConvexSupport& B, FGJKSimplex* InOutSimplex)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(GJKQuery);
+
+		ConvexQueriesPrivate::FSimplex Simplex;
+		FVector Closest;
+		int32 Iterations;
+		const bool bSeparated = ConvexQueriesPrivate::SolveGJK(A, B, ConvexQueriesPrivate::EGJKMode::Intersect, InOutSimplex, Simplex, Closest, Iterations);
+		INC_MATH_COUNTER_BY(GJKQueryIterations, Iterations);
+
+		return !bSeparated;
+	}
+
+
+	bool FConvexQueries::EPAPenetration(const FConvexSupport& A, const FConvexSupport& B, FPenetrationResult& OutResult, FGJKSimplex* InOutSimplex)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(EPAQuery);
+
+		ConvexQueriesPrivate::FSimplex Simplex;
+		FVector Closest;
+		int32 Iterations;
+		const bool bCoresApart = ConvexQueriesPrivate::SolveGJK(A, B, ConvexQueriesPrivate::EGJKMode::Distance, InOutSimplex, Simplex, Closest, Iterations);
+		INC_MATH_COUNTER_BY(GJKQueryIterations, Iterations);
+
+		if (bCoresApart)
+		{
+			// Only the margins overlap, the cores' closest points give the answer without EPA.
+			const float CoreDistance = Closest.Size();
+			const float Margins = A.Margin + B.Margin;
+			if (CoreDistance > Margins)
+			{
+				return false;
+			}
+
+			const FVector Normal = -Closest / CoreDistance;
+			OutResult.Depth = Margins - CoreDistance;
+			OutResult.Normal = Normal;
+			OutResult.PointA = Simplex.GetPointA() + Normal * A.Margin;
+			OutResult.PointB = Simplex.GetPointB() - Normal * B.Margin;
+			return true;
+		}
+
+		// The penetration of the inflated shapes is that of the cores plus the margins, so EPA only ever sees
+		// the cores and spheres and capsules do not need a polytope fitted to their curved surface.
+		ConvexQueriesPrivate::FPolytope Polytope;
+		Polytope.NumVertices = Simplex.Num;
+		for (int32 Index = 0; Index < Simplex.Num; ++Index)
+		{
+			Polytope.Vertices[Index] = Simplex.Vertices[Index];
+		}
+
+		float CoreDepth = 0.0f;
+		FVector Normal = FVector::UpVector;
+		FVector CoreA;
+		FVector CoreB;
+		ConvexQueriesPrivate::FEPAFace Face;
+		if (Polytope.CompleteTetrahedron(A, B, Normal) && Polytope.Expand(A, B, Face, Iterations))
+		{
+			INC_MATH_COUNTER_BY(EPAQueryIterations, Iterations);
+
+			// The face's point nearest the origin, expressed in the face's vertices, gives the deepest points.
+			const ConvexQueriesPrivate::FSupportVertex& V0 = Polytope.Vertices[Face.Vertices[0]];
+			const ConvexQueriesPrivate::FSupportVertex& V1 = Polytope.Vertices[Face.Vertices[1]];
+			const ConvexQueriesPrivate::FSupportVertex& V2 = Polytope.Vertices[Face.Vertices[2]];
+			FVector Bary = FMath::ComputeBaryCentric2D(Face.Normal * Face.Distance, V0.W, V1.W, V2.W);
+			if (Bary.IsZero())
+			{
+				Bary = FVector(1.0f / 3.0f);
+			}
+
+			CoreDepth = FMath::Max(Face.Distance, 0.0f);
+			Normal = Face.Normal;
+			CoreA = V0.A * Bary.X + V1.A * Bary.Y + V2.A * Bary.Z;
+			CoreB = V0.B * Bary.X + V1.B * Bary.Y + V2.B * Bary.Z;
+		}
+		else
+		{
+			// The cores' difference is flat, they touch without overlapping.
+			CoreA = Simplex.GetPointA();
+			CoreB = Simplex.GetPointB();
+		}
+
+		OutResult.Depth = CoreDepth + A.Margin + B.Margin;
+		OutResult.Normal = Normal;
+		OutResult.PointA = CoreA + Normal * A.Margin;
+		OutResult.PointB = CoreB - Normal * B.Margin;
+		return true;
+	}
+}
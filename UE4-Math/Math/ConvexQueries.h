@@ -0,0 +1,207 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+#include "Math/Box.h"
+#include "Math/Sphere.h"
+#include "Math/OrientedBox.h"
+#include "Math/CapsuleShape.h"
+
+namespace UE4Math
+{
+	/** A convex shape given as an array of points, the shape is their convex hull. */
+	struct FConvexPointCloud
+	{
+		/** The points, they do not need to be on the hull. */
+		const FVector* Points;
+
+		/** Number of points, must be at least one. */
+		int32 NumPoints;
+
+	public:
+
+		FConvexPointCloud(const FVector* InPoints, int32 InNumPoints)
+			: Points(InPoints)
+			, NumPoints(InNumPoints)
+		{ }
+	};
+
+
+	/**
+	 * Support mapping of a convex shape, the only thing the GJK and EPA queries know about the shapes they work on.
+	 *
+	 * The support function returns the point of the shape's core furthest along a direction, and the shape is the
+	 * core inflated by Margin. Spheres and capsules are a point and a segment with their radius as margin, which
+	 * keeps GJK from crawling over their curved surface one support point at a time.
+	 *
+	 * The built-in constructors only keep a pointer to the shape, it must outlive the support.
+	 */
+	struct FConvexSupport
+	{
+		/**
+		 * Returns the point of the core furthest along Direction.
+		 *
+		 * @param Shape The shape the support was made with.
+		 * @param Direction The direction, not necessarily normalized and possibly zero.
+		 */
+		typedef FVector (*FSupportFunction)(const void* Shape, const FVector& Direction);
+
+		/** The shape handed back to SupportFunction. */
+		const void* Shape;
+
+		/** The support function of the core. */
+		FSupportFunction SupportFunction;
+
+		/** Radius the core is inflated by. */
+		float Margin;
+
+	public:
+
+		/**
+		 * Creates a support from a user support function.
+		 *
+		 * @param InShape Passed back to InSupportFunction.
+		 * @param InSupportFunction Support function of the core.
+		 * @param InMargin Radius the core is inflated by.
+		 */
+		FConvexSupport(const void* InShape, FSupportFunction InSupportFunction, float InMargin = 0.0f)
+			: Shape(InShape)
+			, SupportFunction(InSupportFunction)
+			, Margin(InMargin)
+		{ }
+
+		explicit FConvexSupport(const FBox& Box);
+		explicit FConvexSupport(const FSphere& Sphere);
+		explicit FConvexSupport(const FCapsuleShape& Capsule);
+		explicit FConvexSupport(const FOrientedBox& Box);
+		explicit FConvexSupport(const FConvexPointCloud& PointCloud);
+
+	public:
+
+		/** @return The point of the core furthest along Direction. */
+		inline FVector GetSupport(const FVector& Direction) const
+		{
+			return SupportFunction(Shape, Direction);
+		}
+
+		/** @return The point of the inflated shape furthest along Direction. */
+		inline FVector GetSupportWithMargin(const FVector& Direction) const
+		{
+			const FVector Point = SupportFunction(Shape, Direction);
+			return Margin > 0.0f ? Point + Direction.GetSafeNormal() * Margin : Point;
+		}
+	};
+
+
+	/**
+	 * The simplex a GJK query ended on, kept as the directions its vertices were found along.
+	 *
+	 * Passing it back to the next query on the same pair of shapes re-evaluates those directions against the
+	 * shapes where they are now. Shapes that moved a little since then end up with a simplex close to the answer,
+	 * and a query on overlapping shapes that are still overlapping often finishes without a single new vertex.
+	 */
+	struct FGJKSimplex
+	{
+		/** Directions the vertices were found along. */
+		FVector Directions[4];
+
+		/** Number of vertices, zero starts the next query from scratch. */
+		int32 NumVertices;
+
+	public:
+
+		FGJKSimplex()
+			: NumVertices(0)
+		{ }
+
+		/** Forgets the simplex, for when the shapes it was found for changed. */
+		inline void Reset()
+		{
+			NumVertices = 0;
+		}
+	};
+
+
+	/** Result of a GJK distance query. */
+	struct FGJKResult
+	{
+		/** Distance between the shapes, zero when they overlap. */
+		float Distance;
+
+		/** The point on the first shape closest to the second. */
+		FVector PointA;
+
+		/** The point on the second shape closest to the first. */
+		FVector PointB;
+
+		/** Unit direction from PointA to PointB, zero when the shapes overlap. */
+		FVector Normal;
+
+		/** Number of support points the query evaluated. */
+		int32 Iterations;
+	};
+
+
+	/** Result of an EPA penetration query. */
+	struct FPenetrationResult
+	{
+		/** How far the second shape must move along Normal to only touch the first. */
+		float Depth;
+
+		/** Unit direction to push the second shape along, away from the first. */
+		FVector Normal;
+
+		/** The point of the first shape deepest inside the second. */
+		FVector PointA;
+
+		/** The point of the second shape deepest inside the first, PointA - PointB = Normal * Depth. */
+		FVector PointB;
+	};
+
+
+	/**
+	 * Distance, overlap and penetration queries between any two convex shapes given by their support mappings.
+	 *
+	 * GJK walks a simplex of the Minkowski difference A - B towards the origin, the simplex sub-solvers are
+	 * FMath::ClosestPointOnTriangleToPoint and FMath::ClosestPointOnTetrahedronToPoint. When the shapes overlap
+	 * EPA grows a polytope from the final simplex until it finds the face of A - B nearest the origin.
+	 */
+	struct FConvexQueries
+	{
+		/**
+		 * Computes the distance between two convex shapes and their closest points.
+		 *
+		 * @param A The first shape.
+		 * @param B The second shape.
+		 * @param OutResult Receives the distance and closest points.
+		 * @param InOutSimplex Optional simplex to start from, receives the simplex the query ended on.
+		 * @return true if the shapes are apart, false if they overlap.
+		 */
+		static bool GJKDistance(const FConvexSupport& A, const FConvexSupport& B, FGJKResult& OutResult, FGJKSimplex* InOutSimplex = nullptr);
+
+		/**
+		 * Tests whether two convex shapes overlap. Cheaper than GJKDistance, it stops at the first separating
+		 * axis it finds or as soon as the shapes are known to be within their margins.
+		 *
+		 * @param A The first shape.
+		 * @param B The second shape.
+		 * @param InOutSimplex Optional simplex to start from, receives the simplex the query ended on.
+		 * @return true if the shapes overlap or touch.
+		 */
+		static bool GJKIntersect(const FConvexSupport& A, const FConvexSupport& B, FGJKSimplex* InOutSimplex = nullptr);
+
+		/**
+		 * Computes how deep two convex shapes overlap. When only the margins overlap the depth comes straight from
+		 * GJK, EPA only runs when the cores themselves overlap.
+		 *
+		 * @param A The first shape.
+		 * @param B The second shape.
+		 * @param OutResult Receives the penetration depth, direction and deepest points.
+		 * @param InOutSimplex Optional simplex to start from, receives the simplex GJK ended on.
+		 * @return true if the shapes overlap, OutResult is only written in that case.
+		 */
+		static bool EPAPenetration(const FConvexSupport& A, const FConvexSupport& B, FPenetrationResult& OutResult, FGJKSimplex* InOutSimplex = nullptr);
+	};
+}
@@ -45,7 +45,7 @@ namespace UE4Math
 		 * @param InX The x-coordinate.
 		 * @param InY The y-coordinate.
 		 */
-		FIntPoint(int32_t InX, int32_t InY);
+		constexpr FIntPoint(int32_t InX, int32_t InY);
 
 		/**
 		 * Create and initialize a new instance to zero.
@@ -285,12 +285,16 @@ namespace UE4Math
 	inline FIntPoint::FIntPoint() { }
 
 
-	inline FIntPoint::FIntPoint(int32_t InX, int32_t InY)
+	constexpr FIntPoint::FIntPoint(int32_t InX, int32_t InY)
 		: X(InX)
 		, Y(InY)
 	{ }
 
 
+	inline constexpr FIntPoint FIntPoint::ZeroValue(0, 0);
+	inline constexpr FIntPoint FIntPoint::NoneValue(INDEX_NONE, INDEX_NONE);
+
+
 	inline FIntPoint::FIntPoint(EForceInit)
 		: X(0)
 		, Y(0)
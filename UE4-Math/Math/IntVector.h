@@ -46,7 +46,7 @@ namespace UE4Math
 		 * @param InY The y-coordinate.
 		 * @param InZ The z-coordinate.
 		 */
-		FIntVector(int32 InX, int32 InY, int32 InZ);
+		constexpr FIntVector(int32 InX, int32 InY, int32 InZ);
 
 		/**
 		 * Constructor
@@ -296,13 +296,17 @@ namespace UE4Math
 	{ }
 
 
-	inline FIntVector::FIntVector(int32 InX, int32 InY, int32 InZ)
+	constexpr FIntVector::FIntVector(int32 InX, int32 InY, int32 InZ)
 		: X(InX)
 		, Y(InY)
 		, Z(InZ)
 	{ }
 
 
+	inline constexpr FIntVector FIntVector::ZeroValue(0, 0, 0);
+	inline constexpr FIntVector FIntVector::NoneValue(INDEX_NONE, INDEX_NONE, INDEX_NONE);
+
+
 	inline FIntVector::FIntVector(int32 InValue)
 		: X(InValue)
 		, Y(InValue)
@@ -0,0 +1,148 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	LargeWorldCoordinates.cpp: Batch conversions between float and double math types
+=============================================================================*/
+
+#include "Math/LargeWorldCoordinates.h"
+
+#if PLATFORM_ALWAYS_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace UE4Math
+{
+	namespace LargeWorldCoordinatesPrivate
+	{
+		static_assert(sizeof(FVector3d) == 3 * sizeof(double), "FVector3d must be tightly packed doubles.");
+		static_assert(sizeof(FMatrix44d) == 16 * sizeof(double), "FMatrix44d must be tightly packed doubles.");
+		static_assert(sizeof(FQuat4d) == 4 * sizeof(double), "FQuat4d must be tightly packed doubles.");
+		static_assert(sizeof(FVector3f) == 3 * sizeof(float), "FVector3f must be tightly packed floats.");
+		static_assert(sizeof(FMatrix44f) == 16 * sizeof(float), "FMatrix44f must be tightly packed floats.");
+		static_assert(sizeof(FQuat4f) == 4 * sizeof(float), "FQuat4f must be tightly packed floats.");
+
+		void NarrowDoubles(const double* In, float* Out, int64 Num)
+		{
+			int64 Index = 0;
+#if PLATFORM_ALWAYS_HAS_AVX2
+			for (; Index + 8 <= Num; Index += 8)
+			{
+				_mm_storeu_ps(Out + Index + 0, _mm256_cvtpd_ps(_mm256_loadu_pd(In + Index + 0)));
+				_mm_storeu_ps(Out + Index + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(In + Index + 4)));
+			}
+#endif
+			for (; Index < Num; ++Index)
+			{
+				Out[Index] = (float)In[Index];
+			}
+		}
+
+		void WidenFloats(const float* In, double* Out, int64 Num)
+		{
+			int64 Index = 0;
+#if PLATFORM_ALWAYS_HAS_AVX2
+			for (; Index + 8 <= Num; Index += 8)
+			{
+				_mm256_storeu_pd(Out + Index + 0, _mm256_cvtps_pd(_mm_loadu_ps(In + Index + 0)));
+				_mm256_storeu_pd(Out + Index + 4, _mm256_cvtps_pd(_mm_loadu_ps(In + Index + 4)));
+			}
+#endif
+			for (; Index < Num; ++Index)
+			{
+				Out[Index] = (double)In[Index];
+			}
+		}
+
+		/**
+		 * Out = In - Origin over packed XYZ triples.
+		 * Four vectors are twelve components, three registers, so the origin repeats with a period of three registers.
+		 */
+		void NarrowRelative(const double* In, const FVector3d& Origin, float* Out, int32 Count)
+		{
+			int32 Index = 0;
+#if PLATFORM_ALWAYS_HAS_AVX2
+			const __m256d O0 = _mm256_setr_pd(Origin.X, Origin.Y, Origin.Z, Origin.X);
+			const __m256d O1 = _mm256_setr_pd(Origin.Y, Origin.Z, Origin.X, Origin.Y);
+			const __m256d O2 = _mm256_setr_pd(Origin.Z, Origin.X, Origin.Y, Origin.Z);
+			for (; Index + 4 <= Count; Index += 4)
+			{
+				const double* Src = In + Index * 3;
+				float* Dst = Out + Index * 3;
+				_mm_storeu_ps(Dst + 0, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(Src + 0), O0)));
+				_mm_storeu_ps(Dst + 4, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(Src + 4), O1)));
+				_mm_storeu_ps(Dst + 8, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(Src + 8), O2)));
+			}
+#endif
+			for (; Index < Count; ++Index)
+			{
+				Out[Index * 3 + 0] = (float)(In[Index * 3 + 0] - Origin.X);
+				Out[Index * 3 + 1] = (float)(In[Index * 3 + 1] - Origin.Y);
+				Out[Index * 3 + 2] = (float)(In[Index * 3 + 2] - Origin.Z);
+			}
+		}
+
+		void WidenRelative(const float* In, const FVector3d& Origin, double* Out, int32 Count)
+		{
+			int32 Index = 0;
+#if PLATFORM_ALWAYS_HAS_AVX2
+			const __m256d O0 = _mm256_setr_pd(Origin.X, Origin.Y, Origin.Z, Origin.X);
+			const __m256d O1 = _mm256_setr_pd(Origin.Y, Origin.Z, Origin.X, Origin.Y);
+			const __m256d O2 = _mm256_setr_pd(Origin.Z, Origin.X, Origin.Y, Origin.Z);
+			for (; Index + 4 <= Count; Index += 4)
+			{
+				const float* Src = In + Index * 3;
+				double* Dst = Out + Index * 3;
+				_mm256_storeu_pd(Dst + 0, _mm256_add_pd(_mm256_cvtps_pd(_mm_loadu_ps(Src + 0)), O0));
+				_mm256_storeu_pd(Dst + 4, _mm256_add_pd(_mm256_cvtps_pd(_mm_loadu_ps(Src + 4)), O1));
+				_mm256_storeu_pd(Dst + 8, _mm256_add_pd(_mm256_cvtps_pd(_mm_loadu_ps(Src + 8)), O2));
+			}
+#endif
+			for (; Index < Count; ++Index)
+			{
+				Out[Index * 3 + 0] = (double)In[Index * 3 + 0] + Origin.X;
+				Out[Index * 3 + 1] = (double)In[Index * 3 + 1] + Origin.Y;
+				Out[Index * 3 + 2] = (double)In[Index * 3 + 2] + Origin.Z;
+			}
+		}
+	}
+
+	void FLargeWorldCoordinates::Narrow(const FVector3d* In, FVector3f* Out, int32 Count)
+	{
+		LargeWorldCoordinatesPrivate::NarrowDoubles(&In->X, &Out->X, (int64)Count * 3);
+	}
+
+	void FLargeWorldCoordinates::Narrow(const FMatrix44d* In, FMatrix44f* Out, int32 Count)
+	{
+		LargeWorldCoordinatesPrivate::NarrowDoubles(&In->M[0][0], &Out->M[0][0], (int64)Count * 16);
+	}
+
+	void FLargeWorldCoordinates::Narrow(const FQuat4d* In, FQuat4f* Out, int32 Count)
+	{
+		LargeWorldCoordinatesPrivate::NarrowDoubles(&In->X, &Out->X, (int64)Count * 4);
+	}
+
+	void FLargeWorldCoordinates::Widen(const FVector3f* In, FVector3d* Out, int32 Count)
+	{
+		LargeWorldCoordinatesPrivate::WidenFloats(&In->X, &Out->X, (int64)Count * 3);
+	}
+
+	void FLargeWorldCoordinates::Widen(const FMatrix44f* In, FMatrix44d* Out, int32 Count)
+	{
+		LargeWorldCoordinatesPrivate::WidenFloats(&In->M[0][0], &Out->M[0][0], (int64)Count * 16);
+	}
+
+	void FLargeWorldCoordinates::Widen(const FQuat4f* In, FQuat4d* Out, int32 Count)
+	{
+		LargeWorldCoordinatesPrivate::WidenFloats(&In->X, &Out->X, (int64)Count * 4);
+	}
+
+	void FLargeWorldCoordinates::NarrowRelative(const FVector3d* In, const FVector3d& Origin, FVector3f* Out, int32 Count)
+	{
+		LargeWorldCoordinatesPrivate::NarrowRelative(&In->X, Origin, &Out->X, Count);
+	}
+
+	void FLargeWorldCoordinates::WidenRelative(const FVector3f* In, const FVector3d& Origin, FVector3d* Out, int32 Count)
+	{
+		LargeWorldCoordinatesPrivate::WidenRelative(&In->X, Origin, &Out->X, Count);
+	}
+}
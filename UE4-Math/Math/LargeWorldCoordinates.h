@@ -0,0 +1,896 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+#include "Math/MathFwd.h"
+#include "Math/UnrealMathUtility.h"
+#include "Math/UnrealMathDouble.h"
+#include "Math/Axis.h"
+#include "Math/Vector.h"
+#include "Math/Matrix.h"
+#include "Math/Quat.h"
+#include "Misc/StringBuilder.h"
+
+/*=============================================================================
+	LargeWorldCoordinates.h: Double precision vectors, matrices and quaternions
+
+	Float positions lose centimetre precision roughly 100 km from the origin
+	and visibly jitter well before that. FVector3d, FMatrix44d and FQuat4d keep
+	world space data in double precision. The usual pattern is to keep world
+	positions in double and to narrow them relative to a nearby origin (e.g.
+	the camera) before handing them to float code, see
+	FLargeWorldCoordinates::NarrowRelative.
+
+	The float types are explicit specializations of the same templates, so
+	generic code can be written against TVector<T>, TMatrix<T> and TQuat<T>
+	using the functions both provide. Conversions between the precisions are
+	always explicit.
+=============================================================================*/
+
+namespace UE4Math
+{
+	/**
+	 * A vector in 3-D space composed of components (X, Y, Z), generic over the component type.
+	 * FVector (float) is a specialization with the complete API, see Vector.h.
+	 */
+	template<typename T>
+	struct TVector
+	{
+		static_assert(std::is_floating_point<T>::value, "TVector only supports floating point components.");
+
+	public:
+
+		/** Vector's X component. */
+		T X;
+
+		/** Vector's Y component. */
+		T Y;
+
+		/** Vector's Z component. */
+		T Z;
+
+	public:
+
+		/** A zero vector (0,0,0) */
+		static const TVector<T> ZeroVector;
+
+		/** One vector (1,1,1) */
+		static const TVector<T> OneVector;
+
+		/** Unreal up vector (0,0,1) */
+		static const TVector<T> UpVector;
+
+		/** Unreal forward vector (1,0,0) */
+		static const TVector<T> ForwardVector;
+
+		/** Unreal right vector (0,1,0) */
+		static const TVector<T> RightVector;
+
+	public:
+
+		/** Default constructor (no initialization). */
+		inline TVector() { }
+
+		/** Constructor initializing all components to a single value. */
+		explicit constexpr TVector(T InF) : X(InF), Y(InF), Z(InF) { }
+
+		/** Constructor using initial values for each component. */
+		constexpr TVector(T InX, T InY, T InZ) : X(InX), Y(InY), Z(InZ) { }
+
+		/** Constructor which initializes all components to zero. */
+		explicit constexpr TVector(EForceInit) : X(0), Y(0), Z(0) { }
+
+		/** Converts from another precision. Narrowing rounds each component to nearest. */
+		template<typename FArg>
+		explicit inline TVector(const TVector<FArg>& V) : X((T)V.X), Y((T)V.Y), Z((T)V.Z) { }
+
+	public:
+
+		inline TVector<T> operator^(const TVector<T>& V) const { return CrossProduct(*this, V); }
+		inline T operator|(const TVector<T>& V) const { return DotProduct(*this, V); }
+
+		inline TVector<T> operator+(const TVector<T>& V) const { return TVector<T>(X + V.X, Y + V.Y, Z + V.Z); }
+		inline TVector<T> operator-(const TVector<T>& V) const { return TVector<T>(X - V.X, Y - V.Y, Z - V.Z); }
+		inline TVector<T> operator*(const TVector<T>& V) const { return TVector<T>(X * V.X, Y * V.Y, Z * V.Z); }
+		inline TVector<T> operator/(const TVector<T>& V) const { return TVector<T>(X / V.X, Y / V.Y, Z / V.Z); }
+		inline TVector<T> operator*(T Scale) const { return TVector<T>(X * Scale, Y * Scale, Z * Scale); }
+		inline TVector<T> operator/(T Scale) const { const T RScale = T(1) / Scale; return TVector<T>(X * RScale, Y * RScale, Z * RScale); }
+		inline TVector<T> operator-() const { return TVector<T>(-X, -Y, -Z); }
+
+		inline TVector<T>& operator+=(const TVector<T>& V) { X += V.X; Y += V.Y; Z += V.Z; return *this; }
+		inline TVector<T>& operator-=(const TVector<T>& V) { X -= V.X; Y -= V.Y; Z -= V.Z; return *this; }
+		inline TVector<T>& operator*=(const TVector<T>& V) { X *= V.X; Y *= V.Y; Z *= V.Z; return *this; }
+		inline TVector<T>& operator*=(T Scale) { X *= Scale; Y *= Scale; Z *= Scale; return *this; }
+		inline TVector<T>& operator/=(T Scale) { const T RScale = T(1) / Scale; X *= RScale; Y *= RScale; Z *= RScale; return *this; }
+
+		inline bool operator==(const TVector<T>& V) const { return X == V.X && Y == V.Y && Z == V.Z; }
+		inline bool operator!=(const TVector<T>& V) const { return X != V.X || Y != V.Y || Z != V.Z; }
+
+		inline T& operator[](int32 Index) { ensure(Index >= 0 && Index < 3); return (&X)[Index]; }
+		inline T operator[](int32 Index) const { ensure(Index >= 0 && Index < 3); return (&X)[Index]; }
+
+		/** Check against another vector for equality, within specified error limits. */
+		inline bool Equals(const TVector<T>& V, T Tolerance = T(KINDA_SMALL_NUMBER)) const
+		{
+			return std::abs(X - V.X) <= Tolerance && std::abs(Y - V.Y) <= Tolerance && std::abs(Z - V.Z) <= Tolerance;
+		}
+
+		static inline TVector<T> CrossProduct(const TVector<T>& A, const TVector<T>& B)
+		{
+			return TVector<T>(A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X);
+		}
+
+		static inline T DotProduct(const TVector<T>& A, const TVector<T>& B)
+		{
+			return A.X * B.X + A.Y * B.Y + A.Z * B.Z;
+		}
+
+		static inline T DistSquared(const TVector<T>& V1, const TVector<T>& V2) { return (V2 - V1).SizeSquared(); }
+		static inline T Dist(const TVector<T>& V1, const TVector<T>& V2) { return (V2 - V1).Size(); }
+
+		inline T Size() const { return std::sqrt(X * X + Y * Y + Z * Z); }
+		inline T SizeSquared() const { return X * X + Y * Y + Z * Z; }
+		inline T Size2D() const { return std::sqrt(X * X + Y * Y); }
+		inline T SizeSquared2D() const { return X * X + Y * Y; }
+
+		inline T GetMax() const { return FMath::Max(FMath::Max(X, Y), Z); }
+		inline T GetMin() const { return FMath::Min(FMath::Min(X, Y), Z); }
+		inline TVector<T> GetAbs() const { return TVector<T>(std::abs(X), std::abs(Y), std::abs(Z)); }
+
+		/** Checks whether all components are within Tolerance of zero. */
+		inline bool IsNearlyZero(T Tolerance = T(KINDA_SMALL_NUMBER)) const
+		{
+			return std::abs(X) <= Tolerance && std::abs(Y) <= Tolerance && std::abs(Z) <= Tolerance;
+		}
+
+		inline bool IsZero() const { return X == 0 && Y == 0 && Z == 0; }
+
+		/**
+		 * Normalize this vector in-place if it is larger than a given tolerance. Leaves it unchanged if not.
+		 *
+		 * @return true if the vector was normalized correctly, false otherwise.
+		 */
+		inline bool Normalize(T Tolerance = T(SMALL_NUMBER))
+		{
+			const T SquareSum = SizeSquared();
+			if (SquareSum > Tolerance)
+			{
+				*this *= T(1) / std::sqrt(SquareSum);
+				return true;
+			}
+			return false;
+		}
+
+		/** @return A normalized copy, or a zero vector if the vector is too small to normalize safely. */
+		inline TVector<T> GetSafeNormal(T Tolerance = T(SMALL_NUMBER)) const
+		{
+			const T SquareSum = SizeSquared();
+			if (SquareSum == T(1))
+			{
+				return *this;
+			}
+			if (SquareSum < Tolerance)
+			{
+				return ZeroVector;
+			}
+			return *this * (T(1) / std::sqrt(SquareSum));
+		}
+
+		inline bool ContainsNaN() const
+		{
+			return !std::isfinite(X) || !std::isfinite(Y) || !std::isfinite(Z);
+		}
+
+		inline std::string ToString() const
+		{
+			TStringBuilder<96> Builder;
+			AppendString(Builder);
+			return Builder.ToString();
+		}
+
+		inline void AppendString(FStringBuilderBase& Out) const
+		{
+			Out << "X=" << X << " Y=" << Y << " Z=" << Z;
+		}
+	};
+
+	template<typename T> inline constexpr TVector<T> TVector<T>::ZeroVector(0, 0, 0);
+	template<typename T> inline constexpr TVector<T> TVector<T>::OneVector(1, 1, 1);
+	template<typename T> inline constexpr TVector<T> TVector<T>::UpVector(0, 0, 1);
+	template<typename T> inline constexpr TVector<T> TVector<T>::ForwardVector(1, 0, 0);
+	template<typename T> inline constexpr TVector<T> TVector<T>::RightVector(0, 1, 0);
+
+	template<typename T>
+	inline TVector<T> operator*(T Scale, const TVector<T>& V)
+	{
+		return V * Scale;
+	}
+
+
+	/**
+	 * 4x4 matrix, generic over the element type, with the same conventions as FMatrix:
+	 * row vectors, Res = Mat1 * Mat2 applies Mat1 first, elements are accessed with M[RowIndex][ColumnIndex].
+	 * FMatrix (float) is a specialization with the complete API, see Matrix.h.
+	 */
+	template<typename T>
+	struct TMatrix
+	{
+		static_assert(std::is_floating_point<T>::value, "TMatrix only supports floating point elements.");
+
+	public:
+
+		T M[4][4];
+
+		static const TMatrix<T> Identity;
+
+		/** Default constructor (no initialization). */
+		inline TMatrix() { }
+
+		/** Constructor which initializes all elements to zero. */
+		explicit inline TMatrix(EForceInit)
+		{
+			for (int32 Row = 0; Row < 4; ++Row)
+			{
+				M[Row][0] = 0; M[Row][1] = 0; M[Row][2] = 0; M[Row][3] = 0;
+			}
+		}
+
+		/** Constructor from the axes and origin, the last column is set to (0,0,0,1). */
+		constexpr TMatrix(const TVector<T>& InX, const TVector<T>& InY, const TVector<T>& InZ, const TVector<T>& InW)
+			: M{
+				{ InX.X, InX.Y, InX.Z, 0 },
+				{ InY.X, InY.Y, InY.Z, 0 },
+				{ InZ.X, InZ.Y, InZ.Z, 0 },
+				{ InW.X, InW.Y, InW.Z, 1 } }
+		{
+		}
+
+		/** Converts from another precision. Narrowing rounds each element to nearest. */
+		template<typename FArg>
+		explicit inline TMatrix(const TMatrix<FArg>& Other)
+		{
+			for (int32 Row = 0; Row < 4; ++Row)
+			{
+				for (int32 Column = 0; Column < 4; ++Column)
+				{
+					M[Row][Column] = (T)Other.M[Row][Column];
+				}
+			}
+		}
+
+		inline void SetIdentity() { *this = Identity; }
+
+		/** Gets the result of multiplying a Matrix to this. */
+		inline TMatrix<T> operator*(const TMatrix<T>& Other) const;
+		inline void operator*=(const TMatrix<T>& Other);
+		inline TMatrix<T> operator+(const TMatrix<T>& Other) const;
+		inline void operator+=(const TMatrix<T>& Other);
+
+		/** Multiplies every element, this is weighting rather than scaling. */
+		inline TMatrix<T> operator*(T Other) const;
+
+		inline bool operator==(const TMatrix<T>& Other) const;
+		inline bool operator!=(const TMatrix<T>& Other) const { return !(*this == Other); }
+
+		/** Checks whether another matrix is equal within specified tolerance. */
+		inline bool Equals(const TMatrix<T>& Other, T Tolerance = T(KINDA_SMALL_NUMBER)) const;
+
+		/** Transform a location, with translation. */
+		inline TVector<T> TransformPosition(const TVector<T>& V) const;
+
+		/** Transform a direction vector, without translation. */
+		inline TVector<T> TransformVector(const TVector<T>& V) const;
+
+		inline TMatrix<T> GetTransposed() const;
+
+		inline T Determinant() const;
+
+		/** @return The inverse, or Identity if the matrix has no scale or is singular, like FMatrix::Inverse. */
+		inline TMatrix<T> Inverse() const;
+
+		inline TVector<T> GetOrigin() const { return TVector<T>(M[3][0], M[3][1], M[3][2]); }
+		inline void SetOrigin(const TVector<T>& NewOrigin) { M[3][0] = NewOrigin.X; M[3][1] = NewOrigin.Y; M[3][2] = NewOrigin.Z; }
+
+		/** Returns a matrix with an additional translation concatenated. */
+		inline TMatrix<T> ConcatTranslation(const TVector<T>& Translation) const
+		{
+			TMatrix<T> Result(*this);
+			Result.SetOrigin(GetOrigin() + Translation);
+			return Result;
+		}
+
+		/** Get axis of this matrix scaled by the scale of the matrix. */
+		inline TVector<T> GetScaledAxis(EAxis::Type Axis) const;
+
+		/** Transform a rotation matrix into a quaternion. The rotation part must be unit length. */
+		inline TQuat<T> ToQuat() const;
+
+		inline bool ContainsNaN() const;
+
+		inline std::string ToString() const
+		{
+			TStringBuilder<512> Builder;
+			AppendString(Builder);
+			return Builder.ToString();
+		}
+
+		inline void AppendString(FStringBuilderBase& Out) const
+		{
+			for (int32 Row = 0; Row < 4; ++Row)
+			{
+				Out << "[" << M[Row][0] << " " << M[Row][1] << " " << M[Row][2] << " " << M[Row][3] << "]";
+			}
+		}
+	};
+
+	template<typename T> inline constexpr TMatrix<T> TMatrix<T>::Identity(TVector<T>(1, 0, 0), TVector<T>(0, 1, 0), TVector<T>(0, 0, 1), TVector<T>(0, 0, 0));
+
+
+	/**
+	 * Quaternion, generic over the component type, with the same conventions as FQuat:
+	 * C = A * B first applies B then A.
+	 * FQuat (float) is a specialization with the complete API, see Quat.h.
+	 */
+	template<typename T>
+	struct TQuat
+	{
+		static_assert(std::is_floating_point<T>::value, "TQuat only supports floating point components.");
+
+	public:
+
+		T X;
+		T Y;
+		T Z;
+		T W;
+
+		/** Identity quaternion. */
+		static const TQuat<T> Identity;
+
+		/** Default constructor (no initialization). */
+		inline TQuat() { }
+
+		/** Creates a quaternion with the W component either 0 or 1 (identity). */
+		explicit inline TQuat(EForceInit ZeroOrNot) : X(0), Y(0), Z(0), W(ZeroOrNot == ForceInitToZero ? T(0) : T(1)) { }
+
+		constexpr TQuat(T InX, T InY, T InZ, T InW) : X(InX), Y(InY), Z(InZ), W(InW) { }
+
+		/**
+		 * Creates a quaternion from a rotation around an axis.
+		 *
+		 * @param Axis assumed to be a normalized vector
+		 * @param AngleRad angle to rotate about the given axis (in radians)
+		 */
+		inline TQuat(const TVector<T>& Axis, T AngleRad)
+		{
+			const T HalfA = T(0.5) * AngleRad;
+			const T S = std::sin(HalfA);
+			X = S * Axis.X;
+			Y = S * Axis.Y;
+			Z = S * Axis.Z;
+			W = std::cos(HalfA);
+		}
+
+		/** Creates a quaternion from a rotation matrix, see TMatrix::ToQuat. */
+		explicit inline TQuat(const TMatrix<T>& M) { *this = M.ToQuat(); }
+
+		/** Converts from another precision. Narrowing rounds each component to nearest. */
+		template<typename FArg>
+		explicit inline TQuat(const TQuat<FArg>& Q) : X((T)Q.X), Y((T)Q.Y), Z((T)Q.Z), W((T)Q.W) { }
+
+		inline TQuat<T> operator+(const TQuat<T>& Q) const { return TQuat<T>(X + Q.X, Y + Q.Y, Z + Q.Z, W + Q.W); }
+		inline TQuat<T> operator-(const TQuat<T>& Q) const { return TQuat<T>(X - Q.X, Y - Q.Y, Z - Q.Z, W - Q.W); }
+		inline TQuat<T> operator*(T Scale) const { return TQuat<T>(X * Scale, Y * Scale, Z * Scale, W * Scale); }
+
+		/** Gets the result of multiplying this by another quaternion (this * Q), which first applies Q then this. */
+		inline TQuat<T> operator*(const TQuat<T>& Q) const
+		{
+			return TQuat<T>(
+				W * Q.X + X * Q.W + Y * Q.Z - Z * Q.Y,
+				W * Q.Y - X * Q.Z + Y * Q.W + Z * Q.X,
+				W * Q.Z + X * Q.Y - Y * Q.X + Z * Q.W,
+				W * Q.W - X * Q.X - Y * Q.Y - Z * Q.Z);
+		}
+
+		inline TQuat<T>& operator*=(const TQuat<T>& Q) { *this = *this * Q; return *this; }
+
+		/** Rotate a vector by this quaternion, same as RotateVector. */
+		inline TVector<T> operator*(const TVector<T>& V) const { return RotateVector(V); }
+
+		/** @return Dot product of the two quaternions. */
+		inline T operator|(const TQuat<T>& Q) const { return X * Q.X + Y * Q.Y + Z * Q.Z + W * Q.W; }
+
+		inline bool operator==(const TQuat<T>& Q) const { return X == Q.X && Y == Q.Y && Z == Q.Z && W == Q.W; }
+		inline bool operator!=(const TQuat<T>& Q) const { return !(*this == Q); }
+
+		/** Checks whether another quaternion represents the same rotation within a tolerance, q and -q included. */
+		inline bool Equals(const TQuat<T>& Q, T Tolerance = T(KINDA_SMALL_NUMBER)) const
+		{
+			return (std::abs(X - Q.X) <= Tolerance && std::abs(Y - Q.Y) <= Tolerance && std::abs(Z - Q.Z) <= Tolerance && std::abs(W - Q.W) <= Tolerance)
+				|| (std::abs(X + Q.X) <= Tolerance && std::abs(Y + Q.Y) <= Tolerance && std::abs(Z + Q.Z) <= Tolerance && std::abs(W + Q.W) <= Tolerance);
+		}
+
+		inline bool IsIdentity(T Tolerance = T(SMALL_NUMBER)) const { return Equals(Identity, Tolerance); }
+
+		inline T SizeSquared() const { return X * X + Y * Y + Z * Z + W * W; }
+		inline T Size() const { return std::sqrt(SizeSquared()); }
+
+		inline bool IsNormalized() const { return std::abs(T(1) - SizeSquared()) < T(THRESH_QUAT_NORMALIZED); }
+
+		/** Normalize this quaternion if it is large enough, otherwise set it to identity. */
+		inline void Normalize(T Tolerance = T(SMALL_NUMBER))
+		{
+			const T SquareSum = SizeSquared();
+			if (SquareSum >= Tolerance)
+			{
+				*this = *this * (T(1) / std::sqrt(SquareSum));
+			}
+			else
+			{
+				*this = Identity;
+			}
+		}
+
+		inline TQuat<T> GetNormalized(T Tolerance = T(SMALL_NUMBER)) const
+		{
+			TQuat<T> Result(*this);
+			Result.Normalize(Tolerance);
+			return Result;
+		}
+
+		/** @return Inverse of this quaternion, which must be normalized. */
+		inline TQuat<T> Inverse() const { return TQuat<T>(-X, -Y, -Z, W); }
+
+		/** Rotate a vector by this quaternion. */
+		inline TVector<T> RotateVector(const TVector<T>& V) const
+		{
+			// V' = V + w*(2(Q x V)) + (Q x (2(Q x V))), see FQuat::RotateVector
+			const TVector<T> Q(X, Y, Z);
+			const TVector<T> TT = TVector<T>::CrossProduct(Q, V) * T(2);
+			return V + TT * W + TVector<T>::CrossProduct(Q, TT);
+		}
+
+		/** Rotate a vector by the inverse of this quaternion. */
+		inline TVector<T> UnrotateVector(const TVector<T>& V) const
+		{
+			const TVector<T> Q(-X, -Y, -Z);
+			const TVector<T> TT = TVector<T>::CrossProduct(Q, V) * T(2);
+			return V + TT * W + TVector<T>::CrossProduct(Q, TT);
+		}
+
+		/** @return The rotation matrix of this quaternion, with zero translation. Same as FQuatRotationTranslationMatrix. */
+		inline TMatrix<T> ToMatrix() const;
+
+		/** Spherical interpolation along the shortest path, without normalizing the result. */
+		static inline TQuat<T> Slerp_NotNormalized(const TQuat<T>& Quat1, const TQuat<T>& Quat2, T Slerp)
+		{
+			const T RawCosom = Quat1 | Quat2;
+			const T Cosom = RawCosom >= 0 ? RawCosom : -RawCosom;
+
+			T Scale0, Scale1;
+			if (Cosom < T(0.9999))
+			{
+				const T Omega = std::acos(Cosom);
+				const T InvSin = T(1) / std::sin(Omega);
+				Scale0 = std::sin((T(1) - Slerp) * Omega) * InvSin;
+				Scale1 = std::sin(Slerp * Omega) * InvSin;
+			}
+			else
+			{
+				// Use linear interpolation.
+				Scale0 = T(1) - Slerp;
+				Scale1 = Slerp;
+			}
+
+			// In keeping with our flipped Cosom:
+			Scale1 = RawCosom >= 0 ? Scale1 : -Scale1;
+			return Quat1 * Scale0 + Quat2 * Scale1;
+		}
+
+		static inline TQuat<T> Slerp(const TQuat<T>& Quat1, const TQuat<T>& Quat2, T Slerp)
+		{
+			return Slerp_NotNormalized(Quat1, Quat2, Slerp).GetNormalized();
+		}
+
+		inline bool ContainsNaN() const
+		{
+			return !std::isfinite(X) || !std::isfinite(Y) || !std::isfinite(Z) || !std::isfinite(W);
+		}
+
+		inline std::string ToString() const
+		{
+			TStringBuilder<128> Builder;
+			AppendString(Builder);
+			return Builder.ToString();
+		}
+
+		inline void AppendString(FStringBuilderBase& Out) const
+		{
+			Out << "X=" << X << " Y=" << Y << " Z=" << Z << " W=" << W;
+		}
+	};
+
+	template<typename T> inline constexpr TQuat<T> TQuat<T>::Identity(0, 0, 0, 1);
+
+
+	namespace LargeWorldCoordinatesPrivate
+	{
+		template<typename T>
+		inline void MatrixMultiply(TMatrix<T>& Result, const TMatrix<T>& A, const TMatrix<T>& B)
+		{
+			TMatrix<T> Tmp;
+			for (int32 Row = 0; Row < 4; ++Row)
+			{
+				for (int32 Column = 0; Column < 4; ++Column)
+				{
+					Tmp.M[Row][Column] = A.M[Row][0] * B.M[0][Column] + A.M[Row][1] * B.M[1][Column] + A.M[Row][2] * B.M[2][Column] + A.M[Row][3] * B.M[3][Column];
+				}
+			}
+			Result = Tmp;
+		}
+
+		inline void MatrixMultiply(TMatrix<double>& Result, const TMatrix<double>& A, const TMatrix<double>& B)
+		{
+			VectorMatrixMultiplyDouble(&Result, &A, &B);
+		}
+
+		/** (V, W) * M, returning XYZ. */
+		template<typename T>
+		inline TVector<T> TransformVector4(const TMatrix<T>& M, const TVector<T>& V, T W)
+		{
+			return TVector<T>(
+				V.X * M.M[0][0] + V.Y * M.M[1][0] + V.Z * M.M[2][0] + W * M.M[3][0],
+				V.X * M.M[0][1] + V.Y * M.M[1][1] + V.Z * M.M[2][1] + W * M.M[3][1],
+				V.X * M.M[0][2] + V.Y * M.M[1][2] + V.Z * M.M[2][2] + W * M.M[3][2]);
+		}
+
+		inline TVector<double> TransformVector4(const TMatrix<double>& M, const TVector<double>& V, double W)
+		{
+			TVector<double> Result;
+			VectorStoreDouble3(VectorTransformVectorDouble(VectorLoadDouble3(&V.X, W), &M), &Result.X);
+			return Result;
+		}
+	}
+
+	/* TMatrix inline functions
+	 *****************************************************************************/
+
+	template<typename T>
+	inline TMatrix<T> TMatrix<T>::operator*(const TMatrix<T>& Other) const
+	{
+		TMatrix<T> Result;
+		LargeWorldCoordinatesPrivate::MatrixMultiply(Result, *this, Other);
+		return Result;
+	}
+
+	template<typename T>
+	inline void TMatrix<T>::operator*=(const TMatrix<T>& Other)
+	{
+		LargeWorldCoordinatesPrivate::MatrixMultiply(*this, *this, Other);
+	}
+
+	template<typename T>
+	inline TMatrix<T> TMatrix<T>::operator+(const TMatrix<T>& Other) const
+	{
+		TMatrix<T> Result(*this);
+		Result += Other;
+		return Result;
+	}
+
+	template<typename T>
+	inline void TMatrix<T>::operator+=(const TMatrix<T>& Other)
+	{
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			for (int32 Column = 0; Column < 4; ++Column)
+			{
+				M[Row][Column] += Other.M[Row][Column];
+			}
+		}
+	}
+
+	template<typename T>
+	inline TMatrix<T> TMatrix<T>::operator*(T Other) const
+	{
+		TMatrix<T> Result;
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			for (int32 Column = 0; Column < 4; ++Column)
+			{
+				Result.M[Row][Column] = M[Row][Column] * Other;
+			}
+		}
+		return Result;
+	}
+
+	template<typename T>
+	inline bool TMatrix<T>::operator==(const TMatrix<T>& Other) const
+	{
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			for (int32 Column = 0; Column < 4; ++Column)
+			{
+				if (M[Row][Column] != Other.M[Row][Column])
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	template<typename T>
+	inline bool TMatrix<T>::Equals(const TMatrix<T>& Other, T Tolerance) const
+	{
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			for (int32 Column = 0; Column < 4; ++Column)
+			{
+				if (std::abs(M[Row][Column] - Other.M[Row][Column]) > Tolerance)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	template<typename T>
+	inline TVector<T> TMatrix<T>::TransformPosition(const TVector<T>& V) const
+	{
+		return LargeWorldCoordinatesPrivate::TransformVector4(*this, V, T(1));
+	}
+
+	template<typename T>
+	inline TVector<T> TMatrix<T>::TransformVector(const TVector<T>& V) const
+	{
+		return LargeWorldCoordinatesPrivate::TransformVector4(*this, V, T(0));
+	}
+
+	template<typename T>
+	inline TMatrix<T> TMatrix<T>::GetTransposed() const
+	{
+		TMatrix<T> Result;
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			for (int32 Column = 0; Column < 4; ++Column)
+			{
+				Result.M[Column][Row] = M[Row][Column];
+			}
+		}
+		return Result;
+	}
+
+	template<typename T>
+	inline T TMatrix<T>::Determinant() const
+	{
+		// Expansion by the 2x2 minors of the top and bottom row pairs.
+		const T S0 = M[0][0] * M[1][1] - M[1][0] * M[0][1];
+		const T S1 = M[0][0] * M[1][2] - M[1][0] * M[0][2];
+		const T S2 = M[0][0] * M[1][3] - M[1][0] * M[0][3];
+		const T S3 = M[0][1] * M[1][2] - M[1][1] * M[0][2];
+		const T S4 = M[0][1] * M[1][3] - M[1][1] * M[0][3];
+		const T S5 = M[0][2] * M[1][3] - M[1][2] * M[0][3];
+		const T C5 = M[2][2] * M[3][3] - M[3][2] * M[2][3];
+		const T C4 = M[2][1] * M[3][3] - M[3][1] * M[2][3];
+		const T C3 = M[2][1] * M[3][2] - M[3][1] * M[2][2];
+		const T C2 = M[2][0] * M[3][3] - M[3][0] * M[2][3];
+		const T C1 = M[2][0] * M[3][2] - M[3][0] * M[2][2];
+		const T C0 = M[2][0] * M[3][1] - M[3][0] * M[2][1];
+		return S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+	}
+
+	template<typename T>
+	inline TMatrix<T> TMatrix<T>::Inverse() const
+	{
+		if (GetScaledAxis(EAxis::X).IsNearlyZero(T(SMALL_NUMBER)) &&
+			GetScaledAxis(EAxis::Y).IsNearlyZero(T(SMALL_NUMBER)) &&
+			GetScaledAxis(EAxis::Z).IsNearlyZero(T(SMALL_NUMBER)))
+		{
+			INC_MATH_COUNTER(MatrixInverseNil);
+			return Identity;
+		}
+
+		const T S0 = M[0][0] * M[1][1] - M[1][0] * M[0][1];
+		const T S1 = M[0][0] * M[1][2] - M[1][0] * M[0][2];
+		const T S2 = M[0][0] * M[1][3] - M[1][0] * M[0][3];
+		const T S3 = M[0][1] * M[1][2] - M[1][1] * M[0][2];
+		const T S4 = M[0][1] * M[1][3] - M[1][1] * M[0][3];
+		const T S5 = M[0][2] * M[1][3] - M[1][2] * M[0][3];
+		const T C5 = M[2][2] * M[3][3] - M[3][2] * M[2][3];
+		const T C4 = M[2][1] * M[3][3] - M[3][1] * M[2][3];
+		const T C3 = M[2][1] * M[3][2] - M[3][1] * M[2][2];
+		const T C2 = M[2][0] * M[3][3] - M[3][0] * M[2][3];
+		const T C1 = M[2][0] * M[3][2] - M[3][0] * M[2][2];
+		const T C0 = M[2][0] * M[3][1] - M[3][0] * M[2][1];
+
+		const T Det = S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+		if (Det == 0)
+		{
+			INC_MATH_COUNTER(MatrixInverseSingular);
+			return Identity;
+		}
+		const T RDet = T(1) / Det;
+
+		TMatrix<T> Result;
+		Result.M[0][0] = ( M[1][1] * C5 - M[1][2] * C4 + M[1][3] * C3) * RDet;
+		Result.M[0][1] = (-M[0][1] * C5 + M[0][2] * C4 - M[0][3] * C3) * RDet;
+		Result.M[0][2] = ( M[3][1] * S5 - M[3][2] * S4 + M[3][3] * S3) * RDet;
+		Result.M[0][3] = (-M[2][1] * S5 + M[2][2] * S4 - M[2][3] * S3) * RDet;
+
+		Result.M[1][0] = (-M[1][0] * C5 + M[1][2] * C2 - M[1][3] * C1) * RDet;
+		Result.M[1][1] = ( M[0][0] * C5 - M[0][2] * C2 + M[0][3] * C1) * RDet;
+		Result.M[1][2] = (-M[3][0] * S5 + M[3][2] * S2 - M[3][3] * S1) * RDet;
+		Result.M[1][3] = ( M[2][0] * S5 - M[2][2] * S2 + M[2][3] * S1) * RDet;
+
+		Result.M[2][0] = ( M[1][0] * C4 - M[1][1] * C2 + M[1][3] * C0) * RDet;
+		Result.M[2][1] = (-M[0][0] * C4 + M[0][1] * C2 - M[0][3] * C0) * RDet;
+		Result.M[2][2] = ( M[3][0] * S4 - M[3][1] * S2 + M[3][3] * S0) * RDet;
+		Result.M[2][3] = (-M[2][0] * S4 + M[2][1] * S2 - M[2][3] * S0) * RDet;
+
+		Result.M[3][0] = (-M[1][0] * C3 + M[1][1] * C1 - M[1][2] * C0) * RDet;
+		Result.M[3][1] = ( M[0][0] * C3 - M[0][1] * C1 + M[0][2] * C0) * RDet;
+		Result.M[3][2] = (-M[3][0] * S3 + M[3][1] * S1 - M[3][2] * S0) * RDet;
+		Result.M[3][3] = ( M[2][0] * S3 - M[2][1] * S1 + M[2][2] * S0) * RDet;
+		return Result;
+	}
+
+	template<typename T>
+	inline TVector<T> TMatrix<T>::GetScaledAxis(EAxis::Type InAxis) const
+	{
+		switch (InAxis)
+		{
+		case EAxis::X:
+			return TVector<T>(M[0][0], M[0][1], M[0][2]);
+
+		case EAxis::Y:
+			return TVector<T>(M[1][0], M[1][1], M[1][2]);
+
+		case EAxis::Z:
+			return TVector<T>(M[2][0], M[2][1], M[2][2]);
+
+		default:
+			ensure(0);
+			return TVector<T>::ZeroVector;
+		}
+	}
+
+	template<typename T>
+	inline TQuat<T> TMatrix<T>::ToQuat() const
+	{
+		// Same as FQuat(const FMatrix&), an identity result for matrices without rotation.
+		if (GetScaledAxis(EAxis::X).IsNearlyZero() || GetScaledAxis(EAxis::Y).IsNearlyZero() || GetScaledAxis(EAxis::Z).IsNearlyZero())
+		{
+			return TQuat<T>::Identity;
+		}
+
+		TQuat<T> Result;
+		const T Trace = M[0][0] + M[1][1] + M[2][2];
+		if (Trace > 0)
+		{
+			const T InvS = T(1) / std::sqrt(Trace + T(1));
+			const T S = T(0.5) * InvS;
+			Result.W = T(0.5) / InvS;
+			Result.X = (M[1][2] - M[2][1]) * S;
+			Result.Y = (M[2][0] - M[0][2]) * S;
+			Result.Z = (M[0][1] - M[1][0]) * S;
+		}
+		else
+		{
+			// diagonal is negative
+			int32 i = 0;
+			if (M[1][1] > M[0][0])
+			{
+				i = 1;
+			}
+			if (M[2][2] > M[i][i])
+			{
+				i = 2;
+			}
+
+			static const int32 Next[3] = { 1, 2, 0 };
+			const int32 j = Next[i];
+			const int32 k = Next[j];
+
+			const T InvS = T(1) / std::sqrt(M[i][i] - M[j][j] - M[k][k] + T(1));
+			const T S = T(0.5) * InvS;
+
+			T Qt[4];
+			Qt[i] = T(0.5) / InvS;
+			Qt[3] = (M[j][k] - M[k][j]) * S;
+			Qt[j] = (M[i][j] + M[j][i]) * S;
+			Qt[k] = (M[i][k] + M[k][i]) * S;
+
+			Result.X = Qt[0];
+			Result.Y = Qt[1];
+			Result.Z = Qt[2];
+			Result.W = Qt[3];
+		}
+		return Result;
+	}
+
+	template<typename T>
+	inline bool TMatrix<T>::ContainsNaN() const
+	{
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			for (int32 Column = 0; Column < 4; ++Column)
+			{
+				if (!std::isfinite(M[Row][Column]))
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/* TQuat inline functions
+	 *****************************************************************************/
+
+	template<typename T>
+	inline TMatrix<T> TQuat<T>::ToMatrix() const
+	{
+		const T X2 = X + X;  const T Y2 = Y + Y;  const T Z2 = Z + Z;
+		const T XX = X * X2; const T XY = X * Y2; const T XZ = X * Z2;
+		const T YY = Y * Y2; const T YZ = Y * Z2; const T ZZ = Z * Z2;
+		const T WX = W * X2; const T WY = W * Y2; const T WZ = W * Z2;
+
+		TMatrix<T> Result;
+		Result.M[0][0] = T(1) - (YY + ZZ); Result.M[0][1] = XY + WZ;           Result.M[0][2] = XZ - WY;           Result.M[0][3] = 0;
+		Result.M[1][0] = XY - WZ;           Result.M[1][1] = T(1) - (XX + ZZ); Result.M[1][2] = YZ + WX;           Result.M[1][3] = 0;
+		Result.M[2][0] = XZ + WY;           Result.M[2][1] = YZ - WX;           Result.M[2][2] = T(1) - (XX + YY); Result.M[2][3] = 0;
+		Result.M[3][0] = 0;                 Result.M[3][1] = 0;                 Result.M[3][2] = 0;                 Result.M[3][3] = 1;
+		return Result;
+	}
+
+	/* Narrowing constructors of the float specializations
+	 *****************************************************************************/
+
+	inline FVector::TVector(const FVector3d& V)
+		: X((float)V.X), Y((float)V.Y), Z((float)V.Z)
+	{
+	}
+
+	inline FMatrix::TMatrix(const FMatrix44d& Other)
+	{
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			for (int32 Column = 0; Column < 4; ++Column)
+			{
+				M[Row][Column] = (float)Other.M[Row][Column];
+			}
+		}
+	}
+
+	inline FQuat::TQuat(const FQuat4d& Q)
+		: X((float)Q.X), Y((float)Q.Y), Z((float)Q.Z), W((float)Q.W)
+	{
+	}
+
+	/**
+	 * Batch conversions between the float and double types. Narrowing rounds to nearest, widening is exact.
+	 * Both run at memory speed with AVX2 (4 components per instruction). In and Out must not overlap.
+	 */
+	struct FLargeWorldCoordinates
+	{
+		static void Narrow(const FVector3d* In, FVector3f* Out, int32 Count);
+		static void Narrow(const FMatrix44d* In, FMatrix44f* Out, int32 Count);
+		static void Narrow(const FQuat4d* In, FQuat4f* Out, int32 Count);
+
+		static void Widen(const FVector3f* In, FVector3d* Out, int32 Count);
+		static void Widen(const FMatrix44f* In, FMatrix44d* Out, int32 Count);
+		static void Widen(const FQuat4f* In, FQuat4d* Out, int32 Count);
+
+		/**
+		 * Narrows positions relative to an origin, Out[i] = FVector(In[i] - Origin), subtracting in double.
+		 * Use this to move world positions into a float space around the camera or a streaming cell
+		 * without the precision loss of narrowing first.
+		 */
+		static void NarrowRelative(const FVector3d* In, const FVector3d& Origin, FVector3f* Out, int32 Count);
+
+		/** Inverse of NarrowRelative, Out[i] = FVector3d(In[i]) + Origin. */
+		static void WidenRelative(const FVector3f* In, const FVector3d& Origin, FVector3d* Out, int32 Count);
+	};
+}
@@ -0,0 +1,27 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+namespace UE4Math
+{
+	/**
+	 * Vector, matrix and quaternion types are templates on their component type. The float versions are
+	 * explicit specializations holding the full API (Vector.h, Matrix.h, Quat.h), the primary templates in
+	 * LargeWorldCoordinates.h provide the double versions for positions far from the origin.
+	 */
+	template<typename T> struct TVector;
+	template<typename T> struct TMatrix;
+	template<typename T> struct TQuat;
+
+	typedef TVector<float>	FVector;
+	typedef TVector<float>	FVector3f;
+	typedef TVector<double>	FVector3d;
+
+	typedef TMatrix<float>	FMatrix;
+	typedef TMatrix<float>	FMatrix44f;
+	typedef TMatrix<double>	FMatrix44d;
+
+	typedef TQuat<float>	FQuat;
+	typedef TQuat<float>	FQuat4f;
+	typedef TQuat<double>	FQuat4d;
+}
@@ -0,0 +1,217 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MathValidation.cpp: Batched NaN and Inf checks
+=============================================================================*/
+
+#include "Math/MathValidation.h"
+#include "Math/UnrealMath.h"
+
+#if PLATFORM_ALWAYS_HAS_AVX2
+#include <immintrin.h>
+#elif PLATFORM_ALWAYS_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace UE4Math
+{
+	namespace MathValidationPrivate
+	{
+		static_assert(sizeof(FVector) == 3 * sizeof(float), "FVector must be tightly packed floats.");
+		static_assert(sizeof(FVector2D) == 2 * sizeof(float), "FVector2D must be tightly packed floats.");
+		static_assert(sizeof(FVector4) == 4 * sizeof(float), "FVector4 must be tightly packed floats.");
+		static_assert(sizeof(FQuat) == 4 * sizeof(float), "FQuat must be tightly packed floats.");
+		static_assert(sizeof(FRotator) == 3 * sizeof(float), "FRotator must be tightly packed floats.");
+		static_assert(sizeof(FMatrix) == 16 * sizeof(float), "FMatrix must be tightly packed floats.");
+		static_assert(sizeof(FMatrix3x4) == 12 * sizeof(float), "FMatrix3x4 must be tightly packed floats.");
+
+		/** A float is NaN or Inf exactly when all of its exponent bits are set. */
+		enum : uint32 { ExponentMask = 0x7F800000 };
+
+		/** Floats tested per block before looking for the exact position. */
+		enum { BlockFloats = 16 };
+
+		std::atomic<uint32> SampleInterval{ 1 };
+		std::atomic<uint32> SampleCounter{ 0 };
+		std::atomic<FNaNReportCallback> ReportCallback{ nullptr };
+
+		inline bool IsNonFinite(const float* Value)
+		{
+			uint32 Bits;
+			FMemory::Memcpy(&Bits, Value, sizeof(Bits));
+			return (Bits & ExponentMask) == ExponentMask;
+		}
+
+		/** @return true if any of the BlockFloats floats at Data is NaN or Inf. */
+		inline bool BlockHasNonFinite(const float* Data)
+		{
+#if PLATFORM_ALWAYS_HAS_AVX2
+			const __m256i Mask = _mm256_set1_epi32((int32)ExponentMask);
+			const __m256i A = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(Data + 0)), Mask);
+			const __m256i B = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(Data + 8)), Mask);
+			const __m256i Bad = _mm256_or_si256(_mm256_cmpeq_epi32(A, Mask), _mm256_cmpeq_epi32(B, Mask));
+			return !_mm256_testz_si256(Bad, Bad);
+#elif PLATFORM_ALWAYS_HAS_SSE2
+			const __m128i Mask = _mm_set1_epi32((int32)ExponentMask);
+			__m128i Bad = _mm_setzero_si128();
+			for (int32 Offset = 0; Offset < BlockFloats; Offset += 4)
+			{
+				const __m128i Bits = _mm_and_si128(_mm_loadu_si128((const __m128i*)(Data + Offset)), Mask);
+				Bad = _mm_or_si128(Bad, _mm_cmpeq_epi32(Bits, Mask));
+			}
+			return _mm_movemask_epi8(Bad) != 0;
+#else
+			for (int32 Offset = 0; Offset < BlockFloats; ++Offset)
+			{
+				if (IsNonFinite(Data + Offset))
+				{
+					return true;
+				}
+			}
+			return false;
+#endif
+		}
+
+		/** @return Index of the first NaN or Inf float, or INDEX_NONE. */
+		int64 FindFirstNonFiniteFloat(const float* Data, int64 NumFloats)
+		{
+			int64 Index = 0;
+			for (; Index + BlockFloats <= NumFloats; Index += BlockFloats)
+			{
+				if (BlockHasNonFinite(Data + Index))
+				{
+					break;
+				}
+			}
+			for (; Index < NumFloats; ++Index)
+			{
+				if (IsNonFinite(Data + Index))
+				{
+					return Index;
+				}
+			}
+			return INDEX_NONE;
+		}
+
+		int32 BuildNonFiniteMask(const float* Data, int32 Count, int32 FloatsPerElement, uint64* OutMask)
+		{
+			FMemory::Memzero(OutMask, (size_t)((Count + 63) / 64) * sizeof(uint64));
+
+			const int64 NumFloats = (int64)Count * FloatsPerElement;
+			int32 NumBad = 0;
+			for (int64 BlockStart = 0; BlockStart < NumFloats; BlockStart += BlockFloats)
+			{
+				const bool bFullBlock = BlockStart + BlockFloats <= NumFloats;
+				if (bFullBlock && !BlockHasNonFinite(Data + BlockStart))
+				{
+					continue;
+				}
+
+				const int64 BlockEnd = bFullBlock ? BlockStart + BlockFloats : NumFloats;
+				for (int64 Index = BlockStart; Index < BlockEnd; ++Index)
+				{
+					if (IsNonFinite(Data + Index))
+					{
+						const int32 Element = (int32)(Index / FloatsPerElement);
+						const uint64 Bit = 1ull << (Element & 63);
+						if (!(OutMask[Element >> 6] & Bit))
+						{
+							OutMask[Element >> 6] |= Bit;
+							++NumBad;
+						}
+					}
+				}
+			}
+			return NumBad;
+		}
+
+		template <typename T>
+		inline int32 FindFirstNonFinite(const T* Values, int32 Count)
+		{
+			enum { FloatsPerElement = sizeof(T) / sizeof(float) };
+			const int64 Index = FindFirstNonFiniteFloat((const float*)Values, (int64)Count * FloatsPerElement);
+			return Index == INDEX_NONE ? INDEX_NONE : (int32)(Index / FloatsPerElement);
+		}
+
+		template <typename T>
+		inline int32 GetNonFiniteMask(const T* Values, int32 Count, uint64* OutMask)
+		{
+			return BuildNonFiniteMask((const float*)Values, Count, (int32)(sizeof(T) / sizeof(float)), OutMask);
+		}
+
+		inline std::string ToReportString(const FVector& Value) { return Value.ToString(); }
+		inline std::string ToReportString(const FVector2D& Value) { return Value.ToString(); }
+		inline std::string ToReportString(const FVector4& Value) { return Value.ToString(); }
+		inline std::string ToReportString(const FQuat& Value) { return Value.ToString(); }
+		inline std::string ToReportString(const FRotator& Value) { return Value.ToString(); }
+		inline std::string ToReportString(const FMatrix& Value) { return Value.ToString(); }
+		inline std::string ToReportString(const FMatrix3x4& Value) { return Value.ToMatrix().ToString(); }
+
+		template <typename T>
+		inline bool Validate(const T* Values, int32 Count, const char* Context, const char* TypeName)
+		{
+			const uint32 Interval = SampleInterval.load(std::memory_order_relaxed);
+			if (Interval == 0 || (Interval > 1 && SampleCounter.fetch_add(1, std::memory_order_relaxed) % Interval != 0))
+			{
+				return true;
+			}
+
+			const int32 BadIndex = FindFirstNonFinite(Values, Count);
+			if (BadIndex == INDEX_NONE)
+			{
+				return true;
+			}
+
+			INC_MATH_COUNTER(NaNValidationFailed);
+			FMathValidation::ReportNaN(Context, TypeName, BadIndex, ToReportString(Values[BadIndex]));
+			return false;
+		}
+	}
+
+#define IMPLEMENT_MATH_VALIDATION(Type) \
+	int32 FMathValidation::FindFirstNonFinite(const Type* Values, int32 Count) \
+	{ \
+		return MathValidationPrivate::FindFirstNonFinite(Values, Count); \
+	} \
+	int32 FMathValidation::GetNonFiniteMask(const Type* Values, int32 Count, uint64* OutMask) \
+	{ \
+		return MathValidationPrivate::GetNonFiniteMask(Values, Count, OutMask); \
+	} \
+	bool FMathValidation::Validate(const Type* Values, int32 Count, const char* Context) \
+	{ \
+		return MathValidationPrivate::Validate(Values, Count, Context, #Type); \
+	}
+
+	IMPLEMENT_MATH_VALIDATION(FVector)
+	IMPLEMENT_MATH_VALIDATION(FVector2D)
+	IMPLEMENT_MATH_VALIDATION(FVector4)
+	IMPLEMENT_MATH_VALIDATION(FQuat)
+	IMPLEMENT_MATH_VALIDATION(FRotator)
+	IMPLEMENT_MATH_VALIDATION(FMatrix)
+	IMPLEMENT_MATH_VALIDATION(FMatrix3x4)
+
+#undef IMPLEMENT_MATH_VALIDATION
+
+	void FMathValidation::SetSampleInterval(uint32 Interval)
+	{
+		MathValidationPrivate::SampleInterval.store(Interval, std::memory_order_relaxed);
+	}
+
+	uint32 FMathValidation::GetSampleInterval()
+	{
+		return MathValidationPrivate::SampleInterval.load(std::memory_order_relaxed);
+	}
+
+	void FMathValidation::SetReportCallback(FNaNReportCallback Callback)
+	{
+		MathValidationPrivate::ReportCallback.store(Callback);
+	}
+
+	void FMathValidation::ReportNaN(const char* Context, const char* TypeName, int32 Index, std::string Value)
+	{
+		if (FNaNReportCallback Callback = MathValidationPrivate::ReportCallback.load())
+		{
+			Callback(FNaNReport{ Context, TypeName, Index, std::move(Value) });
+		}
+	}
+}
@@ -0,0 +1,92 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "Misc/CoreMiscDefines.h"
+#include "Math/MathFwd.h"
+
+namespace UE4Math
+{
+	struct FVector2D;
+	struct FVector4;
+	struct FRotator;
+	struct FMatrix3x4;
+
+	/** Describes a non finite value found by FMathValidation or a DiagnosticCheckNaN. */
+	struct FNaNReport
+	{
+		/** Where the check ran, e.g. a pipeline stage or the function that produced the value. */
+		const char* Context;
+
+		/** Type of the checked value, e.g. "FVector". */
+		const char* TypeName;
+
+		/** Index of the first bad element of the span, 0 for single values. */
+		int32 Index;
+
+		/** The bad element, formatted with ToString(). */
+		std::string Value;
+	};
+
+	typedef void (*FNaNReportCallback)(const FNaNReport& Report);
+
+	/**
+	 * Batch validation of math data for NaN and Inf, meant to run at the boundaries of processing stages
+	 * instead of after every operation. The scans look at the exponent bits of 8 floats per instruction
+	 * on AVX2 (4 on SSE2) and only fall back to scalar code around bad values.
+	 */
+	struct FMathValidation
+	{
+		/** @return Index of the first element with a NaN or Inf component, or INDEX_NONE. */
+		static int32 FindFirstNonFinite(const FVector* Values, int32 Count);
+		static int32 FindFirstNonFinite(const FVector2D* Values, int32 Count);
+		static int32 FindFirstNonFinite(const FVector4* Values, int32 Count);
+		static int32 FindFirstNonFinite(const FQuat* Values, int32 Count);
+		static int32 FindFirstNonFinite(const FRotator* Values, int32 Count);
+		static int32 FindFirstNonFinite(const FMatrix* Values, int32 Count);
+		static int32 FindFirstNonFinite(const FMatrix3x4* Values, int32 Count);
+
+		/**
+		 * Sets bit i of OutMask for every element i with a NaN or Inf component.
+		 *
+		 * @param OutMask Receives (Count + 63) / 64 words.
+		 * @return Number of bad elements.
+		 */
+		static int32 GetNonFiniteMask(const FVector* Values, int32 Count, uint64* OutMask);
+		static int32 GetNonFiniteMask(const FVector2D* Values, int32 Count, uint64* OutMask);
+		static int32 GetNonFiniteMask(const FVector4* Values, int32 Count, uint64* OutMask);
+		static int32 GetNonFiniteMask(const FQuat* Values, int32 Count, uint64* OutMask);
+		static int32 GetNonFiniteMask(const FRotator* Values, int32 Count, uint64* OutMask);
+		static int32 GetNonFiniteMask(const FMatrix* Values, int32 Count, uint64* OutMask);
+		static int32 GetNonFiniteMask(const FMatrix3x4* Values, int32 Count, uint64* OutMask);
+
+		/**
+		 * Checks a span if this call is sampled (see SetSampleInterval) and reports its first bad element.
+		 *
+		 * @param Context Passed on to the report, e.g. the name of the stage that produced the data.
+		 * @return false if the span was checked and contains a NaN or Inf.
+		 */
+		static bool Validate(const FVector* Values, int32 Count, const char* Context);
+		static bool Validate(const FVector2D* Values, int32 Count, const char* Context);
+		static bool Validate(const FVector4* Values, int32 Count, const char* Context);
+		static bool Validate(const FQuat* Values, int32 Count, const char* Context);
+		static bool Validate(const FRotator* Values, int32 Count, const char* Context);
+		static bool Validate(const FMatrix* Values, int32 Count, const char* Context);
+		static bool Validate(const FMatrix3x4* Values, int32 Count, const char* Context);
+
+		/**
+		 * Sets how often Validate actually scans: 0 never, 1 on every call (the default), N on every Nth call.
+		 * The call counter is shared by all threads and types.
+		 */
+		static void SetSampleInterval(uint32 Interval);
+		static uint32 GetSampleInterval();
+
+		/** Sets the function receiving reports from Validate and DiagnosticCheckNaN. Null (the default) drops them. */
+		static void SetReportCallback(FNaNReportCallback Callback);
+
+		/** Sends a report to the installed callback. */
+		static void ReportNaN(const char* Context, const char* TypeName, int32 Index, std::string Value);
+	};
+}
@@ -6,6 +6,7 @@
 //#include "HAL/UnrealMemory.h"
 #include "Math/UnrealMathUtility.h"
 //#include "Containers/UnrealString.h"
+#include "Misc/StringBuilder.h"
 #include "Math/Vector.h"
 #include "Math/Vector4.h"
 #include "Math/Plane.h"
@@ -16,12 +17,14 @@ namespace UE4Math
 {
 	/**
  * 4x4 matrix of floating point values.
+ * This is FMatrix, the float specialization of TMatrix; see LargeWorldCoordinates.h for double precision.
  * Matrix-matrix multiplication happens with a pre-multiple of the transpose --
  * in other words, Res = Mat1.operator*(Mat2) means Res = Mat2^T * Mat1, as
  * opposed to Res = Mat1 * Mat2.
  * Matrix elements are accessed with M[RowIndex][ColumnIndex].
  */
-	struct FMatrix
+	template<>
+	struct TMatrix<float>
 	{
 	public:
 		union
@@ -33,14 +36,14 @@ namespace UE4Math
 		static const FMatrix Identity;
 
 		// Constructors.
-		inline FMatrix();
+		inline TMatrix();
 
 		/**
 		 * Constructor.
 		 *
 		 * @param EForceInit Force Init Enum.
 		 */
-		explicit inline FMatrix(EForceInit)
+		explicit inline TMatrix(EForceInit)
 		{
 			M[0][0]=0; M[0][1] = 0; M[0][2] = 0; M[0][3] = 0;
 			M[1][0]=0; M[1][1] = 0; M[1][2] = 0; M[1][3] = 0;
@@ -57,7 +60,7 @@ namespace UE4Math
 		 * @param InZ Z plane
 		 * @param InW W plane
 		 */
-		inline FMatrix(const FPlane& InX, const FPlane& InY, const FPlane& InZ, const FPlane& InW);
+		constexpr TMatrix(const FPlane& InX, const FPlane& InY, const FPlane& InZ, const FPlane& InW);
 
 		/**
 		 * Constructor.
@@ -67,7 +70,15 @@ namespace UE4Math
 		 * @param InZ Z vector
 		 * @param InW W vector
 		 */
-		inline FMatrix(const FVector& InX, const FVector& InY, const FVector& InZ, const FVector& InW);
+		inline TMatrix(const FVector& InX, const FVector& InY, const FVector& InZ, const FVector& InW);
+
+		/**
+		 * Constructor narrowing a double precision matrix, rounding each element to nearest.
+		 * Defined in LargeWorldCoordinates.h.
+		 *
+		 * @param Other Matrix to convert.
+		 */
+		explicit TMatrix(const FMatrix44d& Other);
 
 		// Set this to the identity matrix
 		inline void SetIdentity();
@@ -180,6 +191,32 @@ namespace UE4Math
 		/** Fast path, and handles nil matrices. */
 		inline FMatrix Inverse() const;
 
+		/**
+		 * Multiplies every matrix in an array by the same matrix, Out[i] = Matrices[i] * Other.
+		 * Out may alias Matrices.
+		 *
+		 * @param Matrices First operands.
+		 * @param Other Second operand, shared by every product.
+		 * @param Out Receives Count matrices.
+		 * @param Count Number of matrices.
+		 */
+		static void MultiplyBatch(const FMatrix* Matrices, const FMatrix& Other, FMatrix* Out, int32 Count);
+
+		/**
+		 * Multiplies two arrays of matrices pairwise, Out[i] = Matrices1[i] * Matrices2[i].
+		 * Out may alias either input.
+		 */
+		static void MultiplyBatch(const FMatrix* Matrices1, const FMatrix* Matrices2, FMatrix* Out, int32 Count);
+
+		/**
+		 * Inverts an array of matrices, each with the same result as Inverse(). Out may alias Matrices.
+		 *
+		 * @param Matrices Matrices to invert.
+		 * @param Out Receives the inverses.
+		 * @param Count Number of matrices.
+		 */
+		static void InverseBatch(const FMatrix* Matrices, FMatrix* Out, int32 Count);
+
 		inline FMatrix TransposeAdjoint() const;
 
 		// NOTE: There is some compiler optimization issues with WIN64 that cause inline to cause a crash
@@ -329,6 +366,14 @@ namespace UE4Math
 		 */
 		std::string ToString() const;
 
+		/**
+		 * Appends a textual representation of this matrix to a string builder without allocating.
+		 * Components are written in the shortest form that parses back to the same value.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const;
+
 		/** Output ToString */
 		void DebugPrint() const;
 
@@ -373,7 +418,7 @@ namespace UE4Math
 	 * A storage class for compile-time fixed size matrices.
 	 */
 	template<uint32 NumRows, uint32 NumColumns>
-	class TMatrix
+	class TFixedMatrix
 	{
 	public:
 
@@ -381,23 +426,23 @@ namespace UE4Math
 		float M[NumRows][NumColumns];
 
 		// Constructor
-		TMatrix();
+		TFixedMatrix();
 
 		/**
 		 * Constructor
 		 *
 		 * @param InMatrix FMatrix reference
 		 */
-		TMatrix(const FMatrix& InMatrix);
+		TFixedMatrix(const FMatrix& InMatrix);
 	};
 
 
 	template<uint32 NumRows, uint32 NumColumns>
-	inline TMatrix<NumRows, NumColumns>::TMatrix() { }
+	inline TFixedMatrix<NumRows, NumColumns>::TFixedMatrix() { }
 
 
 	template<uint32 NumRows, uint32 NumColumns>
-	inline TMatrix<NumRows, NumColumns>::TMatrix(const FMatrix& InMatrix)
+	inline TFixedMatrix<NumRows, NumColumns>::TFixedMatrix(const FMatrix& InMatrix)
 	{
 		for (uint32 RowIndex = 0; (RowIndex < NumRows) && (RowIndex < 4); RowIndex++)
 		{
@@ -472,19 +517,22 @@ namespace UE4Math
 
 	 // Constructors.
 
-	inline FMatrix::FMatrix()
+	inline FMatrix::TMatrix()
 	{
 	}
 
-	inline FMatrix::FMatrix(const FPlane& InX, const FPlane& InY, const FPlane& InZ, const FPlane& InW)
+	constexpr FMatrix::TMatrix(const FPlane& InX, const FPlane& InY, const FPlane& InZ, const FPlane& InW)
+		: M{
+			{ InX.X, InX.Y, InX.Z, InX.W },
+			{ InY.X, InY.Y, InY.Z, InY.W },
+			{ InZ.X, InZ.Y, InZ.Z, InZ.W },
+			{ InW.X, InW.Y, InW.Z, InW.W } }
 	{
-		M[0][0] = InX.X; M[0][1] = InX.Y;  M[0][2] = InX.Z;  M[0][3] = InX.W;
-		M[1][0] = InY.X; M[1][1] = InY.Y;  M[1][2] = InY.Z;  M[1][3] = InY.W;
-		M[2][0] = InZ.X; M[2][1] = InZ.Y;  M[2][2] = InZ.Z;  M[2][3] = InZ.W;
-		M[3][0] = InW.X; M[3][1] = InW.Y;  M[3][2] = InW.Z;  M[3][3] = InW.W;
 	}
 
-	inline FMatrix::FMatrix(const FVector& InX, const FVector& InY, const FVector& InZ, const FVector& InW)
+	inline constexpr FMatrix FMatrix::Identity(FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 1, 0), FPlane(0, 0, 0, 1));
+
+	inline FMatrix::TMatrix(const FVector& InX, const FVector& InY, const FVector& InZ, const FVector& InW)
 	{
 		M[0][0] = InX.X; M[0][1] = InX.Y;  M[0][2] = InX.Z;  M[0][3] = 0.0f;
 		M[1][0] = InY.X; M[1][1] = InY.Y;  M[1][2] = InY.Z;  M[1][3] = 0.0f;
@@ -718,6 +766,7 @@ namespace UE4Math
 			GetScaledAxis(EAxis::Y).IsNearlyZero(SMALL_NUMBER) &&
 			GetScaledAxis(EAxis::Z).IsNearlyZero(SMALL_NUMBER))
 		{
+			INC_MATH_COUNTER(MatrixInverseFastInvalid);
 			ErrorEnsure(("FMatrix::InverseFast(), trying to invert a NIL matrix, this results in NaNs! Use Inverse() instead."));
 		}
 		else
@@ -726,6 +775,7 @@ namespace UE4Math
 
 			if (Det == 0.0f || !FMath::IsFinite(Det))
 			{
+				INC_MATH_COUNTER(MatrixInverseFastInvalid);
 				ErrorEnsure(("FMatrix::InverseFast(), trying to invert a non-invertible matrix, this results in NaNs! Use Inverse() instead."));
 			}
 		}
@@ -746,6 +796,7 @@ namespace UE4Math
 			GetScaledAxis(EAxis::Z).IsNearlyZero(SMALL_NUMBER))
 		{
 			// just set to zero - avoids unsafe inverse of zero and duplicates what QNANs were resulting in before (scaling away all children)
+			INC_MATH_COUNTER(MatrixInverseNil);
 			Result = FMatrix::Identity;
 		}
 		else
@@ -754,6 +805,7 @@ namespace UE4Math
 
 			if (Det == 0.0f)
 			{
+				INC_MATH_COUNTER(MatrixInverseSingular);
 				Result = FMatrix::Identity;
 			}
 			else
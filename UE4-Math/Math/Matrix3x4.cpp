@@ -0,0 +1,143 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	Matrix3x4.cpp: Batch operations on affine transforms
+=============================================================================*/
+
+#include "Math/Matrix3x4.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+
+namespace UE4Math
+{
+	namespace Matrix3x4Private
+	{
+		/** ComposeBatch takes 27 to 30 cycles per matrix at -O2 with SSE2, InverseBatch 37. */
+		enum { BatchParallelMinSize = GetParallelForMinBatchSize(27) };
+
+		/** InverseRigidBatch only transposes the rotation, 14 cycles per matrix. */
+		enum { RigidBatchParallelMinSize = GetParallelForMinBatchSize(14) };
+
+		/** Out = A * B on rows loaded into registers. W carries the translation. */
+		inline void ComposeRows(const VectorRegister& A0, const VectorRegister& A1, const VectorRegister& A2, const FMatrix3x4& B, FMatrix3x4& Out)
+		{
+			for (int32 Row = 0; Row < 3; ++Row)
+			{
+				const VectorRegister BRow = VectorLoad(B.M[Row]);
+				VectorRegister Result = VectorMultiply(BRow, GlobalVectorConstants::Float0001);
+				Result = VectorMultiplyAdd(VectorReplicate(BRow, 0), A0, Result);
+				Result = VectorMultiplyAdd(VectorReplicate(BRow, 1), A1, Result);
+				Result = VectorMultiplyAdd(VectorReplicate(BRow, 2), A2, Result);
+				VectorStore(Result, Out.M[Row]);
+			}
+		}
+	}
+
+	void FMatrix3x4::ComposeBatch(const FMatrix3x4* A, const FMatrix3x4* B, FMatrix3x4* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(Matrix3x4Batch);
+		INC_MATH_COUNTER_BY(Matrix3x4BatchElements, Count);
+
+		ParallelForRange(Count, Matrix3x4Private::BatchParallelMinSize, [A, B, Out](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				// Load both inputs before storing so Out can alias either of them.
+				const VectorRegister A0 = VectorLoad(A[Index].M[0]);
+				const VectorRegister A1 = VectorLoad(A[Index].M[1]);
+				const VectorRegister A2 = VectorLoad(A[Index].M[2]);
+				const FMatrix3x4 BCopy = B[Index];
+				Matrix3x4Private::ComposeRows(A0, A1, A2, BCopy, Out[Index]);
+			}
+		});
+	}
+
+	void FMatrix3x4::ComposeBatch(const FMatrix3x4* A, const FMatrix3x4& B, FMatrix3x4* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(Matrix3x4Batch);
+		INC_MATH_COUNTER_BY(Matrix3x4BatchElements, Count);
+
+		const FMatrix3x4 BCopy = B;
+		ParallelForRange(Count, Matrix3x4Private::BatchParallelMinSize, [A, &BCopy, Out](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const VectorRegister A0 = VectorLoad(A[Index].M[0]);
+				const VectorRegister A1 = VectorLoad(A[Index].M[1]);
+				const VectorRegister A2 = VectorLoad(A[Index].M[2]);
+				Matrix3x4Private::ComposeRows(A0, A1, A2, BCopy, Out[Index]);
+			}
+		});
+	}
+
+	void FMatrix3x4::InverseBatch(const FMatrix3x4* In, FMatrix3x4* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(Matrix3x4Batch);
+		INC_MATH_COUNTER_BY(Matrix3x4BatchElements, Count);
+
+		ParallelForRange(Count, Matrix3x4Private::BatchParallelMinSize, [In, Out](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const FMatrix3x4& Src = In[Index];
+
+				// Rows of the rotation/scale part of the equivalent FMatrix, and the translation.
+				const VectorRegister R0 = VectorSet(Src.M[0][0], Src.M[1][0], Src.M[2][0], 0.f);
+				const VectorRegister R1 = VectorSet(Src.M[0][1], Src.M[1][1], Src.M[2][1], 0.f);
+				const VectorRegister R2 = VectorSet(Src.M[0][2], Src.M[1][2], Src.M[2][2], 0.f);
+				const VectorRegister Origin = VectorSet(Src.M[0][3], Src.M[1][3], Src.M[2][3], 0.f);
+
+				VectorRegister C0 = VectorCross(R1, R2);
+				VectorRegister C1 = VectorCross(R2, R0);
+				VectorRegister C2 = VectorCross(R0, R1);
+
+				const VectorRegister Det = VectorDot3(R0, C0);
+				if (VectorGetComponent(Det, 0) == 0.0f)
+				{
+					INC_MATH_COUNTER(MatrixInverseSingular);
+					Out[Index] = FMatrix3x4::Identity;
+					continue;
+				}
+
+				const VectorRegister InvDet = VectorDivide(GlobalVectorConstants::FloatOne, Det);
+				C0 = VectorMultiply(C0, InvDet);
+				C1 = VectorMultiply(C1, InvDet);
+				C2 = VectorMultiply(C2, InvDet);
+
+				const VectorRegister Row0 = VectorMergeVecXYZ_VecW(C0, VectorNegate(VectorDot3(Origin, C0)));
+				const VectorRegister Row1 = VectorMergeVecXYZ_VecW(C1, VectorNegate(VectorDot3(Origin, C1)));
+				const VectorRegister Row2 = VectorMergeVecXYZ_VecW(C2, VectorNegate(VectorDot3(Origin, C2)));
+				VectorStore(Row0, Out[Index].M[0]);
+				VectorStore(Row1, Out[Index].M[1]);
+				VectorStore(Row2, Out[Index].M[2]);
+			}
+		});
+	}
+
+	void FMatrix3x4::InverseRigidBatch(const FMatrix3x4* In, FMatrix3x4* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(Matrix3x4Batch);
+		INC_MATH_COUNTER_BY(Matrix3x4BatchElements, Count);
+
+		ParallelForRange(Count, Matrix3x4Private::RigidBatchParallelMinSize, [In, Out](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const FMatrix3x4& Src = In[Index];
+
+				// The inverse rotation is the transpose.
+				const VectorRegister C0 = VectorSet(Src.M[0][0], Src.M[1][0], Src.M[2][0], 0.f);
+				const VectorRegister C1 = VectorSet(Src.M[0][1], Src.M[1][1], Src.M[2][1], 0.f);
+				const VectorRegister C2 = VectorSet(Src.M[0][2], Src.M[1][2], Src.M[2][2], 0.f);
+				const VectorRegister Origin = VectorSet(Src.M[0][3], Src.M[1][3], Src.M[2][3], 0.f);
+
+				const VectorRegister Row0 = VectorMergeVecXYZ_VecW(C0, VectorNegate(VectorDot3(Origin, C0)));
+				const VectorRegister Row1 = VectorMergeVecXYZ_VecW(C1, VectorNegate(VectorDot3(Origin, C1)));
+				const VectorRegister Row2 = VectorMergeVecXYZ_VecW(C2, VectorNegate(VectorDot3(Origin, C2)));
+				VectorStore(Row0, Out[Index].M[0]);
+				VectorStore(Row1, Out[Index].M[1]);
+				VectorStore(Row2, Out[Index].M[2]);
+			}
+		});
+	}
+}
@@ -0,0 +1,418 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+//#include "CoreTypes.h"
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+#include "Math/Matrix.h"
+#include "Math/Quat.h"
+#include "Math/RotationTranslationMatrix.h"
+#include "Math/QuatRotationTranslationMatrix.h"
+
+namespace UE4Math
+{
+	/**
+	 * Affine transform stored as a 3x4 matrix (48 bytes instead of the 64 of an FMatrix).
+	 *
+	 * Holds the same transform as an FMatrix whose last column is (0,0,0,1), stored transposed:
+	 * M[i][0..2] is column i of the rotation/scale part and M[i][3] is component i of the translation.
+	 * Multiplication order matches FMatrix, A * B applies A first and then B.
+	 */
+	struct FMatrix3x4
+	{
+	public:
+
+		float M[3][4];
+
+		/** Identity transform. */
+		static const FMatrix3x4 Identity;
+
+		/** Default constructor (no initialization). */
+		inline FMatrix3x4() { }
+
+		/**
+		 * Constructor.
+		 *
+		 * @param EForceInit Force Init Enum.
+		 */
+		explicit inline FMatrix3x4(EForceInit)
+		{
+			M[0][0] = 0; M[0][1] = 0; M[0][2] = 0; M[0][3] = 0;
+			M[1][0] = 0; M[1][1] = 0; M[1][2] = 0; M[1][3] = 0;
+			M[2][0] = 0; M[2][1] = 0; M[2][2] = 0; M[2][3] = 0;
+		}
+
+		/**
+		 * Constructor from an affine FMatrix. The last column of Mat is assumed to be (0,0,0,1) and ignored.
+		 *
+		 * @param Mat The matrix to copy.
+		 */
+		explicit constexpr FMatrix3x4(const FMatrix& Mat)
+			: M{
+				{ Mat.M[0][0], Mat.M[1][0], Mat.M[2][0], Mat.M[3][0] },
+				{ Mat.M[0][1], Mat.M[1][1], Mat.M[2][1], Mat.M[3][1] },
+				{ Mat.M[0][2], Mat.M[1][2], Mat.M[2][2], Mat.M[3][2] } }
+		{
+		}
+
+		/**
+		 * Constructor from a rotation and translation, same result as FQuatRotationTranslationMatrix.
+		 *
+		 * @param Q Normalized rotation.
+		 * @param Origin Translation.
+		 */
+		inline FMatrix3x4(const FQuat& Q, const FVector& Origin);
+
+		/**
+		 * Constructor from a rotation and translation, same result as FRotationTranslationMatrix.
+		 *
+		 * @param Rot Rotation.
+		 * @param Origin Translation.
+		 */
+		inline FMatrix3x4(const FRotator& Rot, const FVector& Origin)
+		{
+			SetMatrix(FRotationTranslationMatrix(Rot, Origin));
+		}
+
+		/** Set this to the identity transform. */
+		inline void SetIdentity();
+
+		/**
+		 * Copies the affine part of an FMatrix.
+		 *
+		 * @param Mat The matrix to copy, its last column is ignored.
+		 */
+		inline void SetMatrix(const FMatrix& Mat);
+
+		/** @return The equivalent 4x4 matrix. */
+		inline FMatrix ToMatrix() const;
+
+		/** @return The rotation part as a quaternion, scale is removed first. */
+		inline FQuat ToQuat() const;
+
+	public:
+
+		/**
+		 * Composes two transforms with 36 multiplies.
+		 *
+		 * @param Other The transform applied after this one.
+		 * @return The combined transform.
+		 */
+		inline FMatrix3x4 operator*(const FMatrix3x4& Other) const;
+
+		/** Composes Other after this transform, in place. */
+		inline void operator*=(const FMatrix3x4& Other);
+
+		/**
+		 * Checks whether another transform is equal to this, within specified tolerance.
+		 *
+		 * @param Other The other transform.
+		 * @param Tolerance Error Tolerance.
+		 * @return true if the transforms are equal, within specified tolerance, otherwise false.
+		 */
+		inline bool Equals(const FMatrix3x4& Other, float Tolerance = KINDA_SMALL_NUMBER) const;
+
+		/** Transforms a position (applies translation). */
+		inline FVector TransformPosition(const FVector& V) const;
+
+		/** Transforms a direction (ignores translation). */
+		inline FVector TransformVector(const FVector& V) const;
+
+		/** @return The translation. */
+		inline FVector GetOrigin() const;
+
+		/** Sets the translation. */
+		inline void SetOrigin(const FVector& NewOrigin);
+
+		/** @return The transformed axis (row of the equivalent FMatrix), including scale. */
+		inline FVector GetScaledAxis(EAxis::Type Axis) const;
+
+		/** @return Determinant of the rotation/scale part. */
+		inline float Determinant() const;
+
+	public:
+
+		/**
+		 * Inverts any affine transform (rotation, scale, shear and translation).
+		 * Like FMatrix::Inverse, a singular transform returns Identity.
+		 */
+		inline FMatrix3x4 Inverse() const;
+
+		/**
+		 * Fast inverse for rotation + non uniform scale + translation (axes must be orthogonal).
+		 * Zero scale returns Identity.
+		 */
+		inline FMatrix3x4 InverseScaled() const;
+
+		/** Fastest inverse, for rotation + translation only (axes must be orthonormal). */
+		inline FMatrix3x4 InverseRigid() const;
+
+	public:
+
+		/**
+		 * Composes arrays of transforms, Out[i] = A[i] * B[i]. Out may alias A or B.
+		 *
+		 * @param A Transforms applied first.
+		 * @param B Transforms applied second.
+		 * @param Out Receives the combined transforms.
+		 * @param Count Number of transforms.
+		 */
+		static void ComposeBatch(const FMatrix3x4* A, const FMatrix3x4* B, FMatrix3x4* Out, int32 Count);
+
+		/**
+		 * Composes every transform in an array with the same transform, Out[i] = A[i] * B. Out may alias A.
+		 */
+		static void ComposeBatch(const FMatrix3x4* A, const FMatrix3x4& B, FMatrix3x4* Out, int32 Count);
+
+		/**
+		 * Inverts an array of affine transforms, same result as Inverse(). Out may alias In.
+		 *
+		 * @param In Transforms to invert.
+		 * @param Out Receives the inverses.
+		 * @param Count Number of transforms.
+		 */
+		static void InverseBatch(const FMatrix3x4* In, FMatrix3x4* Out, int32 Count);
+
+		/**
+		 * Inverts an array of rigid transforms, same result as InverseRigid(). Out may alias In.
+		 */
+		static void InverseRigidBatch(const FMatrix3x4* In, FMatrix3x4* Out, int32 Count);
+	};
+
+	static_assert(sizeof(FMatrix3x4) == 48, "FMatrix3x4 must stay 48 bytes.");
+
+	template <> struct TIsPODType<FMatrix3x4> { enum { Value = true }; };
+
+	inline constexpr FMatrix3x4 FMatrix3x4::Identity(FMatrix::Identity);
+
+
+	/* FMatrix3x4 inline functions
+	 *****************************************************************************/
+
+	inline FMatrix3x4::FMatrix3x4(const FQuat& Q, const FVector& Origin)
+	{
+		const float x2 = Q.X + Q.X;  const float y2 = Q.Y + Q.Y;  const float z2 = Q.Z + Q.Z;
+		const float xx = Q.X * x2;   const float xy = Q.X * y2;   const float xz = Q.X * z2;
+		const float yy = Q.Y * y2;   const float yz = Q.Y * z2;   const float zz = Q.Z * z2;
+		const float wx = Q.W * x2;   const float wy = Q.W * y2;   const float wz = Q.W * z2;
+
+		M[0][0] = 1.0f - (yy + zz);	M[0][1] = xy - wz;				M[0][2] = xz + wy;			M[0][3] = Origin.X;
+		M[1][0] = xy + wz;			M[1][1] = 1.0f - (xx + zz);		M[1][2] = yz - wx;			M[1][3] = Origin.Y;
+		M[2][0] = xz - wy;			M[2][1] = yz + wx;				M[2][2] = 1.0f - (xx + yy);	M[2][3] = Origin.Z;
+	}
+
+
+	inline void FMatrix3x4::SetIdentity()
+	{
+		M[0][0] = 1; M[0][1] = 0; M[0][2] = 0; M[0][3] = 0;
+		M[1][0] = 0; M[1][1] = 1; M[1][2] = 0; M[1][3] = 0;
+		M[2][0] = 0; M[2][1] = 0; M[2][2] = 1; M[2][3] = 0;
+	}
+
+
+	inline void FMatrix3x4::SetMatrix(const FMatrix& Mat)
+	{
+		for (int32 Col = 0; Col < 3; ++Col)
+		{
+			M[Col][0] = Mat.M[0][Col];
+			M[Col][1] = Mat.M[1][Col];
+			M[Col][2] = Mat.M[2][Col];
+			M[Col][3] = Mat.M[3][Col];
+		}
+	}
+
+
+	inline FMatrix FMatrix3x4::ToMatrix() const
+	{
+		FMatrix Result;
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			Result.M[Row][0] = M[0][Row];
+			Result.M[Row][1] = M[1][Row];
+			Result.M[Row][2] = M[2][Row];
+			Result.M[Row][3] = 0.f;
+		}
+		Result.M[3][3] = 1.f;
+		return Result;
+	}
+
+
+	inline FQuat FMatrix3x4::ToQuat() const
+	{
+		return FQuat(ToMatrix().GetMatrixWithoutScale());
+	}
+
+
+	inline FMatrix3x4 FMatrix3x4::operator*(const FMatrix3x4& Other) const
+	{
+		FMatrix3x4 Result;
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			const float B0 = Other.M[Row][0];
+			const float B1 = Other.M[Row][1];
+			const float B2 = Other.M[Row][2];
+
+			Result.M[Row][0] = B0 * M[0][0] + B1 * M[1][0] + B2 * M[2][0];
+			Result.M[Row][1] = B0 * M[0][1] + B1 * M[1][1] + B2 * M[2][1];
+			Result.M[Row][2] = B0 * M[0][2] + B1 * M[1][2] + B2 * M[2][2];
+			Result.M[Row][3] = B0 * M[0][3] + B1 * M[1][3] + B2 * M[2][3] + Other.M[Row][3];
+		}
+		return Result;
+	}
+
+
+	inline void FMatrix3x4::operator*=(const FMatrix3x4& Other)
+	{
+		*this = *this * Other;
+	}
+
+
+	inline bool FMatrix3x4::Equals(const FMatrix3x4& Other, float Tolerance) const
+	{
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			for (int32 Col = 0; Col < 4; ++Col)
+			{
+				if (FMath::Abs(M[Row][Col] - Other.M[Row][Col]) > Tolerance)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+
+	inline FVector FMatrix3x4::TransformPosition(const FVector& V) const
+	{
+		return FVector(
+			M[0][0] * V.X + M[0][1] * V.Y + M[0][2] * V.Z + M[0][3],
+			M[1][0] * V.X + M[1][1] * V.Y + M[1][2] * V.Z + M[1][3],
+			M[2][0] * V.X + M[2][1] * V.Y + M[2][2] * V.Z + M[2][3]);
+	}
+
+
+	inline FVector FMatrix3x4::TransformVector(const FVector& V) const
+	{
+		return FVector(
+			M[0][0] * V.X + M[0][1] * V.Y + M[0][2] * V.Z,
+			M[1][0] * V.X + M[1][1] * V.Y + M[1][2] * V.Z,
+			M[2][0] * V.X + M[2][1] * V.Y + M[2][2] * V.Z);
+	}
+
+
+	inline FVector FMatrix3x4::GetOrigin() const
+	{
+		return FVector(M[0][3], M[1][3], M[2][3]);
+	}
+
+
+	inline void FMatrix3x4::SetOrigin(const FVector& NewOrigin)
+	{
+		M[0][3] = NewOrigin.X;
+		M[1][3] = NewOrigin.Y;
+		M[2][3] = NewOrigin.Z;
+	}
+
+
+	inline FVector FMatrix3x4::GetScaledAxis(EAxis::Type InAxis) const
+	{
+		switch (InAxis)
+		{
+		case EAxis::X:
+			return FVector(M[0][0], M[1][0], M[2][0]);
+
+		case EAxis::Y:
+			return FVector(M[0][1], M[1][1], M[2][1]);
+
+		case EAxis::Z:
+			return FVector(M[0][2], M[1][2], M[2][2]);
+
+		default:
+			ensure(0);
+			return FVector::ZeroVector;
+		}
+	}
+
+
+	inline float FMatrix3x4::Determinant() const
+	{
+		return	M[0][0] * (M[1][1] * M[2][2] - M[2][1] * M[1][2]) -
+				M[1][0] * (M[0][1] * M[2][2] - M[2][1] * M[0][2]) +
+				M[2][0] * (M[0][1] * M[1][2] - M[1][1] * M[0][2]);
+	}
+
+
+	inline FMatrix3x4 FMatrix3x4::Inverse() const
+	{
+		// Rows of the rotation/scale part of the equivalent FMatrix.
+		const FVector R0 = GetScaledAxis(EAxis::X);
+		const FVector R1 = GetScaledAxis(EAxis::Y);
+		const FVector R2 = GetScaledAxis(EAxis::Z);
+
+		// The columns of the inverse are the cross products of the rows, divided by the determinant.
+		const FVector C0 = R1 ^ R2;
+		const FVector C1 = R2 ^ R0;
+		const FVector C2 = R0 ^ R1;
+
+		const float Det = R0 | C0;
+		if (Det == 0.0f)
+		{
+			INC_MATH_COUNTER(MatrixInverseSingular);
+			return FMatrix3x4::Identity;
+		}
+
+		const float InvDet = 1.f / Det;
+		const FVector Origin = GetOrigin();
+
+		FMatrix3x4 Result;
+		const FVector* Columns[3] = { &C0, &C1, &C2 };
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			const FVector Col = *Columns[Row] * InvDet;
+			Result.M[Row][0] = Col.X;
+			Result.M[Row][1] = Col.Y;
+			Result.M[Row][2] = Col.Z;
+			Result.M[Row][3] = -(Origin | Col);
+		}
+		return Result;
+	}
+
+
+	inline FMatrix3x4 FMatrix3x4::InverseScaled() const
+	{
+		FMatrix3x4 Result;
+		const FVector Origin = GetOrigin();
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			const FVector Axis = GetScaledAxis((EAxis::Type)(EAxis::X + Row));
+			const float SizeSquared = Axis.SizeSquared();
+			if (SizeSquared < SMALL_NUMBER)
+			{
+				return FMatrix3x4::Identity;
+			}
+
+			const FVector Col = Axis * (1.f / SizeSquared);
+			Result.M[Row][0] = Col.X;
+			Result.M[Row][1] = Col.Y;
+			Result.M[Row][2] = Col.Z;
+			Result.M[Row][3] = -(Origin | Col);
+		}
+		return Result;
+	}
+
+
+	inline FMatrix3x4 FMatrix3x4::InverseRigid() const
+	{
+		FMatrix3x4 Result;
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			Result.M[Row][0] = M[0][Row];
+			Result.M[Row][1] = M[1][Row];
+			Result.M[Row][2] = M[2][Row];
+			Result.M[Row][3] = -(M[0][3] * M[0][Row] + M[1][3] * M[1][Row] + M[2][3] * M[2][Row]);
+		}
+		return Result;
+	}
+}
@@ -0,0 +1,493 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	OrientedBox.cpp: Implements the FOrientedBox structure.
+=============================================================================*/
+
+#include "Math/OrientedBox.h"
+#include "Math/Matrix3x4.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+
+namespace UE4Math
+{
+	namespace OrientedBoxPrivate
+	{
+		/** The 15 axis separating test of IntersectsBatch takes 62 cycles per box, early outs included. */
+		enum { BatchParallelMinSize = GetParallelForMinBatchSize(62) };
+
+		/**
+		 * Added to the absolute axis dot products in the separating axis test. When two edges are near parallel
+		 * their cross product is near zero and both sides of the test vanish, the epsilon keeps that from
+		 * reporting a false separation.
+		 */
+		constexpr float ParallelEpsilon = 1.e-6f;
+
+		/**
+		 * Eigen decomposition of a symmetric 3x3 matrix with cyclic Jacobi rotations.
+		 *
+		 * @param A The matrix, destroyed. Its diagonal holds the eigenvalues on return.
+		 * @param OutEigenVectors Receives the unit eigenvectors, OutEigenVectors[i] goes with A[i][i].
+		 */
+		void SymmetricEigen(float A[3][3], FVector OutEigenVectors[3])
+		{
+			float V[3][3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+
+			for (int32 Sweep = 0; Sweep < 32; ++Sweep)
+			{
+				const float OffDiagonal = FMath::Square(A[0][1]) + FMath::Square(A[0][2]) + FMath::Square(A[1][2]);
+				const float Diagonal = FMath::Square(A[0][0]) + FMath::Square(A[1][1]) + FMath::Square(A[2][2]);
+				if (OffDiagonal <= Diagonal * 1.e-12f || OffDiagonal < 1.e-30f)
+				{
+					break;
+				}
+
+				static const int32 Pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+				for (const int32* Pair : Pairs)
+				{
+					const int32 P = Pair[0];
+					const int32 Q = Pair[1];
+					if (A[P][Q] == 0.0f)
+					{
+						continue;
+					}
+
+					// Rotation that zeroes A[P][Q], see Numerical Recipes 11.1.
+					const float Theta = (A[Q][Q] - A[P][P]) / (2.0f * A[P][Q]);
+					const float T = (Theta >= 0.0f ? 1.0f : -1.0f) / (FMath::Abs(Theta) + FMath::Sqrt(Theta * Theta + 1.0f));
+					const float C = 1.0f / FMath::Sqrt(T * T + 1.0f);
+					const float S = T * C;
+
+					for (int32 K = 0; K < 3; ++K)
+					{
+						const float AKP = A[K][P];
+						const float AKQ = A[K][Q];
+						A[K][P] = C * AKP - S * AKQ;
+						A[K][Q] = S * AKP + C * AKQ;
+					}
+					for (int32 K = 0; K < 3; ++K)
+					{
+						const float APK = A[P][K];
+						const float AQK = A[Q][K];
+						A[P][K] = C * APK - S * AQK;
+						A[Q][K] = S * APK + C * AQK;
+					}
+					for (int32 K = 0; K < 3; ++K)
+					{
+						const float VKP = V[K][P];
+						const float VKQ = V[K][Q];
+						V[K][P] = C * VKP - S * VKQ;
+						V[K][Q] = S * VKP + C * VKQ;
+					}
+				}
+			}
+
+			for (int32 Index = 0; Index < 3; ++Index)
+			{
+				OutEigenVectors[Index] = FVector(V[0][Index], V[1][Index], V[2][Index]).GetSafeNormal();
+			}
+		}
+
+		/** Sets Out to the smallest box with the given axes around the points. */
+		void FitToAxes(const FVector* Points, int32 Count, const FVector& AxisX, const FVector& AxisY, const FVector& AxisZ, FOrientedBox& Out)
+		{
+			FVector Min(BIG_NUMBER);
+			FVector Max(-BIG_NUMBER);
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				const FVector Local(Points[Index] | AxisX, Points[Index] | AxisY, Points[Index] | AxisZ);
+				Min = Min.ComponentMin(Local);
+				Max = Max.ComponentMax(Local);
+			}
+
+			const FVector Mid = (Min + Max) * 0.5f;
+			const FVector Extent = (Max - Min) * 0.5f;
+
+			Out.Center = AxisX * Mid.X + AxisY * Mid.Y + AxisZ * Mid.Z;
+			Out.AxisX = AxisX;
+			Out.AxisY = AxisY;
+			Out.AxisZ = AxisZ;
+			Out.ExtentX = Extent.X;
+			Out.ExtentY = Extent.Y;
+			Out.ExtentZ = Extent.Z;
+		}
+
+		/** Scalar separating axis test, Gottschalk et al. "OBBTree" 1996. */
+		bool IntersectsScalar(const FOrientedBox& BoxA, const FOrientedBox& BoxB)
+		{
+			const FVector* AxesA[3] = { &BoxA.AxisX, &BoxA.AxisY, &BoxA.AxisZ };
+			const FVector* AxesB[3] = { &BoxB.AxisX, &BoxB.AxisY, &BoxB.AxisZ };
+			const float ExtentA[3] = { BoxA.ExtentX, BoxA.ExtentY, BoxA.ExtentZ };
+			const float ExtentB[3] = { BoxB.ExtentX, BoxB.ExtentY, BoxB.ExtentZ };
+
+			// B's axes in A's frame.
+			float R[3][3];
+			float AbsR[3][3];
+			for (int32 I = 0; I < 3; ++I)
+			{
+				for (int32 J = 0; J < 3; ++J)
+				{
+					R[I][J] = *AxesA[I] | *AxesB[J];
+					AbsR[I][J] = FMath::Abs(R[I][J]) + ParallelEpsilon;
+				}
+			}
+
+			const FVector Delta = BoxB.Center - BoxA.Center;
+			const float T[3] = { Delta | *AxesA[0], Delta | *AxesA[1], Delta | *AxesA[2] };
+
+			// A's face normals.
+			for (int32 I = 0; I < 3; ++I)
+			{
+				const float RadiusB = ExtentB[0] * AbsR[I][0] + ExtentB[1] * AbsR[I][1] + ExtentB[2] * AbsR[I][2];
+				if (FMath::Abs(T[I]) > ExtentA[I] + RadiusB)
+				{
+					return false;
+				}
+			}
+
+			// B's face normals.
+			for (int32 J = 0; J < 3; ++J)
+			{
+				const float RadiusA = ExtentA[0] * AbsR[0][J] + ExtentA[1] * AbsR[1][J] + ExtentA[2] * AbsR[2][J];
+				if (FMath::Abs(T[0] * R[0][J] + T[1] * R[1][J] + T[2] * R[2][J]) > RadiusA + ExtentB[J])
+				{
+					return false;
+				}
+			}
+
+			// Edge pairs, AxesA[I] ^ AxesB[J].
+			for (int32 I = 0; I < 3; ++I)
+			{
+				const int32 I1 = (I + 1) % 3;
+				const int32 I2 = (I + 2) % 3;
+				for (int32 J = 0; J < 3; ++J)
+				{
+					const int32 J1 = (J + 1) % 3;
+					const int32 J2 = (J + 2) % 3;
+					const float RadiusA = ExtentA[I1] * AbsR[I2][J] + ExtentA[I2] * AbsR[I1][J];
+					const float RadiusB = ExtentB[J1] * AbsR[I][J2] + ExtentB[J2] * AbsR[I][J1];
+					if (FMath::Abs(T[I2] * R[I1][J] - T[I1] * R[I2][J]) > RadiusA + RadiusB)
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+		using namespace VectorSwizzlePrivate;
+		using namespace MatrixSIMDPrivate;
+
+		/** (Ptr[0], Ptr[1], Ptr[2], 0) without reading past Ptr[2]. */
+		inline __m128 Load3(const float* Ptr)
+		{
+			return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*)Ptr)), _mm_load_ss(Ptr + 2));
+		}
+
+		inline __m128 Abs(__m128 Vec)
+		{
+			return _mm_and_ps(Vec, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+		}
+
+		/** The first box of a test, with its axes transposed so B's axes can be brought into its frame column by column. */
+		struct FSATBox
+		{
+			__m128 Center;
+			__m128 Extent;
+
+			/** (AxisX[K], AxisY[K], AxisZ[K], 0) */
+			__m128 Transposed[3];
+
+			explicit FSATBox(const FOrientedBox& Box)
+			{
+				Center = Load3(&Box.Center.X);
+				Extent = Load3(&Box.ExtentX);
+				Transposed[0] = Load3(&Box.AxisX.X);
+				Transposed[1] = Load3(&Box.AxisY.X);
+				Transposed[2] = Load3(&Box.AxisZ.X);
+				__m128 Unused = _mm_setzero_ps();
+				_MM_TRANSPOSE4_PS(Transposed[0], Transposed[1], Transposed[2], Unused);
+			}
+
+			/** Coordinates of Vec along the three axes. */
+			inline __m128 ToLocal(__m128 Vec) const
+			{
+				__m128 Result = _mm_mul_ps(Swizzle<0, 0, 0, 0>(Vec), Transposed[0]);
+				Result = MultiplyAdd(Swizzle<1, 1, 1, 1>(Vec), Transposed[1], Result);
+				return MultiplyAdd(Swizzle<2, 2, 2, 2>(Vec), Transposed[2], Result);
+			}
+		};
+
+		/**
+		 * The same 15 axis test as IntersectsScalar, with the three tests of each group in the lanes of one compare.
+		 * Rows[I] is row I of R (lanes over J) and Cols[J] column J (lanes over I).
+		 */
+		inline bool IntersectsSSE(const FSATBox& BoxA, const FOrientedBox& BoxB)
+		{
+			const __m128 Eps = _mm_set_ps(0.0f, ParallelEpsilon, ParallelEpsilon, ParallelEpsilon);
+
+			__m128 Cols[3] = {
+				BoxA.ToLocal(Load3(&BoxB.AxisX.X)),
+				BoxA.ToLocal(Load3(&BoxB.AxisY.X)),
+				BoxA.ToLocal(Load3(&BoxB.AxisZ.X))
+			};
+			const __m128 AbsCols[3] = { _mm_add_ps(Abs(Cols[0]), Eps), _mm_add_ps(Abs(Cols[1]), Eps), _mm_add_ps(Abs(Cols[2]), Eps) };
+
+			__m128 Rows[3] = { Cols[0], Cols[1], Cols[2] };
+			__m128 Unused = _mm_setzero_ps();
+			_MM_TRANSPOSE4_PS(Rows[0], Rows[1], Rows[2], Unused);
+			const __m128 AbsRows[3] = { _mm_add_ps(Abs(Rows[0]), Eps), _mm_add_ps(Abs(Rows[1]), Eps), _mm_add_ps(Abs(Rows[2]), Eps) };
+
+			const __m128 T = BoxA.ToLocal(_mm_sub_ps(Load3(&BoxB.Center.X), BoxA.Center));
+			const __m128 A = BoxA.Extent;
+			const __m128 B = Load3(&BoxB.ExtentX);
+
+			const __m128 T0 = Swizzle<0, 0, 0, 0>(T);
+			const __m128 T1 = Swizzle<1, 1, 1, 1>(T);
+			const __m128 T2 = Swizzle<2, 2, 2, 2>(T);
+			const __m128 A0 = Swizzle<0, 0, 0, 0>(A);
+			const __m128 A1 = Swizzle<1, 1, 1, 1>(A);
+			const __m128 A2 = Swizzle<2, 2, 2, 2>(A);
+
+			// A's face normals, lanes over I.
+			__m128 Radius = MultiplyAdd(Swizzle<0, 0, 0, 0>(B), AbsCols[0], A);
+			Radius = MultiplyAdd(Swizzle<1, 1, 1, 1>(B), AbsCols[1], Radius);
+			Radius = MultiplyAdd(Swizzle<2, 2, 2, 2>(B), AbsCols[2], Radius);
+			__m128 Separated = _mm_cmpgt_ps(Abs(T), Radius);
+
+			// B's face normals, lanes over J.
+			__m128 Distance = MultiplyAdd(T2, Rows[2], MultiplyAdd(T1, Rows[1], _mm_mul_ps(T0, Rows[0])));
+			Radius = MultiplyAdd(A2, AbsRows[2], MultiplyAdd(A1, AbsRows[1], MultiplyAdd(A0, AbsRows[0], B)));
+			Separated = _mm_or_ps(Separated, _mm_cmpgt_ps(Abs(Distance), Radius));
+
+			// Edge pairs, lanes over J. B's radius in lane J is B[J1] * AbsR[I][J2] + B[J2] * AbsR[I][J1], J1 and J2 being the other two lanes.
+			const __m128 BJ1 = Swizzle<1, 0, 0, 3>(B);
+			const __m128 BJ2 = Swizzle<2, 2, 1, 3>(B);
+
+			Distance = _mm_sub_ps(_mm_mul_ps(T2, Rows[1]), _mm_mul_ps(T1, Rows[2]));
+			Radius = _mm_add_ps(_mm_mul_ps(A1, AbsRows[2]), _mm_mul_ps(A2, AbsRows[1]));
+			Radius = MultiplyAdd(BJ1, Swizzle<2, 2, 1, 3>(AbsRows[0]), MultiplyAdd(BJ2, Swizzle<1, 0, 0, 3>(AbsRows[0]), Radius));
+			Separated = _mm_or_ps(Separated, _mm_cmpgt_ps(Abs(Distance), Radius));
+
+			Distance = _mm_sub_ps(_mm_mul_ps(T0, Rows[2]), _mm_mul_ps(T2, Rows[0]));
+			Radius = _mm_add_ps(_mm_mul_ps(A2, AbsRows[0]), _mm_mul_ps(A0, AbsRows[2]));
+			Radius = MultiplyAdd(BJ1, Swizzle<2, 2, 1, 3>(AbsRows[1]), MultiplyAdd(BJ2, Swizzle<1, 0, 0, 3>(AbsRows[1]), Radius));
+			Separated = _mm_or_ps(Separated, _mm_cmpgt_ps(Abs(Distance), Radius));
+
+			Distance = _mm_sub_ps(_mm_mul_ps(T1, Rows[0]), _mm_mul_ps(T0, Rows[1]));
+			Radius = _mm_add_ps(_mm_mul_ps(A0, AbsRows[1]), _mm_mul_ps(A1, AbsRows[0]));
+			Radius = MultiplyAdd(BJ1, Swizzle<2, 2, 1, 3>(AbsRows[2]), MultiplyAdd(BJ2, Swizzle<1, 0, 0, 3>(AbsRows[2]), Radius));
+			Separated = _mm_or_ps(Separated, _mm_cmpgt_ps(Abs(Distance), Radius));
+
+			return (_mm_movemask_ps(Separated) & 0x7) == 0;
+		}
+#endif
+	}
+
+
+	/* FOrientedBox structors
+	 *****************************************************************************/
+
+	FOrientedBox::FOrientedBox(const FBox& LocalBox, const FMatrix3x4& Transform)
+		: Center(Transform.TransformPosition(LocalBox.GetCenter()))
+	{
+		const FVector LocalExtent = LocalBox.GetExtent();
+		const FVector ScaledX = Transform.GetScaledAxis(EAxis::X);
+		const FVector ScaledY = Transform.GetScaledAxis(EAxis::Y);
+		const FVector ScaledZ = Transform.GetScaledAxis(EAxis::Z);
+
+		AxisX = ScaledX.GetSafeNormal();
+		AxisY = ScaledY.GetSafeNormal();
+		AxisZ = ScaledZ.GetSafeNormal();
+		ExtentX = LocalExtent.X * ScaledX.Size();
+		ExtentY = LocalExtent.Y * ScaledY.Size();
+		ExtentZ = LocalExtent.Z * ScaledZ.Size();
+	}
+
+
+	FOrientedBox::FOrientedBox(const FVector* Points, int32 Count, int32 RefineIterations)
+		: FOrientedBox()
+	{
+		if (Count <= 0)
+		{
+			ExtentX = ExtentY = ExtentZ = 0.0f;
+			return;
+		}
+
+		FVector Mean(0.0f);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Mean += Points[Index];
+		}
+		Mean /= (float)Count;
+
+		float Covariance[3][3] = {};
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const FVector D = Points[Index] - Mean;
+			Covariance[0][0] += D.X * D.X;
+			Covariance[0][1] += D.X * D.Y;
+			Covariance[0][2] += D.X * D.Z;
+			Covariance[1][1] += D.Y * D.Y;
+			Covariance[1][2] += D.Y * D.Z;
+			Covariance[2][2] += D.Z * D.Z;
+		}
+		Covariance[1][0] = Covariance[0][1];
+		Covariance[2][0] = Covariance[0][2];
+		Covariance[2][1] = Covariance[1][2];
+
+		FVector EigenVectors[3];
+		OrientedBoxPrivate::SymmetricEigen(Covariance, EigenVectors);
+
+		// Largest variance first, and a right handed basis.
+		int32 Order[3] = { 0, 1, 2 };
+		for (int32 I = 0; I < 2; ++I)
+		{
+			for (int32 J = I + 1; J < 3; ++J)
+			{
+				if (Covariance[Order[J]][Order[J]] > Covariance[Order[I]][Order[I]])
+				{
+					std::swap(Order[I], Order[J]);
+				}
+			}
+		}
+
+		const FVector PrincipalX = EigenVectors[Order[0]];
+		const FVector PrincipalY = EigenVectors[Order[1]];
+		OrientedBoxPrivate::FitToAxes(Points, Count, PrincipalX, PrincipalY, PrincipalX ^ PrincipalY, *this);
+
+		// A box maps onto itself every quarter turn, so +-45 degrees about an axis covers every orientation about it.
+		enum { AngleSteps = 4 };
+		float SearchAngle = PI * 0.25f;
+		for (int32 Iteration = 0; Iteration < RefineIterations; ++Iteration)
+		{
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				const FOrientedBox Current = *this;
+				const FVector& U = Axis == 0 ? Current.AxisY : (Axis == 1 ? Current.AxisZ : Current.AxisX);
+				const FVector& W = Axis == 0 ? Current.AxisZ : (Axis == 1 ? Current.AxisX : Current.AxisY);
+
+				for (int32 Step = -AngleSteps; Step <= AngleSteps; ++Step)
+				{
+					if (Step == 0)
+					{
+						continue;
+					}
+
+					float S, C;
+					FMath::SinCos(&S, &C, SearchAngle * (float)Step / (float)AngleSteps);
+
+					// Rotating U and W about U ^ W keeps the basis right handed.
+					const FVector NewU = U * C + W * S;
+					const FVector NewW = W * C - U * S;
+
+					FOrientedBox Candidate;
+					if (Axis == 0)
+					{
+						OrientedBoxPrivate::FitToAxes(Points, Count, Current.AxisX, NewU, NewW, Candidate);
+					}
+					else if (Axis == 1)
+					{
+						OrientedBoxPrivate::FitToAxes(Points, Count, NewW, Current.AxisY, NewU, Candidate);
+					}
+					else
+					{
+						OrientedBoxPrivate::FitToAxes(Points, Count, NewU, NewW, Current.AxisZ, Candidate);
+					}
+
+					if (Candidate.GetVolume() < GetVolume())
+					{
+						*this = Candidate;
+					}
+				}
+			}
+
+			SearchAngle *= 0.5f;
+		}
+	}
+
+
+	/* FOrientedBox interface
+	 *****************************************************************************/
+
+	bool FOrientedBox::RayIntersection(const FVector& RayOrigin, const FVector& RayDirection, float& OutTime) const
+	{
+		const FVector* Axes[3] = { &AxisX, &AxisY, &AxisZ };
+		const float Extents[3] = { ExtentX, ExtentY, ExtentZ };
+		const FVector Delta = RayOrigin - Center;
+
+		float TimeMin = 0.0f;
+		float TimeMax = BIG_NUMBER;
+
+		for (int32 Index = 0; Index < 3; ++Index)
+		{
+			const float Origin = Delta | *Axes[Index];
+			const float Direction = RayDirection | *Axes[Index];
+
+			if (FMath::Abs(Direction) < SMALL_NUMBER)
+			{
+				// Parallel to this slab, miss unless the ray starts between its planes.
+				if (FMath::Abs(Origin) > Extents[Index])
+				{
+					return false;
+				}
+				continue;
+			}
+
+			const float OneOverDirection = 1.0f / Direction;
+			float Time0 = (-Extents[Index] - Origin) * OneOverDirection;
+			float Time1 = (Extents[Index] - Origin) * OneOverDirection;
+			if (Time0 > Time1)
+			{
+				std::swap(Time0, Time1);
+			}
+
+			TimeMin = FMath::Max(TimeMin, Time0);
+			TimeMax = FMath::Min(TimeMax, Time1);
+			if (TimeMin > TimeMax)
+			{
+				return false;
+			}
+		}
+
+		OutTime = TimeMin;
+		return true;
+	}
+
+
+	bool FOrientedBox::Intersects(const FOrientedBox& Other) const
+	{
+#if PLATFORM_ALWAYS_HAS_SSE2
+		return OrientedBoxPrivate::IntersectsSSE(OrientedBoxPrivate::FSATBox(*this), Other);
+#else
+		return OrientedBoxPrivate::IntersectsScalar(*this, Other);
+#endif
+	}
+
+
+	void FOrientedBox::IntersectsBatch(const FOrientedBox* Others, bool* OutIntersects, int32 Count) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, Count);
+
+		const FOrientedBox& Box = *this;
+		ParallelForRange(Count, OrientedBoxPrivate::BatchParallelMinSize, [&Box, Others, OutIntersects](int32 Begin, int32 End)
+		{
+#if PLATFORM_ALWAYS_HAS_SSE2
+			// This box is transposed once for the whole range.
+			const OrientedBoxPrivate::FSATBox Prepared(Box);
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				OutIntersects[Index] = OrientedBoxPrivate::IntersectsSSE(Prepared, Others[Index]);
+			}
+#else
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				OutIntersects[Index] = OrientedBoxPrivate::IntersectsScalar(Box, Others[Index]);
+			}
+#endif
+		});
+	}
+}
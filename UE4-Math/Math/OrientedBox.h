@@ -0,0 +1,273 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Math/UnrealMathUtility.h"
+#include "Misc/StringBuilder.h"
+#include "Math/Vector.h"
+#include "Math/Box.h"
+
+namespace UE4Math
+{
+	struct FMatrix3x4;
+
+	/** Structure for arbitrarily oriented boxes (not necessarily axis-aligned). */
+	struct FOrientedBox
+	{
+		/** Holds the center of the box. */
+		FVector Center;
+
+		/** Holds the x-axis vector of the box. Must be a unit vector. */
+		FVector AxisX;
+
+		/** Holds the y-axis vector of the box. Must be a unit vector. */
+		FVector AxisY;
+
+		/** Holds the z-axis vector of the box. Must be a unit vector. */
+		FVector AxisZ;
+
+		/** Holds the extent of the box along its x-axis. */
+		float ExtentX;
+
+		/** Holds the extent of the box along its y-axis. */
+		float ExtentY;
+
+		/** Holds the extent of the box along its z-axis. */
+		float ExtentZ;
+
+	public:
+
+		/**
+		 * Default constructor.
+		 *
+		 * Constructs a unit-sized, origin-centered box with axes aligned to the coordinate system.
+		 */
+		FOrientedBox()
+			: Center(0.0f)
+			, AxisX(1.0f, 0.0f, 0.0f)
+			, AxisY(0.0f, 1.0f, 0.0f)
+			, AxisZ(0.0f, 0.0f, 1.0f)
+			, ExtentX(1.0f)
+			, ExtentY(1.0f)
+			, ExtentZ(1.0f)
+		{ }
+
+		/**
+		 * Creates and initializes a new instance from an axis aligned box.
+		 *
+		 * @param Box The axis aligned box.
+		 */
+		explicit FOrientedBox(const FBox& Box)
+			: Center(Box.GetCenter())
+			, AxisX(1.0f, 0.0f, 0.0f)
+			, AxisY(0.0f, 1.0f, 0.0f)
+			, AxisZ(0.0f, 0.0f, 1.0f)
+		{
+			const FVector Extent = Box.GetExtent();
+			ExtentX = Extent.X;
+			ExtentY = Extent.Y;
+			ExtentZ = Extent.Z;
+		}
+
+		/**
+		 * Creates and initializes a new instance from a local space box and the transform that places it.
+		 * Scale and shear along the transform's axes end up in the extents, the axes are normalized.
+		 *
+		 * @param LocalBox The box in local space.
+		 * @param Transform Local to world transform, its axes should be orthogonal.
+		 */
+		FOrientedBox(const FBox& LocalBox, const FMatrix3x4& Transform);
+
+		/**
+		 * Fits a box to a set of points.
+		 *
+		 * The axes are the eigenvectors of the points' covariance matrix (principal component analysis). PCA is
+		 * fast but can miss the tightest box by a wide margin for symmetric point sets, so each refinement
+		 * iteration rotates the box about each of its axes and keeps the orientation with the smallest volume.
+		 *
+		 * @param Points Points the box must contain.
+		 * @param Count Number of points, no points gives a zero sized box at the origin.
+		 * @param RefineIterations Number of refinement iterations, each one halves the angle searched.
+		 */
+		FOrientedBox(const FVector* Points, int32 Count, int32 RefineIterations = 0);
+
+	public:
+
+		/**
+		 * Fills in the Verts array with the eight vertices of the box.
+		 *
+		 * @param Verts The array to fill in with the vertices.
+		 */
+		inline void CalcVertices(FVector* Verts) const;
+
+		/**
+		 * Finds the projection interval of the box when projected onto Axis.
+		 *
+		 * @param Axis The unit vector defining the axis to project the box onto.
+		 * @param OutMin Receives the lower end of the interval.
+		 * @param OutMax Receives the upper end of the interval.
+		 */
+		inline void Project(const FVector& Axis, float& OutMin, float& OutMax) const;
+
+		/** @return The world space axis aligned box around this box. */
+		inline FBox GetBox() const;
+
+		/** @return The volume of the box. */
+		inline float GetVolume() const
+		{
+			return 8.0f * ExtentX * ExtentY * ExtentZ;
+		}
+
+		/**
+		 * Gets the point inside the box closest to a given point.
+		 *
+		 * @param Point The point.
+		 * @return Point itself when it is inside the box, otherwise the closest point on the surface.
+		 */
+		inline FVector GetClosestPointTo(const FVector& Point) const;
+
+		/**
+		 * Calculates the squared distance from a point to the box.
+		 *
+		 * @param Point The point.
+		 * @return The squared distance, zero inside the box.
+		 */
+		inline float ComputeSquaredDistanceToPoint(const FVector& Point) const
+		{
+			return (GetClosestPointTo(Point) - Point).SizeSquared();
+		}
+
+		/**
+		 * Checks whether the given location is inside this box.
+		 *
+		 * @param Point The location to test.
+		 * @return true if the location is inside the box, otherwise false.
+		 */
+		inline bool IsInside(const FVector& Point) const;
+
+		/**
+		 * Tests a ray against the box.
+		 *
+		 * @param RayOrigin Start of the ray.
+		 * @param RayDirection Direction of the ray, does not need to be normalized.
+		 * @param OutTime Receives the entry time in units of RayDirection, zero when the ray starts inside the box.
+		 * @return true if the ray hits the box.
+		 */
+		bool RayIntersection(const FVector& RayOrigin, const FVector& RayDirection, float& OutTime) const;
+
+		/**
+		 * Tests whether this box overlaps another, using the separating axis test on the 15 candidate axes.
+		 *
+		 * @param Other The other box.
+		 * @return true if the boxes overlap.
+		 */
+		bool Intersects(const FOrientedBox& Other) const;
+
+		/**
+		 * Tests this box against an array of boxes.
+		 *
+		 * @param Others Boxes to test against.
+		 * @param OutIntersects Receives Intersects(Others[i]) for each box.
+		 * @param Count Number of boxes.
+		 */
+		void IntersectsBatch(const FOrientedBox* Others, bool* OutIntersects, int32 Count) const;
+
+		/**
+		 * Get a textual representation of the box.
+		 *
+		 * @return Text describing the box.
+		 */
+		std::string ToString() const
+		{
+			TStringBuilder<256> Builder;
+			AppendString(Builder);
+			return Builder.ToString();
+		}
+
+		/**
+		 * Appends a textual representation of this box to a string builder without allocating.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const
+		{
+			Out << "Center=(";
+			Center.AppendString(Out);
+			Out << ") AxisX=(";
+			AxisX.AppendString(Out);
+			Out << ") AxisY=(";
+			AxisY.AppendString(Out);
+			Out << ") AxisZ=(";
+			AxisZ.AppendString(Out);
+			Out << ") Extent=(" << ExtentX << " " << ExtentY << " " << ExtentZ << ")";
+		}
+	};
+
+
+	/* FOrientedBox inline functions
+	 *****************************************************************************/
+
+	inline void FOrientedBox::CalcVertices(FVector* Verts) const
+	{
+		static const float Signs[] = { -1.0f, 1.0f };
+
+		for (int32 i = 0; i < 2; i++)
+		{
+			for (int32 j = 0; j < 2; j++)
+			{
+				for (int32 k = 0; k < 2; k++)
+				{
+					*Verts++ = Center + Signs[i] * AxisX * ExtentX + Signs[j] * AxisY * ExtentY + Signs[k] * AxisZ * ExtentZ;
+				}
+			}
+		}
+	}
+
+
+	inline void FOrientedBox::Project(const FVector& Axis, float& OutMin, float& OutMax) const
+	{
+		const float ProjectedCenter = Axis | Center;
+		const float ProjectedRadius =
+			FMath::Abs(Axis | AxisX) * ExtentX +
+			FMath::Abs(Axis | AxisY) * ExtentY +
+			FMath::Abs(Axis | AxisZ) * ExtentZ;
+
+		OutMin = ProjectedCenter - ProjectedRadius;
+		OutMax = ProjectedCenter + ProjectedRadius;
+	}
+
+
+	inline FBox FOrientedBox::GetBox() const
+	{
+		const FVector Extent(
+			FMath::Abs(AxisX.X) * ExtentX + FMath::Abs(AxisY.X) * ExtentY + FMath::Abs(AxisZ.X) * ExtentZ,
+			FMath::Abs(AxisX.Y) * ExtentX + FMath::Abs(AxisY.Y) * ExtentY + FMath::Abs(AxisZ.Y) * ExtentZ,
+			FMath::Abs(AxisX.Z) * ExtentX + FMath::Abs(AxisY.Z) * ExtentY + FMath::Abs(AxisZ.Z) * ExtentZ);
+
+		return FBox(Center - Extent, Center + Extent);
+	}
+
+
+	inline FVector FOrientedBox::GetClosestPointTo(const FVector& Point) const
+	{
+		const FVector Delta = Point - Center;
+
+		return Center
+			+ AxisX * FMath::Clamp(Delta | AxisX, -ExtentX, ExtentX)
+			+ AxisY * FMath::Clamp(Delta | AxisY, -ExtentY, ExtentY)
+			+ AxisZ * FMath::Clamp(Delta | AxisZ, -ExtentZ, ExtentZ);
+	}
+
+
+	inline bool FOrientedBox::IsInside(const FVector& Point) const
+	{
+		const FVector Delta = Point - Center;
+
+		return FMath::Abs(Delta | AxisX) <= ExtentX
+			&& FMath::Abs(Delta | AxisY) <= ExtentY
+			&& FMath::Abs(Delta | AxisZ) <= ExtentZ;
+	}
+
+
+	template <> struct TIsPODType<FOrientedBox> { enum { Value = true }; };
+}
@@ -45,7 +45,7 @@ namespace UE4Math
 		 * @param InZ Z-coefficient.
 		 * @param InW W-coefficient.
 		 */
-		inline FPlane(float InX, float InY, float InZ, float InW);
+		constexpr FPlane(float InX, float InY, float InZ, float InW);
 
 		/**
 		 * Constructor.
@@ -341,7 +341,7 @@ namespace UE4Math
 	{}
 
 
-	inline FPlane::FPlane(float InX, float InY, float InZ, float InW)
+	constexpr FPlane::FPlane(float InX, float InY, float InZ, float InW)
 		: FVector(InX, InY, InZ)
 		, W(InW)
 	{}
@@ -0,0 +1,289 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	PolygonClipping.cpp: Sutherland-Hodgman polygon clipping against planes.
+=============================================================================*/
+
+#include "Math/PolygonClipping.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+
+namespace UE4Math
+{
+	namespace PolygonClippingPrivate
+	{
+		/** Clipping a triangle against the six planes of a box takes 90 cycles, most are accepted or rejected whole. */
+		enum { BatchParallelMinSize = GetParallelForMinBatchSize(90) };
+
+		/** Most vertices a triangle clipped against every batch plane can have. */
+		enum { MaxBatchVertices = 3 + FPolygonClipping::MaxBatchPlanes };
+
+		/** @return The point where the edge between a vertex behind the plane and one in front of it crosses the plane. */
+		inline FVector IntersectEdge(const FVector& Behind, float BehindDist, const FVector& Front, float FrontDist)
+		{
+			return Behind + (Front - Behind) * (BehindDist / (BehindDist - FrontDist));
+		}
+
+		/** @return true if any vertex is in front of the plane. */
+		inline bool IsAnyVertexInFront(const FVector* Vertices, int32 NumVertices, const FPlane& Plane)
+		{
+			for (int32 Index = 0; Index < NumVertices; ++Index)
+			{
+				if (Plane.PlaneDot(Vertices[Index]) > 0.0f)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		 * Clips a polygon against a plane. Vertices on the plane are kept as they are, so a polygon touching the
+		 * plane does not grow a duplicated vertex.
+		 *
+		 * @return Number of vertices written, or INDEX_NONE if they did not fit.
+		 */
+		int32 ClipAgainstPlane(const FVector* Vertices, int32 NumVertices, const FPlane& Plane, FVector* OutVertices, int32 MaxOutVertices)
+		{
+			int32 NumOut = 0;
+			FVector Previous = Vertices[NumVertices - 1];
+			float PreviousDist = Plane.PlaneDot(Previous);
+
+			for (int32 Index = 0; Index < NumVertices; ++Index)
+			{
+				const FVector& Current = Vertices[Index];
+				const float CurrentDist = Plane.PlaneDot(Current);
+
+				if ((PreviousDist < 0.0f && CurrentDist > 0.0f) || (PreviousDist > 0.0f && CurrentDist < 0.0f))
+				{
+					if (NumOut == MaxOutVertices)
+					{
+						return INDEX_NONE;
+					}
+					OutVertices[NumOut++] = PreviousDist < 0.0f
+						? IntersectEdge(Previous, PreviousDist, Current, CurrentDist)
+						: IntersectEdge(Current, CurrentDist, Previous, PreviousDist);
+				}
+
+				if (CurrentDist <= 0.0f)
+				{
+					if (NumOut == MaxOutVertices)
+					{
+						return INDEX_NONE;
+					}
+					OutVertices[NumOut++] = Current;
+				}
+
+				Previous = Current;
+				PreviousDist = CurrentDist;
+			}
+
+			return NumOut;
+		}
+
+		/**
+		 * Planes of a triangle batch in groups of four, one register per plane component. Padding planes have a
+		 * zero normal and a positive W, everything is behind them.
+		 */
+		struct FBatchPlanes
+		{
+			alignas(16) float X[FPolygonClipping::MaxBatchPlanes];
+			alignas(16) float Y[FPolygonClipping::MaxBatchPlanes];
+			alignas(16) float Z[FPolygonClipping::MaxBatchPlanes];
+			alignas(16) float W[FPolygonClipping::MaxBatchPlanes];
+			int32 NumGroups;
+
+			FBatchPlanes(const FPlane* Planes, int32 NumPlanes)
+			{
+				NumGroups = (NumPlanes + 3) / 4;
+				for (int32 Index = 0; Index < NumGroups * 4; ++Index)
+				{
+					const FPlane Plane = Index < NumPlanes ? Planes[Index] : FPlane(0.0f, 0.0f, 0.0f, 1.0f);
+					X[Index] = Plane.X;
+					Y[Index] = Plane.Y;
+					Z[Index] = Plane.Z;
+					W[Index] = Plane.W;
+				}
+			}
+		};
+
+		/**
+		 * Classifies a triangle against every batch plane.
+		 *
+		 * @param OutStraddleMask Receives one bit per plane with a vertex in front of it.
+		 * @param OutCullMask Receives one bit per plane with all three vertices in front of it.
+		 */
+		inline void ClassifyTriangle(const FBatchPlanes& Planes, const FVector* Triangle, uint32& OutStraddleMask, uint32& OutCullMask)
+		{
+			uint32 StraddleMask = 0;
+			uint32 CullMask = 0;
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+			const __m128 Zero = _mm_setzero_ps();
+			for (int32 Group = 0; Group < Planes.NumGroups; ++Group)
+			{
+				const __m128 PX = _mm_load_ps(Planes.X + Group * 4);
+				const __m128 PY = _mm_load_ps(Planes.Y + Group * 4);
+				const __m128 PZ = _mm_load_ps(Planes.Z + Group * 4);
+				const __m128 PW = _mm_load_ps(Planes.W + Group * 4);
+
+				__m128 AnyInFront = Zero;
+				__m128 AllInFront = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (int32 Corner = 0; Corner < 3; ++Corner)
+				{
+					const FVector& Vertex = Triangle[Corner];
+					__m128 Dist = _mm_mul_ps(PX, _mm_set1_ps(Vertex.X));
+					Dist = _mm_add_ps(Dist, _mm_mul_ps(PY, _mm_set1_ps(Vertex.Y)));
+					Dist = _mm_add_ps(Dist, _mm_mul_ps(PZ, _mm_set1_ps(Vertex.Z)));
+					Dist = _mm_sub_ps(Dist, PW);
+
+					const __m128 InFront = _mm_cmpgt_ps(Dist, Zero);
+					AnyInFront = _mm_or_ps(AnyInFront, InFront);
+					AllInFront = _mm_and_ps(AllInFront, InFront);
+				}
+
+				StraddleMask |= (uint32)_mm_movemask_ps(AnyInFront) << (Group * 4);
+				CullMask |= (uint32)_mm_movemask_ps(AllInFront) << (Group * 4);
+			}
+#else
+			for (int32 Index = 0; Index < Planes.NumGroups * 4; ++Index)
+			{
+				const FPlane Plane(Planes.X[Index], Planes.Y[Index], Planes.Z[Index], Planes.W[Index]);
+				const bool bInFront0 = Plane.PlaneDot(Triangle[0]) > 0.0f;
+				const bool bInFront1 = Plane.PlaneDot(Triangle[1]) > 0.0f;
+				const bool bInFront2 = Plane.PlaneDot(Triangle[2]) > 0.0f;
+				StraddleMask |= (uint32)(bInFront0 || bInFront1 || bInFront2) << Index;
+				CullMask |= (uint32)(bInFront0 && bInFront1 && bInFront2) << Index;
+			}
+#endif
+
+			OutStraddleMask = StraddleMask;
+			OutCullMask = CullMask;
+		}
+	}
+
+
+	int32 FPolygonClipping::ClipPolygon(const FVector* Vertices, int32 NumVertices, const FPlane& Plane, FVector* OutVertices, int32 MaxOutVertices)
+	{
+		if (NumVertices < 3)
+		{
+			return 0;
+		}
+
+		const int32 NumOut = PolygonClippingPrivate::ClipAgainstPlane(Vertices, NumVertices, Plane, OutVertices, MaxOutVertices);
+		return ensure(NumOut != INDEX_NONE) && NumOut >= 3 ? NumOut : 0;
+	}
+
+
+	int32 FPolygonClipping::ClipPolygon(const FVector* Vertices, int32 NumVertices, const FPlane* Planes, int32 NumPlanes, FVector* OutVertices, FVector* ScratchVertices, int32 MaxOutVertices)
+	{
+		using namespace PolygonClippingPrivate;
+
+		if (NumVertices < 3 || !ensure(NumVertices <= MaxOutVertices))
+		{
+			return 0;
+		}
+
+		// Ping-pong between the two buffers, planes the polygon is entirely behind are skipped without a copy.
+		const FVector* Source = Vertices;
+		int32 NumSource = NumVertices;
+		for (int32 PlaneIndex = 0; PlaneIndex < NumPlanes; ++PlaneIndex)
+		{
+			if (!IsAnyVertexInFront(Source, NumSource, Planes[PlaneIndex]))
+			{
+				continue;
+			}
+
+			FVector* Dest = Source == OutVertices ? ScratchVertices : OutVertices;
+			NumSource = ClipAgainstPlane(Source, NumSource, Planes[PlaneIndex], Dest, MaxOutVertices);
+			if (!ensure(NumSource != INDEX_NONE) || NumSource < 3)
+			{
+				return 0;
+			}
+			Source = Dest;
+		}
+
+		if (Source != OutVertices)
+		{
+			for (int32 Index = 0; Index < NumSource; ++Index)
+			{
+				OutVertices[Index] = Source[Index];
+			}
+		}
+		return NumSource;
+	}
+
+
+	int32 FPolygonClipping::GetFrustumPlanes(const FMatrix& ViewProjectionMatrix, FPlane OutPlanes[6])
+	{
+		int32 NumPlanes = 0;
+		NumPlanes += ViewProjectionMatrix.GetFrustumNearPlane(OutPlanes[NumPlanes]) ? 1 : 0;
+		NumPlanes += ViewProjectionMatrix.GetFrustumLeftPlane(OutPlanes[NumPlanes]) ? 1 : 0;
+		NumPlanes += ViewProjectionMatrix.GetFrustumRightPlane(OutPlanes[NumPlanes]) ? 1 : 0;
+		NumPlanes += ViewProjectionMatrix.GetFrustumTopPlane(OutPlanes[NumPlanes]) ? 1 : 0;
+		NumPlanes += ViewProjectionMatrix.GetFrustumBottomPlane(OutPlanes[NumPlanes]) ? 1 : 0;
+		NumPlanes += ViewProjectionMatrix.GetFrustumFarPlane(OutPlanes[NumPlanes]) ? 1 : 0;
+		return NumPlanes;
+	}
+
+
+	int32 FPolygonClipping::ClipPolygonToFrustum(const FMatrix& ViewProjectionMatrix, const FVector* Vertices, int32 NumVertices, FVector* OutVertices, FVector* ScratchVertices, int32 MaxOutVertices)
+	{
+		FPlane Planes[6];
+		const int32 NumPlanes = GetFrustumPlanes(ViewProjectionMatrix, Planes);
+		return ClipPolygon(Vertices, NumVertices, Planes, NumPlanes, OutVertices, ScratchVertices, MaxOutVertices);
+	}
+
+
+	void FPolygonClipping::ClipTrianglesBatch(const FVector* Vertices, int32 NumTriangles, const FPlane* Planes, int32 NumPlanes, FVector* OutVertices, int32* OutNumVertices)
+	{
+		using namespace PolygonClippingPrivate;
+
+		if (!ensure(NumPlanes >= 0 && NumPlanes <= MaxBatchPlanes))
+		{
+			return;
+		}
+
+		SCOPE_MATH_CYCLE_COUNTER(ClipBatch);
+		INC_MATH_COUNTER_BY(ClipBatchElements, NumTriangles);
+
+		const FBatchPlanes BatchPlanes(Planes, NumPlanes);
+		const int32 Stride = 3 + NumPlanes;
+
+		ParallelForRange(NumTriangles, BatchParallelMinSize, [&BatchPlanes, Vertices, Planes, Stride, OutVertices, OutNumVertices](int32 Begin, int32 End)
+		{
+			FPlane StraddledPlanes[MaxBatchPlanes];
+			FVector Scratch[MaxBatchVertices];
+
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const FVector* Triangle = Vertices + Index * 3;
+				FVector* OutTriangle = OutVertices + Index * Stride;
+
+				uint32 StraddleMask, CullMask;
+				ClassifyTriangle(BatchPlanes, Triangle, StraddleMask, CullMask);
+
+				if (CullMask != 0)
+				{
+					OutNumVertices[Index] = 0;
+				}
+				else if (StraddleMask == 0)
+				{
+					OutTriangle[0] = Triangle[0];
+					OutTriangle[1] = Triangle[1];
+					OutTriangle[2] = Triangle[2];
+					OutNumVertices[Index] = 3;
+				}
+				else
+				{
+					int32 NumStraddled = 0;
+					for (uint32 Mask = StraddleMask; Mask != 0; Mask &= Mask - 1)
+					{
+						StraddledPlanes[NumStraddled++] = Planes[FMath::CountTrailingZeros(Mask)];
+					}
+					OutNumVertices[Index] = FPolygonClipping::ClipPolygon(Triangle, 3, StraddledPlanes, NumStraddled, OutTriangle, Scratch, Stride);
+				}
+			}
+		});
+	}
+}
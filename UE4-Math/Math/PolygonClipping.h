@@ -0,0 +1,114 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+#include "Math/Plane.h"
+#include "Math/Matrix.h"
+
+namespace UE4Math
+{
+	/**
+	 * Sutherland-Hodgman clipping of polygons against planes.
+	 *
+	 * Clipping keeps the part of a polygon behind each plane, where PlaneDot <= 0. That is the inside of a convex
+	 * volume given by outward facing planes, such as the ones FMatrix::GetFrustum*Plane return. Polygons may be
+	 * concave, a concave polygon that a plane cuts into several pieces comes out as one polygon whose pieces are
+	 * joined by edges lying in the plane.
+	 *
+	 * Nothing allocates, the caller provides the output buffers. A new vertex is always interpolated from the
+	 * vertex behind the plane towards the one in front, so an edge shared by two polygons is cut at the same point
+	 * for both whatever its direction, and clipped meshes stay watertight.
+	 */
+	struct FPolygonClipping
+	{
+		/** Most planes ClipTrianglesBatch clips against. */
+		enum { MaxBatchPlanes = 16 };
+
+		/**
+		 * Upper bound on the number of vertices of a polygon clipped by several planes, to size the buffers with.
+		 *
+		 * A plane adds at most one vertex to a convex polygon, so convex polygons never need more than
+		 * NumVertices + NumPlanes. A concave polygon can grow by half its vertices per plane, which is the bound
+		 * returned here.
+		 *
+		 * @param NumVertices Number of vertices of the polygon.
+		 * @param NumPlanes Number of planes it is clipped against.
+		 */
+		static inline int32 GetMaxClippedVertices(int32 NumVertices, int32 NumPlanes)
+		{
+			for (int32 PlaneIndex = 0; PlaneIndex < NumPlanes; ++PlaneIndex)
+			{
+				NumVertices += NumVertices / 2;
+			}
+			return NumVertices;
+		}
+
+		/**
+		 * Clips a polygon against one plane.
+		 *
+		 * @param Vertices The polygon.
+		 * @param NumVertices Number of vertices.
+		 * @param Plane Only the part of the polygon behind the plane is kept.
+		 * @param OutVertices Receives the clipped polygon, may not overlap Vertices.
+		 * @param MaxOutVertices Capacity of OutVertices, NumVertices + NumVertices / 2 is always enough.
+		 * @return Number of vertices written, zero when less than a triangle is left.
+		 */
+		static int32 ClipPolygon(const FVector* Vertices, int32 NumVertices, const FPlane& Plane, FVector* OutVertices, int32 MaxOutVertices);
+
+		/**
+		 * Clips a polygon against several planes in turn.
+		 *
+		 * @param Vertices The polygon.
+		 * @param NumVertices Number of vertices.
+		 * @param Planes Only the part of the polygon behind every plane is kept.
+		 * @param NumPlanes Number of planes.
+		 * @param OutVertices Receives the clipped polygon, may not overlap Vertices.
+		 * @param ScratchVertices Working buffer with the same capacity as OutVertices.
+		 * @param MaxOutVertices Capacity of OutVertices and ScratchVertices, see GetMaxClippedVertices.
+		 * @return Number of vertices written, zero when less than a triangle is left.
+		 */
+		static int32 ClipPolygon(const FVector* Vertices, int32 NumVertices, const FPlane* Planes, int32 NumPlanes, FVector* OutVertices, FVector* ScratchVertices, int32 MaxOutVertices);
+
+		/**
+		 * Gets the planes of a view frustum, facing outwards.
+		 *
+		 * Planes the matrix does not define, such as the far plane of an infinite projection, are left out.
+		 *
+		 * @param ViewProjectionMatrix The frustum, world to clip space.
+		 * @param OutPlanes Receives up to six planes.
+		 * @return Number of planes written.
+		 */
+		static int32 GetFrustumPlanes(const FMatrix& ViewProjectionMatrix, FPlane OutPlanes[6]);
+
+		/**
+		 * Clips a polygon to a view frustum.
+		 *
+		 * @param ViewProjectionMatrix The frustum, world to clip space.
+		 * @param Vertices The polygon.
+		 * @param NumVertices Number of vertices.
+		 * @param OutVertices Receives the clipped polygon, may not overlap Vertices.
+		 * @param ScratchVertices Working buffer with the same capacity as OutVertices.
+		 * @param MaxOutVertices Capacity of OutVertices and ScratchVertices, see GetMaxClippedVertices with six planes.
+		 * @return Number of vertices written, zero when the polygon is outside the frustum.
+		 */
+		static int32 ClipPolygonToFrustum(const FMatrix& ViewProjectionMatrix, const FVector* Vertices, int32 NumVertices, FVector* OutVertices, FVector* ScratchVertices, int32 MaxOutVertices);
+
+		/**
+		 * Clips many triangles against the same planes.
+		 *
+		 * Every triangle is first classified against all planes at once, triangles fully behind them are copied
+		 * and triangles fully in front of one of them are dropped without clipping. The rest are only clipped
+		 * against the planes they straddle.
+		 *
+		 * @param Vertices Three vertices per triangle.
+		 * @param NumTriangles Number of triangles.
+		 * @param Planes Only the part of the triangles behind every plane is kept.
+		 * @param NumPlanes Number of planes, at most MaxBatchPlanes.
+		 * @param OutVertices Receives the clipped triangle I at OutVertices + I * (3 + NumPlanes).
+		 * @param OutNumVertices Receives the number of vertices of each clipped triangle, zero when nothing is left.
+		 */
+		static void ClipTrianglesBatch(const FVector* Vertices, int32 NumTriangles, const FPlane* Planes, int32 NumPlanes, FVector* OutVertices, int32* OutNumVertices);
+	};
+}
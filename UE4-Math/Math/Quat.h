@@ -6,6 +6,8 @@
 //#include "Misc/AssertionMacros.h"
 #include "Math/UnrealMathUtility.h"
 //#include "Containers/UnrealString.h"
+#include "Misc/StringBuilder.h"
+#include "Misc/Parse.h"
 //#include "Logging/LogMacros.h"
 #include "Math/Vector.h"
 #include "Math/VectorRegister.h"
@@ -18,6 +20,7 @@ namespace UE4Math
 
 	/**
 	 * Floating point quaternion that can represent a rotation about an axis in 3-D space.
+	 * This is FQuat, the float specialization of TQuat; see LargeWorldCoordinates.h for double precision.
 	 * The X, Y, Z, W components also double as the Axis/Angle format.
 	 *
 	 * Order matters when composing quaternions: C = A * B will yield a quaternion C that logically
@@ -27,7 +30,8 @@ namespace UE4Math
 	 * Example: LocalToWorld = (LocalToWorld * DeltaRotation) will change rotation in local space by DeltaRotation.
 	 * Example: LocalToWorld = (DeltaRotation * LocalToWorld) will change rotation in world space by DeltaRotation.
 	 */
-	struct FQuat
+	template<>
+	struct TQuat<float>
 	{
 	public:
 
@@ -51,14 +55,22 @@ namespace UE4Math
 	public:
 
 		/** Default constructor (no initialization). */
-		inline FQuat() { }
+		inline TQuat() { }
 
 		/**
 		 * Creates and initializes a new quaternion, with the W component either 0 or 1.
 		 *
 		 * @param EForceInit Force init enum: if equal to ForceInitToZero then W is 0, otherwise W = 1 (creating an identity transform)
 		 */
-		explicit inline FQuat(EForceInit);
+		explicit inline TQuat(EForceInit);
+
+		/**
+		 * Constructor narrowing a double precision quaternion, rounding each component to nearest.
+		 * Defined in LargeWorldCoordinates.h.
+		 *
+		 * @param Q Quaternion to convert.
+		 */
+		explicit TQuat(const FQuat4d& Q);
 
 		/**
 		 * Constructor.
@@ -68,21 +80,21 @@ namespace UE4Math
 		 * @param InZ Z component of the quaternion
 		 * @param InW W component of the quaternion
 		 */
-		inline FQuat(float InX, float InY, float InZ, float InW);
+		constexpr TQuat(float InX, float InY, float InZ, float InW);
 
 		/**
 		 * Creates and initializes a new quaternion from the given matrix.
 		 *
 		 * @param M The rotation matrix to initialize from.
 		 */
-		explicit FQuat(const FMatrix& M);
+		explicit TQuat(const FMatrix& M);
 
 		/**
 		 * Creates and initializes a new quaternion from the given rotator.
 		 *
 		 * @param R The rotator to initialize from.
 		 */
-		explicit FQuat(const FRotator& R);
+		explicit TQuat(const FRotator& R);
 
 		/**
 		 * Creates and initializes a new quaternion from the a rotation around the given axis.
@@ -90,7 +102,7 @@ namespace UE4Math
 		 * @param Axis assumed to be a normalized vector
 		 * @param Angle angle to rotate above the given axis (in radians)
 		 */
-		FQuat(FVector Axis, float AngleRad);
+		TQuat(FVector Axis, float AngleRad);
 
 	public:
 
@@ -423,6 +435,23 @@ namespace UE4Math
 		 */
 		std::string ToString() const;
 
+		/**
+		 * Appends a textual representation of this quaternion to a string builder without allocating.
+		 * Components are written in the shortest form that parses back to the same value.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const;
+
+		/**
+		 * Initialize this FQuat from a string. The string is expected to contain X=, Y=, Z=, W=.
+		 * The FQuat will be bogus when InitFromString returns false.
+		 *
+		 * @param InSourceString String containing the quaternion values.
+		 * @return true if the X,Y,Z,W values were read successfully; false otherwise.
+		 */
+		bool InitFromString(std::string_view InSourceString);
+
 
 	public:
 
@@ -431,22 +460,24 @@ namespace UE4Math
 		{
 			if (ContainsNaN())
 			{
-				logOrEnsureNanError(TEXT("FQuat contains NaN: %s"), *ToString());
+				INC_MATH_COUNTER(NaNQuat);
+				FMathValidation::ReportNaN("DiagnosticCheckNaN", "FQuat", 0, ToString());
 				*const_cast<FQuat*>(this) = FQuat::Identity;
 			}
 		}
 
-		inline void DiagnosticCheckNaN(const TCHAR* Message) const
+		inline void DiagnosticCheckNaN(const char* Message) const
 		{
 			if (ContainsNaN())
 			{
-				logOrEnsureNanError(TEXT("%s: FQuat contains NaN: %s"), Message, *ToString());
+				INC_MATH_COUNTER(NaNQuat);
+				FMathValidation::ReportNaN(Message, "FQuat", 0, ToString());
 				*const_cast<FQuat*>(this) = FQuat::Identity;
 			}
 		}
 #else
-		inline void DiagnosticCheckNaN() const {}
-		inline void DiagnosticCheckNaN(const char* Message) const {}
+		inline void DiagnosticCheckNaN() const { INC_MATH_COUNTER_IF(NaNQuat, ContainsNaN()); }
+		inline void DiagnosticCheckNaN(const char* Message) const { INC_MATH_COUNTER_IF(NaNQuat, ContainsNaN()); }
 #endif
 
 	public:
@@ -553,7 +584,7 @@ namespace UE4Math
 	/* FQuat inline functions
 	 *****************************************************************************/
 
-	inline FQuat::FQuat(const FMatrix& M)
+	inline FQuat::TQuat(const FMatrix& M)
 	{
 		// If Matrix is NULL, return Identity quaternion. If any of them is 0, you won't be able to construct rotation
 		// if you have two plane at least, we can reconstruct the frame using cross product, but that's a bit expensive op to do here
@@ -628,7 +659,7 @@ namespace UE4Math
 	}
 
 
-	inline FQuat::FQuat(const FRotator& R)
+	inline FQuat::TQuat(const FRotator& R)
 	{
 		*this = R.Quaternion();
 		DiagnosticCheckNaN();
@@ -664,29 +695,49 @@ namespace UE4Math
 	/* FQuat inline functions
 	 *****************************************************************************/
 
-	inline FQuat::FQuat(EForceInit ZeroOrNot)
+	inline FQuat::TQuat(EForceInit ZeroOrNot)
 		: X(0), Y(0), Z(0), W(ZeroOrNot == ForceInitToZero ? 0.0f : 1.0f)
 	{ }
 
 
-	inline FQuat::FQuat(float InX, float InY, float InZ, float InW)
+	constexpr FQuat::TQuat(float InX, float InY, float InZ, float InW)
 		: X(InX)
 		, Y(InY)
 		, Z(InZ)
 		, W(InW)
 	{
-		DiagnosticCheckNaN();
+		if (!UE_IS_CONSTANT_EVALUATED())
+		{
+			DiagnosticCheckNaN();
+		}
 	}
 
 
+	inline constexpr FQuat FQuat::Identity(0, 0, 0, 1);
+
+
 	inline std::string FQuat::ToString() const
 	{
-		char stemp[200] = "";
-		snprintf(stemp, 200, "X=%.9f Y=%.9f Z=%.9f W=%.9f", X, Y, Z, W);
-		return std::string(stemp);
+		TStringBuilder<96> Builder;
+		AppendString(Builder);
+		return Builder.ToString();
 		//return FString::Printf(TEXT("X=%.9f Y=%.9f Z=%.9f W=%.9f"), X, Y, Z, W);
 	}
 
+	inline void FQuat::AppendString(FStringBuilderBase& Out) const
+	{
+		Out << "X=" << X << " Y=" << Y << " Z=" << Z << " W=" << W;
+	}
+
+	inline bool FQuat::InitFromString(std::string_view InSourceString)
+	{
+		X = Y = Z = W = 0;
+
+		const bool bSuccessful = FParse::Value(InSourceString, "X=", X) && FParse::Value(InSourceString, "Y=", Y) && FParse::Value(InSourceString, "Z=", Z) && FParse::Value(InSourceString, "W=", W);
+
+		return bSuccessful;
+	}
+
 #ifdef IMPLEMENT_ASSIGNMENT_OPERATOR_MANUALLY
 	inline FQuat& FQuat::operator=(const FQuat& Other)
 	{
@@ -700,7 +751,7 @@ namespace UE4Math
 #endif
 
 
-	inline FQuat::FQuat(FVector Axis, float AngleRad)
+	inline FQuat::TQuat(FVector Axis, float AngleRad)
 	{
 		const float half_a = 0.5f * AngleRad;
 		float s, c;
@@ -876,6 +927,7 @@ namespace UE4Math
 
 		const VectorRegister SquareSum = VectorDot4(Vector, Vector);
 		const VectorRegister NonZeroMask = VectorCompareGE(SquareSum, VectorLoadFloat1(&Tolerance));
+		INC_MATH_COUNTER_IF(QuatNormalizeFallback, VectorGetComponent(SquareSum, 0) < Tolerance);
 		const VectorRegister InvLength = VectorReciprocalSqrtAccurate(SquareSum);
 		const VectorRegister NormalizedVector = VectorMultiply(InvLength, Vector);
 		VectorRegister Result = VectorSelect(NonZeroMask, NormalizedVector, GlobalVectorConstants::Float0001);
@@ -895,6 +947,7 @@ namespace UE4Math
 		}
 		else
 		{
+			INC_MATH_COUNTER(QuatNormalizeFallback);
 			*this = FQuat::Identity;
 		}
 #endif // PLATFORM_ENABLE_VECTORINTRINSICS
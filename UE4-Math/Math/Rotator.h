@@ -41,22 +41,24 @@ namespace UE4Math
 		{
 			if (ContainsNaN())
 			{
-				logOrEnsureNanError(TEXT("FRotator contains NaN: %s"), *ToString());
+				INC_MATH_COUNTER(NaNRotator);
+				FMathValidation::ReportNaN("DiagnosticCheckNaN", "FRotator", 0, ToString());
 				*const_cast<FRotator*>(this) = ZeroRotator;
 			}
 		}
 
-		inline void DiagnosticCheckNaN(const TCHAR* Message) const
+		inline void DiagnosticCheckNaN(const char* Message) const
 		{
 			if (ContainsNaN())
 			{
-				logOrEnsureNanError(TEXT("%s: FRotator contains NaN: %s"), Message, *ToString());
+				INC_MATH_COUNTER(NaNRotator);
+				FMathValidation::ReportNaN(Message, "FRotator", 0, ToString());
 				*const_cast<FRotator*>(this) = ZeroRotator;
 			}
 		}
 #else
-		inline void DiagnosticCheckNaN() const {}
-		inline void DiagnosticCheckNaN(const char* Message) const {}
+		inline void DiagnosticCheckNaN() const { INC_MATH_COUNTER_IF(NaNRotator, ContainsNaN()); }
+		inline void DiagnosticCheckNaN(const char* Message) const { INC_MATH_COUNTER_IF(NaNRotator, ContainsNaN()); }
 #endif
 
 		/**
@@ -69,7 +71,7 @@ namespace UE4Math
 		 *
 		 * @param InF Value to set all components to.
 		 */
-		explicit inline FRotator(float InF);
+		explicit constexpr FRotator(float InF);
 
 		/**
 		 * Constructor.
@@ -78,7 +80,7 @@ namespace UE4Math
 		 * @param InYaw Yaw in degrees.
 		 * @param InRoll Roll in degrees.
 		 */
-		inline FRotator(float InPitch, float InYaw, float InRoll);
+		constexpr FRotator(float InPitch, float InYaw, float InRoll);
 
 		/**
 		 * Constructor.
@@ -416,20 +418,29 @@ namespace UE4Math
 	}
 
 
-	inline FRotator::FRotator(float InF)
+	constexpr FRotator::FRotator(float InF)
 		: Pitch(InF), Yaw(InF), Roll(InF)
 	{
-		DiagnosticCheckNaN();
+		if (!UE_IS_CONSTANT_EVALUATED())
+		{
+			DiagnosticCheckNaN();
+		}
 	}
 
 
-	inline FRotator::FRotator(float InPitch, float InYaw, float InRoll)
+	constexpr FRotator::FRotator(float InPitch, float InYaw, float InRoll)
 		: Pitch(InPitch), Yaw(InYaw), Roll(InRoll)
 	{
-		DiagnosticCheckNaN();
+		if (!UE_IS_CONSTANT_EVALUATED())
+		{
+			DiagnosticCheckNaN();
+		}
 	}
 
 
+	inline constexpr FRotator FRotator::ZeroRotator(0.f, 0.f, 0.f);
+
+
 	inline FRotator::FRotator(EForceInit)
 		: Pitch(0), Yaw(0), Roll(0)
 	{}
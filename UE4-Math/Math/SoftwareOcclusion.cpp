@@ -0,0 +1,553 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	SoftwareOcclusion.cpp: CPU depth rasterizer and HiZ occlusion queries.
+=============================================================================*/
+
+#include "Math/SoftwareOcclusion.h"
+#include "Math/PolygonClipping.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+#include <algorithm>
+
+namespace UE4Math
+{
+	namespace SoftwareOcclusionPrivate
+	{
+		/** A query projects eight corners and reads up to 4x4 HiZ texels, 340 cycles. */
+		enum { BatchParallelMinSize = GetParallelForMinBatchSize(340) };
+
+		/** Triangles are clipped at this clip space W, and boxes reaching closer are always visible. */
+		constexpr float NearClipW = 1.e-3f;
+
+		/**
+		 * Triangles reaching further off screen than this many half screens are clipped before setup, which keeps
+		 * the edge functions of huge triangles within float precision.
+		 */
+		constexpr float GuardBand = 4.0f;
+
+		/** Triangles covering less than this many square pixels are dropped. */
+		constexpr float MinTriangleArea = 1.e-4f;
+
+		/**
+		 * Planes bounding the part of a mesh that is set up without clipping, in the mesh's local space: in front of
+		 * the near plane and within the guard band.
+		 */
+		void GetClipPlanes(const FMatrix& LocalToClip, FPlane OutPlanes[5])
+		{
+			const FVector4 ClipX(LocalToClip.M[0][0], LocalToClip.M[1][0], LocalToClip.M[2][0], LocalToClip.M[3][0]);
+			const FVector4 ClipY(LocalToClip.M[0][1], LocalToClip.M[1][1], LocalToClip.M[2][1], LocalToClip.M[3][1]);
+			const FVector4 ClipW(LocalToClip.M[0][3], LocalToClip.M[1][3], LocalToClip.M[2][3], LocalToClip.M[3][3]);
+
+			// Each plane is a linear function of the clip space position that is positive outside, PlaneDot subtracts W.
+			auto MakePlane = [](const FVector4& Outside)
+			{
+				return FPlane(Outside.X, Outside.Y, Outside.Z, -Outside.W);
+			};
+
+			OutPlanes[0] = MakePlane(FVector4(0.0f, 0.0f, 0.0f, NearClipW) - ClipW);
+			OutPlanes[1] = MakePlane(ClipX - ClipW * GuardBand);
+			OutPlanes[2] = MakePlane(ClipX * -1.0f - ClipW * GuardBand);
+			OutPlanes[3] = MakePlane(ClipY - ClipW * GuardBand);
+			OutPlanes[4] = MakePlane(ClipY * -1.0f - ClipW * GuardBand);
+		}
+
+		/** @return true if the clip space vertex can be set up without clipping. */
+		inline bool IsInsideGuardBand(const FVector4& V)
+		{
+			const float Band = V.W * GuardBand;
+			return V.W >= NearClipW && FMath::Abs(V.X) <= Band && FMath::Abs(V.Y) <= Band;
+		}
+
+		/** @return true if all three clip space vertices are outside the same side of the view frustum. */
+		inline bool IsTriangleOffScreen(const FVector4& V0, const FVector4& V1, const FVector4& V2)
+		{
+			return (V0.X > V0.W && V1.X > V1.W && V2.X > V2.W)
+				|| (V0.X < -V0.W && V1.X < -V1.W && V2.X < -V2.W)
+				|| (V0.Y > V0.W && V1.Y > V1.W && V2.Y > V2.W)
+				|| (V0.Y < -V0.W && V1.Y < -V1.W && V2.Y < -V2.W)
+				|| (V0.W < NearClipW && V1.W < NearClipW && V2.W < NearClipW);
+		}
+	}
+
+
+	FSoftwareOcclusionBuffer::FSoftwareOcclusionBuffer(int32 InWidth, int32 InHeight)
+		: ViewProjectionMatrix(FMatrix::Identity)
+	{
+		NumTilesX = FMath::Max((InWidth + TileSize - 1) / TileSize, 1);
+		NumTilesY = FMath::Max((InHeight + TileSize - 1) / TileSize, 1);
+		Width = NumTilesX * TileSize;
+		Height = NumTilesY * TileSize;
+
+		for (int32 Level = 0; ; ++Level)
+		{
+			DepthLevels.emplace_back(GetLevelWidth(Level) * GetLevelHeight(Level), 0.0f);
+			if (GetLevelWidth(Level) == 1 && GetLevelHeight(Level) == 1)
+			{
+				break;
+			}
+		}
+
+		TileBinStarts.resize(NumTilesX * NumTilesY + 1, 0);
+	}
+
+
+	void FSoftwareOcclusionBuffer::BeginFrame(const FMatrix& InViewProjectionMatrix)
+	{
+		ViewProjectionMatrix = InViewProjectionMatrix;
+		Triangles.clear();
+		for (std::vector<float>& Level : DepthLevels)
+		{
+			std::fill(Level.begin(), Level.end(), 0.0f);
+		}
+	}
+
+
+	void FSoftwareOcclusionBuffer::AddOccluder(const FVector* Vertices, int32 NumVertices, const int32* Indices, int32 NumIndices, const FMatrix& LocalToWorld)
+	{
+		using namespace SoftwareOcclusionPrivate;
+
+		const FMatrix LocalToClip = LocalToWorld * ViewProjectionMatrix;
+		ClipVertices.resize(NumVertices);
+		for (int32 Index = 0; Index < NumVertices; ++Index)
+		{
+			ClipVertices[Index] = LocalToClip.TransformFVector4(FVector4(Vertices[Index], 1.0f));
+		}
+
+		FPlane ClipPlanes[5];
+		bool bHasClipPlanes = false;
+
+		for (int32 Index = 0; Index + 3 <= NumIndices; Index += 3)
+		{
+			const FVector4& V0 = ClipVertices[Indices[Index]];
+			const FVector4& V1 = ClipVertices[Indices[Index + 1]];
+			const FVector4& V2 = ClipVertices[Indices[Index + 2]];
+
+			if (IsTriangleOffScreen(V0, V1, V2))
+			{
+				continue;
+			}
+
+			if (IsInsideGuardBand(V0) && IsInsideGuardBand(V1) && IsInsideGuardBand(V2))
+			{
+				SetupTriangle(V0, V1, V2);
+				continue;
+			}
+
+			// Clip in local space and set up the pieces as a fan.
+			if (!bHasClipPlanes)
+			{
+				GetClipPlanes(LocalToClip, ClipPlanes);
+				bHasClipPlanes = true;
+			}
+
+			const FVector Triangle[3] = { Vertices[Indices[Index]], Vertices[Indices[Index + 1]], Vertices[Indices[Index + 2]] };
+			FVector Clipped[8];
+			FVector Scratch[8];
+			const int32 NumClipped = FPolygonClipping::ClipPolygon(Triangle, 3, ClipPlanes, 5, Clipped, Scratch, 8);
+
+			FVector4 ClippedClip[8];
+			for (int32 Vertex = 0; Vertex < NumClipped; ++Vertex)
+			{
+				ClippedClip[Vertex] = LocalToClip.TransformFVector4(FVector4(Clipped[Vertex], 1.0f));
+			}
+			for (int32 Vertex = 2; Vertex < NumClipped; ++Vertex)
+			{
+				SetupTriangle(ClippedClip[0], ClippedClip[Vertex - 1], ClippedClip[Vertex]);
+			}
+		}
+	}
+
+
+	void FSoftwareOcclusionBuffer::SetupTriangle(const FVector4& V0, const FVector4& V1, const FVector4& V2)
+	{
+		using namespace SoftwareOcclusionPrivate;
+
+		// Clip space to pixels, Y down.
+		const FVector4* Clip[3] = { &V0, &V1, &V2 };
+		float X[3], Y[3], Depth[3];
+		for (int32 Vertex = 0; Vertex < 3; ++Vertex)
+		{
+			Depth[Vertex] = 1.0f / Clip[Vertex]->W;
+			X[Vertex] = (Clip[Vertex]->X * Depth[Vertex] * 0.5f + 0.5f) * Width;
+			Y[Vertex] = (0.5f - Clip[Vertex]->Y * Depth[Vertex] * 0.5f) * Height;
+		}
+
+		float Det = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+		if (FMath::Abs(Det) < 2.0f * MinTriangleArea)
+		{
+			return;
+		}
+
+		// Occluders are two sided, back facing triangles are turned around.
+		if (Det < 0.0f)
+		{
+			std::swap(X[1], X[2]);
+			std::swap(Y[1], Y[2]);
+			std::swap(Depth[1], Depth[2]);
+			Det = -Det;
+		}
+
+		// Pixel centers are at half integers.
+		const int32 MinX = FMath::Max(FMath::CeilToInt(FMath::Min3(X[0], X[1], X[2]) - 0.5f), 0);
+		const int32 MinY = FMath::Max(FMath::CeilToInt(FMath::Min3(Y[0], Y[1], Y[2]) - 0.5f), 0);
+		const int32 MaxX = FMath::Min(FMath::FloorToInt(FMath::Max3(X[0], X[1], X[2]) - 0.5f), Width - 1);
+		const int32 MaxY = FMath::Min(FMath::FloorToInt(FMath::Max3(Y[0], Y[1], Y[2]) - 0.5f), Height - 1);
+		if (MinX > MaxX || MinY > MaxY)
+		{
+			return;
+		}
+
+		FSetupTriangle Triangle;
+		for (int32 Edge = 0; Edge < 3; ++Edge)
+		{
+			const int32 Next = Edge < 2 ? Edge + 1 : 0;
+			Triangle.EdgeA[Edge] = Y[Edge] - Y[Next];
+			Triangle.EdgeB[Edge] = X[Next] - X[Edge];
+			Triangle.EdgeC[Edge] = -(Triangle.EdgeA[Edge] * X[Edge] + Triangle.EdgeB[Edge] * Y[Edge]);
+		}
+
+		const float OneOverDet = 1.0f / Det;
+		const float Depth10 = Depth[1] - Depth[0];
+		const float Depth20 = Depth[2] - Depth[0];
+		Triangle.DepthA = (Depth10 * (Y[2] - Y[0]) - Depth20 * (Y[1] - Y[0])) * OneOverDet;
+		Triangle.DepthB = (Depth20 * (X[1] - X[0]) - Depth10 * (X[2] - X[0])) * OneOverDet;
+		Triangle.DepthC = Depth[0] - Triangle.DepthA * X[0] - Triangle.DepthB * Y[0];
+		Triangle.MaxDepth = FMath::Max3(Depth[0], Depth[1], Depth[2]);
+		Triangle.Bounds = FIntRect(MinX, MinY, MaxX + 1, MaxY + 1);
+
+		Triangles.push_back(Triangle);
+	}
+
+
+	void FSoftwareOcclusionBuffer::FinishOccluders()
+	{
+		SCOPE_MATH_CYCLE_COUNTER(OcclusionRaster);
+		INC_MATH_COUNTER_BY(OcclusionRasterTriangles, (int32)Triangles.size());
+
+		// Counting sort of the triangles by the tiles their bounds touch. After the fill pass every start has moved
+		// to the end of its bin, shifting them by one puts them back.
+		const int32 NumTiles = NumTilesX * NumTilesY;
+		std::fill(TileBinStarts.begin(), TileBinStarts.end(), 0);
+		for (const FSetupTriangle& Triangle : Triangles)
+		{
+			for (int32 TileY = Triangle.Bounds.Min.Y / TileSize; TileY <= (Triangle.Bounds.Max.Y - 1) / TileSize; ++TileY)
+			{
+				for (int32 TileX = Triangle.Bounds.Min.X / TileSize; TileX <= (Triangle.Bounds.Max.X - 1) / TileSize; ++TileX)
+				{
+					++TileBinStarts[TileY * NumTilesX + TileX];
+				}
+			}
+		}
+
+		int32 NumBinned = 0;
+		for (int32 Tile = 0; Tile < NumTiles; ++Tile)
+		{
+			const int32 Count = TileBinStarts[Tile];
+			TileBinStarts[Tile] = NumBinned;
+			NumBinned += Count;
+		}
+
+		BinnedTriangles.resize(NumBinned);
+		for (int32 TriangleIndex = 0; TriangleIndex < (int32)Triangles.size(); ++TriangleIndex)
+		{
+			const FIntRect& Bounds = Triangles[TriangleIndex].Bounds;
+			for (int32 TileY = Bounds.Min.Y / TileSize; TileY <= (Bounds.Max.Y - 1) / TileSize; ++TileY)
+			{
+				for (int32 TileX = Bounds.Min.X / TileSize; TileX <= (Bounds.Max.X - 1) / TileSize; ++TileX)
+				{
+					BinnedTriangles[TileBinStarts[TileY * NumTilesX + TileX]++] = TriangleIndex;
+				}
+			}
+		}
+
+		for (int32 Tile = NumTiles; Tile > 0; --Tile)
+		{
+			TileBinStarts[Tile] = TileBinStarts[Tile - 1];
+		}
+		TileBinStarts[0] = 0;
+
+		// Tiles own their pixels and their part of the first HiZ levels, so they need no synchronization.
+		ParallelFor(NumTiles, 1, [this](int32 TileIndex)
+		{
+			RasterizeTile(TileIndex);
+		});
+
+		// The levels above one texel per tile are small, they are built on this thread.
+		for (int32 Level = NumTileLevels; Level < GetNumLevels(); ++Level)
+		{
+			const std::vector<float>& Source = DepthLevels[Level - 1];
+			const int32 SourceWidth = GetLevelWidth(Level - 1);
+			const int32 SourceHeight = GetLevelHeight(Level - 1);
+			std::vector<float>& Dest = DepthLevels[Level];
+			const int32 DestWidth = GetLevelWidth(Level);
+			const int32 DestHeight = GetLevelHeight(Level);
+
+			for (int32 Y = 0; Y < DestHeight; ++Y)
+			{
+				const int32 Y0 = Y * 2;
+				const int32 Y1 = FMath::Min(Y0 + 1, SourceHeight - 1);
+				for (int32 X = 0; X < DestWidth; ++X)
+				{
+					const int32 X0 = X * 2;
+					const int32 X1 = FMath::Min(X0 + 1, SourceWidth - 1);
+					Dest[Y * DestWidth + X] = FMath::Min(
+						FMath::Min(Source[Y0 * SourceWidth + X0], Source[Y0 * SourceWidth + X1]),
+						FMath::Min(Source[Y1 * SourceWidth + X0], Source[Y1 * SourceWidth + X1]));
+				}
+			}
+		}
+	}
+
+
+	void FSoftwareOcclusionBuffer::RasterizeTile(int32 TileIndex)
+	{
+		const int32 TileMinX = (TileIndex % NumTilesX) * TileSize;
+		const int32 TileMinY = (TileIndex / NumTilesX) * TileSize;
+		float* Depth = DepthLevels[0].data();
+
+		for (int32 BinIndex = TileBinStarts[TileIndex]; BinIndex < TileBinStarts[TileIndex + 1]; ++BinIndex)
+		{
+			const FSetupTriangle& Triangle = Triangles[BinnedTriangles[BinIndex]];
+			const int32 MinX = FMath::Max(Triangle.Bounds.Min.X, TileMinX);
+			const int32 MinY = FMath::Max(Triangle.Bounds.Min.Y, TileMinY);
+			const int32 MaxX = FMath::Min(Triangle.Bounds.Max.X, TileMinX + TileSize);
+			const int32 MaxY = FMath::Min(Triangle.Bounds.Max.Y, TileMinY + TileSize);
+
+			// The HiZ must not hide anything the triangle does not, so a pixel stores the farthest depth of the plane
+			// over its whole square rather than the depth at its center, half a pixel away along X and Y.
+			const float FootprintDepth = 0.5f * (FMath::Abs(Triangle.DepthA) + FMath::Abs(Triangle.DepthB));
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+			// Four pixels at a time from a multiple of four, the tile is a multiple of four wide so the extra pixels
+			// on the left stay in the tile, and they are outside the triangle.
+			const __m128 EdgeA0 = _mm_set1_ps(Triangle.EdgeA[0]);
+			const __m128 EdgeA1 = _mm_set1_ps(Triangle.EdgeA[1]);
+			const __m128 EdgeA2 = _mm_set1_ps(Triangle.EdgeA[2]);
+			const __m128 DepthA = _mm_set1_ps(Triangle.DepthA);
+			const __m128 MaxDepth = _mm_set1_ps(Triangle.MaxDepth);
+			const __m128 Footprint = _mm_set1_ps(FootprintDepth);
+			const __m128 PixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+			const __m128 Zero = _mm_setzero_ps();
+			const int32 AlignedMinX = MinX & ~3;
+
+			for (int32 Y = MinY; Y < MaxY; ++Y)
+			{
+				const float CenterY = Y + 0.5f;
+				const __m128 RowEdge0 = _mm_set1_ps(Triangle.EdgeB[0] * CenterY + Triangle.EdgeC[0]);
+				const __m128 RowEdge1 = _mm_set1_ps(Triangle.EdgeB[1] * CenterY + Triangle.EdgeC[1]);
+				const __m128 RowEdge2 = _mm_set1_ps(Triangle.EdgeB[2] * CenterY + Triangle.EdgeC[2]);
+				const __m128 RowDepth = _mm_sub_ps(_mm_set1_ps(Triangle.DepthB * CenterY + Triangle.DepthC), Footprint);
+				float* Row = Depth + Y * Width;
+
+				for (int32 X = AlignedMinX; X < MaxX; X += 4)
+				{
+					const __m128 CenterX = _mm_add_ps(_mm_set1_ps((float)X), PixelOffsets);
+					const __m128 Edge0 = _mm_add_ps(_mm_mul_ps(EdgeA0, CenterX), RowEdge0);
+					const __m128 Edge1 = _mm_add_ps(_mm_mul_ps(EdgeA1, CenterX), RowEdge1);
+					const __m128 Edge2 = _mm_add_ps(_mm_mul_ps(EdgeA2, CenterX), RowEdge2);
+					const __m128 Inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(Edge0, Zero), _mm_cmpge_ps(Edge1, Zero)), _mm_cmpge_ps(Edge2, Zero));
+					if (_mm_movemask_ps(Inside) == 0)
+					{
+						continue;
+					}
+
+					const __m128 PixelDepth = _mm_min_ps(_mm_add_ps(_mm_mul_ps(DepthA, CenterX), RowDepth), MaxDepth);
+					const __m128 OldDepth = _mm_loadu_ps(Row + X);
+					const __m128 NewDepth = _mm_max_ps(OldDepth, PixelDepth);
+					_mm_storeu_ps(Row + X, _mm_or_ps(_mm_and_ps(Inside, NewDepth), _mm_andnot_ps(Inside, OldDepth)));
+				}
+			}
+#else
+			for (int32 Y = MinY; Y < MaxY; ++Y)
+			{
+				const float CenterY = Y + 0.5f;
+				float* Row = Depth + Y * Width;
+				for (int32 X = MinX; X < MaxX; ++X)
+				{
+					const float CenterX = X + 0.5f;
+					if (Triangle.EdgeA[0] * CenterX + Triangle.EdgeB[0] * CenterY + Triangle.EdgeC[0] >= 0.0f
+						&& Triangle.EdgeA[1] * CenterX + Triangle.EdgeB[1] * CenterY + Triangle.EdgeC[1] >= 0.0f
+						&& Triangle.EdgeA[2] * CenterX + Triangle.EdgeB[2] * CenterY + Triangle.EdgeC[2] >= 0.0f)
+					{
+						const float PixelDepth = FMath::Min(Triangle.DepthA * CenterX + Triangle.DepthB * CenterY + Triangle.DepthC - FootprintDepth, Triangle.MaxDepth);
+						Row[X] = FMath::Max(Row[X], PixelDepth);
+					}
+				}
+			}
+#endif
+		}
+
+		// HiZ levels within the tile, each texel keeps the farthest of its four children.
+		for (int32 Level = 1; Level < NumTileLevels; ++Level)
+		{
+			const float* Source = DepthLevels[Level - 1].data();
+			float* Dest = DepthLevels[Level].data();
+			const int32 SourceWidth = GetLevelWidth(Level - 1);
+			const int32 DestWidth = GetLevelWidth(Level);
+			const int32 LevelTileSize = TileSize >> Level;
+			const int32 DestMinX = TileMinX >> Level;
+			const int32 DestMinY = TileMinY >> Level;
+
+			for (int32 Y = DestMinY; Y < DestMinY + LevelTileSize; ++Y)
+			{
+				const float* Row0 = Source + (Y * 2) * SourceWidth;
+				const float* Row1 = Row0 + SourceWidth;
+				for (int32 X = DestMinX; X < DestMinX + LevelTileSize; ++X)
+				{
+					Dest[Y * DestWidth + X] = FMath::Min(FMath::Min(Row0[X * 2], Row0[X * 2 + 1]), FMath::Min(Row1[X * 2], Row1[X * 2 + 1]));
+				}
+			}
+		}
+	}
+
+
+	bool FSoftwareOcclusionBuffer::ProjectBox(const FBox& Box, FIntRect& OutRect, float& OutNearestDepth) const
+	{
+		using namespace SoftwareOcclusionPrivate;
+
+		// Clip space corners, X * Row0 + Y * Row1 + Z * Row2 + Row3 with each coordinate from Min or Max.
+		alignas(16) float Corners[8][4];
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+		const __m128 Row0 = _mm_loadu_ps(ViewProjectionMatrix.M[0]);
+		const __m128 Row1 = _mm_loadu_ps(ViewProjectionMatrix.M[1]);
+		const __m128 Row2 = _mm_loadu_ps(ViewProjectionMatrix.M[2]);
+		const __m128 Row3 = _mm_loadu_ps(ViewProjectionMatrix.M[3]);
+		const __m128 PartX[2] = { _mm_mul_ps(_mm_set1_ps(Box.Min.X), Row0), _mm_mul_ps(_mm_set1_ps(Box.Max.X), Row0) };
+		const __m128 PartY[2] = { _mm_mul_ps(_mm_set1_ps(Box.Min.Y), Row1), _mm_mul_ps(_mm_set1_ps(Box.Max.Y), Row1) };
+		const __m128 PartZ[2] = { _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Box.Min.Z), Row2), Row3), _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Box.Max.Z), Row2), Row3) };
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			_mm_store_ps(Corners[Corner], _mm_add_ps(_mm_add_ps(PartX[Corner & 1], PartY[(Corner >> 1) & 1]), PartZ[Corner >> 2]));
+		}
+#else
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			const FVector Point((Corner & 1) ? Box.Max.X : Box.Min.X, (Corner & 2) ? Box.Max.Y : Box.Min.Y, (Corner & 4) ? Box.Max.Z : Box.Min.Z);
+			for (int32 Component = 0; Component < 4; ++Component)
+			{
+				Corners[Corner][Component] = Point.X * ViewProjectionMatrix.M[0][Component] + Point.Y * ViewProjectionMatrix.M[1][Component]
+					+ Point.Z * ViewProjectionMatrix.M[2][Component] + ViewProjectionMatrix.M[3][Component];
+			}
+		}
+#endif
+
+		int32 NumBehind = 0;
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			NumBehind += Corners[Corner][3] < NearClipW ? 1 : 0;
+		}
+
+		if (NumBehind == 8)
+		{
+			OutRect = FIntRect();
+			OutNearestDepth = 0.0f;
+			return true;
+		}
+		else if (NumBehind > 0)
+		{
+			return false;
+		}
+
+		float MinW = BIG_NUMBER;
+		float MinX = BIG_NUMBER, MinY = BIG_NUMBER;
+		float MaxX = -BIG_NUMBER, MaxY = -BIG_NUMBER;
+		for (int32 Corner = 0; Corner < 8; ++Corner)
+		{
+			const float W = Corners[Corner][3];
+			const float OneOverW = 1.0f / W;
+			const float X = Corners[Corner][0] * OneOverW;
+			const float Y = Corners[Corner][1] * OneOverW;
+			MinW = FMath::Min(MinW, W);
+			MinX = FMath::Min(MinX, X);
+			MaxX = FMath::Max(MaxX, X);
+			MinY = FMath::Min(MinY, Y);
+			MaxY = FMath::Max(MaxY, Y);
+		}
+
+		// Every pixel the projected bounds touch, Y down. Clamped before the conversion so far off screen
+		// coordinates do not overflow.
+		const float PixelMinX = FMath::Clamp((MinX * 0.5f + 0.5f) * Width, -1.0f, (float)Width);
+		const float PixelMaxX = FMath::Clamp((MaxX * 0.5f + 0.5f) * Width, -1.0f, (float)Width);
+		const float PixelMinY = FMath::Clamp((0.5f - MaxY * 0.5f) * Height, -1.0f, (float)Height);
+		const float PixelMaxY = FMath::Clamp((0.5f - MinY * 0.5f) * Height, -1.0f, (float)Height);
+
+		OutRect.Min.X = FMath::Max(FMath::FloorToInt(PixelMinX), 0);
+		OutRect.Min.Y = FMath::Max(FMath::FloorToInt(PixelMinY), 0);
+		OutRect.Max.X = FMath::Min(FMath::FloorToInt(PixelMaxX) + 1, Width);
+		OutRect.Max.Y = FMath::Min(FMath::FloorToInt(PixelMaxY) + 1, Height);
+		if (PixelMaxX < 0.0f || PixelMinX >= Width || PixelMaxY < 0.0f || PixelMinY >= Height)
+		{
+			OutRect = FIntRect();
+		}
+
+		// W is linear over the box, so its closest point is one of the corners.
+		OutNearestDepth = 1.0f / MinW;
+		return true;
+	}
+
+
+	bool FSoftwareOcclusionBuffer::IsVisible(const FBox& Box) const
+	{
+		FIntRect Rect;
+		float NearestDepth;
+		if (!ProjectBox(Box, Rect, NearestDepth))
+		{
+			return true;
+		}
+
+		if (Rect.IsEmpty())
+		{
+			return false;
+		}
+
+		// Occluders only cover the pixels whose centers they contain, so a box ending just past an occluder's edge
+		// can project entirely into pixels it covers. Growing the rectangle by a pixel reaches the neighbors that
+		// show what is behind.
+		Rect.Min.X = FMath::Max(Rect.Min.X - 1, 0);
+		Rect.Min.Y = FMath::Max(Rect.Min.Y - 1, 0);
+		Rect.Max.X = FMath::Min(Rect.Max.X + 1, Width);
+		Rect.Max.Y = FMath::Min(Rect.Max.Y + 1, Height);
+
+		// The coarsest level the rectangle spans at most 4x4 texels of.
+		const int32 LastX = Rect.Max.X - 1;
+		const int32 LastY = Rect.Max.Y - 1;
+		int32 Level = 0;
+		while (Level + 1 < GetNumLevels() && ((LastX >> Level) - (Rect.Min.X >> Level) > 3 || (LastY >> Level) - (Rect.Min.Y >> Level) > 3))
+		{
+			++Level;
+		}
+
+		const float* Texels = DepthLevels[Level].data();
+		const int32 LevelWidth = GetLevelWidth(Level);
+		for (int32 Y = Rect.Min.Y >> Level; Y <= (LastY >> Level); ++Y)
+		{
+			for (int32 X = Rect.Min.X >> Level; X <= (LastX >> Level); ++X)
+			{
+				// Visible as soon as one texel has no occluder in front of the box.
+				if (Texels[Y * LevelWidth + X] <= NearestDepth)
+				{
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+
+	void FSoftwareOcclusionBuffer::IsVisibleBatch(const FBox* Boxes, bool* OutVisible, int32 Count) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, Count);
+
+		const FSoftwareOcclusionBuffer& Buffer = *this;
+		ParallelForRange(Count, SoftwareOcclusionPrivate::BatchParallelMinSize, [&Buffer, Boxes, OutVisible](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				OutVisible[Index] = Buffer.IsVisible(Boxes[Index]);
+			}
+		});
+	}
+}
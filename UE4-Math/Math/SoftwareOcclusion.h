@@ -0,0 +1,192 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+#include "Math/Vector4.h"
+#include "Math/Box.h"
+#include "Math/IntRect.h"
+#include "Math/Matrix.h"
+
+namespace UE4Math
+{
+	/**
+	 * Low resolution depth buffer rasterized on the CPU, for occlusion culling without a GPU.
+	 *
+	 * Occluder triangles are queued with AddOccluder and drawn by FinishOccluders: the screen is cut into tiles,
+	 * every triangle is binned to the tiles its bounds touch and each tile is rasterized by one thread, four
+	 * pixels at a time with SIMD edge functions. Each tile then builds its part of a hierarchical depth buffer
+	 * (HiZ) in which every texel holds the farthest depth of the texels below it.
+	 *
+	 * Occludees are tested by projecting their bounds to a screen rectangle and comparing their nearest depth
+	 * against the HiZ level where the rectangle covers at most 4x4 texels.
+	 *
+	 * Depth is stored as 1 / W in clip space, which is linear in screen space and makes larger values closer.
+	 * That works with any perspective projection whatever its Z mapping, but not with orthographic ones. Pixels
+	 * no occluder covers hold zero, infinitely far away.
+	 *
+	 * A frame is BeginFrame, any number of AddOccluder, FinishOccluders, then any number of visibility queries.
+	 */
+	class FSoftwareOcclusionBuffer
+	{
+	public:
+		/** Width and height of a tile in pixels, a power of two. */
+		enum { TileSize = 32 };
+
+		/** Number of HiZ levels a tile builds on its own, the last one has a single texel per tile. */
+		enum { NumTileLevels = 6 };
+
+		/**
+		 * Creates a buffer.
+		 *
+		 * @param InWidth Width in pixels, rounded up to a whole number of tiles.
+		 * @param InHeight Height in pixels, rounded up to a whole number of tiles.
+		 */
+		FSoftwareOcclusionBuffer(int32 InWidth, int32 InHeight);
+
+		/**
+		 * Clears the buffer and starts a new frame.
+		 *
+		 * @param InViewProjectionMatrix World to clip space.
+		 */
+		void BeginFrame(const FMatrix& InViewProjectionMatrix);
+
+		/**
+		 * Queues an indexed triangle mesh to be drawn by FinishOccluders. Triangles are drawn from both sides and
+		 * clipped against the near plane, so occluders may surround or touch the viewer.
+		 *
+		 * @param Vertices Vertex positions.
+		 * @param NumVertices Number of vertices.
+		 * @param Indices Three vertex indices per triangle.
+		 * @param NumIndices Number of indices.
+		 * @param LocalToWorld Transform of the vertices.
+		 */
+		void AddOccluder(const FVector* Vertices, int32 NumVertices, const int32* Indices, int32 NumIndices, const FMatrix& LocalToWorld = FMatrix::Identity);
+
+		/** Rasterizes the queued occluders and builds the HiZ. */
+		void FinishOccluders();
+
+		/**
+		 * Projects a box to the screen.
+		 *
+		 * @param Box The box in world space.
+		 * @param OutRect Receives the pixels the box may cover clamped to the screen, empty if the box is off screen or
+		 *                entirely behind the viewer.
+		 * @param OutNearestDepth Receives the depth of the point of the box closest to the viewer, as 1 / W.
+		 * @return false if the box straddles the near plane and cannot be projected.
+		 */
+		bool ProjectBox(const FBox& Box, FIntRect& OutRect, float& OutNearestDepth) const;
+
+		/**
+		 * Tests whether a box may be visible. Boxes off screen are not, boxes straddling the near plane always are.
+		 *
+		 * @param Box The box in world space.
+		 * @return false if the box is hidden behind the occluders.
+		 */
+		bool IsVisible(const FBox& Box) const;
+
+		/**
+		 * Tests many boxes, in parallel.
+		 *
+		 * @param Boxes The boxes in world space.
+		 * @param OutVisible Receives IsVisible(Boxes[i]) for each box.
+		 * @param Count Number of boxes.
+		 */
+		void IsVisibleBatch(const FBox* Boxes, bool* OutVisible, int32 Count) const;
+
+		/**
+		 * Gets a texel of the HiZ.
+		 *
+		 * @param X Column in the level.
+		 * @param Y Row in the level.
+		 * @param Level Zero for pixels, each level above halves the resolution.
+		 * @return The farthest depth under the texel as 1 / W, zero where nothing was drawn.
+		 */
+		inline float GetDepth(int32 X, int32 Y, int32 Level = 0) const
+		{
+			return DepthLevels[Level][Y * GetLevelWidth(Level) + X];
+		}
+
+		/** @return Width of the buffer in pixels. */
+		inline int32 GetWidth() const
+		{
+			return Width;
+		}
+
+		/** @return Height of the buffer in pixels. */
+		inline int32 GetHeight() const
+		{
+			return Height;
+		}
+
+		/** @return Number of HiZ levels, the last one is a single texel. */
+		inline int32 GetNumLevels() const
+		{
+			return (int32)DepthLevels.size();
+		}
+
+		/** @return Width of a HiZ level in texels. */
+		inline int32 GetLevelWidth(int32 Level) const
+		{
+			return FMath::Max((Width + (1 << Level) - 1) >> Level, 1);
+		}
+
+		/** @return Height of a HiZ level in texels. */
+		inline int32 GetLevelHeight(int32 Level) const
+		{
+			return FMath::Max((Height + (1 << Level) - 1) >> Level, 1);
+		}
+
+	private:
+		/** A triangle set up for rasterization in pixel space. */
+		struct FSetupTriangle
+		{
+			/** Edge functions A * X + B * Y + C, positive inside. */
+			float EdgeA[3];
+			float EdgeB[3];
+			float EdgeC[3];
+
+			/** Depth plane DepthA * X + DepthB * Y + DepthC. */
+			float DepthA;
+			float DepthB;
+			float DepthC;
+
+			/** Closest depth of the vertices, interpolation is clamped to it so edges never come out closer. */
+			float MaxDepth;
+
+			/** Pixels whose centers may be inside the triangle. */
+			FIntRect Bounds;
+		};
+
+		/** Sets up a triangle given in clip space, all vertices in front of the near plane. */
+		void SetupTriangle(const FVector4& V0, const FVector4& V1, const FVector4& V2);
+
+		/** Draws the triangles binned to a tile and builds the tile's HiZ levels. */
+		void RasterizeTile(int32 TileIndex);
+
+		/** World to clip space of the current frame. */
+		FMatrix ViewProjectionMatrix;
+
+		int32 Width;
+		int32 Height;
+		int32 NumTilesX;
+		int32 NumTilesY;
+
+		/** Triangles queued since BeginFrame. */
+		std::vector<FSetupTriangle> Triangles;
+
+		/** Start of each tile's triangles in BinnedTriangles, one extra entry at the end. */
+		std::vector<int32> TileBinStarts;
+
+		/** Triangle indices sorted by tile. */
+		std::vector<int32> BinnedTriangles;
+
+		/** Clip space vertices of the occluder being added. */
+		std::vector<FVector4> ClipVertices;
+
+		/** HiZ levels, level zero is the depth buffer itself. */
+		std::vector<std::vector<float>> DepthLevels;
+	};
+}
@@ -0,0 +1,363 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	Sphere.cpp: Implements the FSphere class.
+=============================================================================*/
+
+#include "Math/Sphere.h"
+#include "Math/Matrix3x4.h"
+#include <vector>
+
+namespace UE4Math
+{
+	namespace SpherePrivate
+	{
+		/** Relative slack on the radius when testing whether Welzl's sphere already holds a point. */
+		constexpr float ContainsEpsilon = 1.e-5f;
+
+		/** Triangles and tetrahedra flatter than this, relative to the size of their edges, have no circumsphere. */
+		constexpr float DegenerateEpsilon = 1.e-10f;
+
+		inline bool Contains(const FSphere& Sphere, const FVector& Point)
+		{
+			return FVector::DistSquared(Sphere.Center, Point) <= FMath::Square(Sphere.W) * (1.0f + ContainsEpsilon) + SMALL_NUMBER;
+		}
+
+		/** @return The smallest sphere through A and B. */
+		inline FSphere MakeDiametral(const FVector& A, const FVector& B)
+		{
+			return FSphere((A + B) * 0.5f, FVector::Dist(A, B) * 0.5f);
+		}
+
+		/** Grows Sphere just enough to hold Point, the old sphere stays inside the new one. */
+		inline void GrowToInclude(FSphere& Sphere, const FVector& Point)
+		{
+			const float DistSquared = FVector::DistSquared(Sphere.Center, Point);
+			if (DistSquared > FMath::Square(Sphere.W))
+			{
+				const float Dist = FMath::Sqrt(DistSquared);
+				const float NewRadius = (Sphere.W + Dist) * 0.5f;
+				Sphere.Center += (Point - Sphere.Center) * ((NewRadius - Sphere.W) / Dist);
+				Sphere.W = NewRadius;
+			}
+		}
+
+		/** @return The smallest sphere with A, B and C on its surface, or through the two furthest apart if they are collinear. */
+		FSphere MakeCircumsphere(const FVector& A, const FVector& B, const FVector& C)
+		{
+			const FVector AB = B - A;
+			const FVector AC = C - A;
+			const FVector Normal = AB ^ AC;
+			const float NormalSizeSquared = Normal.SizeSquared();
+
+			if (NormalSizeSquared <= DegenerateEpsilon * AB.SizeSquared() * AC.SizeSquared())
+			{
+				const float DistAB = AB.SizeSquared();
+				const float DistAC = AC.SizeSquared();
+				const float DistBC = FVector::DistSquared(B, C);
+				if (DistAB >= DistAC && DistAB >= DistBC)
+				{
+					return MakeDiametral(A, B);
+				}
+				return DistAC >= DistBC ? MakeDiametral(A, C) : MakeDiametral(B, C);
+			}
+
+			const FVector Offset = ((Normal ^ AB) * AC.SizeSquared() + (AC ^ Normal) * AB.SizeSquared()) / (2.0f * NormalSizeSquared);
+			return FSphere(A + Offset, Offset.Size());
+		}
+
+		/** @return The sphere with A, B, C and D on its surface, or the smallest sphere through three of them holding the fourth if they are coplanar. */
+		FSphere MakeCircumsphere(const FVector& A, const FVector& B, const FVector& C, const FVector& D)
+		{
+			const FVector AB = B - A;
+			const FVector AC = C - A;
+			const FVector AD = D - A;
+			const float Det = AB | (AC ^ AD);
+
+			if (FMath::Square(Det) <= DegenerateEpsilon * AB.SizeSquared() * AC.SizeSquared() * AD.SizeSquared())
+			{
+				const FSphere Candidates[3] = { MakeCircumsphere(A, B, D), MakeCircumsphere(A, C, D), MakeCircumsphere(B, C, D) };
+				const FVector* Others[3] = { &C, &B, &A };
+
+				FSphere Best(A, BIG_NUMBER);
+				for (int32 Index = 0; Index < 3; ++Index)
+				{
+					if (Candidates[Index].W < Best.W && Contains(Candidates[Index], *Others[Index]))
+					{
+						Best = Candidates[Index];
+					}
+				}
+
+				if (Best.W == BIG_NUMBER)
+				{
+					Best = MakeCircumsphere(A, B, C);
+					GrowToInclude(Best, D);
+				}
+				return Best;
+			}
+
+			const FVector Offset = ((AB ^ AC) * AD.SizeSquared() + (AD ^ AB) * AC.SizeSquared() + (AC ^ AD) * AB.SizeSquared()) / (2.0f * Det);
+			return FSphere(A + Offset, Offset.Size());
+		}
+
+		/*
+		 * Welzl's algorithm unrolled into nested loops, MinimumBoundingN is the smallest sphere holding the first
+		 * Count points with the N given points on its surface.
+		 */
+
+		FSphere MinimumBounding3(const FVector* Points, int32 Count, const FVector& Q1, const FVector& Q2, const FVector& Q3)
+		{
+			FSphere Sphere = MakeCircumsphere(Q1, Q2, Q3);
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				if (!Contains(Sphere, Points[Index]))
+				{
+					Sphere = MakeCircumsphere(Q1, Q2, Q3, Points[Index]);
+				}
+			}
+			return Sphere;
+		}
+
+		FSphere MinimumBounding2(const FVector* Points, int32 Count, const FVector& Q1, const FVector& Q2)
+		{
+			FSphere Sphere = MakeDiametral(Q1, Q2);
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				if (!Contains(Sphere, Points[Index]))
+				{
+					Sphere = MinimumBounding3(Points, Index, Q1, Q2, Points[Index]);
+				}
+			}
+			return Sphere;
+		}
+
+		FSphere MinimumBounding1(const FVector* Points, int32 Count, const FVector& Q1)
+		{
+			FSphere Sphere(Q1, 0.0f);
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				if (!Contains(Sphere, Points[Index]))
+				{
+					Sphere = MinimumBounding2(Points, Index, Q1, Points[Index]);
+				}
+			}
+			return Sphere;
+		}
+
+		/** Grows Sphere over Count points starting at First and wrapping around. */
+		void GrowToIncludeAll(FSphere& Sphere, const FVector* Pts, int32 Count, int32 First)
+		{
+			for (int32 Index = First; Index < Count; ++Index)
+			{
+				GrowToInclude(Sphere, Pts[Index]);
+			}
+			for (int32 Index = 0; Index < First; ++Index)
+			{
+				GrowToInclude(Sphere, Pts[Index]);
+			}
+		}
+	}
+
+
+	/* FSphere structors
+	 *****************************************************************************/
+
+	FSphere::FSphere(const FVector* Pts, int32 Count)
+		: Center(0, 0, 0)
+		, W(0)
+	{
+		if (Count)
+		{
+			FBox Box(ForceInit);
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				Box += Pts[Index];
+			}
+
+			*this = FSphere((Box.Min + Box.Max) / 2, 0);
+
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				const float Dist = FVector::DistSquared(Pts[Index], Center);
+
+				if (Dist > W)
+				{
+					W = Dist;
+				}
+			}
+
+			W = FMath::Sqrt(W) * 1.001f;
+		}
+	}
+
+
+	FSphere FSphere::MakeMinimumBounding(const FVector* Pts, int32 Count, uint32 Seed)
+	{
+		if (Count <= 0)
+		{
+			return FSphere(0);
+		}
+
+		// Work relative to the first point, which keeps precision for points far from the origin, in shuffled order.
+		const FVector Origin = Pts[0];
+		std::vector<FVector> Points(Count);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Points[Index] = Pts[Index] - Origin;
+		}
+
+		uint32 State = Seed * 747796405u + 2891336453u;
+		for (int32 Index = Count - 1; Index > 0; --Index)
+		{
+			State = State * 1664525u + 1013904223u;
+			std::swap(Points[Index], Points[(State >> 8) % (uint32)(Index + 1)]);
+		}
+
+		FSphere Sphere(Points[0], 0.0f);
+		for (int32 Index = 1; Index < Count; ++Index)
+		{
+			if (!SpherePrivate::Contains(Sphere, Points[Index]))
+			{
+				Sphere = SpherePrivate::MinimumBounding1(Points.data(), Index, Points[Index]);
+			}
+		}
+
+		// The tests above allow for rounding, make sure every point really is inside.
+		float MaxDistSquared = FMath::Square(Sphere.W);
+		for (const FVector& Point : Points)
+		{
+			MaxDistSquared = FMath::Max(MaxDistSquared, FVector::DistSquared(Sphere.Center, Point));
+		}
+
+		return FSphere(Sphere.Center + Origin, FMath::Sqrt(MaxDistSquared));
+	}
+
+
+	FSphere FSphere::MakeRitterBounding(const FVector* Pts, int32 Count, int32 RefineIterations)
+	{
+		if (Count <= 0)
+		{
+			return FSphere(0);
+		}
+
+		// Start from the most separated pair among the extreme points along each axis.
+		int32 MinIndex[3] = { 0, 0, 0 };
+		int32 MaxIndex[3] = { 0, 0, 0 };
+		for (int32 Index = 1; Index < Count; ++Index)
+		{
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				if (Pts[Index][Axis] < Pts[MinIndex[Axis]][Axis])
+				{
+					MinIndex[Axis] = Index;
+				}
+				if (Pts[Index][Axis] > Pts[MaxIndex[Axis]][Axis])
+				{
+					MaxIndex[Axis] = Index;
+				}
+			}
+		}
+
+		int32 BestAxis = 0;
+		float BestDistSquared = -1.0f;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const float DistSquared = FVector::DistSquared(Pts[MinIndex[Axis]], Pts[MaxIndex[Axis]]);
+			if (DistSquared > BestDistSquared)
+			{
+				BestDistSquared = DistSquared;
+				BestAxis = Axis;
+			}
+		}
+
+		FSphere Sphere = SpherePrivate::MakeDiametral(Pts[MinIndex[BestAxis]], Pts[MaxIndex[BestAxis]]);
+		SpherePrivate::GrowToIncludeAll(Sphere, Pts, Count, 0);
+
+		// Each pass starts from a different point, since the order the points are met in decides where the sphere ends up.
+		for (int32 Iteration = 0; Iteration < RefineIterations; ++Iteration)
+		{
+			FSphere Candidate(Sphere.Center, Sphere.W * 0.95f);
+			SpherePrivate::GrowToIncludeAll(Candidate, Pts, Count, (int32)(((int64)Iteration + 1) * Count / (RefineIterations + 1)));
+			if (Candidate.W < Sphere.W)
+			{
+				Sphere = Candidate;
+			}
+		}
+
+		return Sphere;
+	}
+
+
+	/* FSphere interface
+	 *****************************************************************************/
+
+	FSphere FSphere::TransformBy(const FMatrix& M) const
+	{
+		FSphere Result;
+
+		Result.Center = M.TransformPosition(this->Center);
+		Result.W = M.GetMaximumAxisScale() * W;
+
+		return Result;
+	}
+
+
+	FSphere FSphere::TransformBy(const FMatrix3x4& M) const
+	{
+		FSphere Result;
+
+		const float MaxAxisScaleSquared = FMath::Max(
+			M.GetScaledAxis(EAxis::X).SizeSquared(),
+			FMath::Max(
+				M.GetScaledAxis(EAxis::Y).SizeSquared(),
+				M.GetScaledAxis(EAxis::Z).SizeSquared()
+			)
+		);
+
+		Result.Center = M.TransformPosition(this->Center);
+		Result.W = FMath::Sqrt(MaxAxisScaleSquared) * W;
+
+		return Result;
+	}
+
+
+	float FSphere::GetVolume() const
+	{
+		return (4.f / 3.f) * PI * (W * W * W);
+	}
+
+
+	FSphere& FSphere::operator+=(const FSphere& Other)
+	{
+		if (W == 0.f)
+		{
+			*this = Other;
+		}
+		else if (IsInside(Other))
+		{
+			*this = Other;
+		}
+		else if (Other.IsInside(*this))
+		{
+			// no change
+		}
+		else
+		{
+			FVector Dir = Other.Center - Center;
+			float Dist = Dir.Size();
+
+			FSphere NewSphere;
+			NewSphere.W = (Dist + Other.W + W) * 0.5f;
+			NewSphere.Center = Center;
+
+			if (Dist > SMALL_NUMBER)
+			{
+				NewSphere.Center += Dir * ((NewSphere.W - W) / Dist);
+			}
+
+			*this = NewSphere;
+		}
+
+		return *this;
+	}
+}
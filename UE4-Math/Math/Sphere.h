@@ -0,0 +1,252 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Math/UnrealMathUtility.h"
+#include "Misc/StringBuilder.h"
+#include "Math/Vector.h"
+#include "Math/Plane.h"
+#include "Math/Box.h"
+#include "Math/Matrix.h"
+
+namespace UE4Math
+{
+	struct FMatrix3x4;
+
+	/**
+	 * Implements a basic sphere.
+	 *
+	 * Center and W are packed into 16 bytes, so a sphere loads as a single vector register.
+	 */
+	class FSphere
+	{
+	public:
+
+		/** The sphere's center point. */
+		FVector Center;
+
+		/** The sphere's radius. */
+		float W;
+
+	public:
+
+		/** Default constructor (no initialization). */
+		FSphere() { }
+
+		/**
+		 * Creates and initializes a new sphere.
+		 *
+		 * @param int32 Passing int32 sets up zeroed sphere.
+		 */
+		explicit FSphere(int32)
+			: Center(0.0f, 0.0f, 0.0f)
+			, W(0)
+		{ }
+
+		/**
+		 * Creates and initializes a new sphere with the specified parameters.
+		 *
+		 * @param InV Center of sphere.
+		 * @param InW Radius of sphere.
+		 */
+		FSphere(FVector InV, float InW)
+			: Center(InV)
+			, W(InW)
+		{ }
+
+		/**
+		 * Constructor.
+		 *
+		 * @param EForceInit Force Init Enum.
+		 */
+		explicit inline FSphere(EForceInit)
+			: Center(ForceInit)
+			, W(0.0f)
+		{ }
+
+		/**
+		 * Constructor.
+		 *
+		 * @param Pts Pointer to list of points this sphere must contain.
+		 * @param Count How many points are in the list.
+		 */
+		FSphere(const FVector* Pts, int32 Count);
+
+		/**
+		 * Computes the smallest sphere containing a set of points with Welzl's algorithm.
+		 * The points are visited in a shuffled order, which makes the expected running time linear in Count.
+		 *
+		 * @param Pts Pointer to list of points this sphere must contain.
+		 * @param Count How many points are in the list, no points gives a zeroed sphere.
+		 * @param Seed Seed of the shuffle, the same points and seed always give the same sphere.
+		 * @return The sphere.
+		 */
+		static FSphere MakeMinimumBounding(const FVector* Pts, int32 Count, uint32 Seed = 0);
+
+		/**
+		 * Computes a bounding sphere with Ritter's algorithm, which starts from the most separated pair of
+		 * extreme points along the axes and grows the sphere over the points in a single pass. It is usually
+		 * within a few percent of the minimum, each refinement iteration shrinks the sphere slightly, grows it
+		 * back over the points and keeps it if it ended up smaller.
+		 *
+		 * @param Pts Pointer to list of points this sphere must contain.
+		 * @param Count How many points are in the list, no points gives a zeroed sphere.
+		 * @param RefineIterations Number of refinement iterations.
+		 * @return The sphere.
+		 */
+		static FSphere MakeRitterBounding(const FVector* Pts, int32 Count, int32 RefineIterations = 0);
+
+	public:
+
+		/**
+		 * Check whether two spheres are the same within specified tolerance.
+		 *
+		 * @param Sphere The other sphere.
+		 * @param Tolerance Error Tolerance.
+		 * @return true if spheres are equal within specified tolerance, otherwise false.
+		 */
+		inline bool Equals(const FSphere& Sphere, float Tolerance = KINDA_SMALL_NUMBER) const
+		{
+			return Center.Equals(Sphere.Center, Tolerance) && FMath::Abs(W - Sphere.W) <= Tolerance;
+		}
+
+		/**
+		 * Check whether sphere is inside of another.
+		 *
+		 * @param Other The other sphere.
+		 * @param Tolerance Error Tolerance.
+		 * @return true if sphere is inside another, otherwise false.
+		 */
+		inline bool IsInside(const FSphere& Other, float Tolerance = KINDA_SMALL_NUMBER) const
+		{
+			if (W > Other.W + Tolerance)
+			{
+				return false;
+			}
+
+			return (Center - Other.Center).SizeSquared() <= FMath::Square(Other.W + Tolerance - W);
+		}
+
+		/**
+		 * Checks whether the given location is inside this sphere.
+		 *
+		 * @param In The location to test for inside the bounding volume.
+		 * @param Tolerance Error Tolerance.
+		 * @return true if location is inside this volume.
+		 */
+		inline bool IsInside(const FVector& In, float Tolerance = KINDA_SMALL_NUMBER) const
+		{
+			return (Center - In).SizeSquared() <= FMath::Square(W + Tolerance);
+		}
+
+		/**
+		 * Test whether this sphere intersects another.
+		 *
+		 * @param Other The other sphere.
+		 * @param Tolerance Error tolerance.
+		 * @return true if spheres intersect, false otherwise.
+		 */
+		inline bool Intersects(const FSphere& Other, float Tolerance = KINDA_SMALL_NUMBER) const
+		{
+			return (Center - Other.Center).SizeSquared() <= FMath::Square(FMath::Max(0.f, Other.W + W + Tolerance));
+		}
+
+		/**
+		 * Test whether this sphere touches the inside of a convex volume such as a view frustum.
+		 *
+		 * @param Planes Bounding planes of the volume, normals pointing out.
+		 * @param NumPlanes Number of planes.
+		 * @return false if the sphere is entirely outside one of the planes.
+		 */
+		inline bool IntersectsFrustum(const FPlane* Planes, int32 NumPlanes) const
+		{
+			for (int32 Index = 0; Index < NumPlanes; ++Index)
+			{
+				if (Planes[Index].PlaneDot(Center) > W)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/**
+		 * Get result of Transforming sphere by Matrix.
+		 *
+		 * @param M Matrix to transform by.
+		 * @return Result of transformation.
+		 */
+		FSphere TransformBy(const FMatrix& M) const;
+
+		/**
+		 * Get result of Transforming sphere with an affine transform.
+		 *
+		 * @param M Transform information.
+		 * @return Result of transformation.
+		 */
+		FSphere TransformBy(const FMatrix3x4& M) const;
+
+		/**
+		 * Get volume of the current sphere
+		 *
+		 * @return Volume (in Unreal units).
+		 */
+		float GetVolume() const;
+
+		/**
+		 * Adds to this sphere to include a new bounding volume.
+		 *
+		 * @param Other the bounding volume to increase the bounding volume to.
+		 * @return Reference to this bounding volume after resizing to include the other bounding volume.
+		 */
+		FSphere& operator+=(const FSphere& Other);
+
+		/**
+		 * Gets the result of addition to this bounding volume.
+		 *
+		 * @param Other The other volume to add to this.
+		 * @return A new bounding volume.
+		 */
+		FSphere operator+(const FSphere& Other) const
+		{
+			return FSphere(*this) += Other;
+		}
+
+		/**
+		 * Get a textual representation of the sphere.
+		 *
+		 * @return Text describing the sphere.
+		 */
+		std::string ToString() const
+		{
+			TStringBuilder<128> Builder;
+			AppendString(Builder);
+			return Builder.ToString();
+		}
+
+		/**
+		 * Appends a textual representation of this sphere to a string builder without allocating.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const
+		{
+			Out << "Center=(";
+			Center.AppendString(Out);
+			Out << ") Radius=" << W;
+		}
+	};
+
+	static_assert(sizeof(FSphere) == 16, "FSphere must stay one vector register wide.");
+
+	template <> struct TIsPODType<FSphere> { enum { Value = true }; };
+
+
+	/* FMath inline functions
+	 *****************************************************************************/
+
+	inline bool FMath::SphereAABBIntersection(const FSphere& Sphere, const FBox& AABB)
+	{
+		return SphereAABBIntersection(Sphere.Center, FMath::Square(Sphere.W), AABB);
+	}
+}
@@ -0,0 +1,533 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	TriangleMeshBVH.cpp: Closest point on mesh queries over a triangle hierarchy.
+=============================================================================*/
+
+#include "Math/TriangleMeshBVH.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
+#include <algorithm>
+
+namespace UE4Math
+{
+	namespace TriangleMeshBVHPrivate
+	{
+		/** A warm started query a unit or so off a 32k triangle height field takes 1340 cycles. */
+		enum { BatchParallelMinSize = GetParallelForMinBatchSize(1340) };
+
+		/** The bounds, centroid and normal loops of Build take 14 to 30 cycles per triangle. */
+		enum { BuildParallelMinSize = GetParallelForMinBatchSize(14) };
+
+		/** Nodes a query can have waiting, median splits keep the depth well below it. */
+		enum { MaxStackDepth = 64 };
+
+		/** Part of a triangle a closest point is on, which decides the pseudo-normal of the signed distance. */
+		enum ETriangleFeature
+		{
+			Face,
+			Vertex0,
+			Vertex1,
+			Vertex2,
+			Edge01,
+			Edge12,
+			Edge20,
+		};
+
+		/** @return Closest point to Point on the segment A B, with the weight of B. */
+		inline FVector GetClosestPointOnSegment(const FVector& Point, const FVector& A, const FVector& B, float& OutWeightB)
+		{
+			const FVector AB = B - A;
+			const float LengthSquared = AB | AB;
+			OutWeightB = LengthSquared > 0.0f ? FMath::Clamp(((Point - A) | AB) / LengthSquared, 0.0f, 1.0f) : 0.0f;
+			return A + AB * OutWeightB;
+		}
+
+		/**
+		 * Closest point on a triangle, by finding which of its seven Voronoi regions the point is in, from Real-Time
+		 * Collision Detection by Christer Ericson. Unlike FMath::ClosestPointOnTriangleToPoint it also returns the
+		 * barycentric coordinates and the region, and never builds planes.
+		 */
+		FVector GetClosestPointOnTriangle(const FVector& Point, const FVector& A, const FVector& B, const FVector& C, FVector& OutBarycentricCoords, int32& OutFeature)
+		{
+			const FVector AB = B - A;
+			const FVector AC = C - A;
+			const FVector AP = Point - A;
+			const float D1 = AB | AP;
+			const float D2 = AC | AP;
+			if (D1 <= 0.0f && D2 <= 0.0f)
+			{
+				OutBarycentricCoords = FVector(1.0f, 0.0f, 0.0f);
+				OutFeature = Vertex0;
+				return A;
+			}
+
+			const FVector BP = Point - B;
+			const float D3 = AB | BP;
+			const float D4 = AC | BP;
+			if (D3 >= 0.0f && D4 <= D3)
+			{
+				OutBarycentricCoords = FVector(0.0f, 1.0f, 0.0f);
+				OutFeature = Vertex1;
+				return B;
+			}
+
+			const float VC = D1 * D4 - D3 * D2;
+			if (VC <= 0.0f && D1 >= 0.0f && D3 <= 0.0f)
+			{
+				const float V = D1 / (D1 - D3);
+				OutBarycentricCoords = FVector(1.0f - V, V, 0.0f);
+				OutFeature = Edge01;
+				return A + AB * V;
+			}
+
+			const FVector CP = Point - C;
+			const float D5 = AB | CP;
+			const float D6 = AC | CP;
+			if (D6 >= 0.0f && D5 <= D6)
+			{
+				OutBarycentricCoords = FVector(0.0f, 0.0f, 1.0f);
+				OutFeature = Vertex2;
+				return C;
+			}
+
+			const float VB = D5 * D2 - D1 * D6;
+			if (VB <= 0.0f && D2 >= 0.0f && D6 <= 0.0f)
+			{
+				const float W = D2 / (D2 - D6);
+				OutBarycentricCoords = FVector(1.0f - W, 0.0f, W);
+				OutFeature = Edge20;
+				return A + AC * W;
+			}
+
+			const float VA = D3 * D6 - D5 * D4;
+			if (VA <= 0.0f && D4 >= D3 && D5 >= D6)
+			{
+				const float W = (D4 - D3) / ((D4 - D3) + (D5 - D6));
+				OutBarycentricCoords = FVector(0.0f, 1.0f - W, W);
+				OutFeature = Edge12;
+				return B + (C - B) * W;
+			}
+
+			const float Denominator = VA + VB + VC;
+			if (Denominator > 0.0f)
+			{
+				const float V = VB / Denominator;
+				const float W = VC / Denominator;
+				OutBarycentricCoords = FVector(1.0f - V - W, V, W);
+				OutFeature = Face;
+				return A + AB * V + AC * W;
+			}
+
+			// Only a degenerate triangle gets here, its closest point is on one of its edges.
+			float Weight01, Weight12, Weight20;
+			const FVector Closest01 = GetClosestPointOnSegment(Point, A, B, Weight01);
+			const FVector Closest12 = GetClosestPointOnSegment(Point, B, C, Weight12);
+			const FVector Closest20 = GetClosestPointOnSegment(Point, C, A, Weight20);
+			const float Distance01 = FVector::DistSquared(Point, Closest01);
+			const float Distance12 = FVector::DistSquared(Point, Closest12);
+			const float Distance20 = FVector::DistSquared(Point, Closest20);
+			if (Distance01 <= Distance12 && Distance01 <= Distance20)
+			{
+				OutBarycentricCoords = FVector(1.0f - Weight01, Weight01, 0.0f);
+				OutFeature = Edge01;
+				return Closest01;
+			}
+			if (Distance12 <= Distance20)
+			{
+				OutBarycentricCoords = FVector(0.0f, 1.0f - Weight12, Weight12);
+				OutFeature = Edge12;
+				return Closest12;
+			}
+			OutBarycentricCoords = FVector(Weight20, 0.0f, 1.0f - Weight20);
+			OutFeature = Edge20;
+			return Closest20;
+		}
+
+		/** @return Angle between two edges leaving a vertex. */
+		inline float GetCornerAngle(const FVector& Edge0, const FVector& Edge1)
+		{
+			return FMath::Acos(FMath::Clamp(Edge0.GetSafeNormal() | Edge1.GetSafeNormal(), -1.0f, 1.0f));
+		}
+	}
+
+
+	bool FTriangleMeshBVH::Build(const FVector* Vertices, int32 NumVertices, const int32* Indices, int32 NumIndices)
+	{
+		using namespace TriangleMeshBVHPrivate;
+
+		SCOPE_MATH_CYCLE_COUNTER(MeshBVHBuild);
+		INC_MATH_COUNTER_BY(MeshBVHBuildTriangles, NumIndices / 3);
+
+		Nodes.clear();
+		Triangles.clear();
+		TriangleOrder.clear();
+		FaceNormals.clear();
+		EdgeNormals.clear();
+		TriangleVertices.clear();
+		VertexNormals.clear();
+
+		ensure(NumIndices % 3 == 0);
+		const int32 NumTriangles = NumIndices / 3;
+		for (int32 Index = 0; Index < NumTriangles * 3; ++Index)
+		{
+			if (!ensure(Indices[Index] >= 0 && Indices[Index] < NumVertices))
+			{
+				return false;
+			}
+		}
+		if (NumTriangles == 0)
+		{
+			return true;
+		}
+
+		std::vector<FBox> TriangleBounds(NumTriangles);
+		std::vector<FVector> Centroids(NumTriangles);
+		ParallelForRange(NumTriangles, BuildParallelMinSize, [&](int32 Begin, int32 End)
+		{
+			for (int32 Triangle = Begin; Triangle < End; ++Triangle)
+			{
+				const FVector& V0 = Vertices[Indices[Triangle * 3 + 0]];
+				const FVector& V1 = Vertices[Indices[Triangle * 3 + 1]];
+				const FVector& V2 = Vertices[Indices[Triangle * 3 + 2]];
+				TriangleBounds[Triangle] = FBox(V0.ComponentMin(V1).ComponentMin(V2), V0.ComponentMax(V1).ComponentMax(V2));
+				Centroids[Triangle] = (V0 + V1 + V2) * (1.0f / 3.0f);
+			}
+		});
+
+		TriangleOrder.resize(NumTriangles);
+		for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+		{
+			TriangleOrder[Triangle] = Triangle;
+		}
+
+		// Leaves hold at least half of MaxLeafTriangles, so there are fewer nodes than triangles.
+		Nodes.reserve(NumTriangles + 1);
+		Nodes.resize(1);
+		BuildNode(0, 0, NumTriangles, TriangleBounds, Centroids);
+
+		Triangles.resize(NumTriangles);
+		ParallelForRange(NumTriangles, BuildParallelMinSize, [&](int32 Begin, int32 End)
+		{
+			for (int32 Triangle = Begin; Triangle < End; ++Triangle)
+			{
+				const int32* TriangleIndices = Indices + TriangleOrder[Triangle] * 3;
+				Triangles[Triangle] = { Vertices[TriangleIndices[0]], Vertices[TriangleIndices[1]], Vertices[TriangleIndices[2]] };
+			}
+		});
+
+		BuildPseudoNormals(NumVertices, Indices);
+		return true;
+	}
+
+	void FTriangleMeshBVH::BuildNode(int32 NodeIndex, int32 Start, int32 Count, const std::vector<FBox>& TriangleBounds, const std::vector<FVector>& Centroids)
+	{
+		FBox Bounds(ForceInit);
+		FBox CentroidBounds(ForceInit);
+		for (int32 Index = Start; Index < Start + Count; ++Index)
+		{
+			Bounds += TriangleBounds[TriangleOrder[Index]];
+			CentroidBounds += Centroids[TriangleOrder[Index]];
+		}
+
+		Nodes[NodeIndex].Min = Bounds.Min;
+		Nodes[NodeIndex].Max = Bounds.Max;
+		if (Count <= MaxLeafTriangles)
+		{
+			Nodes[NodeIndex].FirstIndex = Start;
+			Nodes[NodeIndex].NumTriangles = Count;
+			return;
+		}
+
+		const FVector Extent = CentroidBounds.Max - CentroidBounds.Min;
+		const int32 Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+		const int32 Middle = Start + Count / 2;
+		std::nth_element(TriangleOrder.begin() + Start, TriangleOrder.begin() + Middle, TriangleOrder.begin() + Start + Count, [&Centroids, Axis](int32 A, int32 B)
+		{
+			return (&Centroids[A].X)[Axis] < (&Centroids[B].X)[Axis];
+		});
+
+		// Nodes may move while the children are built, so the node is only accessed through its index.
+		const int32 FirstChild = (int32)Nodes.size();
+		Nodes.resize(FirstChild + 2);
+		Nodes[NodeIndex].FirstIndex = FirstChild;
+		Nodes[NodeIndex].NumTriangles = 0;
+
+		BuildNode(FirstChild, Start, Middle - Start, TriangleBounds, Centroids);
+		BuildNode(FirstChild + 1, Middle, Start + Count - Middle, TriangleBounds, Centroids);
+	}
+
+	void FTriangleMeshBVH::BuildPseudoNormals(int32 NumVertices, const int32* Indices)
+	{
+		using namespace TriangleMeshBVHPrivate;
+
+		const int32 NumTriangles = GetNumTriangles();
+		FaceNormals.resize(NumTriangles);
+		TriangleVertices.resize(NumTriangles * 3);
+		ParallelForRange(NumTriangles, BuildParallelMinSize, [&](int32 Begin, int32 End)
+		{
+			for (int32 Triangle = Begin; Triangle < End; ++Triangle)
+			{
+				const FTriangle& Corners = Triangles[Triangle];
+				FaceNormals[Triangle] = ((Corners.V1 - Corners.V0) ^ (Corners.V2 - Corners.V0)).GetSafeNormal();
+				for (int32 Corner = 0; Corner < 3; ++Corner)
+				{
+					TriangleVertices[Triangle * 3 + Corner] = Indices[TriangleOrder[Triangle] * 3 + Corner];
+				}
+			}
+		});
+
+		// Vertex pseudo-normals weight every triangle around the vertex by its angle there.
+		VertexNormals.assign(NumVertices, FVector::ZeroVector);
+		for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+		{
+			const FTriangle& Corners = Triangles[Triangle];
+			const FVector& Normal = FaceNormals[Triangle];
+			VertexNormals[TriangleVertices[Triangle * 3 + 0]] += Normal * GetCornerAngle(Corners.V1 - Corners.V0, Corners.V2 - Corners.V0);
+			VertexNormals[TriangleVertices[Triangle * 3 + 1]] += Normal * GetCornerAngle(Corners.V2 - Corners.V1, Corners.V0 - Corners.V1);
+			VertexNormals[TriangleVertices[Triangle * 3 + 2]] += Normal * GetCornerAngle(Corners.V0 - Corners.V2, Corners.V1 - Corners.V2);
+		}
+
+		// Edge pseudo-normals sum the triangles sharing the edge, found by sorting the edges by their vertices.
+		std::vector<std::pair<uint64, int32>> Edges(NumTriangles * 3);
+		for (int32 Triangle = 0; Triangle < NumTriangles; ++Triangle)
+		{
+			for (int32 Edge = 0; Edge < 3; ++Edge)
+			{
+				const uint32 Vertex0 = (uint32)TriangleVertices[Triangle * 3 + Edge];
+				const uint32 Vertex1 = (uint32)TriangleVertices[Triangle * 3 + (Edge + 1) % 3];
+				const uint64 Key = ((uint64)FMath::Min(Vertex0, Vertex1) << 32) | FMath::Max(Vertex0, Vertex1);
+				Edges[Triangle * 3 + Edge] = std::make_pair(Key, Triangle * 3 + Edge);
+			}
+		}
+		std::sort(Edges.begin(), Edges.end());
+
+		EdgeNormals.resize(NumTriangles * 3);
+		for (int32 First = 0; First < (int32)Edges.size();)
+		{
+			int32 Last = First;
+			FVector Normal = FVector::ZeroVector;
+			for (; Last < (int32)Edges.size() && Edges[Last].first == Edges[First].first; ++Last)
+			{
+				Normal += FaceNormals[Edges[Last].second / 3];
+			}
+			for (; First < Last; ++First)
+			{
+				EdgeNormals[Edges[First].second] = Normal;
+			}
+		}
+	}
+
+	void FTriangleMeshBVH::TestTriangle(const FVector& Point, int32 Triangle, FCandidate& Candidate) const
+	{
+		const FTriangle& Corners = Triangles[Triangle];
+		FVector BarycentricCoords;
+		int32 Feature;
+		const FVector Closest = TriangleMeshBVHPrivate::GetClosestPointOnTriangle(Point, Corners.V0, Corners.V1, Corners.V2, BarycentricCoords, Feature);
+		const float DistanceSquared = FVector::DistSquared(Point, Closest);
+
+		// Ties go to the lower source triangle index rather than the first one found, so the result does not depend
+		// on where the search started. Nodes at the candidate's distance are still visited, which finds every tie.
+		if (DistanceSquared < Candidate.DistanceSquared
+			|| (DistanceSquared == Candidate.DistanceSquared && (Candidate.Triangle == INDEX_NONE || TriangleOrder[Triangle] < TriangleOrder[Candidate.Triangle])))
+		{
+			Candidate.Point = Closest;
+			Candidate.BarycentricCoords = BarycentricCoords;
+			Candidate.DistanceSquared = DistanceSquared;
+			Candidate.Triangle = Triangle;
+			Candidate.Feature = Feature;
+		}
+	}
+
+	void FTriangleMeshBVH::FindClosestTriangle(const FVector& Point, FCandidate& Candidate) const
+	{
+		using namespace TriangleMeshBVHPrivate;
+
+		if (Nodes.empty())
+		{
+			return;
+		}
+
+		const FBox RootBounds(Nodes[0].Min, Nodes[0].Max);
+		if (RootBounds.ComputeSquaredDistanceToPoint(Point) > Candidate.DistanceSquared)
+		{
+			return;
+		}
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+		const __m128 QueryPoint = _mm_setr_ps(Point.X, Point.Y, Point.Z, 0.0f);
+		const __m128 Zero = _mm_setzero_ps();
+		const __m128 XYZMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+#endif
+
+		struct FStackEntry
+		{
+			int32 Node;
+			float DistanceSquared;
+		};
+		FStackEntry Stack[MaxStackDepth];
+		int32 StackSize = 0;
+		int32 NodeIndex = 0;
+
+		for (;;)
+		{
+			const FNode& Node = Nodes[NodeIndex];
+			if (Node.NumTriangles > 0)
+			{
+				for (int32 Triangle = Node.FirstIndex; Triangle < Node.FirstIndex + Node.NumTriangles; ++Triangle)
+				{
+					TestTriangle(Point, Triangle, Candidate);
+				}
+			}
+			else
+			{
+				const FNode* Children = &Nodes[Node.FirstIndex];
+				float ChildDistancesSquared[4];
+
+#if PLATFORM_ALWAYS_HAS_SSE2
+				// Both children at once, the integers after Min and Max are masked out before any arithmetic.
+				const __m128 Min0 = _mm_and_ps(_mm_loadu_ps(&Children[0].Min.X), XYZMask);
+				const __m128 Max0 = _mm_and_ps(_mm_loadu_ps(&Children[0].Max.X), XYZMask);
+				const __m128 Min1 = _mm_and_ps(_mm_loadu_ps(&Children[1].Min.X), XYZMask);
+				const __m128 Max1 = _mm_and_ps(_mm_loadu_ps(&Children[1].Max.X), XYZMask);
+				const __m128 Delta0 = _mm_max_ps(_mm_max_ps(_mm_sub_ps(Min0, QueryPoint), _mm_sub_ps(QueryPoint, Max0)), Zero);
+				const __m128 Delta1 = _mm_max_ps(_mm_max_ps(_mm_sub_ps(Min1, QueryPoint), _mm_sub_ps(QueryPoint, Max1)), Zero);
+				const __m128 Squared0 = _mm_mul_ps(Delta0, Delta0);
+				const __m128 Squared1 = _mm_mul_ps(Delta1, Delta1);
+				const __m128 Sum = _mm_add_ps(_mm_unpacklo_ps(Squared0, Squared1), _mm_unpackhi_ps(Squared0, Squared1));
+				_mm_storeu_ps(ChildDistancesSquared, _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum)));
+#else
+				ChildDistancesSquared[0] = FBox(Children[0].Min, Children[0].Max).ComputeSquaredDistanceToPoint(Point);
+				ChildDistancesSquared[1] = FBox(Children[1].Min, Children[1].Max).ComputeSquaredDistanceToPoint(Point);
+#endif
+
+				const int32 Nearer = ChildDistancesSquared[1] < ChildDistancesSquared[0] ? 1 : 0;
+				const float NearerDistanceSquared = ChildDistancesSquared[Nearer];
+				const float FartherDistanceSquared = ChildDistancesSquared[1 - Nearer];
+				if (NearerDistanceSquared <= Candidate.DistanceSquared)
+				{
+					if (FartherDistanceSquared <= Candidate.DistanceSquared && ensure(StackSize < MaxStackDepth))
+					{
+						Stack[StackSize++] = { Node.FirstIndex + 1 - Nearer, FartherDistanceSquared };
+					}
+					NodeIndex = Node.FirstIndex + Nearer;
+					continue;
+				}
+			}
+
+			// Nodes waiting on the stack may have become farther than the closest triangle found since.
+			do
+			{
+				if (StackSize == 0)
+				{
+					return;
+				}
+				--StackSize;
+			}
+			while (Stack[StackSize].DistanceSquared > Candidate.DistanceSquared);
+			NodeIndex = Stack[StackSize].Node;
+		}
+	}
+
+	void FTriangleMeshBVH::GetResult(const FVector& Point, const FCandidate& Candidate, bool bSignedDistance, FMeshClosestPoint& OutResult) const
+	{
+		using namespace TriangleMeshBVHPrivate;
+
+		OutResult.Point = Candidate.Point;
+		OutResult.BarycentricCoords = Candidate.BarycentricCoords;
+		OutResult.Distance = FMath::Sqrt(Candidate.DistanceSquared);
+		OutResult.TriangleIndex = TriangleOrder[Candidate.Triangle];
+
+		if (bSignedDistance)
+		{
+			const int32 Triangle = Candidate.Triangle;
+			FVector PseudoNormal;
+			switch (Candidate.Feature)
+			{
+			case Vertex0:
+			case Vertex1:
+			case Vertex2:
+				PseudoNormal = VertexNormals[TriangleVertices[Triangle * 3 + Candidate.Feature - Vertex0]];
+				break;
+			case Edge01:
+			case Edge12:
+			case Edge20:
+				PseudoNormal = EdgeNormals[Triangle * 3 + Candidate.Feature - Edge01];
+				break;
+			default:
+				PseudoNormal = FaceNormals[Triangle];
+				break;
+			}
+
+			if (((Point - Candidate.Point) | PseudoNormal) < 0.0f)
+			{
+				OutResult.Distance = -OutResult.Distance;
+			}
+		}
+	}
+
+	bool FTriangleMeshBVH::FindClosestPoint(const FVector& Point, FMeshClosestPoint& OutResult, float MaxDistance, bool bSignedDistance) const
+	{
+		if (MaxDistance < 0.0f)
+		{
+			return false;
+		}
+
+		FCandidate Candidate;
+		Candidate.DistanceSquared = FMath::Square(MaxDistance);
+		Candidate.Triangle = INDEX_NONE;
+		FindClosestTriangle(Point, Candidate);
+		if (Candidate.Triangle == INDEX_NONE)
+		{
+			return false;
+		}
+
+		GetResult(Point, Candidate, bSignedDistance, OutResult);
+		return true;
+	}
+
+	void FTriangleMeshBVH::FindClosestPointBatch(const FVector* Points, FMeshClosestPoint* OutResults, int32 Count, float MaxDistance, bool bSignedDistance) const
+	{
+		SCOPE_MATH_CYCLE_COUNTER(ShapeQueryBatch);
+		INC_MATH_COUNTER_BY(ShapeQueryBatchElements, Count);
+
+		const FTriangleMeshBVH& BVH = *this;
+		const float MaxDistanceSquared = MaxDistance >= 0.0f ? FMath::Square(MaxDistance) : -1.0f;
+		ParallelForRange(Count, TriangleMeshBVHPrivate::BatchParallelMinSize, [&BVH, Points, OutResults, MaxDistance, MaxDistanceSquared, bSignedDistance](int32 Begin, int32 End)
+		{
+			// The triangle the previous point ended on bounds the search of the next one before it starts.
+			int32 PreviousTriangle = INDEX_NONE;
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const FVector& Point = Points[Index];
+				FCandidate Candidate;
+				Candidate.DistanceSquared = MaxDistanceSquared;
+				Candidate.Triangle = INDEX_NONE;
+				if (PreviousTriangle != INDEX_NONE)
+				{
+					BVH.TestTriangle(Point, PreviousTriangle, Candidate);
+				}
+				BVH.FindClosestTriangle(Point, Candidate);
+
+				FMeshClosestPoint& Result = OutResults[Index];
+				if (Candidate.Triangle != INDEX_NONE)
+				{
+					BVH.GetResult(Point, Candidate, bSignedDistance, Result);
+					PreviousTriangle = Candidate.Triangle;
+				}
+				else
+				{
+					Result.Point = Point;
+					Result.BarycentricCoords = FVector::ZeroVector;
+					Result.Distance = MaxDistance;
+					Result.TriangleIndex = INDEX_NONE;
+				}
+			}
+		});
+	}
+
+	FBox FTriangleMeshBVH::GetBounds() const
+	{
+		return Nodes.empty() ? FBox(ForceInit) : FBox(Nodes[0].Min, Nodes[0].Max);
+	}
+}
@@ -0,0 +1,179 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+#include "Math/Box.h"
+
+namespace UE4Math
+{
+	/** Result of a closest point on mesh query. */
+	struct FMeshClosestPoint
+	{
+		/** The point of the mesh closest to the query point. */
+		FVector Point;
+
+		/** Weights of the triangle's three vertices that make up Point. */
+		FVector BarycentricCoords;
+
+		/** Distance from the query point to Point, negative behind the surface when the signed distance was asked for. */
+		float Distance;
+
+		/**
+		 * The triangle Point is on, INDEX_NONE when no triangle was within the maximum distance. Of several triangles
+		 * at the same distance, the one with the lowest index.
+		 */
+		int32 TriangleIndex;
+	};
+
+
+	/**
+	 * Bounding volume hierarchy over the triangles of an indexed mesh, for closest point and distance queries.
+	 *
+	 * Triangles are split along the longest axis of their centroids' bounds at the median until at most
+	 * MaxLeafTriangles are left, and copied into leaf order so a leaf's vertices are read from consecutive memory.
+	 * Queries descend into the nearer child first and skip any node farther than the closest triangle found so far.
+	 *
+	 * Signed distances use angle weighted pseudo-normals: the closest point is classified as being inside a
+	 * triangle, on an edge or on a vertex, and the sign comes from the face normal, the sum of the normals of the
+	 * triangles sharing the edge or the angle weighted sum of the normals around the vertex. The sign is reliable
+	 * anywhere on closed, consistently wound meshes whose vertices are shared rather than duplicated, and near the
+	 * surface of open ones such as terrain. Positive is on the side of (V1 - V0) ^ (V2 - V0).
+	 */
+	class FTriangleMeshBVH
+	{
+	public:
+		/** Most triangles a leaf holds. */
+		enum { MaxLeafTriangles = 4 };
+
+		/** Creates an empty hierarchy, every query misses until Build is called. */
+		FTriangleMeshBVH() { }
+
+		/** Creates a hierarchy, see Build. */
+		FTriangleMeshBVH(const FVector* Vertices, int32 NumVertices, const int32* Indices, int32 NumIndices)
+		{
+			Build(Vertices, NumVertices, Indices, NumIndices);
+		}
+
+		/**
+		 * Builds the hierarchy, replacing the previous one. The mesh is copied and may be released afterwards.
+		 *
+		 * @param Vertices Vertex positions.
+		 * @param NumVertices Number of vertices.
+		 * @param Indices Three vertex indices per triangle.
+		 * @param NumIndices Number of indices, a multiple of three.
+		 * @return false if an index is out of range, the hierarchy is then left empty.
+		 */
+		bool Build(const FVector* Vertices, int32 NumVertices, const int32* Indices, int32 NumIndices);
+
+		/**
+		 * Finds the point of the mesh closest to a point.
+		 *
+		 * @param Point The query point.
+		 * @param OutResult Receives the closest point, left untouched on a miss.
+		 * @param MaxDistance Triangles farther than this are ignored, a small value ends the query early.
+		 * @param bSignedDistance Whether OutResult.Distance is negative behind the surface.
+		 * @return false if no triangle is within MaxDistance.
+		 */
+		bool FindClosestPoint(const FVector& Point, FMeshClosestPoint& OutResult, float MaxDistance = BIG_NUMBER, bool bSignedDistance = false) const;
+
+		/**
+		 * Finds the closest points of many points, in parallel.
+		 *
+		 * Each query starts from the triangle the previous point of its batch ended on, so points that are close to
+		 * each other in the array are faster to answer. The results are the same as FindClosestPoint's.
+		 *
+		 * @param Points The query points.
+		 * @param OutResults Receives the closest point of each point, TriangleIndex is INDEX_NONE on a miss.
+		 * @param Count Number of points.
+		 * @param MaxDistance Triangles farther than this are ignored.
+		 * @param bSignedDistance Whether distances are negative behind the surface.
+		 */
+		void FindClosestPointBatch(const FVector* Points, FMeshClosestPoint* OutResults, int32 Count, float MaxDistance = BIG_NUMBER, bool bSignedDistance = false) const;
+
+		/** @return Bounds of the whole mesh, invalid when empty. */
+		FBox GetBounds() const;
+
+		/** @return Number of triangles. */
+		inline int32 GetNumTriangles() const
+		{
+			return (int32)Triangles.size();
+		}
+
+		/** @return Number of nodes, leaves included. */
+		inline int32 GetNumNodes() const
+		{
+			return (int32)Nodes.size();
+		}
+
+	private:
+		/** A node, the two children of an inner node are stored next to each other. */
+		struct FNode
+		{
+			FVector Min;
+
+			/** First child of an inner node, first triangle of a leaf. */
+			int32 FirstIndex;
+
+			FVector Max;
+
+			/** Number of triangles of a leaf, zero for inner nodes. */
+			int32 NumTriangles;
+		};
+
+		/** A triangle's vertices, in leaf order. */
+		struct FTriangle
+		{
+			FVector V0;
+			FVector V1;
+			FVector V2;
+		};
+
+		/** The closest triangle found so far by a query. */
+		struct FCandidate
+		{
+			FVector Point;
+			FVector BarycentricCoords;
+			float DistanceSquared;
+			int32 Triangle;
+			int32 Feature;
+		};
+
+		/** Builds the node Nodes[NodeIndex] over the triangles [Start, Start + Count) of TriangleOrder. */
+		void BuildNode(int32 NodeIndex, int32 Start, int32 Count, const std::vector<FBox>& TriangleBounds, const std::vector<FVector>& Centroids);
+
+		/** Computes the face, edge and vertex pseudo-normals, in leaf order. */
+		void BuildPseudoNormals(int32 NumVertices, const int32* Indices);
+
+		/** Tests a triangle against the candidate, replacing it when the triangle is closer. */
+		void TestTriangle(const FVector& Point, int32 Triangle, FCandidate& Candidate) const;
+
+		/** Descends the hierarchy, keeping the closest triangle in the candidate. */
+		void FindClosestTriangle(const FVector& Point, FCandidate& Candidate) const;
+
+		/** Fills a result from a candidate that found a triangle. */
+		void GetResult(const FVector& Point, const FCandidate& Candidate, bool bSignedDistance, FMeshClosestPoint& OutResult) const;
+
+		std::vector<FNode> Nodes;
+
+		/** Triangles in leaf order. */
+		std::vector<FTriangle> Triangles;
+
+		/** Index in the source mesh of each leaf ordered triangle, also the build's work order. */
+		std::vector<int32> TriangleOrder;
+
+		/** Unit normal of each triangle, in leaf order. */
+		std::vector<FVector> FaceNormals;
+
+		/** Pseudo-normals of the edges V0 V1, V1 V2 and V2 V0 of each triangle, in leaf order. */
+		std::vector<FVector> EdgeNormals;
+
+		/** Source vertex indices of each triangle, in leaf order. */
+		std::vector<int32> TriangleVertices;
+
+		/** Pseudo-normal of each source vertex. */
+		std::vector<FVector> VertexNormals;
+	};
+}
@@ -5,6 +5,7 @@
 =============================================================================*/
 
 #include "Math/UnrealMath.h"
+#include "Async/ParallelFor.h"
 //#include "Stats/Stats.h"
 //#include "Math/RandomStream.h"
 //#include "UObject/PropertyPortFlags.h"
@@ -22,21 +23,6 @@ namespace UE4Math
 	Globals
 -----------------------------------------------------------------------------*/
 
-	const FVector FVector::ZeroVector(0.0f, 0.0f, 0.0f);
-	const FVector FVector::OneVector(1.0f, 1.0f, 1.0f);
-	const FVector FVector::UpVector(0.0f, 0.0f, 1.0f);
-	const FVector FVector::DownVector(0.0f, 0.0f, -1.0f);
-	const FVector FVector::ForwardVector(1.0f, 0.0f, 0.0f);
-	const FVector FVector::BackwardVector(-1.0f, 0.0f, 0.0f);
-	const FVector FVector::RightVector(0.0f, 1.0f, 0.0f);
-	const FVector FVector::LeftVector(0.0f, -1.0f, 0.0f);
-	const FVector2D FVector2D::ZeroVector(0.0f, 0.0f);
-	const FVector2D FVector2D::UnitVector(1.0f, 1.0f);
-	const FVector2D FVector2D::Unit45Deg(UE_INV_SQRT_2, UE_INV_SQRT_2);
-	const FRotator FRotator::ZeroRotator(0.f, 0.f, 0.f);
-
-	const VectorRegister VECTOR_INV_255 = DECLARE_VECTOR_REGISTER(1.f / 255.f, 1.f / 255.f, 1.f / 255.f, 1.f / 255.f);
-
 	const uint32 FMath::BitFlag[32] =
 	{
 		(1U << 0),	(1U << 1),	(1U << 2),	(1U << 3),
@@ -49,11 +35,6 @@ namespace UE4Math
 		(1U << 28),	(1U << 29),	(1U << 30),	(1U << 31),
 	};
 
-	const FIntPoint FIntPoint::ZeroValue(0, 0);
-	const FIntPoint FIntPoint::NoneValue(INDEX_NONE, INDEX_NONE);
-	const FIntVector FIntVector::ZeroValue(0, 0, 0);
-	const FIntVector FIntVector::NoneValue(INDEX_NONE, INDEX_NONE, INDEX_NONE);
-
 
 	FRotator FVector::ToOrientationRotator() const
 	{
@@ -71,7 +52,7 @@ namespace UE4Math
 #if ENABLE_NAN_DIAGNOSTIC
 		if (R.ContainsNaN())
 		{
-			logOrEnsureNanError(TEXT("FVector::Rotation(): Rotator result %s contains NaN! Input FVector = %s"), *R.ToString(), *this->ToString());
+			FMathValidation::ReportNaN("FVector::Rotation", "FRotator", 0, R.ToString());
 			R = FRotator::ZeroRotator;
 		}
 #endif
@@ -100,7 +81,7 @@ namespace UE4Math
 #if ENABLE_NAN_DIAGNOSTIC
 		if (R.ContainsNaN())
 		{
-			logOrEnsureNanError(TEXT("FVector4::Rotation(): Rotator result %s contains NaN! Input FVector4 = %s"), *R.ToString(), *this->ToString());
+			FMathValidation::ReportNaN("FVector4::Rotation", "FRotator", 0, R.ToString());
 			R = FRotator::ZeroRotator;
 		}
 #endif
@@ -321,7 +302,7 @@ namespace UE4Math
 		// Very large inputs can cause NaN's. Want to catch this here
 		if (RotationQuat.ContainsNaN())
 		{
-			logOrEnsureNanError(TEXT("Invalid input %s to FRotator::Quaternion - generated NaN output: %s"), *ToString(), *RotationQuat.ToString());
+			FMathValidation::ReportNaN("FRotator::Quaternion", "FQuat", 0, RotationQuat.ToString());
 			RotationQuat = FQuat::Identity;
 		}
 #endif
@@ -396,23 +377,199 @@ namespace UE4Math
 		return Result;
 	}
 
-	const FMatrix FMatrix::Identity(FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 1, 0), FPlane(0, 0, 0, 1));
+	std::string FMatrix::ToString() const
+	{
+		TStringBuilder<384> Builder;
+		AppendString(Builder);
+		return Builder.ToString();
+	}
 
-	const FQuat FQuat::Identity(0, 0, 0, 1);
+	void FMatrix::AppendString(FStringBuilderBase& Out) const
+	{
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			Out << "[" << M[Row][0] << " " << M[Row][1] << " " << M[Row][2] << " " << M[Row][3] << "]";
+		}
+	}
 
-	std::string FMatrix::ToString() const
+	namespace UnrealMathPrivate
 	{
-		std::string Output;
-		char stemp[50] = "";snprintf(stemp, 50, "[%g %g %g %g]", M[0][0], M[0][1], M[0][2], M[0][3]);
-		Output += std::string(stemp);
-		char stemp2[50] = ""; snprintf(stemp2, 50, "[%g %g %g %g]", M[1][0], M[1][1], M[1][2], M[1][3]);
-		Output += std::string(stemp);
-		char stemp3[50] = ""; snprintf(stemp3, 50, "[%g %g %g %g]", M[2][0], M[2][1], M[2][2], M[2][3]);
-		Output += std::string(stemp);
-		char stemp4[50] = ""; snprintf(stemp4, 50, "[%g %g %g %g]", M[3][0], M[3][1], M[3][2], M[3][3]);
-		Output += std::string(stemp);
+		/** MultiplyBatch takes 14 to 17 cycles per matrix at -O2 with SSE2, 7 to 8 with AVX2 and FMA. */
+		enum { MatrixMultiplyBatchParallelMinSize = GetParallelForMinBatchSize(14) };
+
+		/** The SSE2 block inverse of InverseBatch takes 38 cycles per matrix. */
+		enum { MatrixInverseBatchParallelMinSize = GetParallelForMinBatchSize(38) };
+
+		/**
+		 * MulAddBatch and ScaleAddBatch take 1.3 to 1.9 cycles per vector in cache and 4 to 6 streaming from memory.
+		 * Arrays near the threshold still fit in L2, so it is sized for the cached cost.
+		 */
+		enum { VectorBatchParallelMinSize = GetParallelForMinBatchSize(1) };
+
+		/** Out[i] = A[i] * B[i] + C[i] over Num floats. */
+		void MulAddFloats(const float* A, const float* B, const float* C, float* Out, int64 Num)
+		{
+			int64 Index = 0;
+#if PLATFORM_ALWAYS_HAS_AVX2
+			for (; Index + 8 <= Num; Index += 8)
+			{
+				const __m256 VA = _mm256_loadu_ps(A + Index);
+				const __m256 VB = _mm256_loadu_ps(B + Index);
+				const __m256 VC = _mm256_loadu_ps(C + Index);
+#if PLATFORM_ALWAYS_HAS_FMA3
+				_mm256_storeu_ps(Out + Index, _mm256_fmadd_ps(VA, VB, VC));
+#else
+				_mm256_storeu_ps(Out + Index, _mm256_add_ps(_mm256_mul_ps(VA, VB), VC));
+#endif
+			}
+#elif PLATFORM_ALWAYS_HAS_SSE2
+			for (; Index + 4 <= Num; Index += 4)
+			{
+				_mm_storeu_ps(Out + Index, MatrixSIMDPrivate::MultiplyAdd(_mm_loadu_ps(A + Index), _mm_loadu_ps(B + Index), _mm_loadu_ps(C + Index)));
+			}
+#endif
+			for (; Index < Num; ++Index)
+			{
+				Out[Index] = A[Index] * B[Index] + C[Index];
+			}
+		}
+
+		/** Out[i] = A[i] * Scale + B[i] over Num floats. */
+		void ScaleAddFloats(const float* A, float Scale, const float* B, float* Out, int64 Num)
+		{
+			int64 Index = 0;
+#if PLATFORM_ALWAYS_HAS_AVX2
+			const __m256 VScale = _mm256_set1_ps(Scale);
+			for (; Index + 8 <= Num; Index += 8)
+			{
+				const __m256 VA = _mm256_loadu_ps(A + Index);
+				const __m256 VB = _mm256_loadu_ps(B + Index);
+#if PLATFORM_ALWAYS_HAS_FMA3
+				_mm256_storeu_ps(Out + Index, _mm256_fmadd_ps(VA, VScale, VB));
+#else
+				_mm256_storeu_ps(Out + Index, _mm256_add_ps(_mm256_mul_ps(VA, VScale), VB));
+#endif
+			}
+#elif PLATFORM_ALWAYS_HAS_SSE2
+			const __m128 VScale = _mm_set1_ps(Scale);
+			for (; Index + 4 <= Num; Index += 4)
+			{
+				_mm_storeu_ps(Out + Index, MatrixSIMDPrivate::MultiplyAdd(_mm_loadu_ps(A + Index), VScale, _mm_loadu_ps(B + Index)));
+			}
+#endif
+			for (; Index < Num; ++Index)
+			{
+				Out[Index] = A[Index] * Scale + B[Index];
+			}
+		}
+	}
+
+	void FVector::MulAddBatch(const FVector* A, const FVector* B, const FVector* C, FVector* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(VectorBatch);
+		INC_MATH_COUNTER_BY(VectorBatchElements, Count);
+
+		// FVector is three packed floats, so a range of vectors is a flat float array and every lane does the same work.
+		ParallelForRange(Count, UnrealMathPrivate::VectorBatchParallelMinSize, [A, B, C, Out](int32 Begin, int32 End)
+		{
+			UnrealMathPrivate::MulAddFloats(&A[Begin].X, &B[Begin].X, &C[Begin].X, &Out[Begin].X, (int64)(End - Begin) * 3);
+		});
+	}
+
+	void FVector::ScaleAddBatch(const FVector* A, float Scale, const FVector* B, FVector* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(VectorBatch);
+		INC_MATH_COUNTER_BY(VectorBatchElements, Count);
+
+		ParallelForRange(Count, UnrealMathPrivate::VectorBatchParallelMinSize, [A, Scale, B, Out](int32 Begin, int32 End)
+		{
+			UnrealMathPrivate::ScaleAddFloats(&A[Begin].X, Scale, &B[Begin].X, &Out[Begin].X, (int64)(End - Begin) * 3);
+		});
+	}
+
+	void FMatrix::MultiplyBatch(const FMatrix* Matrices, const FMatrix& Other, FMatrix* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(MatrixMultiplyBatch);
+		INC_MATH_COUNTER_BY(MatrixMultiplyBatchElements, Count);
+
+		// Other may be one of the outputs, which another thread could overwrite before this one reads it.
+		const FMatrix Shared = Other;
+		ParallelForRange(Count, UnrealMathPrivate::MatrixMultiplyBatchParallelMinSize, [Matrices, &Shared, Out](int32 Begin, int32 End)
+		{
+#if PLATFORM_ALWAYS_HAS_AVX2
+			VectorMatrixMultiplyBatchAVX2(Out + Begin, Matrices + Begin, &Shared, End - Begin, 0);
+#elif PLATFORM_ALWAYS_HAS_SSE2
+			VectorMatrixMultiplyBatchSSE(Out + Begin, Matrices + Begin, &Shared, End - Begin, 0);
+#else
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				VectorMatrixMultiply(&Out[Index], &Matrices[Index], &Shared);
+			}
+#endif
+		});
+	}
+
+	void FMatrix::MultiplyBatch(const FMatrix* Matrices1, const FMatrix* Matrices2, FMatrix* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(MatrixMultiplyBatch);
+		INC_MATH_COUNTER_BY(MatrixMultiplyBatchElements, Count);
+
+		ParallelForRange(Count, UnrealMathPrivate::MatrixMultiplyBatchParallelMinSize, [Matrices1, Matrices2, Out](int32 Begin, int32 End)
+		{
+#if PLATFORM_ALWAYS_HAS_AVX2
+			VectorMatrixMultiplyBatchAVX2(Out + Begin, Matrices1 + Begin, Matrices2 + Begin, End - Begin, 1);
+#elif PLATFORM_ALWAYS_HAS_SSE2
+			VectorMatrixMultiplyBatchSSE(Out + Begin, Matrices1 + Begin, Matrices2 + Begin, End - Begin, 1);
+#else
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				VectorMatrixMultiply(&Out[Index], &Matrices1[Index], &Matrices2[Index]);
+			}
+#endif
+		});
+	}
+
+	void FMatrix::InverseBatch(const FMatrix* Matrices, FMatrix* Out, int32 Count)
+	{
+		SCOPE_MATH_CYCLE_COUNTER(MatrixInverseBatch);
+		INC_MATH_COUNTER_BY(MatrixInverseBatchElements, Count);
+
+		ParallelForRange(Count, UnrealMathPrivate::MatrixInverseBatchParallelMinSize, [Matrices, Out](int32 Begin, int32 End)
+		{
+			for (int32 Index = Begin; Index < End; ++Index)
+			{
+				const FMatrix& Src = Matrices[Index];
+
+				// Same nil and singular handling as Inverse().
+				if (Src.GetScaledAxis(EAxis::X).IsNearlyZero(SMALL_NUMBER) &&
+					Src.GetScaledAxis(EAxis::Y).IsNearlyZero(SMALL_NUMBER) &&
+					Src.GetScaledAxis(EAxis::Z).IsNearlyZero(SMALL_NUMBER))
+				{
+					INC_MATH_COUNTER(MatrixInverseNil);
+					Out[Index] = FMatrix::Identity;
+					continue;
+				}
 
-		return Output;
+#if PLATFORM_ALWAYS_HAS_SSE2
+				// The kernel returns the determinant it computed, which saves the separate Determinant() pass.
+				if (VectorMatrixInverseSSE(&Out[Index], &Src) == 0.0f)
+				{
+					INC_MATH_COUNTER(MatrixInverseSingular);
+					Out[Index] = FMatrix::Identity;
+				}
+#else
+				if (Src.Determinant() == 0.0f)
+				{
+					INC_MATH_COUNTER(MatrixInverseSingular);
+					Out[Index] = FMatrix::Identity;
+				}
+				else
+				{
+					VectorMatrixInverse(&Out[Index], &Src);
+				}
+#endif
+			}
+		});
 	}
 
 	void FMatrix::DebugPrint() const
@@ -479,7 +636,7 @@ namespace UE4Math
 #if ENABLE_NAN_DIAGNOSTIC
 		if (RotatorFromQuat.ContainsNaN())
 		{
-			logOrEnsureNanError(TEXT("FQuat::Rotator(): Rotator result %s contains NaN! Quat = %s, YawY = %.9f, YawX = %.9f"), *RotatorFromQuat.ToString(), *this->ToString(), YawY, YawX);
+			FMathValidation::ReportNaN("FQuat::Rotator", "FRotator", 0, RotatorFromQuat.ToString());
 			RotatorFromQuat = FRotator::ZeroRotator;
 		}
 #endif
@@ -1524,6 +1681,8 @@ namespace UE4Math
 
 	bool FMath::SegmentTriangleIntersection(const FVector& StartPoint, const FVector& EndPoint, const FVector& A, const FVector& B, const FVector& C, FVector& OutIntersectPoint, FVector& OutTriangleNormal)
 	{
+		SCOPE_MATH_CYCLE_COUNTER(SegmentTriangleIntersection);
+
 		const FVector BA = A - B;
 		const FVector CB = B - C;
 		const FVector TriNormal = BA ^ CB;
@@ -1673,6 +1832,21 @@ namespace UE4Math
 		}
 	}
 
+	FSphere FMath::ComputeBoundingSphereForCone(FVector const& ConeOrigin, FVector const& ConeDirection, float ConeRadius, float CosConeAngle, float SinConeAngle)
+	{
+		// Based on https://bartwronski.com/2017/04/13/cull-that-cone/
+		const float COS_PI_OVER_4 = 0.707107f;
+		if (CosConeAngle < COS_PI_OVER_4)
+		{
+			return FSphere(ConeOrigin + ConeDirection * ConeRadius * CosConeAngle, ConeRadius * SinConeAngle);
+		}
+		else
+		{
+			const float BoundingRadius = ConeRadius / (2.0f * CosConeAngle);
+			return FSphere(ConeOrigin + ConeDirection * BoundingRadius, BoundingRadius);
+		}
+	}
+
 	int32 FMath::PlaneAABBRelativePosition(const FPlane& P, const FBox& AABB)
 	{
 		// find diagonal most closely aligned with normal of plane
@@ -1752,6 +1926,15 @@ namespace UE4Math
 		return false;
 	}
 
+	/**
+	 * Outside two edges of a triangle the closest point is on one of those edges. It is only the shared vertex when
+	 * the triangle's angle there is obtuse enough, so both edges have to be checked.
+	 */
+	static FVector ClosestOfTwoPoints(const FVector& Point, const FVector& Candidate1, const FVector& Candidate2)
+	{
+		return FVector::DistSquared(Point, Candidate1) <= FVector::DistSquared(Point, Candidate2) ? Candidate1 : Candidate2;
+	}
+
 	FVector FMath::ClosestPointOnTriangleToPoint(const FVector& Point, const FVector& A, const FVector& B, const FVector& C)
 	{
 		//Figure out what region the point is in and compare against that "point" or "edge"
@@ -1785,15 +1968,18 @@ namespace UE4Math
 		case 2:	//010 Segment AC
 			Result = FMath::ClosestPointOnSegment(Point, A, C);
 			break;
-		case 3:	//011 point A
-			return A;
+		case 3:	//011 Segments BA and AC, point A when both angles at A are obtuse
+			Result = ClosestOfTwoPoints(Point, FMath::ClosestPointOnSegment(Point, B, A), FMath::ClosestPointOnSegment(Point, A, C));
+			break;
 		case 4: //100 Segment BC
 			Result = FMath::ClosestPointOnSegment(Point, B, C);
 			break;
-		case 5: //101 point B
-			return B;
-		case 6: //110 point C
-			return C;
+		case 5: //101 Segments BA and BC
+			Result = ClosestOfTwoPoints(Point, FMath::ClosestPointOnSegment(Point, B, A), FMath::ClosestPointOnSegment(Point, B, C));
+			break;
+		case 6: //110 Segments AC and BC
+			Result = ClosestOfTwoPoints(Point, FMath::ClosestPointOnSegment(Point, A, C), FMath::ClosestPointOnSegment(Point, B, C));
+			break;
 		default:
 			//UE_LOG(LogUnrealMath, Log, TEXT("Impossible result in FMath::ClosestPointOnTriangleToPoint"));
 			break;
@@ -1871,7 +2057,6 @@ namespace UE4Math
 		//Check for coplanarity of all four points
 		//check(fabsf((C - A) | ((B - A) ^ (D - C))) > 0.0001f && "Coplanar points in FMath::ComputeBaryCentric3D()");
 
-		//http://osdir.com/ml/games.devel.algorithms/2003-02/msg00394.html
 		//     D
 		//    /|\		  C-----------B
 		//   / | \		   \         /
@@ -1892,64 +2077,29 @@ namespace UE4Math
 		}
 
 		//Tetrahedron made up of 4 CCW faces - DCA, DBC, DAB, ACB
-		const FPlane Planes[4] = { FPlane(Pt4,Pt3,Pt1), FPlane(Pt4,Pt2,Pt3), FPlane(Pt4,Pt1,Pt2), FPlane(Pt1,Pt3,Pt2) };
+		const FVector Faces[4][3] = { { Pt4, Pt3, Pt1 }, { Pt4, Pt2, Pt3 }, { Pt4, Pt1, Pt2 }, { Pt1, Pt3, Pt2 } };
 
-		//Determine which side of each plane the test point exists
-		int32 PlaneHalfspaceBitmask = 0;
+		// Outside the tetrahedron the closest point is on one of the faces the point is in front of. Which one is
+		// not decided by the faces alone (a point in front of two faces can be closest to either one's interior),
+		// so each of them is checked.
+		FVector Result(Point.X, Point.Y, Point.Z);
+		float ResultDistSquared = BIG_NUMBER;
 		for (int32 i = 0; i < 4; i++)
 		{
-			if (Planes[i].PlaneDot(Point) > 0.0f)
+			const FPlane Plane(Faces[i][0], Faces[i][1], Faces[i][2]);
+			if (Plane.PlaneDot(Point) > 0.0f)
 			{
-				PlaneHalfspaceBitmask |= (1 << i);
+				const FVector Candidate = FMath::ClosestPointOnTriangleToPoint(Point, Faces[i][0], Faces[i][1], Faces[i][2]);
+				const float CandidateDistSquared = FVector::DistSquared(Point, Candidate);
+				if (CandidateDistSquared < ResultDistSquared)
+				{
+					Result = Candidate;
+					ResultDistSquared = CandidateDistSquared;
+				}
 			}
 		}
 
-		//Verts + Faces - Edges = 2	(Euler)
-		FVector Result(Point.X, Point.Y, Point.Z);
-		switch (PlaneHalfspaceBitmask)
-		{
-		case 0:	 //inside (0000)
-			//@TODO - could project point onto any face
-			break;
-		case 1:	 //0001 Face	DCA
-			return FMath::ClosestPointOnTriangleToPoint(Point, Pt4, Pt3, Pt1);
-		case 2:	 //0010 Face	DBC
-			return FMath::ClosestPointOnTriangleToPoint(Point, Pt4, Pt2, Pt3);
-		case 3:  //0011	Edge	DC
-			Result = FMath::ClosestPointOnSegment(Point, Pt4, Pt3);
-			break;
-		case 4:	 //0100 Face	DAB
-			return FMath::ClosestPointOnTriangleToPoint(Point, Pt4, Pt1, Pt2);
-		case 5:  //0101	Edge	DA
-			Result = FMath::ClosestPointOnSegment(Point, Pt4, Pt1);
-			break;
-		case 6:  //0110	Edge	DB
-			Result = FMath::ClosestPointOnSegment(Point, Pt4, Pt2);
-			break;
-		case 7:	 //0111 Point	D
-			return Pt4;
-		case 8:	 //1000 Face	ACB
-			return FMath::ClosestPointOnTriangleToPoint(Point, Pt1, Pt3, Pt2);
-		case 9:  //1001	Edge	AC	
-			Result = FMath::ClosestPointOnSegment(Point, Pt1, Pt3);
-			break;
-		case 10: //1010	Edge	BC
-			Result = FMath::ClosestPointOnSegment(Point, Pt2, Pt3);
-			break;
-		case 11: //1011 Point	C
-			return Pt3;
-		case 12: //1100	Edge	BA
-			Result = FMath::ClosestPointOnSegment(Point, Pt2, Pt1);
-			break;
-		case 13: //1101 Point	A
-			return Pt1;
-		case 14: //1110 Point	B
-			return Pt2;
-		default: //impossible (1111)
-			//UE_LOG(LogUnrealMath, Log, TEXT("FMath::ClosestPointOnTetrahedronToPoint() : impossible result"));
-			break;
-		}
-
+		//Inside when in front of no face
 		return Result;
 	}
 
@@ -2553,14 +2703,18 @@ namespace UE4Math
 		}
 
 		// Temp storage for each cluster that mirrors the order of the passed in Clusters array
-		std::vector<FClusterMovedHereToMakeCompile> ClusterData(Clusters.size());
+		std::vector<FClusterMovedHereToMakeCompile> ClusterData(Clusters.size(), FClusterMovedHereToMakeCompile{ FVector::ZeroVector, 0 });
 		//ClusterData.AddZeroed(Clusters.Num());
 
+		// Nearest cluster of each point, found in parallel and accumulated in point order so the sums
+		// do not depend on the number of threads.
+		std::vector<int32> NearestClusters(Points.size());
+
 		// Then iterate
 		for (int32 ItCount = 0; ItCount < NumIterations; ItCount++)
 		{
 			// Classify each point - find closest cluster center
-			for (int32 i = 0; i < Points.size(); i++)
+			ParallelFor((int32)Points.size(), 256, [&Points, &Clusters, &NearestClusters](int32 i)
 			{
 				const FVector& Pos = Points[i];
 
@@ -2576,10 +2730,16 @@ namespace UE4Math
 						NearestClusterIndex = j;
 					}
 				}
-				// Update its info with this point
+				NearestClusters[i] = NearestClusterIndex;
+			});
+
+			// Update its info with this point
+			for (int32 i = 0; i < Points.size(); i++)
+			{
+				const int32 NearestClusterIndex = NearestClusters[i];
 				if (NearestClusterIndex != INDEX_NONE)
 				{
-					ClusterData[NearestClusterIndex].ClusterPosAccum += Pos;
+					ClusterData[NearestClusterIndex].ClusterPosAccum += Points[i];
 					ClusterData[NearestClusterIndex].ClusterSize++;
 				}
 			}
@@ -2753,53 +2913,6 @@ namespace UE4Math
 		//return Dst;
 	}
 
-	bool FMath::MemoryTest(void* BaseAddress, uint32 NumBytes)
-	{
-		volatile uint32* Ptr;
-		uint32 NumDwords = NumBytes / 4;
-		uint32 TestWords[2] = { 0xdeadbeef, 0x1337c0de };
-		bool bSucceeded = true;
-
-		for (int32 TestIndex = 0; TestIndex < 2; ++TestIndex)
-		{
-			// Fill the memory with a pattern.
-			Ptr = (uint32*)BaseAddress;
-			for (uint32 Index = 0; Index < NumDwords; ++Index)
-			{
-				*Ptr = TestWords[TestIndex];
-				Ptr++;
-			}
-
-			// Check that each uint32 is still ok and overwrite it with the complement.
-			Ptr = (uint32*)BaseAddress;
-			for (uint32 Index = 0; Index < NumDwords; ++Index)
-			{
-				if (*Ptr != TestWords[TestIndex])
-				{
-					//FPlatformMisc::LowLevelOutputDebugStringf(TEXT("Failed memory test at 0x%08x, wrote: 0x%08x, read: 0x%08x\n"), Ptr, TestWords[TestIndex], *Ptr);
-					bSucceeded = false;
-				}
-				*Ptr = ~TestWords[TestIndex];
-				Ptr++;
-			}
-
-			// Check again, now going backwards in memory.
-			Ptr = ((uint32*)BaseAddress) + NumDwords;
-			for (uint32 Index = 0; Index < NumDwords; ++Index)
-			{
-				Ptr--;
-				if (*Ptr != ~TestWords[TestIndex])
-				{
-					//FPlatformMisc::LowLevelOutputDebugStringf(TEXT("Failed memory test at 0x%08x, wrote: 0x%08x, read: 0x%08x\n"), Ptr, ~TestWords[TestIndex], *Ptr);
-					bSucceeded = false;
-				}
-				*Ptr = TestWords[TestIndex];
-			}
-		}
-
-		return bSucceeded;
-	}
-
 	/**
 	 * Converts a string to it's numeric equivalent, ignoring whitespace.
 	 * "123  45" - becomes 12,345
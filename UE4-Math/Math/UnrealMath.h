@@ -17,17 +17,18 @@
 //#include "Math/Ray.h"
 //#include "Math/Edge.h"
 #include "Math/Plane.h"
-//#include "Math/Sphere.h"
-//#include "Math/CapsuleShape.h"
+#include "Math/Sphere.h"
+#include "Math/CapsuleShape.h"
 #include "Math/Rotator.h"
 //#include "Math/RangeBound.h"
 //#include "Math/Range.h"
 //#include "Math/RangeSet.h"
 //#include "Math/Interval.h"
 #include "Math/Box.h"
-//#include "Math/Box2D.h"
-//#include "Math/BoxSphereBounds.h"
-//#include "Math/OrientedBox.h"
+#include "Math/Box2D.h"
+#include "Math/BoxSphereBounds.h"
+#include "Math/OrientedBox.h"
+#include "Math/ConvexQueries.h"
 #include "Math/Axis.h"
 #include "Math/Matrix.h"
 #include "Math/RotationTranslationMatrix.h"
@@ -39,6 +40,8 @@
 //#include "Math/OrthoMatrix.h"
 //#include "Math/TranslationMatrix.h"
 #include "Math/QuatRotationTranslationMatrix.h"
+#include "Math/Matrix3x4.h"
+#include "Math/LargeWorldCoordinates.h"
 //#include "Math/InverseRotationMatrix.h"
 //#include "Math/ScaleMatrix.h"
 //#include "Math/MirrorMatrix.h"
@@ -52,4 +55,8 @@
 #include "Math/Vector2DHalf.h"
 //#include "Math/ScalarRegister.h"
 //#include "Math/Transform.h"
-//#include "Math/ConvexHull2d.h"
+#include "Math/ConvexHull2d.h"
+#include "Math/PolygonClipping.h"
+#include "Math/SoftwareOcclusion.h"
+#include "Math/ClusteredCulling.h"
+#include "Math/TriangleMeshBVH.h"
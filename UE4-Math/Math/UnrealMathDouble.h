@@ -0,0 +1,405 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+/*=============================================================================
+	UnrealMathDouble.h: Vector intrinsics on 4 doubles
+
+	Backs the double precision math types (LargeWorldCoordinates.h). With AVX2
+	a VectorRegister4Double is one 256-bit register, so a double operation
+	costs about the same as the 128-bit float one. SSE2 targets use a pair of
+	128-bit registers, others plain loops over the 4 components.
+
+	Matrices are 16 doubles, row major, the same layout as FMatrix44d. Loads
+	and stores are unaligned and every kernel reads all of its inputs before
+	it writes, so the result may alias an input.
+=============================================================================*/
+
+#include "Misc/CoreMiscDefines.h"
+#include "Math/VectorRegister.h"
+
+#if PLATFORM_ALWAYS_HAS_AVX2
+#include <immintrin.h>
+#elif PLATFORM_ALWAYS_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace UE4Math
+{
+	/**
+	 *	double[4] vector register type, where the first double (X) is stored in the lowest 64 bits, and so on.
+	 */
+	struct alignas(32) VectorRegister4Double
+	{
+#if PLATFORM_ALWAYS_HAS_AVX2
+		__m256d V;
+#elif PLATFORM_ALWAYS_HAS_SSE2
+		__m128d XY;
+		__m128d ZW;
+#else
+		double V[4];
+#endif
+	};
+
+#if PLATFORM_ALWAYS_HAS_AVX2
+
+	inline VectorRegister4Double MakeVectorRegister4Double(double X, double Y, double Z, double W)
+	{
+		return VectorRegister4Double{ _mm256_setr_pd(X, Y, Z, W) };
+	}
+
+	/** @return VectorRegister4Double(0, 0, 0, 0) */
+	inline VectorRegister4Double VectorZeroDouble()
+	{
+		return VectorRegister4Double{ _mm256_setzero_pd() };
+	}
+
+	/** @return VectorRegister4Double(X, X, X, X) */
+	inline VectorRegister4Double VectorSetDouble1(double X)
+	{
+		return VectorRegister4Double{ _mm256_set1_pd(X) };
+	}
+
+	/** Loads 4 doubles from unaligned memory. */
+	inline VectorRegister4Double VectorLoadDouble(const double* Ptr)
+	{
+		return VectorRegister4Double{ _mm256_loadu_pd(Ptr) };
+	}
+
+	/** Loads 3 doubles from unaligned memory and sets W. Does not read Ptr[3]. */
+	inline VectorRegister4Double VectorLoadDouble3(const double* Ptr, double W = 0.0)
+	{
+		const __m128d XY = _mm_loadu_pd(Ptr);
+		const __m128d ZW = _mm_setr_pd(Ptr[2], W);
+		return VectorRegister4Double{ _mm256_insertf128_pd(_mm256_castpd128_pd256(XY), ZW, 1) };
+	}
+
+	/** Stores 4 doubles to unaligned memory. */
+	inline void VectorStoreDouble(const VectorRegister4Double& Vec, double* Ptr)
+	{
+		_mm256_storeu_pd(Ptr, Vec.V);
+	}
+
+	/** Stores X, Y and Z to unaligned memory. Does not write Ptr[3]. */
+	inline void VectorStoreDouble3(const VectorRegister4Double& Vec, double* Ptr)
+	{
+		const __m128d ZW = _mm256_extractf128_pd(Vec.V, 1);
+		_mm_storeu_pd(Ptr, _mm256_castpd256_pd128(Vec.V));
+		_mm_store_sd(Ptr + 2, ZW);
+	}
+
+	/** @return VectorRegister4Double(Vec[Index], Vec[Index], Vec[Index], Vec[Index]) */
+	template <int32 Index>
+	inline VectorRegister4Double VectorReplicateDouble(const VectorRegister4Double& Vec)
+	{
+		static_assert(Index >= 0 && Index <= 3, "Invalid Index");
+		return VectorRegister4Double{ _mm256_permute4x64_pd(Vec.V, Index * 0x55) };
+	}
+
+	inline VectorRegister4Double VectorAddDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return VectorRegister4Double{ _mm256_add_pd(A.V, B.V) };
+	}
+
+	inline VectorRegister4Double VectorSubtractDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return VectorRegister4Double{ _mm256_sub_pd(A.V, B.V) };
+	}
+
+	inline VectorRegister4Double VectorMultiplyDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return VectorRegister4Double{ _mm256_mul_pd(A.V, B.V) };
+	}
+
+	inline VectorRegister4Double VectorDivideDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return VectorRegister4Double{ _mm256_div_pd(A.V, B.V) };
+	}
+
+	/** @return A * B + C, fused when the target has FMA. */
+	inline VectorRegister4Double VectorMultiplyAddDouble(const VectorRegister4Double& A, const VectorRegister4Double& B, const VectorRegister4Double& C)
+	{
+#if PLATFORM_ALWAYS_HAS_FMA3
+		return VectorRegister4Double{ _mm256_fmadd_pd(A.V, B.V, C.V) };
+#else
+		return VectorRegister4Double{ _mm256_add_pd(_mm256_mul_pd(A.V, B.V), C.V) };
+#endif
+	}
+
+	/** @return Dot product of the XYZ components. */
+	inline double VectorDot3Double(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		const __m256d Mul = _mm256_mul_pd(A.V, B.V);
+		const __m128d XY = _mm256_castpd256_pd128(Mul);
+		const __m128d ZW = _mm256_extractf128_pd(Mul, 1);
+		const __m128d Sum = _mm_add_sd(_mm_add_sd(XY, _mm_unpackhi_pd(XY, XY)), ZW);
+		return _mm_cvtsd_f64(Sum);
+	}
+
+	/** @return Dot product of all 4 components. */
+	inline double VectorDot4Double(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		const __m256d Mul = _mm256_mul_pd(A.V, B.V);
+		const __m128d Sum2 = _mm_add_pd(_mm256_castpd256_pd128(Mul), _mm256_extractf128_pd(Mul, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(Sum2, _mm_unpackhi_pd(Sum2, Sum2)));
+	}
+
+	/** Rounds each component to float. */
+	inline VectorRegister VectorNarrowDouble(const VectorRegister4Double& Vec)
+	{
+		float Result[4];
+		_mm_storeu_ps(Result, _mm256_cvtpd_ps(Vec.V));
+		return VectorLoad(Result);
+	}
+
+	/** Widens each component to double, which is exact. */
+	inline VectorRegister4Double VectorWidenFloat(const VectorRegister& Vec)
+	{
+		float Source[4];
+		VectorStore(Vec, Source);
+		return VectorRegister4Double{ _mm256_cvtps_pd(_mm_loadu_ps(Source)) };
+	}
+
+#elif PLATFORM_ALWAYS_HAS_SSE2
+
+	inline VectorRegister4Double MakeVectorRegister4Double(double X, double Y, double Z, double W)
+	{
+		return VectorRegister4Double{ _mm_setr_pd(X, Y), _mm_setr_pd(Z, W) };
+	}
+
+	inline VectorRegister4Double VectorZeroDouble()
+	{
+		return VectorRegister4Double{ _mm_setzero_pd(), _mm_setzero_pd() };
+	}
+
+	inline VectorRegister4Double VectorSetDouble1(double X)
+	{
+		const __m128d XX = _mm_set1_pd(X);
+		return VectorRegister4Double{ XX, XX };
+	}
+
+	inline VectorRegister4Double VectorLoadDouble(const double* Ptr)
+	{
+		return VectorRegister4Double{ _mm_loadu_pd(Ptr), _mm_loadu_pd(Ptr + 2) };
+	}
+
+	inline VectorRegister4Double VectorLoadDouble3(const double* Ptr, double W = 0.0)
+	{
+		return VectorRegister4Double{ _mm_loadu_pd(Ptr), _mm_setr_pd(Ptr[2], W) };
+	}
+
+	inline void VectorStoreDouble(const VectorRegister4Double& Vec, double* Ptr)
+	{
+		_mm_storeu_pd(Ptr, Vec.XY);
+		_mm_storeu_pd(Ptr + 2, Vec.ZW);
+	}
+
+	inline void VectorStoreDouble3(const VectorRegister4Double& Vec, double* Ptr)
+	{
+		_mm_storeu_pd(Ptr, Vec.XY);
+		_mm_store_sd(Ptr + 2, Vec.ZW);
+	}
+
+	template <int32 Index>
+	inline VectorRegister4Double VectorReplicateDouble(const VectorRegister4Double& Vec)
+	{
+		static_assert(Index >= 0 && Index <= 3, "Invalid Index");
+		const __m128d Half = Index < 2 ? Vec.XY : Vec.ZW;
+		const __m128d Result = _mm_shuffle_pd(Half, Half, (Index & 1) ? 3 : 0);
+		return VectorRegister4Double{ Result, Result };
+	}
+
+	inline VectorRegister4Double VectorAddDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return VectorRegister4Double{ _mm_add_pd(A.XY, B.XY), _mm_add_pd(A.ZW, B.ZW) };
+	}
+
+	inline VectorRegister4Double VectorSubtractDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return VectorRegister4Double{ _mm_sub_pd(A.XY, B.XY), _mm_sub_pd(A.ZW, B.ZW) };
+	}
+
+	inline VectorRegister4Double VectorMultiplyDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return VectorRegister4Double{ _mm_mul_pd(A.XY, B.XY), _mm_mul_pd(A.ZW, B.ZW) };
+	}
+
+	inline VectorRegister4Double VectorDivideDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return VectorRegister4Double{ _mm_div_pd(A.XY, B.XY), _mm_div_pd(A.ZW, B.ZW) };
+	}
+
+	inline VectorRegister4Double VectorMultiplyAddDouble(const VectorRegister4Double& A, const VectorRegister4Double& B, const VectorRegister4Double& C)
+	{
+		return VectorRegister4Double{ _mm_add_pd(_mm_mul_pd(A.XY, B.XY), C.XY), _mm_add_pd(_mm_mul_pd(A.ZW, B.ZW), C.ZW) };
+	}
+
+	inline double VectorDot3Double(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		const __m128d XY = _mm_mul_pd(A.XY, B.XY);
+		const __m128d ZW = _mm_mul_pd(A.ZW, B.ZW);
+		return _mm_cvtsd_f64(_mm_add_sd(_mm_add_sd(XY, _mm_unpackhi_pd(XY, XY)), ZW));
+	}
+
+	inline double VectorDot4Double(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		const __m128d Sum2 = _mm_add_pd(_mm_mul_pd(A.XY, B.XY), _mm_mul_pd(A.ZW, B.ZW));
+		return _mm_cvtsd_f64(_mm_add_sd(Sum2, _mm_unpackhi_pd(Sum2, Sum2)));
+	}
+
+	inline VectorRegister VectorNarrowDouble(const VectorRegister4Double& Vec)
+	{
+		float Result[4];
+		_mm_storeu_ps(Result, _mm_movelh_ps(_mm_cvtpd_ps(Vec.XY), _mm_cvtpd_ps(Vec.ZW)));
+		return VectorLoad(Result);
+	}
+
+	inline VectorRegister4Double VectorWidenFloat(const VectorRegister& Vec)
+	{
+		float Source[4];
+		VectorStore(Vec, Source);
+		const __m128 XYZW = _mm_loadu_ps(Source);
+		return VectorRegister4Double{ _mm_cvtps_pd(XYZW), _mm_cvtps_pd(_mm_movehl_ps(XYZW, XYZW)) };
+	}
+
+#else
+
+	inline VectorRegister4Double MakeVectorRegister4Double(double X, double Y, double Z, double W)
+	{
+		return VectorRegister4Double{ { X, Y, Z, W } };
+	}
+
+	inline VectorRegister4Double VectorZeroDouble()
+	{
+		return MakeVectorRegister4Double(0.0, 0.0, 0.0, 0.0);
+	}
+
+	inline VectorRegister4Double VectorSetDouble1(double X)
+	{
+		return MakeVectorRegister4Double(X, X, X, X);
+	}
+
+	inline VectorRegister4Double VectorLoadDouble(const double* Ptr)
+	{
+		return MakeVectorRegister4Double(Ptr[0], Ptr[1], Ptr[2], Ptr[3]);
+	}
+
+	inline VectorRegister4Double VectorLoadDouble3(const double* Ptr, double W = 0.0)
+	{
+		return MakeVectorRegister4Double(Ptr[0], Ptr[1], Ptr[2], W);
+	}
+
+	inline void VectorStoreDouble(const VectorRegister4Double& Vec, double* Ptr)
+	{
+		Ptr[0] = Vec.V[0]; Ptr[1] = Vec.V[1]; Ptr[2] = Vec.V[2]; Ptr[3] = Vec.V[3];
+	}
+
+	inline void VectorStoreDouble3(const VectorRegister4Double& Vec, double* Ptr)
+	{
+		Ptr[0] = Vec.V[0]; Ptr[1] = Vec.V[1]; Ptr[2] = Vec.V[2];
+	}
+
+	template <int32 Index>
+	inline VectorRegister4Double VectorReplicateDouble(const VectorRegister4Double& Vec)
+	{
+		static_assert(Index >= 0 && Index <= 3, "Invalid Index");
+		return VectorSetDouble1(Vec.V[Index]);
+	}
+
+	inline VectorRegister4Double VectorAddDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return MakeVectorRegister4Double(A.V[0] + B.V[0], A.V[1] + B.V[1], A.V[2] + B.V[2], A.V[3] + B.V[3]);
+	}
+
+	inline VectorRegister4Double VectorSubtractDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return MakeVectorRegister4Double(A.V[0] - B.V[0], A.V[1] - B.V[1], A.V[2] - B.V[2], A.V[3] - B.V[3]);
+	}
+
+	inline VectorRegister4Double VectorMultiplyDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return MakeVectorRegister4Double(A.V[0] * B.V[0], A.V[1] * B.V[1], A.V[2] * B.V[2], A.V[3] * B.V[3]);
+	}
+
+	inline VectorRegister4Double VectorDivideDouble(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return MakeVectorRegister4Double(A.V[0] / B.V[0], A.V[1] / B.V[1], A.V[2] / B.V[2], A.V[3] / B.V[3]);
+	}
+
+	inline VectorRegister4Double VectorMultiplyAddDouble(const VectorRegister4Double& A, const VectorRegister4Double& B, const VectorRegister4Double& C)
+	{
+		return VectorAddDouble(VectorMultiplyDouble(A, B), C);
+	}
+
+	inline double VectorDot3Double(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return A.V[0] * B.V[0] + A.V[1] * B.V[1] + A.V[2] * B.V[2];
+	}
+
+	inline double VectorDot4Double(const VectorRegister4Double& A, const VectorRegister4Double& B)
+	{
+		return (A.V[0] * B.V[0] + A.V[1] * B.V[1]) + (A.V[2] * B.V[2] + A.V[3] * B.V[3]);
+	}
+
+	inline VectorRegister VectorNarrowDouble(const VectorRegister4Double& Vec)
+	{
+		return MakeVectorRegister((float)Vec.V[0], (float)Vec.V[1], (float)Vec.V[2], (float)Vec.V[3]);
+	}
+
+	inline VectorRegister4Double VectorWidenFloat(const VectorRegister& Vec)
+	{
+		float Source[4];
+		VectorStore(Vec, Source);
+		return MakeVectorRegister4Double(Source[0], Source[1], Source[2], Source[3]);
+	}
+
+#endif
+
+	/**
+	 * Multiplies two 4x4 double matrices, Result = Matrix1 * Matrix2 with the FMatrix row vector convention.
+	 *
+	 * @param Result	Pointer to where the result should be stored
+	 * @param Matrix1	Pointer to the first matrix
+	 * @param Matrix2	Pointer to the second matrix
+	 */
+	inline void VectorMatrixMultiplyDouble(void* Result, const void* Matrix1, const void* Matrix2)
+	{
+		const double* A = (const double*)Matrix1;
+		const double* B = (const double*)Matrix2;
+		const VectorRegister4Double B0 = VectorLoadDouble(B + 0);
+		const VectorRegister4Double B1 = VectorLoadDouble(B + 4);
+		const VectorRegister4Double B2 = VectorLoadDouble(B + 8);
+		const VectorRegister4Double B3 = VectorLoadDouble(B + 12);
+
+		VectorRegister4Double Rows[4];
+		for (int32 Row = 0; Row < 4; ++Row)
+		{
+			const double* ARow = A + Row * 4;
+			VectorRegister4Double Acc = VectorMultiplyDouble(VectorSetDouble1(ARow[0]), B0);
+			Acc = VectorMultiplyAddDouble(VectorSetDouble1(ARow[1]), B1, Acc);
+			Acc = VectorMultiplyAddDouble(VectorSetDouble1(ARow[2]), B2, Acc);
+			Rows[Row] = VectorMultiplyAddDouble(VectorSetDouble1(ARow[3]), B3, Acc);
+		}
+
+		double* R = (double*)Result;
+		VectorStoreDouble(Rows[0], R + 0);
+		VectorStoreDouble(Rows[1], R + 4);
+		VectorStoreDouble(Rows[2], R + 8);
+		VectorStoreDouble(Rows[3], R + 12);
+	}
+
+	/**
+	 * Calculates Vec * Matrix for a 4 component row vector.
+	 *
+	 * @param Vec		Row vector, W is used as is
+	 * @param Matrix	Pointer to a 4x4 double matrix
+	 */
+	inline VectorRegister4Double VectorTransformVectorDouble(const VectorRegister4Double& Vec, const void* Matrix)
+	{
+		const double* M = (const double*)Matrix;
+		VectorRegister4Double Acc = VectorMultiplyDouble(VectorReplicateDouble<0>(Vec), VectorLoadDouble(M + 0));
+		Acc = VectorMultiplyAddDouble(VectorReplicateDouble<1>(Vec), VectorLoadDouble(M + 4), Acc);
+		Acc = VectorMultiplyAddDouble(VectorReplicateDouble<2>(Vec), VectorLoadDouble(M + 8), Acc);
+		return VectorMultiplyAddDouble(VectorReplicateDouble<3>(Vec), VectorLoadDouble(M + 12), Acc);
+	}
+}
@@ -3,6 +3,8 @@
 #pragma once
 #include "Misc/CoreMiscDefines.h"
 #include "Math/UnrealMathUtility.h"
+#include "Math/UnrealMathMatrixSIMD.h"
+#include <limits>
 
 //#include "HAL/UnrealMemory.h"
 namespace UE4Math
@@ -67,10 +69,9 @@ namespace UE4Math
 	 * @param W		4th float component
 	 * @return		Vector of the 4 FLOATs
 	 */
-	inline VectorRegister MakeVectorRegister(float X, float Y, float Z, float W)
+	constexpr VectorRegister MakeVectorRegister(float X, float Y, float Z, float W)
 	{
-		VectorRegister Vec = { { X, Y, Z, W } };
-		return Vec;
+		return VectorRegister{ { X, Y, Z, W } };
 	}
 
 	/**
@@ -82,16 +83,71 @@ namespace UE4Math
 	* @param W		4th int32 component
 	* @return		Vector of the 4 int32
 	*/
-	inline VectorRegisterInt MakeVectorRegisterInt(int32 X, int32 Y, int32 Z, int32 W)
+	constexpr VectorRegisterInt MakeVectorRegisterInt(int32 X, int32 Y, int32 Z, int32 W)
 	{
-		VectorRegisterInt Vec;
-		((int32&)Vec.V[0]) = X;
-		((int32&)Vec.V[1]) = Y;
-		((int32&)Vec.V[2]) = Z;
-		((int32&)Vec.V[3]) = W;
-		return Vec;
+		return VectorRegisterInt{ { X, Y, Z, W } };
 	}
 
+#if PLATFORM_ALWAYS_HAS_SSE2
+	/**
+	 * Swizzles for SSE kernels that keep their data in __m128 from load to store.
+	 * VectorRegister itself is plain memory in this backend, so VectorSwizzle and friends stay element copies:
+	 * moving a single swizzle into an xmm register and back costs more than it saves.
+	 */
+	namespace VectorSwizzlePrivate
+	{
+		/** (Vec[X], Vec[Y], Vec[Z], Vec[W]) in the single cheapest instruction for the pattern. */
+		template<int X, int Y, int Z, int W>
+		inline __m128 Swizzle(__m128 Vec)
+		{
+			if constexpr (X == 0 && Y == 1 && Z == 2 && W == 3)
+			{
+				return Vec;
+			}
+			else if constexpr (X == 0 && Y == 1 && Z == 0 && W == 1)
+			{
+				return _mm_movelh_ps(Vec, Vec);
+			}
+			else if constexpr (X == 2 && Y == 3 && Z == 2 && W == 3)
+			{
+				return _mm_movehl_ps(Vec, Vec);
+			}
+			else if constexpr (X == 0 && Y == 0 && Z == 1 && W == 1)
+			{
+				return _mm_unpacklo_ps(Vec, Vec);
+			}
+			else if constexpr (X == 2 && Y == 2 && Z == 3 && W == 3)
+			{
+				return _mm_unpackhi_ps(Vec, Vec);
+			}
+#if PLATFORM_ALWAYS_HAS_AVX2
+			else if constexpr (X == 0 && Y == 0 && Z == 2 && W == 2)
+			{
+				return _mm_moveldup_ps(Vec);
+			}
+			else if constexpr (X == 1 && Y == 1 && Z == 3 && W == 3)
+			{
+				return _mm_movehdup_ps(Vec);
+			}
+			else if constexpr (X == 0 && Y == 0 && Z == 0 && W == 0)
+			{
+				return _mm_broadcastss_ps(Vec);
+			}
+			else
+			{
+				return _mm_permute_ps(Vec, _MM_SHUFFLE(W, Z, Y, X));
+			}
+#else
+			else
+			{
+				// pshufd does not overwrite its source, so it saves the register copy shufps would need.
+				return _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(Vec), _MM_SHUFFLE(W, Z, Y, X)));
+			}
+#endif
+		}
+	}
+#endif
+
 	/*=============================================================================
 	 *	Constants:
 	 *============================================================================*/
@@ -216,7 +272,21 @@ namespace UE4Math
 				   * @param Vec	Vector to store
 				   * @param Ptr	Aligned memory pointer
 				   */
+#if PLATFORM_ALWAYS_HAS_SSE2
+#define VectorStoreAlignedStreamed( Vec, Ptr )	_mm_stream_ps( (float*)(Ptr), _mm_loadu_ps( (Vec).V ) )
+#else
 #define VectorStoreAlignedStreamed( Vec, Ptr )	VectorStoreAligned( Vec , Ptr )
+#endif
+
+				   /**
+					* Orders the preceding streamed stores before any later store, call once after a loop of
+					* VectorStoreAlignedStreamed before the memory is handed to another thread.
+					*/
+#if PLATFORM_ALWAYS_HAS_SSE2
+#define VectorStoreStreamedFence()	_mm_sfence()
+#else
+#define VectorStoreStreamedFence()
+#endif
 
 				   /**
 					* Stores a vector to memory (aligned or unaligned).
@@ -249,7 +319,14 @@ namespace UE4Math
 					   * @param ElementIndex	Index (0-3) of the element to replicate
 					   * @return				VectorRegister( Vec[ElementIndex], Vec[ElementIndex], Vec[ElementIndex], Vec[ElementIndex] )
 					   */
-#define VectorReplicate( Vec, ElementIndex )	MakeVectorRegister( (Vec).V[ElementIndex], (Vec).V[ElementIndex], (Vec).V[ElementIndex], (Vec).V[ElementIndex] )
+	template<int ElementIndex>
+	inline VectorRegister VectorReplicateTemplate(const VectorRegister& Vec)
+	{
+		static_assert(ElementIndex >= 0 && ElementIndex <= 3, "Invalid Index");
+		return MakeVectorRegister(Vec.V[ElementIndex], Vec.V[ElementIndex], Vec.V[ElementIndex], Vec.V[ElementIndex]);
+	}
+
+#define VectorReplicate( Vec, ElementIndex )	VectorReplicateTemplate<ElementIndex>(Vec)
 
 					   /**
 						* Returns the absolute value (component-wise).
@@ -729,7 +806,19 @@ namespace UE4Math
 		const Float4& B = *((const Float4*)Quat2);
 		Float4& R = *((Float4*)Result);
 
-#if USE_FAST_QUAT_MUL
+#if PLATFORM_ALWAYS_HAS_SSE2
+		// Each element of A scales a swizzle of B, the sign flips are xors on the swizzled B.
+		const __m128 QA = _mm_loadu_ps(A);
+		const __m128 QB = _mm_loadu_ps(B);
+		const __m128 Sign0 = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+		const __m128 Sign1 = _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f);
+		const __m128 Sign2 = _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+		__m128 QR = _mm_mul_ps(VectorSwizzlePrivate::Swizzle<3, 3, 3, 3>(QA), QB);
+		QR = MatrixSIMDPrivate::MultiplyAdd(VectorSwizzlePrivate::Swizzle<0, 0, 0, 0>(QA), _mm_xor_ps(VectorSwizzlePrivate::Swizzle<3, 2, 1, 0>(QB), Sign0), QR);
+		QR = MatrixSIMDPrivate::MultiplyAdd(VectorSwizzlePrivate::Swizzle<1, 1, 1, 1>(QA), _mm_xor_ps(VectorSwizzlePrivate::Swizzle<2, 3, 0, 1>(QB), Sign1), QR);
+		QR = MatrixSIMDPrivate::MultiplyAdd(VectorSwizzlePrivate::Swizzle<2, 2, 2, 2>(QA), _mm_xor_ps(VectorSwizzlePrivate::Swizzle<1, 0, 3, 2>(QB), Sign2), QR);
+		_mm_storeu_ps(R, QR);
+#elif USE_FAST_QUAT_MUL
 		const float T0 = (A[2] - A[1]) * (B[1] - B[2]);
 		const float T1 = (A[3] + A[0]) * (B[3] + B[0]);
 		const float T2 = (A[3] - A[0]) * (B[1] + B[2]);
@@ -778,13 +867,13 @@ namespace UE4Math
 	}
 
 	/**
-	 * Multiplies two 4x4 matrices.
+	 * Multiplies two 4x4 matrices, scalar reference implementation.
 	 *
 	 * @param Result	Pointer to where the result should be stored
 	 * @param Matrix1	Pointer to the first matrix
 	 * @param Matrix2	Pointer to the second matrix
 	 */
-	inline void VectorMatrixMultiply(void* Result, const void* Matrix1, const void* Matrix2)
+	inline void VectorMatrixMultiplyFPU(void* Result, const void* Matrix1, const void* Matrix2)
 	{
 		typedef float Float4x4[4][4];
 		const Float4x4& A = *((const Float4x4*)Matrix1);
@@ -813,12 +902,12 @@ namespace UE4Math
 	}
 
 	/**
-	 * Calculate the inverse of an FMatrix.
+	 * Calculate the inverse of an FMatrix, scalar reference implementation.
 	 *
 	 * @param DstMatrix		FMatrix pointer to where the result should be stored
 	 * @param SrcMatrix		FMatrix pointer to the Matrix to be inversed
 	 */
-	inline void VectorMatrixInverse(void* DstMatrix, const void* SrcMatrix)
+	inline void VectorMatrixInverseFPU(void* DstMatrix, const void* SrcMatrix)
 	{
 		typedef float Float4x4[4][4];
 		const Float4x4& M = *((const Float4x4*)SrcMatrix);
@@ -902,6 +991,41 @@ namespace UE4Math
 		memcpy(DstMatrix, &Result, 16 * sizeof(float));
 	}
 
+	/**
+	 * Multiplies two 4x4 matrices, with AVX2 or SSE kernels when the target always has them.
+	 * @see UnrealMathMatrixSIMD.h for the tolerance against VectorMatrixMultiplyFPU.
+	 *
+	 * @param Result	Pointer to where the result should be stored
+	 * @param Matrix1	Pointer to the first matrix
+	 * @param Matrix2	Pointer to the second matrix
+	 */
+	inline void VectorMatrixMultiply(void* Result, const void* Matrix1, const void* Matrix2)
+	{
+#if PLATFORM_ALWAYS_HAS_AVX2
+		VectorMatrixMultiplyAVX2(Result, Matrix1, Matrix2);
+#elif PLATFORM_ALWAYS_HAS_SSE2
+		VectorMatrixMultiplySSE(Result, Matrix1, Matrix2);
+#else
+		VectorMatrixMultiplyFPU(Result, Matrix1, Matrix2);
+#endif
+	}
+
+	/**
+	 * Calculate the inverse of an FMatrix, with SSE kernels when the target always has them.
+	 * @see UnrealMathMatrixSIMD.h for the tolerance against VectorMatrixInverseFPU.
+	 *
+	 * @param DstMatrix		FMatrix pointer to where the result should be stored
+	 * @param SrcMatrix		FMatrix pointer to the Matrix to be inversed
+	 */
+	inline void VectorMatrixInverse(void* DstMatrix, const void* SrcMatrix)
+	{
+#if PLATFORM_ALWAYS_HAS_SSE2
+		VectorMatrixInverseSSE(DstMatrix, SrcMatrix);
+#else
+		VectorMatrixInverseFPU(DstMatrix, SrcMatrix);
+#endif
+	}
+
 	/**
 	 * Calculate Homogeneous transform.
 	 *
@@ -968,7 +1092,21 @@ namespace UE4Math
 	 * @param W			Index for which component to use for W (literal 0-3)
 	 * @return			The swizzled vector
 	 */
-#define VectorSwizzle( Vec, X, Y, Z, W )	MakeVectorRegister( (Vec).V[X], (Vec).V[Y], (Vec).V[Z], (Vec).V[W] )
+	template<int X, int Y, int Z, int W>
+	inline VectorRegister VectorSwizzleTemplate(const VectorRegister& Vec)
+	{
+		static_assert(X >= 0 && X <= 3 && Y >= 0 && Y <= 3 && Z >= 0 && Z <= 3 && W >= 0 && W <= 3, "Invalid Index");
+		if constexpr (X == 0 && Y == 1 && Z == 2 && W == 3)
+		{
+			return Vec;
+		}
+		else
+		{
+			return MakeVectorRegister(Vec.V[X], Vec.V[Y], Vec.V[Z], Vec.V[W]);
+		}
+	}
+
+#define VectorSwizzle( Vec, X, Y, Z, W )	VectorSwizzleTemplate<X, Y, Z, W>(Vec)
 
 
 	 /**
@@ -982,7 +1120,14 @@ namespace UE4Math
 	  * @param W			Index for which component to Vector2 to use for W (literal 0-3)
 	  * @return			The swizzled vector
 	  */
-#define VectorShuffle( Vec1, Vec2, X, Y, Z, W )	MakeVectorRegister( (Vec1).V[X], (Vec1).V[Y], (Vec2).V[Z], (Vec2).V[W] )
+	template<int X, int Y, int Z, int W>
+	inline VectorRegister VectorShuffleTemplate(const VectorRegister& Vec1, const VectorRegister& Vec2)
+	{
+		static_assert(X >= 0 && X <= 3 && Y >= 0 && Y <= 3 && Z >= 0 && Z <= 3 && W >= 0 && W <= 3, "Invalid Index");
+		return MakeVectorRegister(Vec1.V[X], Vec1.V[Y], Vec2.V[Z], Vec2.V[W]);
+	}
+
+#define VectorShuffle( Vec1, Vec2, X, Y, Z, W )	VectorShuffleTemplate<X, Y, Z, W>(Vec1, Vec2)
 
 	  /**
 	  * Creates a vector by combining two high components from each vector
@@ -7,6 +7,9 @@
 //#include "HAL/PlatformMath.h"
 #include "Memory/FMemory.h"
 #include "Misc/CoreMiscDefines.h"
+#include "Math/MathFwd.h"
+#include "Stats/MathStats.h"
+#include "Math/MathValidation.h"
 #include "Windows/WindowsPlatformMath.h"
 #include <vector>
 #include <string>
@@ -30,18 +33,17 @@ namespace UE4Math
 -----------------------------------------------------------------------------*/
 
 // Forward declarations.
-	struct  FVector;
 	struct  FVector4;
 	struct  FPlane;
 	struct  FBox;
 	struct  FRotator;
-	struct  FMatrix;
-	struct  FQuat;
 	struct  FTwoVectors;
 	struct  FTransform;
 	class  FSphere;
 	struct FVector2D;
 	struct FLinearColor;
+	struct FMemoryTestOptions;
+	struct FMemoryTestResult;
 
 	/*-----------------------------------------------------------------------------
 		Floating point constants.
@@ -1273,7 +1275,8 @@ namespace UE4Math
 		/**
 		 * Returns closest point on a tetrahedron to a point.
 		 * The idea is to identify the halfplanes that the point is
-		 * in relative to each face of the tetrahedron
+		 * in relative to each face of the tetrahedron, and take the
+		 * closest point over the faces the point is in front of
 		 *
 		 * @param	Point			point to check distance for
 		 * @param	A,B,C,D			four points defining a tetrahedron
@@ -1433,6 +1436,19 @@ namespace UE4Math
 		 */
 		static bool MemoryTest(void* BaseAddress, uint32_t NumBytes);
 
+		/**
+		 * Tests a memory region on several threads, see Memory/MemoryTest.h.
+		 * Every pattern fills the whole region, then checks it forwards while writing the complement,
+		 * then checks that backwards. The region is left holding the last pattern.
+		 *
+		 * @param BaseAddress	Starting address
+		 * @param NumBytes		Number of bytes to test (will be rounded down to a multiple of 4, unaligned 32 bit words at the ends are tested on their own)
+		 * @param Options		Patterns, thread count, pool and progress callback
+		 * @param OutResult		Failing addresses and throughput
+		 * @return				true if the memory region passed the test
+		 */
+		static bool MemoryTest(void* BaseAddress, uint64 NumBytes, const FMemoryTestOptions& Options, FMemoryTestResult& OutResult);
+
 		/**
 		 * Evaluates a numerical equation.
 		 *
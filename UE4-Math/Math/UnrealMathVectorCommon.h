@@ -9,7 +9,7 @@ namespace UE4Math
 
 	inline bool VectorIsAligned(const void* Ptr)
 	{
-		return !(int32(Ptr) & (SIMD_ALIGNMENT - 1));
+		return !(UPTRINT(Ptr) & (SIMD_ALIGNMENT - 1));
 	}
 
 	// Returns a normalized 4 vector = Vector / |Vector|.
@@ -255,16 +255,22 @@ namespace UE4Math
 	 * @return the number of zeros before the first "on" bit
 	 */
 
+#if defined(_MSC_VER)
 #pragma intrinsic( _BitScanForward )
+#endif
 	inline uint32 appCountTrailingZeros(uint32 Value)
 	{
 		if (Value == 0)
 		{
 			return 32;
 		}
+#if defined(_MSC_VER)
 		unsigned long BitIndex;	// 0-based, where the LSB is 0 and MSB is 31
 		_BitScanForward(&BitIndex, Value);	// Scans from LSB to MSB
 		return BitIndex;
+#else
+		return (uint32)__builtin_ctz(Value);
+#endif
 	}
 }
 
@@ -8,7 +8,8 @@
 //#include "Misc/Crc.h"
 #include "Math/UnrealMathUtility.h"
 //#include "Containers/UnrealString.h"
-//#include "Misc/Parse.h"
+#include "Misc/StringBuilder.h"
+#include "Misc/Parse.h"
 //#include "Math/Color.h"
 #include "Math/IntPoint.h"
 //#include "Logging/LogMacros.h"
@@ -27,8 +28,10 @@ namespace UE4Math
 {
 	/**
  * A vector in 3-D space composed of components (X, Y, Z) with floating point precision.
+ * This is FVector, the float specialization of TVector; see LargeWorldCoordinates.h for double precision.
  */
-	struct FVector
+	template<>
+	struct TVector<float>
 	{
 	public:
 
@@ -74,33 +77,35 @@ namespace UE4Math
 		{
 			if (ContainsNaN())
 			{
-				logOrEnsureNanError(TEXT("FVector contains NaN: %s"), *ToString());
+				INC_MATH_COUNTER(NaNVector);
+				FMathValidation::ReportNaN("DiagnosticCheckNaN", "FVector", 0, ToString());
 				*const_cast<FVector*>(this) = ZeroVector;
 			}
 		}
 
-		inline void DiagnosticCheckNaN(const TCHAR* Message) const
+		inline void DiagnosticCheckNaN(const char* Message) const
 		{
 			if (ContainsNaN())
 			{
-				logOrEnsureNanError(TEXT("%s: FVector contains NaN: %s"), Message, *ToString());
+				INC_MATH_COUNTER(NaNVector);
+				FMathValidation::ReportNaN(Message, "FVector", 0, ToString());
 				*const_cast<FVector*>(this) = ZeroVector;
 			}
 		}
 #else
-		inline void DiagnosticCheckNaN() const {}
-		inline void DiagnosticCheckNaN(const char* Message) const {}
+		inline void DiagnosticCheckNaN() const { INC_MATH_COUNTER_IF(NaNVector, ContainsNaN()); }
+		inline void DiagnosticCheckNaN(const char* Message) const { INC_MATH_COUNTER_IF(NaNVector, ContainsNaN()); }
 #endif
 
 		/** Default constructor (no initialization). */
-		inline FVector();
+		inline TVector();
 
 		/**
 		 * Constructor initializing all components to a single float value.
 		 *
 		 * @param InF Value to set all components to.
 		 */
-		explicit inline FVector(float InF);
+		explicit constexpr TVector(float InF);
 
 		/**
 		 * Constructor using initial values for each component.
@@ -109,7 +114,7 @@ namespace UE4Math
 		 * @param InY Y Coordinate.
 		 * @param InZ Z Coordinate.
 		 */
-		inline FVector(float InX, float InY, float InZ);
+		constexpr TVector(float InX, float InY, float InZ);
 
 		/**
 		 * Constructs a vector from an FVector2D and Z value.
@@ -117,42 +122,50 @@ namespace UE4Math
 		 * @param V Vector to copy from.
 		 * @param InZ Z Coordinate.
 		 */
-		explicit inline FVector(const FVector2D V, float InZ);
+		explicit inline TVector(const FVector2D V, float InZ);
 
 		/**
 		 * Constructor using the XYZ components from a 4D vector.
 		 *
 		 * @param V 4D Vector to copy from.
 		 */
-		inline FVector(const FVector4& V);
+		inline TVector(const FVector4& V);
 
 		/**
 		 * Constructs a vector from an FLinearColor.
 		 *
 		 * @param InColor Color to copy from.
 		 */
-		explicit FVector(const FLinearColor& InColor);
+		explicit TVector(const FLinearColor& InColor);
 
 		/**
 		 * Constructs a vector from an FIntVector.
 		 *
 		 * @param InVector FIntVector to copy from.
 		 */
-		explicit FVector(FIntVector InVector);
+		explicit TVector(FIntVector InVector);
 
 		/**
 		 * Constructs a vector from an FIntPoint.
 		 *
 		 * @param A Int Point used to set X and Y coordinates, Z is set to zero.
 		 */
-		explicit FVector(FIntPoint A);
+		explicit TVector(FIntPoint A);
 
 		/**
 		 * Constructor which initializes all components to zero.
 		 *
 		 * @param EForceInit Force init enum
 		 */
-		explicit inline FVector(EForceInit);
+		explicit constexpr TVector(EForceInit);
+
+		/**
+		 * Constructor narrowing a double precision vector, rounding each component to nearest.
+		 * Defined in LargeWorldCoordinates.h.
+		 *
+		 * @param V Vector to convert.
+		 */
+		explicit TVector(const FVector3d& V);
 
 #ifdef IMPLEMENT_ASSIGNMENT_OPERATOR_MANUALLY
 		/**
@@ -198,6 +211,37 @@ namespace UE4Math
 		 */
 		inline static float DotProduct(const FVector& A, const FVector& B);
 
+		/**
+		 * Component-wise A * B + C in one step, without the temporary A * B would make.
+		 *
+		 * @param A The first factor.
+		 * @param B The second factor.
+		 * @param C The vector to add.
+		 * @return A * B + C.
+		 */
+		inline static FVector MulAdd(const FVector& A, const FVector& B, const FVector& C);
+
+		/**
+		 * A * Scale + B in one step. Chains such as A + (B - C) * S + D * T become nested ScaleAdd calls.
+		 *
+		 * @param A The vector to scale.
+		 * @param Scale The scale applied to A.
+		 * @param B The vector to add.
+		 * @return A * Scale + B.
+		 */
+		inline static FVector ScaleAdd(const FVector& A, float Scale, const FVector& B);
+
+		/**
+		 * Out[i] = A[i] * B[i] + C[i] over arrays of vectors in a single pass. Out may alias any input.
+		 */
+		static void MulAddBatch(const FVector* A, const FVector* B, const FVector* C, FVector* Out, int32 Count);
+
+		/**
+		 * Out[i] = A[i] * Scale + B[i] over arrays of vectors in a single pass. Out may alias any input,
+		 * so ScaleAddBatch(Velocities, DeltaTime, Positions, Positions, Count) integrates positions in place.
+		 */
+		static void ScaleAddBatch(const FVector* A, float Scale, const FVector* B, FVector* Out, int32 Count);
+
 		/**
 		 * Gets the result of component-wise addition of this and another vector.
 		 *
@@ -732,6 +776,22 @@ namespace UE4Math
 		 */
 		std::string ToString() const;
 
+		/**
+		 * Appends a textual representation of this vector to a string builder without allocating.
+		 * Components are written in the shortest form that parses back to the same value.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const;
+
+		/**
+		 * Initialize this Vector based on a string. The String is expected to contain X=, Y=, Z=.
+		 * The FVector will be bogus when InitFromString returns false.
+		 *
+		 * @param InSourceString String containing the vector values.
+		 * @return true if the X,Y,Z values were read successfully; false otherwise.
+		 */
+		bool InitFromString(std::string_view InSourceString);
 
 		/** Get a short textural representation of this vector, for compact readable logging. */
 		std::string ToCompactString() const;
@@ -1041,7 +1101,7 @@ namespace UE4Math
 	}
 
 
-	inline FVector::FVector(const FVector2D V, float InZ)
+	inline FVector::TVector(const FVector2D V, float InZ)
 		: X(V.X), Y(V.Y), Z(InZ)
 	{
 		DiagnosticCheckNaN();
@@ -1173,45 +1233,63 @@ namespace UE4Math
 		return DegVector * (PI / 180.f);
 	}
 
-	inline FVector::FVector()
+	inline FVector::TVector()
 	{}
 
-	inline FVector::FVector(float InF)
+	constexpr FVector::TVector(float InF)
 		: X(InF), Y(InF), Z(InF)
 	{
-		DiagnosticCheckNaN();
+		if (!UE_IS_CONSTANT_EVALUATED())
+		{
+			DiagnosticCheckNaN();
+		}
 	}
 
-	inline FVector::FVector(float InX, float InY, float InZ)
+	constexpr FVector::TVector(float InX, float InY, float InZ)
 		: X(InX), Y(InY), Z(InZ)
 	{
-		DiagnosticCheckNaN();
+		if (!UE_IS_CONSTANT_EVALUATED())
+		{
+			DiagnosticCheckNaN();
+		}
 	}
 
-	//inline FVector::FVector(const FLinearColor& InColor)
+	//inline FVector::TVector(const FLinearColor& InColor)
 	//	: X(InColor.R), Y(InColor.G), Z(InColor.B)
 	//{
 	//	DiagnosticCheckNaN();
 	//}
 
-	inline FVector::FVector(FIntVector InVector)
+	inline FVector::TVector(FIntVector InVector)
 		: X(InVector.X), Y(InVector.Y), Z(InVector.Z)
 	{
 		DiagnosticCheckNaN();
 	}
 
-	inline FVector::FVector(FIntPoint A)
+	inline FVector::TVector(FIntPoint A)
 		: X(A.X), Y(A.Y), Z(0.f)
 	{
 		DiagnosticCheckNaN();
 	}
 
-	inline FVector::FVector(EForceInit)
+	constexpr FVector::TVector(EForceInit)
 		: X(0.0f), Y(0.0f), Z(0.0f)
 	{
-		DiagnosticCheckNaN();
+		if (!UE_IS_CONSTANT_EVALUATED())
+		{
+			DiagnosticCheckNaN();
+		}
 	}
 
+	inline constexpr FVector FVector::ZeroVector(0.0f, 0.0f, 0.0f);
+	inline constexpr FVector FVector::OneVector(1.0f, 1.0f, 1.0f);
+	inline constexpr FVector FVector::UpVector(0.0f, 0.0f, 1.0f);
+	inline constexpr FVector FVector::DownVector(0.0f, 0.0f, -1.0f);
+	inline constexpr FVector FVector::ForwardVector(1.0f, 0.0f, 0.0f);
+	inline constexpr FVector FVector::BackwardVector(-1.0f, 0.0f, 0.0f);
+	inline constexpr FVector FVector::RightVector(0.0f, 1.0f, 0.0f);
+	inline constexpr FVector FVector::LeftVector(0.0f, -1.0f, 0.0f);
+
 #ifdef IMPLEMENT_ASSIGNMENT_OPERATOR_MANUALLY
 	inline FVector& FVector::operator=(const FVector& Other)
 	{
@@ -1240,6 +1318,16 @@ namespace UE4Math
 		return A ^ B;
 	}
 
+	inline FVector FVector::MulAdd(const FVector& A, const FVector& B, const FVector& C)
+	{
+		return FVector(A.X * B.X + C.X, A.Y * B.Y + C.Y, A.Z * B.Z + C.Z);
+	}
+
+	inline FVector FVector::ScaleAdd(const FVector& A, float Scale, const FVector& B)
+	{
+		return FVector(A.X * Scale + B.X, A.Y * Scale + B.Y, A.Z * Scale + B.Z);
+	}
+
 	inline float FVector::operator|(const FVector& V) const
 	{
 		return X * V.X + Y * V.Y + Z * V.Z;
@@ -1760,12 +1848,27 @@ namespace UE4Math
 
 	inline std::string FVector::ToString() const
 	{
-		char stemp[200] = "";
-		snprintf(stemp, 200, "X=%3.3f Y=%3.3f Z=%3.3f", X, Y, Z);
-		return std::string(stemp);
+		TStringBuilder<64> Builder;
+		AppendString(Builder);
+		return Builder.ToString();
 		//return FString::Printf(TEXT("X=%3.3f Y=%3.3f Z=%3.3f"), X, Y, Z);
 	}
 
+	inline void FVector::AppendString(FStringBuilderBase& Out) const
+	{
+		Out << "X=" << X << " Y=" << Y << " Z=" << Z;
+	}
+
+	inline bool FVector::InitFromString(std::string_view InSourceString)
+	{
+		X = Y = Z = 0;
+
+		// The initialization is only successful if the X, Y, and Z values can all be parsed from the string
+		const bool bSuccessful = FParse::Value(InSourceString, "X=", X) && FParse::Value(InSourceString, "Y=", Y) && FParse::Value(InSourceString, "Z=", Z);
+
+		return bSuccessful;
+	}
+
 
 	inline std::string FVector::ToCompactString() const
 	{
@@ -6,7 +6,8 @@
 //#include "Misc/AssertionMacros.h"
 //#include "Misc/Crc.h"
 //#include "Containers/UnrealString.h"
-//#include "Misc/Parse.h"
+#include "Misc/StringBuilder.h"
+#include "Misc/Parse.h"
 //#include "Logging/LogMacros.h"
 #include "UnrealMathUtility.h"
 #include "IntPoint.h"
@@ -54,14 +55,14 @@ namespace UE4Math
 		 * @param InX X coordinate.
 		 * @param InY Y coordinate.
 		 */
-		inline FVector2D(float InX, float InY);
+		constexpr FVector2D(float InX, float InY);
 
 		/**
 		 * Constructor initializing both components to a single float value.
 		 *
 		 * @param InF Value to set both components to.
 		 */
-		explicit inline FVector2D(float InF);
+		explicit constexpr FVector2D(float InF);
 
 		/**
 		 * Constructs a vector from an FIntPoint.
@@ -517,6 +518,14 @@ namespace UE4Math
 		 */
 		std::string ToString() const;
 
+		/**
+		 * Appends a textual representation of this vector to a string builder without allocating.
+		 * Components are written in the shortest form that parses back to the same value.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const;
+
 		/**
 		 * Initialize this Vector based on an FString. The String is expected to contain X=, Y=.
 		 * The FVector2D will be bogus when InitFromString returns false.
@@ -524,7 +533,7 @@ namespace UE4Math
 		 * @param	InSourceString	FString containing the vector values.
 		 * @return true if the X,Y values were read successfully; false otherwise.
 		 */
-		bool InitFromString(const std::string& InSourceString);
+		bool InitFromString(std::string_view InSourceString);
 
 
 
@@ -534,12 +543,13 @@ namespace UE4Math
 		{
 			if (ContainsNaN())
 			{
-				logOrEnsureNanError(TEXT("FVector contains NaN: %s"), *ToString());
+				INC_MATH_COUNTER(NaNVector2D);
+				FMathValidation::ReportNaN("DiagnosticCheckNaN", "FVector2D", 0, ToString());
 				*this = FVector2D::ZeroVector;
 			}
 		}
 #else
-		inline void DiagnosticCheckNaN() {}
+		inline void DiagnosticCheckNaN() { INC_MATH_COUNTER_IF(NaNVector2D, ContainsNaN()); }
 #endif
 
 		/**
@@ -580,14 +590,18 @@ namespace UE4Math
 	template <> struct TIsPODType<FVector2D> { enum { Value = true }; };
 
 
-	inline FVector2D::FVector2D(float InX, float InY)
+	constexpr FVector2D::FVector2D(float InX, float InY)
 		: X(InX), Y(InY)
 	{ }
 
-	inline FVector2D::FVector2D(float InF)
+	constexpr FVector2D::FVector2D(float InF)
 		: X(InF), Y(InF)
 	{ }
 
+	inline constexpr FVector2D FVector2D::ZeroVector(0.0f, 0.0f);
+	inline constexpr FVector2D FVector2D::UnitVector(1.0f, 1.0f);
+	inline constexpr FVector2D FVector2D::Unit45Deg(UE_INV_SQRT_2, UE_INV_SQRT_2);
+
 	inline FVector2D::FVector2D(FIntPoint InPos)
 	{
 		X = (float)InPos.X;
@@ -951,12 +965,27 @@ namespace UE4Math
 
 	inline std::string FVector2D::ToString() const
 	{
-		char stemp[200] = "";
-		snprintf(stemp, 200, "X=%3.3f Y=%3.3f", X, Y);
-		return std::string(stemp);
+		TStringBuilder<64> Builder;
+		AppendString(Builder);
+		return Builder.ToString();
 		//return FString::Printf(TEXT("X=%3.3f Y=%3.3f"), X, Y);
 	}
 
+	inline void FVector2D::AppendString(FStringBuilderBase& Out) const
+	{
+		Out << "X=" << X << " Y=" << Y;
+	}
+
+	inline bool FVector2D::InitFromString(std::string_view InSourceString)
+	{
+		X = Y = 0;
+
+		// The initialization is only successful if the X and Y values can all be parsed from the string
+		const bool bSuccessful = FParse::Value(InSourceString, "X=", X) && FParse::Value(InSourceString, "Y=", Y);
+
+		return bSuccessful;
+	}
+
 	/* FMath inline functions
 	 *****************************************************************************/
 
@@ -4,6 +4,7 @@
 
 //#include "CoreTypes.h"
 //#include "Containers/UnrealString.h"
+#include "Misc/StringBuilder.h"
 #include "Math/Vector2D.h"
 #include "Math/Float16.h"
 
@@ -67,6 +68,14 @@ namespace UE4Math
 		 */
 		std::string ToString() const;
 
+		/**
+		 * Appends a textual representation of this vector to a string builder without allocating.
+		 * Components are written in the shortest form that parses back to the same value.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const;
+
 	public:
 
 	};
@@ -101,12 +110,17 @@ namespace UE4Math
 
 	inline std::string FVector2DHalf::ToString() const
 	{
-		char stemp[100] = "";
-		snprintf(stemp, 100, "X=%3.3f Y=%3.3f", (float)X, (float)Y);
-		return std::string(stemp);
+		TStringBuilder<64> Builder;
+		AppendString(Builder);
+		return Builder.ToString();
 		//return FString::Printf(TEXT("X=%3.3f Y=%3.3f"), (float)X, (float)Y);
 	}
 
+	inline void FVector2DHalf::AppendString(FStringBuilderBase& Out) const
+	{
+		Out << "X=" << (float)X << " Y=" << (float)Y;
+	}
+
 
 	inline FVector2DHalf::operator FVector2D() const
 	{
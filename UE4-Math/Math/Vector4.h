@@ -6,7 +6,8 @@
 //#include "Misc/Crc.h"
 #include "Math/UnrealMathUtility.h"
 //#include "Containers/UnrealString.h"
-//#include "Misc/Parse.h"
+#include "Misc/StringBuilder.h"
+#include "Misc/Parse.h"
 //#include "Logging/LogMacros.h"
 #include "Math/Vector2D.h"
 #include "Math/Vector.h"
@@ -300,6 +301,14 @@ namespace UE4Math
 		 */
 		std::string ToString() const;
 
+		/**
+		 * Appends a textual representation of this vector to a string builder without allocating.
+		 * Components are written in the shortest form that parses back to the same value.
+		 *
+		 * @param Out Builder to append to.
+		 */
+		void AppendString(FStringBuilderBase& Out) const;
+
 		/**
 		 * Initialize this Vector based on an FString. The String is expected to contain X=, Y=, Z=, W=.
 		 * The FVector4 will be bogus when InitFromString returns false.
@@ -307,7 +316,7 @@ namespace UE4Math
 		 * @param InSourceString	FString containing the vector values.
 		 * @return true if the X,Y,Z values were read successfully; false otherwise.
 		 */
-		bool InitFromString(const std::string& InSourceString);
+		bool InitFromString(std::string_view InSourceString);
 
 		/**
 		 * Returns a normalized copy of the vector if safe to normalize.
@@ -404,13 +413,14 @@ namespace UE4Math
 		{
 			if (ContainsNaN())
 			{
-				logOrEnsureNanError(TEXT("FVector contains NaN: %s"), *ToString());
+				INC_MATH_COUNTER(NaNVector4);
+				FMathValidation::ReportNaN("DiagnosticCheckNaN", "FVector4", 0, ToString());
 				*this = FVector4(FVector::ZeroVector);
 
 			}
 		}
 #else
-		inline void DiagnosticCheckNaN() { }
+		inline void DiagnosticCheckNaN() { INC_MATH_COUNTER_IF(NaNVector4, ContainsNaN()); }
 #endif
 
 
@@ -595,12 +605,31 @@ namespace UE4Math
 
 	inline std::string FVector4::ToString() const
 	{
-		char stemp[200] = "";
-		snprintf(stemp, 100, "X=%3.3f Y=%3.3f Z=%3.3f W=%3.3f", X, Y, Z, W);
-		return std::string(stemp);
+		TStringBuilder<96> Builder;
+		AppendString(Builder);
+		return Builder.ToString();
 		//return FString::Printf(TEXT("X=%3.3f Y=%3.3f Z=%3.3f W=%3.3f"), X, Y, Z, W);
 	}
 
+	inline void FVector4::AppendString(FStringBuilderBase& Out) const
+	{
+		Out << "X=" << X << " Y=" << Y << " Z=" << Z << " W=" << W;
+	}
+
+	inline bool FVector4::InitFromString(std::string_view InSourceString)
+	{
+		X = Y = Z = 0;
+		W = 1.0f;
+
+		// The initialization is only successful if the X, Y, and Z values can all be parsed from the string
+		const bool bSuccessful = FParse::Value(InSourceString, "X=", X) && FParse::Value(InSourceString, "Y=", Y) && FParse::Value(InSourceString, "Z=", Z);
+
+		// W is optional, so don't factor in its presence (or lack thereof) in determining initialization success
+		FParse::Value(InSourceString, "W=", W);
+
+		return bSuccessful;
+	}
+
 
 	inline FVector4 FVector4::GetSafeNormal(float Tolerance) const
 	{
@@ -723,7 +752,7 @@ namespace UE4Math
 	/* FVector inline functions
 	 *****************************************************************************/
 
-	inline FVector::FVector(const FVector4& V)
+	inline FVector::TVector(const FVector4& V)
 		: X(V.X), Y(V.Y), Z(V.Z)
 	{
 		DiagnosticCheckNaN();
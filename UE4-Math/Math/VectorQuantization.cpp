@@ -0,0 +1,202 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	VectorQuantization.cpp: Batch FVector codecs for replication
+=============================================================================*/
+
+#include "Math/VectorQuantization.h"
+#include "Math/VectorRegister.h"
+
+namespace UE4Math
+{
+	/*-----------------------------------------------------------------------------
+		FFixedPointVectorCodec
+	-----------------------------------------------------------------------------*/
+
+	void FFixedPointVectorCodec::Init(const FBox& InBounds, uint32 InBitsPerAxis)
+	{
+		// 24 bits is the most a float can step through exactly.
+		BitsPerAxis = FMath::Clamp<uint32>(InBitsPerAxis, 1, 24);
+		MaxQuantized = (float)((1u << BitsPerAxis) - 1);
+		Min = InBounds.Min;
+
+		const FVector Extent = InBounds.Max - InBounds.Min;
+		Scale.X = Extent.X > SMALL_NUMBER ? MaxQuantized / Extent.X : 0.f;
+		Scale.Y = Extent.Y > SMALL_NUMBER ? MaxQuantized / Extent.Y : 0.f;
+		Scale.Z = Extent.Z > SMALL_NUMBER ? MaxQuantized / Extent.Z : 0.f;
+		InvScale = FVector(FMath::Max(Extent.X, 0.f), FMath::Max(Extent.Y, 0.f), FMath::Max(Extent.Z, 0.f)) / MaxQuantized;
+	}
+
+	void FFixedPointVectorCodec::EncodeBatch(const FVector* Vectors, int32 Count, FBitWriter& Writer) const
+	{
+		const VectorRegister VMin = VectorLoadFloat3(&Min);
+		const VectorRegister VScale = VectorLoadFloat3(&Scale);
+		const VectorRegister VMaxQuantized = VectorSetFloat1(MaxQuantized);
+		const VectorRegister VZero = VectorZero();
+		const VectorRegister VHalf = GlobalVectorConstants::FloatOneHalf;
+
+		int32 Quantized[4];
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const VectorRegister V = VectorLoadFloat3(&Vectors[Index]);
+			const VectorRegister Scaled = VectorMultiply(VectorSubtract(V, VMin), VScale);
+			const VectorRegister Clamped = VectorMin(VectorMax(Scaled, VZero), VMaxQuantized);
+			VectorIntStore(VectorFloatToInt(VectorAdd(Clamped, VHalf)), Quantized);
+
+			Writer.WriteBits((uint32)Quantized[0], BitsPerAxis);
+			Writer.WriteBits((uint32)Quantized[1], BitsPerAxis);
+			Writer.WriteBits((uint32)Quantized[2], BitsPerAxis);
+		}
+	}
+
+	void FFixedPointVectorCodec::DecodeBatch(FBitReader& Reader, FVector* OutVectors, int32 Count) const
+	{
+		const VectorRegister VMin = VectorLoadFloat3(&Min);
+		const VectorRegister VInvScale = VectorLoadFloat3(&InvScale);
+
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const int32 QX = (int32)Reader.ReadBits(BitsPerAxis);
+			const int32 QY = (int32)Reader.ReadBits(BitsPerAxis);
+			const int32 QZ = (int32)Reader.ReadBits(BitsPerAxis);
+			const VectorRegister Q = VectorIntToFloat(MakeVectorRegisterInt(QX, QY, QZ, 0));
+			const VectorRegister V = VectorMultiplyAdd(Q, VInvScale, VMin);
+			VectorStoreFloat3(V, &OutVectors[Index]);
+		}
+	}
+
+	/*-----------------------------------------------------------------------------
+		FOctahedralNormalCodec
+	-----------------------------------------------------------------------------*/
+
+	void FOctahedralNormalCodec::EncodeBatch(const FVector* Normals, int32 Count, FBitWriter& Writer) const
+	{
+		const VectorRegister VZero = VectorZero();
+		const VectorRegister VOne = VectorOne();
+		const VectorRegister VMinusOne = GlobalVectorConstants::FloatMinusOne;
+		const VectorRegister VHalf = GlobalVectorConstants::FloatOneHalf;
+		const VectorRegister VSmall = GlobalVectorConstants::SmallNumber;
+		const VectorRegister VMaxQuantized = VectorSetFloat1(MaxQuantized);
+
+		// Four normals per iteration in SoA form: one register per component.
+		int32 Index = 0;
+		int32 QuantizedX[4];
+		int32 QuantizedY[4];
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			const FVector* N = Normals + Index;
+			const VectorRegister X = MakeVectorRegister(N[0].X, N[1].X, N[2].X, N[3].X);
+			const VectorRegister Y = MakeVectorRegister(N[0].Y, N[1].Y, N[2].Y, N[3].Y);
+			const VectorRegister Z = MakeVectorRegister(N[0].Z, N[1].Z, N[2].Z, N[3].Z);
+
+			const VectorRegister L1 = VectorAdd(VectorAdd(VectorAbs(X), VectorAbs(Y)), VectorAbs(Z));
+			const VectorRegister ValidMask = VectorCompareGE(L1, VSmall);
+			const VectorRegister InvL1 = VectorDivide(VOne, VectorMax(L1, VSmall));
+			VectorRegister PX = VectorSelect(ValidMask, VectorMultiply(X, InvL1), VZero);
+			VectorRegister PY = VectorSelect(ValidMask, VectorMultiply(Y, InvL1), VZero);
+
+			// Fold the lower hemisphere over the diagonals.
+			const VectorRegister SignX = VectorSelect(VectorCompareGE(PX, VZero), VOne, VMinusOne);
+			const VectorRegister SignY = VectorSelect(VectorCompareGE(PY, VZero), VOne, VMinusOne);
+			const VectorRegister FoldedX = VectorMultiply(VectorSubtract(VOne, VectorAbs(PY)), SignX);
+			const VectorRegister FoldedY = VectorMultiply(VectorSubtract(VOne, VectorAbs(PX)), SignY);
+			const VectorRegister LowerMask = VectorBitwiseAnd(ValidMask, VectorCompareLT(Z, VZero));
+			PX = VectorSelect(LowerMask, FoldedX, PX);
+			PY = VectorSelect(LowerMask, FoldedY, PY);
+
+			// [-1,1] -> [0,MaxQuantized], rounded.
+			const VectorRegister UX = VectorMin(VectorMax(VectorMultiplyAdd(PX, VHalf, VHalf), VZero), VOne);
+			const VectorRegister UY = VectorMin(VectorMax(VectorMultiplyAdd(PY, VHalf, VHalf), VZero), VOne);
+			VectorIntStore(VectorFloatToInt(VectorMultiplyAdd(UX, VMaxQuantized, VHalf)), QuantizedX);
+			VectorIntStore(VectorFloatToInt(VectorMultiplyAdd(UY, VMaxQuantized, VHalf)), QuantizedY);
+
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				Writer.WriteBits((uint32)QuantizedX[Lane], BitsPerComponent);
+				Writer.WriteBits((uint32)QuantizedY[Lane], BitsPerComponent);
+			}
+		}
+
+		for (; Index < Count; ++Index)
+		{
+			Encode(Normals[Index], Writer);
+		}
+	}
+
+	void FOctahedralNormalCodec::DecodeBatch(FBitReader& Reader, FVector* OutNormals, int32 Count) const
+	{
+		const VectorRegister VZero = VectorZero();
+		const VectorRegister VOne = VectorOne();
+		const VectorRegister VDequantize = VectorSetFloat1(2.f / MaxQuantized);
+
+		int32 Index = 0;
+		int32 QuantizedX[4];
+		int32 QuantizedY[4];
+		for (; Index + 4 <= Count; Index += 4)
+		{
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				QuantizedX[Lane] = (int32)Reader.ReadBits(BitsPerComponent);
+				QuantizedY[Lane] = (int32)Reader.ReadBits(BitsPerComponent);
+			}
+
+			VectorRegister X = VectorSubtract(VectorMultiply(VectorIntToFloat(VectorIntLoad(QuantizedX)), VDequantize), VOne);
+			VectorRegister Y = VectorSubtract(VectorMultiply(VectorIntToFloat(VectorIntLoad(QuantizedY)), VDequantize), VOne);
+			const VectorRegister Z = VectorSubtract(VectorSubtract(VOne, VectorAbs(X)), VectorAbs(Y));
+
+			// Unfold the lower hemisphere: X += (X >= 0) ? -T : T, with T = max(-Z, 0).
+			const VectorRegister T = VectorMax(VectorNegate(Z), VZero);
+			const VectorRegister NegT = VectorNegate(T);
+			X = VectorAdd(X, VectorSelect(VectorCompareGE(X, VZero), NegT, T));
+			Y = VectorAdd(Y, VectorSelect(VectorCompareGE(Y, VZero), NegT, T));
+
+			const VectorRegister LengthSquared = VectorMultiplyAdd(X, X, VectorMultiplyAdd(Y, Y, VectorMultiply(Z, Z)));
+			const VectorRegister InvLength = VectorReciprocalSqrtAccurate(LengthSquared);
+			X = VectorMultiply(X, InvLength);
+			Y = VectorMultiply(Y, InvLength);
+			const VectorRegister NZ = VectorMultiply(Z, InvLength);
+
+			for (int32 Lane = 0; Lane < 4; ++Lane)
+			{
+				OutNormals[Index + Lane] = FVector(VectorGetComponent(X, Lane), VectorGetComponent(Y, Lane), VectorGetComponent(NZ, Lane));
+			}
+		}
+
+		for (; Index < Count; ++Index)
+		{
+			OutNormals[Index] = Decode(Reader);
+		}
+	}
+
+	/*-----------------------------------------------------------------------------
+		FHalfFloatVectorCodec
+	-----------------------------------------------------------------------------*/
+
+	void FHalfFloatVectorCodec::EncodeBatch(const FVector* Vectors, int32 Count, FBitWriter& Writer) const
+	{
+		const VectorRegister VInvScale = VectorSetFloat1(InvScale);
+		float Scaled[4];
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const VectorRegister V = VectorMultiply(VectorLoadFloat3(&Vectors[Index]), VInvScale);
+			VectorStore(V, Scaled);
+			Writer.WriteBits(FFloat16(Scaled[0]).Encoded, 16);
+			Writer.WriteBits(FFloat16(Scaled[1]).Encoded, 16);
+			Writer.WriteBits(FFloat16(Scaled[2]).Encoded, 16);
+		}
+	}
+
+	void FHalfFloatVectorCodec::DecodeBatch(FBitReader& Reader, FVector* OutVectors, int32 Count) const
+	{
+		const VectorRegister VScale = VectorSetFloat1(Scale);
+		FFloat16 Half[3];
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			Half[0].Encoded = (uint16)Reader.ReadBits(16);
+			Half[1].Encoded = (uint16)Reader.ReadBits(16);
+			Half[2].Encoded = (uint16)Reader.ReadBits(16);
+			const VectorRegister V = VectorMultiply(VectorSetFloat3(Half[0].GetFloat(), Half[1].GetFloat(), Half[2].GetFloat()), VScale);
+			VectorStoreFloat3(V, &OutVectors[Index]);
+		}
+	}
+}
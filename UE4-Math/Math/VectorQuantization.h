@@ -0,0 +1,357 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+//#include "CoreTypes.h"
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+#include "Math/Vector2D.h"
+#include "Math/Box.h"
+#include "Math/Float16.h"
+#include "Serialization/BitWriter.h"
+#include "Serialization/BitReader.h"
+
+namespace UE4Math
+{
+	/**
+	 * Quantizes positions to fixed point inside a bounding box.
+	 *
+	 * Each axis is mapped linearly from [Bounds.Min, Bounds.Max] to [0, 2^BitsPerAxis - 1]. Values outside
+	 * the box are clamped to it. The worst case error per axis is half of GetStepSize().
+	 */
+	struct FFixedPointVectorCodec
+	{
+	public:
+
+		/**
+		 * Creates a codec for the given quantization box.
+		 *
+		 * @param InBounds Box that all encoded positions are expected to lie in.
+		 * @param InBitsPerAxis Number of bits used per component (1-24).
+		 */
+		FFixedPointVectorCodec(const FBox& InBounds, uint32 InBitsPerAxis)
+		{
+			Init(InBounds, InBitsPerAxis);
+		}
+
+		/**
+		 * Changes the quantization box and precision.
+		 *
+		 * @param InBounds Box that all encoded positions are expected to lie in.
+		 * @param InBitsPerAxis Number of bits used per component (1-24).
+		 */
+		void Init(const FBox& InBounds, uint32 InBitsPerAxis);
+
+	public:
+
+		/**
+		 * Quantizes a single position.
+		 *
+		 * @param V The position.
+		 * @param OutX Receives the quantized X component.
+		 * @param OutY Receives the quantized Y component.
+		 * @param OutZ Receives the quantized Z component.
+		 */
+		inline void Quantize(const FVector& V, uint32& OutX, uint32& OutY, uint32& OutZ) const
+		{
+			OutX = (uint32)FMath::TruncToInt(FMath::Clamp((V.X - Min.X) * Scale.X, 0.f, MaxQuantized) + 0.5f);
+			OutY = (uint32)FMath::TruncToInt(FMath::Clamp((V.Y - Min.Y) * Scale.Y, 0.f, MaxQuantized) + 0.5f);
+			OutZ = (uint32)FMath::TruncToInt(FMath::Clamp((V.Z - Min.Z) * Scale.Z, 0.f, MaxQuantized) + 0.5f);
+		}
+
+		/**
+		 * Reconstructs a position from its quantized components.
+		 *
+		 * @return The grid point Quantize rounded to, at most half a step from the encoded position on each axis.
+		 */
+		inline FVector Dequantize(uint32 InX, uint32 InY, uint32 InZ) const
+		{
+			return FVector(Min.X + (float)InX * InvScale.X, Min.Y + (float)InY * InvScale.Y, Min.Z + (float)InZ * InvScale.Z);
+		}
+
+		/** Writes one position to a bit stream. */
+		inline void Encode(const FVector& V, FBitWriter& Writer) const
+		{
+			uint32 QX, QY, QZ;
+			Quantize(V, QX, QY, QZ);
+			Writer.WriteBits(QX, BitsPerAxis);
+			Writer.WriteBits(QY, BitsPerAxis);
+			Writer.WriteBits(QZ, BitsPerAxis);
+		}
+
+		/** Reads one position from a bit stream. */
+		inline FVector Decode(FBitReader& Reader) const
+		{
+			const uint32 QX = Reader.ReadBits(BitsPerAxis);
+			const uint32 QY = Reader.ReadBits(BitsPerAxis);
+			const uint32 QZ = Reader.ReadBits(BitsPerAxis);
+			return Dequantize(QX, QY, QZ);
+		}
+
+		/**
+		 * Writes an array of positions to a bit stream.
+		 *
+		 * @param Vectors Positions to encode.
+		 * @param Count Number of positions.
+		 * @param Writer Stream to append to.
+		 */
+		void EncodeBatch(const FVector* Vectors, int32 Count, FBitWriter& Writer) const;
+
+		/**
+		 * Reads an array of positions from a bit stream.
+		 *
+		 * @param Reader Stream to read from.
+		 * @param OutVectors Receives the decoded positions.
+		 * @param Count Number of positions to read.
+		 */
+		void DecodeBatch(FBitReader& Reader, FVector* OutVectors, int32 Count) const;
+
+	public:
+
+		/** @return Number of bits written per position. */
+		inline uint32 GetBitsPerVector() const
+		{
+			return BitsPerAxis * 3;
+		}
+
+		/** @return Size of one quantization step on each axis. */
+		inline FVector GetStepSize() const
+		{
+			return InvScale;
+		}
+
+	private:
+
+		/** Minimum corner of the quantization box. */
+		FVector Min;
+
+		/** Maps box space to quantized space per axis. */
+		FVector Scale;
+
+		/** Maps quantized space back to box space per axis. */
+		FVector InvScale;
+
+		/** Largest quantized value, (2^BitsPerAxis - 1). */
+		float MaxQuantized;
+
+		/** Number of bits per component. */
+		uint32 BitsPerAxis;
+	};
+
+
+	/** Precision options for octahedral unit vector encoding, valued by bits per component. */
+	namespace EOctahedralPrecision
+	{
+		enum Type
+		{
+			/** 2x8 bits, about 1 degree worst case error. */
+			Bits16 = 8,
+			/** 2x12 bits, about 0.06 degrees worst case error. */
+			Bits24 = 12,
+			/** 2x16 bits, about 0.004 degrees worst case error. */
+			Bits32 = 16,
+		};
+	}
+
+	/**
+	 * Encodes unit vectors with an octahedral mapping.
+	 *
+	 * The sphere is projected onto an octahedron and unfolded onto the [-1,1] square, which spreads the
+	 * quantization error much more evenly than storing two spherical angles or three clamped components.
+	 */
+	struct FOctahedralNormalCodec
+	{
+	public:
+
+		/**
+		 * Creates a codec with the given precision.
+		 *
+		 * @param InPrecision Number of bits used per encoded component.
+		 */
+		explicit FOctahedralNormalCodec(EOctahedralPrecision::Type InPrecision = EOctahedralPrecision::Bits24)
+			: BitsPerComponent((uint32)InPrecision)
+			, MaxQuantized((float)((1u << (uint32)InPrecision) - 1))
+		{ }
+
+	public:
+
+		/**
+		 * Maps a direction onto the octahedron square.
+		 *
+		 * @param N The direction, does not need to be normalized. Zero maps to +Z.
+		 * @return Coordinates in [-1,1].
+		 */
+		static inline FVector2D UnitVectorToOctahedron(const FVector& N)
+		{
+			const float L1 = FMath::Abs(N.X) + FMath::Abs(N.Y) + FMath::Abs(N.Z);
+			if (L1 < SMALL_NUMBER)
+			{
+				return FVector2D(0.f, 0.f);
+			}
+
+			const float InvL1 = 1.f / L1;
+			float X = N.X * InvL1;
+			float Y = N.Y * InvL1;
+			if (N.Z < 0.f)
+			{
+				// Fold the lower hemisphere over the diagonals.
+				const float FoldedX = (1.f - FMath::Abs(Y)) * FMath::FloatSelect(X, 1.f, -1.f);
+				const float FoldedY = (1.f - FMath::Abs(X)) * FMath::FloatSelect(Y, 1.f, -1.f);
+				X = FoldedX;
+				Y = FoldedY;
+			}
+			return FVector2D(X, Y);
+		}
+
+		/**
+		 * Maps coordinates on the octahedron square back to a unit vector.
+		 *
+		 * @param Oct Coordinates in [-1,1].
+		 * @return The normalized direction.
+		 */
+		static inline FVector OctahedronToUnitVector(const FVector2D& Oct)
+		{
+			FVector N(Oct.X, Oct.Y, 1.f - FMath::Abs(Oct.X) - FMath::Abs(Oct.Y));
+			const float T = FMath::Max(-N.Z, 0.f);
+			N.X += FMath::FloatSelect(N.X, -T, T);
+			N.Y += FMath::FloatSelect(N.Y, -T, T);
+			return N * FMath::InvSqrt(N.SizeSquared());
+		}
+
+		/** Writes one unit vector to a bit stream. */
+		inline void Encode(const FVector& N, FBitWriter& Writer) const
+		{
+			const FVector2D Oct = UnitVectorToOctahedron(N);
+			Writer.WriteBits(QuantizeComponent(Oct.X), BitsPerComponent);
+			Writer.WriteBits(QuantizeComponent(Oct.Y), BitsPerComponent);
+		}
+
+		/** Reads one unit vector from a bit stream. */
+		inline FVector Decode(FBitReader& Reader) const
+		{
+			const float X = DequantizeComponent(Reader.ReadBits(BitsPerComponent));
+			const float Y = DequantizeComponent(Reader.ReadBits(BitsPerComponent));
+			return OctahedronToUnitVector(FVector2D(X, Y));
+		}
+
+		/**
+		 * Writes an array of unit vectors to a bit stream, four at a time in vector registers.
+		 *
+		 * @param Normals Directions to encode.
+		 * @param Count Number of directions.
+		 * @param Writer Stream to append to.
+		 */
+		void EncodeBatch(const FVector* Normals, int32 Count, FBitWriter& Writer) const;
+
+		/**
+		 * Reads an array of unit vectors from a bit stream, four at a time in vector registers.
+		 *
+		 * @param Reader Stream to read from.
+		 * @param OutNormals Receives the decoded directions.
+		 * @param Count Number of directions to read.
+		 */
+		void DecodeBatch(FBitReader& Reader, FVector* OutNormals, int32 Count) const;
+
+	public:
+
+		/** @return Number of bits written per unit vector. */
+		inline uint32 GetBitsPerVector() const
+		{
+			return BitsPerComponent * 2;
+		}
+
+	private:
+
+		inline uint32 QuantizeComponent(float X) const
+		{
+			return (uint32)FMath::TruncToInt(FMath::Clamp(X * 0.5f + 0.5f, 0.f, 1.f) * MaxQuantized + 0.5f);
+		}
+
+		inline float DequantizeComponent(uint32 Q) const
+		{
+			return (float)Q * (2.f / MaxQuantized) - 1.f;
+		}
+
+		/** Number of bits per encoded component. */
+		uint32 BitsPerComponent;
+
+		/** Largest quantized value, (2^BitsPerComponent - 1). */
+		float MaxQuantized;
+	};
+
+
+	/**
+	 * Encodes vectors such as velocities as three scaled half floats.
+	 *
+	 * Components are divided by Scale before conversion so that typical magnitudes land where half
+	 * precision has the most resolution. Magnitudes above 65504 * Scale saturate.
+	 */
+	struct FHalfFloatVectorCodec
+	{
+	public:
+
+		/**
+		 * Creates a codec with the given scale.
+		 *
+		 * @param InScale Units represented by 1.0 in the encoded half floats.
+		 */
+		explicit FHalfFloatVectorCodec(float InScale = 1.f)
+			: Scale(InScale)
+			, InvScale(1.f / InScale)
+		{ }
+
+	public:
+
+		/** Writes one vector to a bit stream. */
+		inline void Encode(const FVector& V, FBitWriter& Writer) const
+		{
+			Writer.WriteBits(FFloat16(V.X * InvScale).Encoded, 16);
+			Writer.WriteBits(FFloat16(V.Y * InvScale).Encoded, 16);
+			Writer.WriteBits(FFloat16(V.Z * InvScale).Encoded, 16);
+		}
+
+		/** Reads one vector from a bit stream. */
+		inline FVector Decode(FBitReader& Reader) const
+		{
+			FFloat16 HX, HY, HZ;
+			HX.Encoded = (uint16)Reader.ReadBits(16);
+			HY.Encoded = (uint16)Reader.ReadBits(16);
+			HZ.Encoded = (uint16)Reader.ReadBits(16);
+			return FVector(HX.GetFloat() * Scale, HY.GetFloat() * Scale, HZ.GetFloat() * Scale);
+		}
+
+		/**
+		 * Writes an array of vectors to a bit stream.
+		 *
+		 * @param Vectors Vectors to encode.
+		 * @param Count Number of vectors.
+		 * @param Writer Stream to append to.
+		 */
+		void EncodeBatch(const FVector* Vectors, int32 Count, FBitWriter& Writer) const;
+
+		/**
+		 * Reads an array of vectors from a bit stream.
+		 *
+		 * @param Reader Stream to read from.
+		 * @param OutVectors Receives the decoded vectors.
+		 * @param Count Number of vectors to read.
+		 */
+		void DecodeBatch(FBitReader& Reader, FVector* OutVectors, int32 Count) const;
+
+	public:
+
+		/** @return Number of bits written per vector. */
+		inline uint32 GetBitsPerVector() const
+		{
+			return 48;
+		}
+
+	private:
+
+		/** Units represented by 1.0 in the encoded half floats. */
+		float Scale;
+
+		/** 1 / Scale. */
+		float InvScale;
+	};
+}
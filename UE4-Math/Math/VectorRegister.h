@@ -26,7 +26,7 @@
 namespace UE4Math
 {
 	/** Vector that represents (1/255,1/255,1/255,1/255) */
-	extern const VectorRegister VECTOR_INV_255;
+	inline constexpr VectorRegister VECTOR_INV_255 = DECLARE_VECTOR_REGISTER(1.f / 255.f, 1.f / 255.f, 1.f / 255.f, 1.f / 255.f);
 
 	/**
 	* Below this weight threshold, animations won't be blended in.
@@ -35,8 +35,8 @@ namespace UE4Math
 
 	namespace GlobalVectorConstants
 	{
-		static const VectorRegister AnimWeightThreshold = MakeVectorRegister(ZERO_ANIMWEIGHT_THRESH, ZERO_ANIMWEIGHT_THRESH, ZERO_ANIMWEIGHT_THRESH, ZERO_ANIMWEIGHT_THRESH);
-		static const VectorRegister RotationSignificantThreshold = MakeVectorRegister(1.0f - DELTA * DELTA, 1.0f - DELTA * DELTA, 1.0f - DELTA * DELTA, 1.0f - DELTA * DELTA);
+		inline constexpr VectorRegister AnimWeightThreshold = MakeVectorRegister(ZERO_ANIMWEIGHT_THRESH, ZERO_ANIMWEIGHT_THRESH, ZERO_ANIMWEIGHT_THRESH, ZERO_ANIMWEIGHT_THRESH);
+		inline constexpr VectorRegister RotationSignificantThreshold = MakeVectorRegister(1.0f - DELTA * DELTA, 1.0f - DELTA * DELTA, 1.0f - DELTA * DELTA, 1.0f - DELTA * DELTA);
 	}
 }
 
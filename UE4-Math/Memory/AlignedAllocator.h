@@ -0,0 +1,131 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <new>
+#include <vector>
+#include "Memory/FMemory.h"
+#include "Memory/MemStack.h"
+#include "Misc/CoreMiscDefines.h"
+
+namespace UE4Math
+{
+	/**
+	 * STL allocator handing out blocks from FMemory::Malloc with a fixed minimum alignment,
+	 * e.g. 32 bytes for AVX loads or 64 bytes for cache line aligned SoA buffers.
+	 */
+	template <typename T, uint32 Alignment = 64>
+	class TAlignedAllocator
+	{
+		static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+	public:
+		typedef T value_type;
+
+		template <typename OtherType>
+		struct rebind
+		{
+			typedef TAlignedAllocator<OtherType, Alignment> other;
+		};
+
+		TAlignedAllocator() noexcept = default;
+
+		template <typename OtherType>
+		TAlignedAllocator(const TAlignedAllocator<OtherType, Alignment>&) noexcept
+		{
+		}
+
+		T* allocate(size_t Count)
+		{
+			void* Ptr = FMemory::Malloc(Count * sizeof(T), Alignment > alignof(T) ? Alignment : (uint32)alignof(T));
+			if (!Ptr)
+			{
+				// Required by the standard allocator contract, containers do not check for null.
+				throw std::bad_alloc();
+			}
+			return (T*)Ptr;
+		}
+
+		void deallocate(T* Ptr, size_t)
+		{
+			FMemory::Free(Ptr);
+		}
+
+		template <typename OtherType>
+		bool operator==(const TAlignedAllocator<OtherType, Alignment>&) const noexcept
+		{
+			return true;
+		}
+
+		template <typename OtherType>
+		bool operator!=(const TAlignedAllocator<OtherType, Alignment>&) const noexcept
+		{
+			return false;
+		}
+	};
+
+	/**
+	 * STL allocator allocating from a memory stack. Deallocation is a no-op, the memory is released
+	 * with the stack's marks or Flush(), so containers using it must not outlive that point.
+	 */
+	template <typename T, uint32 Alignment = 16>
+	class TMemStackAllocator
+	{
+		static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two.");
+
+	public:
+		typedef T value_type;
+
+		template <typename OtherType>
+		struct rebind
+		{
+			typedef TMemStackAllocator<OtherType, Alignment> other;
+		};
+
+		explicit TMemStackAllocator(FMemStackBase& InMem = FMemStack::Get()) noexcept
+			: Mem(&InMem)
+		{
+		}
+
+		template <typename OtherType>
+		TMemStackAllocator(const TMemStackAllocator<OtherType, Alignment>& Other) noexcept
+			: Mem(Other.Mem)
+		{
+		}
+
+		T* allocate(size_t Count)
+		{
+			return (T*)Mem->PushBytes(Count * sizeof(T), Alignment > alignof(T) ? Alignment : alignof(T));
+		}
+
+		void deallocate(T*, size_t)
+		{
+		}
+
+		template <typename OtherType>
+		bool operator==(const TMemStackAllocator<OtherType, Alignment>& Other) const noexcept
+		{
+			return Mem == Other.Mem;
+		}
+
+		template <typename OtherType>
+		bool operator!=(const TMemStackAllocator<OtherType, Alignment>& Other) const noexcept
+		{
+			return Mem != Other.Mem;
+		}
+
+	private:
+		template <typename OtherType, uint32 OtherAlignment>
+		friend class TMemStackAllocator;
+
+		FMemStackBase* Mem;
+	};
+
+	/** std::vector with storage aligned to Alignment bytes. */
+	template <typename T, uint32 Alignment = 64>
+	using TAlignedVector = std::vector<T, TAlignedAllocator<T, Alignment>>;
+
+	/** std::vector allocating from a memory stack, for per frame temporaries. */
+	template <typename T, uint32 Alignment = 16>
+	using TMemStackVector = std::vector<T, TMemStackAllocator<T, Alignment>>;
+}
@@ -1,68 +1,240 @@
 #include "FMemory.h"
 #include "Math/UnrealMathUtility.h"
 
-//void UE4Math::FMemory::MemswapGreaterThan8(void* Ptr1, void* Ptr2, size_t Size)
-//{
-//	union PtrUnion
-//	{
-//		void* PtrVoid;
-//		uint8_t* Ptr8;
-//		uint16_t* Ptr16;
-//		uint32_t* Ptr32;
-//		uint64_t* Ptr64;
-//		UPTRINT PtrUint;
-//	};
-//
-//	PtrUnion Union1 = { Ptr1 };
-//	PtrUnion Union2 = { Ptr2 };
-//
-//	//checkf(Union1.PtrVoid && Union2.PtrVoid, TEXT("Pointers must be non-null: %p, %p"), Union1.PtrVoid, Union2.PtrVoid);
-//
-//	// We may skip up to 7 bytes below, so better make sure that we're swapping more than that
-//	// (8 is a common case that we also want to inline before we this call, so skip that too)
-//	//check(Size > 8);
-//
-//	if (Union1.PtrUint & 1)
-//	{
-//		Valswap(*Union1.Ptr8++, *Union2.Ptr8++);
-//		Size -= 1;
-//	}
-//	if (Union1.PtrUint & 2)
-//	{
-//		Valswap(*Union1.Ptr16++, *Union2.Ptr16++);
-//		Size -= 2;
-//	}
-//	if (Union1.PtrUint & 4)
-//	{
-//		Valswap(*Union1.Ptr32++, *Union2.Ptr32++);
-//		Size -= 4;
-//	}
-//
-//	uint32_t CommonAlignment = FMath::Min(FMath::CountTrailingZeros(Union1.PtrUint - Union2.PtrUint), 3u);
-//	switch (CommonAlignment)
-//	{
-//	default:
-//		for (; Size >= 8; Size -= 8)
-//		{
-//			Valswap(*Union1.Ptr64++, *Union2.Ptr64++);
-//		}
-//
-//	case 2:
-//		for (; Size >= 4; Size -= 4)
-//		{
-//			Valswap(*Union1.Ptr32++, *Union2.Ptr32++);
-//		}
-//
-//	case 1:
-//		for (; Size >= 2; Size -= 2)
-//		{
-//			Valswap(*Union1.Ptr16++, *Union2.Ptr16++);
-//		}
-//
-//	case 0:
-//		for (; Size >= 1; Size -= 1)
-//		{
-//			Valswap(*Union1.Ptr8++, *Union2.Ptr8++);
-//		}
-//	}
-//}
+#if PLATFORM_ALWAYS_HAS_SSE2
+#include <emmintrin.h>
+#endif
+#if PLATFORM_ALWAYS_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace UE4Math
+{
+	namespace MemoryPrivate
+	{
+		/**
+		 * Blocks are over-allocated from the system heap. The requested size and the pointer returned
+		 * by SystemMalloc are stored just below the aligned block handed out to the caller.
+		 */
+		enum { HeaderSize = sizeof(void*) + sizeof(size_t) };
+
+		/** Below this, setting up the non-temporal loop costs more than the cache pollution it saves. */
+		enum { MinStreamingSize = 4 * 1024 };
+
+		/** BigBlockMemcpy streams blocks past this size, they would flush most of the last level cache anyway. */
+		enum { BigBlockStreamingSize = 8 * 1024 * 1024 };
+
+		/** How far ahead of the loads BigBlockMemcpy prefetches. */
+		enum { PrefetchDistance = 512 };
+
+		inline void*& GetSystemPointer(void* Ptr)
+		{
+			return *((void**)((uint8*)Ptr - sizeof(void*)));
+		}
+
+		inline size_t& GetRequestedSize(void* Ptr)
+		{
+			return *((size_t*)((uint8*)Ptr - HeaderSize));
+		}
+	}
+
+	void* FMemory::Malloc(size_t Count, uint32 Alignment)
+	{
+		Alignment = FMath::Max(Count >= 16 ? (uint32)16 : (uint32)MIN_ALIGNMENT, Alignment);
+		ensure(FMath::IsPowerOfTwo(Alignment));
+
+		void* Ptr = SystemMalloc(Count + Alignment + MemoryPrivate::HeaderSize);
+		if (!Ptr)
+		{
+			return nullptr;
+		}
+
+		void* Result = (void*)(((UPTRINT)Ptr + MemoryPrivate::HeaderSize + Alignment - 1) & ~(UPTRINT)(Alignment - 1));
+		MemoryPrivate::GetSystemPointer(Result) = Ptr;
+		MemoryPrivate::GetRequestedSize(Result) = Count;
+		return Result;
+	}
+
+	void* FMemory::Realloc(void* Original, size_t Count, uint32 Alignment)
+	{
+		if (!Original)
+		{
+			return Malloc(Count, Alignment);
+		}
+		if (Count == 0)
+		{
+			Free(Original);
+			return nullptr;
+		}
+
+		void* Result = Malloc(Count, Alignment);
+		if (Result)
+		{
+			Memcpy(Result, Original, FMath::Min(Count, MemoryPrivate::GetRequestedSize(Original)));
+			Free(Original);
+		}
+		return Result;
+	}
+
+	void FMemory::Free(void* Original)
+	{
+		if (Original)
+		{
+			SystemFree(MemoryPrivate::GetSystemPointer(Original));
+		}
+	}
+
+	size_t FMemory::GetAllocSize(void* Original)
+	{
+		return Original ? MemoryPrivate::GetRequestedSize(Original) : 0;
+	}
+
+	void* FMemory::BigBlockMemcpy(void* Dest, const void* Src, size_t Count)
+	{
+		if (Count >= MemoryPrivate::BigBlockStreamingSize)
+		{
+			return StreamingMemcpy(Dest, Src, Count);
+		}
+
+#if PLATFORM_ALWAYS_HAS_AVX2
+		uint8* DestBytes = (uint8*)Dest;
+		const uint8* SrcBytes = (const uint8*)Src;
+		for (; Count >= 128; Count -= 128, DestBytes += 128, SrcBytes += 128)
+		{
+			_mm_prefetch((const char*)SrcBytes + MemoryPrivate::PrefetchDistance, _MM_HINT_T0);
+			_mm_prefetch((const char*)SrcBytes + MemoryPrivate::PrefetchDistance + 64, _MM_HINT_T0);
+			const __m256i V0 = _mm256_loadu_si256((const __m256i*)(SrcBytes + 0));
+			const __m256i V1 = _mm256_loadu_si256((const __m256i*)(SrcBytes + 32));
+			const __m256i V2 = _mm256_loadu_si256((const __m256i*)(SrcBytes + 64));
+			const __m256i V3 = _mm256_loadu_si256((const __m256i*)(SrcBytes + 96));
+			_mm256_storeu_si256((__m256i*)(DestBytes + 0), V0);
+			_mm256_storeu_si256((__m256i*)(DestBytes + 32), V1);
+			_mm256_storeu_si256((__m256i*)(DestBytes + 64), V2);
+			_mm256_storeu_si256((__m256i*)(DestBytes + 96), V3);
+		}
+		memcpy(DestBytes, SrcBytes, Count);
+		return Dest;
+#else
+		return memcpy(Dest, Src, Count);
+#endif
+	}
+
+	void* FMemory::StreamingMemcpy(void* Dest, const void* Src, size_t Count)
+	{
+#if PLATFORM_ALWAYS_HAS_SSE2
+		if (Count >= MemoryPrivate::MinStreamingSize)
+		{
+			uint8* DestBytes = (uint8*)Dest;
+			const uint8* SrcBytes = (const uint8*)Src;
+
+			// Non-temporal stores need an aligned destination, the loads can stay unaligned.
+			const size_t HeadSize = (16 - ((UPTRINT)DestBytes & 15)) & 15;
+			memcpy(DestBytes, SrcBytes, HeadSize);
+			DestBytes += HeadSize;
+			SrcBytes += HeadSize;
+			Count -= HeadSize;
+
+			for (; Count >= 64; Count -= 64, DestBytes += 64, SrcBytes += 64)
+			{
+				const __m128i V0 = _mm_loadu_si128((const __m128i*)(SrcBytes + 0));
+				const __m128i V1 = _mm_loadu_si128((const __m128i*)(SrcBytes + 16));
+				const __m128i V2 = _mm_loadu_si128((const __m128i*)(SrcBytes + 32));
+				const __m128i V3 = _mm_loadu_si128((const __m128i*)(SrcBytes + 48));
+				_mm_stream_si128((__m128i*)(DestBytes + 0), V0);
+				_mm_stream_si128((__m128i*)(DestBytes + 16), V1);
+				_mm_stream_si128((__m128i*)(DestBytes + 32), V2);
+				_mm_stream_si128((__m128i*)(DestBytes + 48), V3);
+			}
+
+			// Streaming stores are weakly ordered, make them visible before anyone reads the block.
+			_mm_sfence();
+			memcpy(DestBytes, SrcBytes, Count);
+			return Dest;
+		}
+#endif
+		return memcpy(Dest, Src, Count);
+	}
+
+	void FMemory::MemswapGreaterThan8(void* Ptr1, void* Ptr2, size_t Size)
+	{
+		union PtrUnion
+		{
+			void* PtrVoid;
+			uint8* Ptr8;
+			uint16* Ptr16;
+			uint32* Ptr32;
+			uint64* Ptr64;
+			UPTRINT PtrUint;
+		};
+
+		PtrUnion Union1 = { Ptr1 };
+		PtrUnion Union2 = { Ptr2 };
+
+		// We may skip up to 7 bytes below, so better make sure that we're swapping more than that
+		// (8 is a common case that we also want to inline before we this call, so skip that too)
+		ensure(Union1.PtrVoid && Union2.PtrVoid && Size > 8);
+
+		if (Union1.PtrUint & 1)
+		{
+			Valswap(*Union1.Ptr8++, *Union2.Ptr8++);
+			Size -= 1;
+		}
+		if (Union1.PtrUint & 2)
+		{
+			Valswap(*Union1.Ptr16++, *Union2.Ptr16++);
+			Size -= 2;
+		}
+		if (Union1.PtrUint & 4)
+		{
+			Valswap(*Union1.Ptr32++, *Union2.Ptr32++);
+			Size -= 4;
+		}
+
+#if PLATFORM_ALWAYS_HAS_AVX2
+		for (; Size >= 32; Size -= 32, Union1.Ptr8 += 32, Union2.Ptr8 += 32)
+		{
+			const __m256i V1 = _mm256_loadu_si256((const __m256i*)Union1.Ptr8);
+			const __m256i V2 = _mm256_loadu_si256((const __m256i*)Union2.Ptr8);
+			_mm256_storeu_si256((__m256i*)Union1.Ptr8, V2);
+			_mm256_storeu_si256((__m256i*)Union2.Ptr8, V1);
+		}
+#elif PLATFORM_ALWAYS_HAS_SSE2
+		// Unaligned vector loads are cheap enough that the relative alignment of the blocks does not matter.
+		for (; Size >= 16; Size -= 16, Union1.Ptr8 += 16, Union2.Ptr8 += 16)
+		{
+			const __m128i V1 = _mm_loadu_si128((const __m128i*)Union1.Ptr8);
+			const __m128i V2 = _mm_loadu_si128((const __m128i*)Union2.Ptr8);
+			_mm_storeu_si128((__m128i*)Union1.Ptr8, V2);
+			_mm_storeu_si128((__m128i*)Union2.Ptr8, V1);
+		}
+#endif
+
+		uint32 CommonAlignment = FMath::Min(FMath::CountTrailingZeros((uint32)(Union1.PtrUint - Union2.PtrUint)), 3u);
+		switch (CommonAlignment)
+		{
+		default:
+			for (; Size >= 8; Size -= 8)
+			{
+				Valswap(*Union1.Ptr64++, *Union2.Ptr64++);
+			}
+
+		case 2:
+			for (; Size >= 4; Size -= 4)
+			{
+				Valswap(*Union1.Ptr32++, *Union2.Ptr32++);
+			}
+
+		case 1:
+			for (; Size >= 2; Size -= 2)
+			{
+				Valswap(*Union1.Ptr16++, *Union2.Ptr16++);
+			}
+
+		case 0:
+			for (; Size >= 1; Size -= 1)
+			{
+				Valswap(*Union1.Ptr8++, *Union2.Ptr8++);
+			}
+		}
+	}
+}
@@ -1,33 +1,44 @@
+#pragma once
 
 #include <wchar.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h> 
-#include <malloc.h>.
+#include <malloc.h>
+#include "Misc/CoreMiscDefines.h"
 
 namespace UE4Math
 {
+	enum
+	{
+		// Default allocator alignment. If the default is specified, the allocator applies to engine rules.
+		// Blocks >= 16 bytes will be 16-byte-aligned, Blocks < 16 will be 8-byte aligned.
+		DEFAULT_ALIGNMENT = 0,
+
+		// Minimum allocator alignment
+		MIN_ALIGNMENT = 8,
+	};
 
 	/*-----------------------------------------------------------------------------
 		FMemory.
 	-----------------------------------------------------------------------------*/
 
-	//template <typename T>
-	//static inline void Valswap(T& A, T& B)
-	//{
-	//	// Usually such an implementation would use move semantics, but
-	//	// we're only ever going to call it on fundamental types and MoveTemp
-	//	// is not necessarily in scope here anyway, so we don't want to
-	//	// #include it if we don't need to.
-	//	T Tmp = A;
-	//	A = B;
-	//	B = Tmp;
-	//}
+	template <typename T>
+	static inline void Valswap(T& A, T& B)
+	{
+		// Usually such an implementation would use move semantics, but
+		// we're only ever going to call it on fundamental types and MoveTemp
+		// is not necessarily in scope here anyway, so we don't want to
+		// #include it if we don't need to.
+		T Tmp = A;
+		A = B;
+		B = Tmp;
+	}
 
 
 	struct FMemory
 	{
-		//static void MemswapGreaterThan8(void* Ptr1, void* Ptr2, size_t Size);
+		static void MemswapGreaterThan8(void* Ptr1, void* Ptr2, size_t Size);
 		/** @name Memory functions (wrapper for FPlatformMemory) */
 
 		static inline void* Memmove(void* Dest, const void* Src, size_t Count)
@@ -76,71 +87,75 @@ namespace UE4Math
 			Memcpy(&Dest, &Src, sizeof(T));
 		}
 
-		static inline void* BigBlockMemcpy(void* Dest, const void* Src, size_t Count)
-		{
-			return memcpy(Dest, Src, Count);
-		}
+		/**
+		 * Copies a large block (several KB and up). Uses 32 byte loads and stores with software prefetch
+		 * on AVX2 builds, and switches to StreamingMemcpy for blocks too large to stay in the cache anyway.
+		 * The blocks must not overlap.
+		 */
+		static void* BigBlockMemcpy(void* Dest, const void* Src, size_t Count);
 
-		static inline void* StreamingMemcpy(void* Dest, const void* Src, size_t Count)
+		/**
+		 * Copies a block with non-temporal stores, so the destination does not evict the working set
+		 * from the cache. Use for output buffers that will not be read again soon. Small copies fall
+		 * back to memcpy. The stores are fenced before returning. The blocks must not overlap.
+		 */
+		static void* StreamingMemcpy(void* Dest, const void* Src, size_t Count);
+
+		static inline void Memswap(void* Ptr1, void* Ptr2, size_t Size)
 		{
-			return memcpy(Dest, Src, Count);
+			switch (Size)
+			{
+			case 0:
+				break;
+
+			case 1:
+				Valswap(*(uint8_t*)Ptr1, *(uint8_t*)Ptr2);
+				break;
+
+			case 2:
+				Valswap(*(uint16_t*)Ptr1, *(uint16_t*)Ptr2);
+				break;
+
+			case 3:
+				Valswap(*((uint16_t*&)Ptr1)++, *((uint16_t*&)Ptr2)++);
+				Valswap(*(uint8_t*)Ptr1, *(uint8_t*)Ptr2);
+				break;
+
+			case 4:
+				Valswap(*(uint32_t*)Ptr1, *(uint32_t*)Ptr2);
+				break;
+
+			case 5:
+				Valswap(*((uint32_t*&)Ptr1)++, *((uint32_t*&)Ptr2)++);
+				Valswap(*(uint8_t*)Ptr1, *(uint8_t*)Ptr2);
+				break;
+
+			case 6:
+				Valswap(*((uint32_t*&)Ptr1)++, *((uint32_t*&)Ptr2)++);
+				Valswap(*(uint16_t*)Ptr1, *(uint16_t*)Ptr2);
+				break;
+
+			case 7:
+				Valswap(*((uint32_t*&)Ptr1)++, *((uint32_t*&)Ptr2)++);
+				Valswap(*((uint16_t*&)Ptr1)++, *((uint16_t*&)Ptr2)++);
+				Valswap(*(uint8_t*)Ptr1, *(uint8_t*)Ptr2);
+				break;
+
+			case 8:
+				Valswap(*(uint64_t*)Ptr1, *(uint64_t*)Ptr2);
+				break;
+
+			case 16:
+				Valswap(((uint64_t*)Ptr1)[0], ((uint64_t*)Ptr2)[0]);
+				Valswap(((uint64_t*)Ptr1)[1], ((uint64_t*)Ptr2)[1]);
+				break;
+
+			default:
+				MemswapGreaterThan8(Ptr1, Ptr2, Size);
+				break;
+			}
 		}
 
-		//static inline void Memswap(void* Ptr1, void* Ptr2, size_t Size)
-		//{
-		//	switch (Size)
-		//	{
-		//	case 0:
-		//		break;
-
-		//	case 1:
-		//		Valswap(*(uint8_t*)Ptr1, *(uint8_t*)Ptr2);
-		//		break;
-
-		//	case 2:
-		//		Valswap(*(uint16_t*)Ptr1, *(uint16_t*)Ptr2);
-		//		break;
-
-		//	case 3:
-		//		Valswap(*((uint16_t*&)Ptr1)++, *((uint16_t*&)Ptr2)++);
-		//		Valswap(*(uint8_t*)Ptr1, *(uint8_t*)Ptr2);
-		//		break;
-
-		//	case 4:
-		//		Valswap(*(uint32_t*)Ptr1, *(uint32_t*)Ptr2);
-		//		break;
-
-		//	case 5:
-		//		Valswap(*((uint32_t*&)Ptr1)++, *((uint32_t*&)Ptr2)++);
-		//		Valswap(*(uint8_t*)Ptr1, *(uint8_t*)Ptr2);
-		//		break;
-
-		//	case 6:
-		//		Valswap(*((uint32_t*&)Ptr1)++, *((uint32_t*&)Ptr2)++);
-		//		Valswap(*(uint16_t*)Ptr1, *(uint16_t*)Ptr2);
-		//		break;
-
-		//	case 7:
-		//		Valswap(*((uint32_t*&)Ptr1)++, *((uint32_t*&)Ptr2)++);
-		//		Valswap(*((uint16_t*&)Ptr1)++, *((uint16_t*&)Ptr2)++);
-		//		Valswap(*(uint8_t*)Ptr1, *(uint8_t*)Ptr2);
-		//		break;
-
-		//	case 8:
-		//		Valswap(*(uint64_t*)Ptr1, *(uint64_t*)Ptr2);
-		//		break;
-
-		//	case 16:
-		//		Valswap(((uint64_t*)Ptr1)[0], ((uint64_t*)Ptr2)[0]);
-		//		Valswap(((uint64_t*)Ptr1)[1], ((uint64_t*)Ptr2)[1]);
-		//		break;
-
-		//	default:
-		//		MemswapGreaterThan8(Ptr1, Ptr2, Size);
-		//		break;
-		//	}
-		//}
-
 		//
 		// C style memory allocation stubs that fall back to C runtime
 		//
@@ -158,10 +173,26 @@ namespace UE4Math
 		// C style memory allocation stubs.
 		//
 
-		//static void* Malloc(size_t Count, uint32 Alignment = DEFAULT_ALIGNMENT);
-		//static void* Realloc(void* Original, size_t Count, uint32 Alignment = DEFAULT_ALIGNMENT);
-		//static void Free(void* Original);
-		//static size_t GetAllocSize(void* Original);
+		/**
+		 * Allocates a block of memory.
+		 *
+		 * @param Count Size of the block in bytes.
+		 * @param Alignment Alignment of the block (power of two), DEFAULT_ALIGNMENT for 16 bytes (8 for blocks under 16 bytes).
+		 * @return The block, or null if the system is out of memory. Release with Free.
+		 */
+		static void* Malloc(size_t Count, uint32 Alignment = DEFAULT_ALIGNMENT);
+
+		/**
+		 * Resizes a block from Malloc, keeping its contents up to the smaller of the two sizes.
+		 * A null Original behaves like Malloc, a zero Count like Free (returning null).
+		 */
+		static void* Realloc(void* Original, size_t Count, uint32 Alignment = DEFAULT_ALIGNMENT);
+
+		/** Releases a block from Malloc or Realloc. Null is ignored. */
+		static void Free(void* Original);
+
+		/** @return The size that was requested for a block from Malloc or Realloc. */
+		static size_t GetAllocSize(void* Original);
 		///**
 		//* For some allocators this will return the actual size that should be requested to eliminate
 		//* internal fragmentation. The return value will always be >= Count. This can be used to grow
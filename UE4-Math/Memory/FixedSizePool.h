@@ -0,0 +1,179 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <new>
+#include <utility>
+#include "Memory/FMemory.h"
+#include "Misc/CoreMiscDefines.h"
+
+namespace UE4Math
+{
+	/**
+	 * Pool of equally sized blocks carved out of pages from FMemory::Malloc.
+	 * Allocate and Free are a pointer pop/push on an intrusive free list. Pages are only returned
+	 * to the system when the pool is destroyed or emptied. Not thread safe.
+	 *
+	 * @param BlockSize Size of each block, at least a pointer and a multiple of BlockAlignment.
+	 * @param BlockAlignment Alignment of each block, a power of two.
+	 * @param PageSize Bytes requested from the system per page.
+	 */
+	template <uint32 BlockSize, uint32 BlockAlignment = 16, uint32 PageSize = 16 * 1024>
+	class TFixedSizePool
+	{
+		static_assert(BlockSize >= sizeof(void*), "Blocks must be able to hold a free list link.");
+		static_assert((BlockAlignment & (BlockAlignment - 1)) == 0, "Block alignment must be a power of two.");
+		static_assert(BlockSize % BlockAlignment == 0, "Block size must be a multiple of the alignment.");
+
+		struct FFreeBlock
+		{
+			FFreeBlock* Next;
+		};
+
+		struct FPage
+		{
+			FPage* Next;
+		};
+
+		/** Blocks start after the page header, rounded up to the block alignment. */
+		enum
+		{
+			FirstBlockOffset = (sizeof(FPage) + BlockAlignment - 1) & ~(BlockAlignment - 1),
+			BlocksPerPage = (PageSize - FirstBlockOffset) / BlockSize,
+		};
+		static_assert(BlocksPerPage > 0, "Page size is too small for a single block.");
+
+	public:
+		TFixedSizePool()
+			: FreeList(nullptr)
+			, Pages(nullptr)
+			, NumUsed(0)
+			, NumPages(0)
+		{
+		}
+
+		~TFixedSizePool()
+		{
+			FreePages();
+		}
+
+		TFixedSizePool(const TFixedSizePool&) = delete;
+		TFixedSizePool& operator=(const TFixedSizePool&) = delete;
+
+		/** @return An uninitialized block of BlockSize bytes, or null if the system is out of memory. */
+		inline void* Allocate()
+		{
+			if (!FreeList && !AllocatePage())
+			{
+				return nullptr;
+			}
+
+			FFreeBlock* Block = FreeList;
+			FreeList = Block->Next;
+			++NumUsed;
+			return Block;
+		}
+
+		/** Returns a block from Allocate to the pool. */
+		inline void Free(void* Ptr)
+		{
+			if (Ptr)
+			{
+				FFreeBlock* Block = (FFreeBlock*)Ptr;
+				Block->Next = FreeList;
+				FreeList = Block;
+				--NumUsed;
+			}
+		}
+
+		/** Constructs a T in a block from the pool. */
+		template <typename T, typename... ArgsType>
+		inline T* New(ArgsType&&... Args)
+		{
+			static_assert(sizeof(T) <= BlockSize && alignof(T) <= BlockAlignment, "Type does not fit in the pool blocks.");
+			void* Ptr = Allocate();
+			return Ptr ? new(Ptr) T(std::forward<ArgsType>(Args)...) : nullptr;
+		}
+
+		/** Destroys an object from New and returns its block to the pool. */
+		template <typename T>
+		inline void Delete(T* Object)
+		{
+			if (Object)
+			{
+				Object->~T();
+				Free(Object);
+			}
+		}
+
+		/**
+		 * Releases all pages to the system.
+		 * @return false (and does nothing) if blocks are still in use.
+		 */
+		bool Empty()
+		{
+			if (NumUsed != 0)
+			{
+				return false;
+			}
+			FreePages();
+			return true;
+		}
+
+		inline int32 GetNumUsed() const
+		{
+			return NumUsed;
+		}
+
+		inline int32 GetNumAllocated() const
+		{
+			return NumPages * BlocksPerPage;
+		}
+
+	private:
+		bool AllocatePage()
+		{
+			uint8* Memory = (uint8*)FMemory::Malloc(FirstBlockOffset + BlocksPerPage * BlockSize, BlockAlignment);
+			if (!Memory)
+			{
+				return false;
+			}
+
+			FPage* Page = (FPage*)Memory;
+			Page->Next = Pages;
+			Pages = Page;
+			++NumPages;
+
+			// Link the blocks in address order so consecutive allocations are contiguous.
+			uint8* Block = Memory + FirstBlockOffset;
+			for (int32 Index = 0; Index < BlocksPerPage; ++Index, Block += BlockSize)
+			{
+				((FFreeBlock*)Block)->Next = Index + 1 < BlocksPerPage ? (FFreeBlock*)(Block + BlockSize) : FreeList;
+			}
+			FreeList = (FFreeBlock*)(Memory + FirstBlockOffset);
+			return true;
+		}
+
+		void FreePages()
+		{
+			while (Pages)
+			{
+				FPage* Page = Pages;
+				Pages = Page->Next;
+				FMemory::Free(Page);
+			}
+			FreeList = nullptr;
+			NumPages = 0;
+		}
+
+		FFreeBlock* FreeList;
+		FPage* Pages;
+		int32 NumUsed;
+		int32 NumPages;
+	};
+
+	/** Pools sized for the common math types: FVector4/FQuat/FPlane, FMatrix and a pair of matrices. */
+	typedef TFixedSizePool<16, 16> FFixedSizePool16;
+	typedef TFixedSizePool<64, 16> FFixedSizePool64;
+	typedef TFixedSizePool<128, 16> FFixedSizePool128;
+}
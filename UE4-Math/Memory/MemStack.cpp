@@ -0,0 +1,116 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MemStack.cpp: Linear memory stack for per frame temporaries
+=============================================================================*/
+
+#include "Memory/MemStack.h"
+#include "Math/UnrealMathUtility.h"
+
+namespace UE4Math
+{
+	FMemStackBase::FMemStackBase(size_t InChunkSize)
+		: Top(nullptr)
+		, End(nullptr)
+		, TopChunk(nullptr)
+		, UnusedChunks(nullptr)
+		, ChunkSize(InChunkSize)
+	{
+	}
+
+	FMemStackBase::~FMemStackBase()
+	{
+		Flush();
+		Trim();
+	}
+
+	void FMemStackBase::AllocateNewChunk(size_t MinSize)
+	{
+		// Reuse the first free chunk that is large enough, oversized requests get a chunk of their own.
+		FChunk** Link = &UnusedChunks;
+		while (*Link && (*Link)->DataSize < MinSize)
+		{
+			Link = &(*Link)->Next;
+		}
+
+		FChunk* Chunk = *Link;
+		if (Chunk)
+		{
+			*Link = Chunk->Next;
+		}
+		else
+		{
+			const size_t DataSize = FMath::Max(MinSize, ChunkSize - sizeof(FChunk));
+			Chunk = (FChunk*)FMemory::Malloc(sizeof(FChunk) + DataSize, 16);
+			Chunk->DataSize = DataSize;
+		}
+
+		Chunk->Next = TopChunk;
+		TopChunk = Chunk;
+		Top = Chunk->Data();
+		End = Top + Chunk->DataSize;
+	}
+
+	void FMemStackBase::FreeChunks(FChunk* NewTopChunk)
+	{
+		while (TopChunk != NewTopChunk)
+		{
+			FChunk* Chunk = TopChunk;
+			TopChunk = Chunk->Next;
+			Chunk->Next = UnusedChunks;
+			UnusedChunks = Chunk;
+		}
+
+		Top = nullptr;
+		End = nullptr;
+		if (TopChunk)
+		{
+			End = TopChunk->Data() + TopChunk->DataSize;
+		}
+	}
+
+	void FMemStackBase::Flush()
+	{
+		FreeChunks(nullptr);
+	}
+
+	void FMemStackBase::Trim()
+	{
+		while (UnusedChunks)
+		{
+			FChunk* Chunk = UnusedChunks;
+			UnusedChunks = Chunk->Next;
+			FMemory::Free(Chunk);
+		}
+	}
+
+	size_t FMemStackBase::GetByteCount() const
+	{
+		size_t Count = 0;
+		for (FChunk* Chunk = TopChunk; Chunk; Chunk = Chunk->Next)
+		{
+			Count += Chunk == TopChunk ? (size_t)(Top - Chunk->Data()) : Chunk->DataSize;
+		}
+		return Count;
+	}
+
+	size_t FMemStackBase::GetReservedByteCount() const
+	{
+		size_t Count = 0;
+		for (FChunk* Chunk = TopChunk; Chunk; Chunk = Chunk->Next)
+		{
+			Count += Chunk->DataSize;
+		}
+		for (FChunk* Chunk = UnusedChunks; Chunk; Chunk = Chunk->Next)
+		{
+			Count += Chunk->DataSize;
+		}
+		return Count;
+	}
+
+	FMemStack& FMemStack::Get()
+	{
+		static thread_local FMemStack Stack;
+		return Stack;
+	}
+}
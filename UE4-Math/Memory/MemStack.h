@@ -0,0 +1,186 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Memory/FMemory.h"
+#include "Misc/CoreMiscDefines.h"
+
+namespace UE4Math
+{
+	/*-----------------------------------------------------------------------------
+		FMemStackBase.
+	-----------------------------------------------------------------------------*/
+
+	/**
+	 * Simple linear-allocation memory stack.
+	 * Items are allocated via PushBytes() or the templated helpers and are freed all at once, either
+	 * through an FMemMark going out of scope or through Flush() at the end of a frame. Chunks are kept
+	 * for reuse, so a stack that reached its working size stops calling the system allocator.
+	 * Not thread safe, use one stack per thread (see FMemStack::Get()).
+	 */
+	class FMemStackBase
+	{
+	public:
+		enum { DefaultChunkSize = 64 * 1024 };
+
+		explicit FMemStackBase(size_t InChunkSize = DefaultChunkSize);
+		~FMemStackBase();
+
+		FMemStackBase(const FMemStackBase&) = delete;
+		FMemStackBase& operator=(const FMemStackBase&) = delete;
+
+		/**
+		 * Allocates uninitialized memory from the stack.
+		 *
+		 * @param AllocSize Size of the block in bytes.
+		 * @param Alignment Alignment of the block, must be a power of two.
+		 */
+		inline void* PushBytes(size_t AllocSize, size_t Alignment)
+		{
+			uint8* Result = AlignPointer(Top, Alignment);
+			if (Top && Result + AllocSize <= End)
+			{
+				Top = Result + AllocSize;
+				return Result;
+			}
+
+			AllocateNewChunk(AllocSize + Alignment);
+			Result = AlignPointer(Top, Alignment);
+			Top = Result + AllocSize;
+			return Result;
+		}
+
+		/** Allocates uninitialized storage for Count elements of T. */
+		template <typename T>
+		inline T* PushArray(size_t Count, size_t Alignment = alignof(T))
+		{
+			return (T*)PushBytes(Count * sizeof(T), Alignment);
+		}
+
+		/** Allocates storage for Count elements of T and zeroes it. */
+		template <typename T>
+		inline T* PushArrayZeroed(size_t Count, size_t Alignment = alignof(T))
+		{
+			T* Result = PushArray<T>(Count, Alignment);
+			FMemory::Memzero(Result, Count * sizeof(T));
+			return Result;
+		}
+
+		/**
+		 * Frees everything allocated from the stack, e.g. at the end of a frame.
+		 * Chunks are kept for the next frame, call Trim() to give them back to the system.
+		 */
+		void Flush();
+
+		/** Releases the chunks that are not currently in use. */
+		void Trim();
+
+		/** @return Number of bytes handed out, including alignment padding. */
+		size_t GetByteCount() const;
+
+		/** @return Number of bytes held in chunks, used or not. */
+		size_t GetReservedByteCount() const;
+
+		inline bool IsEmpty() const
+		{
+			return TopChunk == nullptr;
+		}
+
+	private:
+		friend class FMemMark;
+
+		struct FChunk
+		{
+			FChunk* Next;
+			size_t DataSize;
+
+			inline uint8* Data()
+			{
+				return (uint8*)(this + 1);
+			}
+		};
+
+		static inline uint8* AlignPointer(uint8* Ptr, size_t Alignment)
+		{
+			return (uint8*)(((UPTRINT)Ptr + Alignment - 1) & ~(UPTRINT)(Alignment - 1));
+		}
+
+		/** Makes a chunk of at least MinSize bytes the top chunk, reusing a free one if possible. */
+		void AllocateNewChunk(size_t MinSize);
+
+		/** Moves chunks above NewTopChunk to the free list. */
+		void FreeChunks(FChunk* NewTopChunk);
+
+		/** Current allocation position in the top chunk. */
+		uint8* Top;
+
+		/** End of the top chunk. */
+		uint8* End;
+
+		/** Chunk currently allocated from, linked to the chunks below it. */
+		FChunk* TopChunk;
+
+		/** Chunks released by Flush() or a mark, ready for reuse. */
+		FChunk* UnusedChunks;
+
+		size_t ChunkSize;
+	};
+
+	/** Per thread memory stack for temporary allocations. */
+	class FMemStack : public FMemStackBase
+	{
+	public:
+		using FMemStackBase::FMemStackBase;
+
+		/** @return The calling thread's stack. */
+		static FMemStack& Get();
+	};
+
+	/*-----------------------------------------------------------------------------
+		FMemMark.
+	-----------------------------------------------------------------------------*/
+
+	/**
+	 * Marks a position in a memory stack. Everything allocated after the mark is freed when
+	 * Pop() is called or the mark goes out of scope. Marks must be released in reverse order.
+	 */
+	class FMemMark
+	{
+	public:
+		explicit FMemMark(FMemStackBase& InMem)
+			: Mem(InMem)
+			, Top(InMem.Top)
+			, SavedChunk(InMem.TopChunk)
+			, bPopped(false)
+		{
+		}
+
+		~FMemMark()
+		{
+			Pop();
+		}
+
+		FMemMark(const FMemMark&) = delete;
+		FMemMark& operator=(const FMemMark&) = delete;
+
+		/** Frees the memory allocated after the mark. */
+		void Pop()
+		{
+			if (!bPopped)
+			{
+				bPopped = true;
+				if (Mem.TopChunk != SavedChunk)
+				{
+					Mem.FreeChunks(SavedChunk);
+				}
+				Mem.Top = Top;
+			}
+		}
+
+	private:
+		FMemStackBase& Mem;
+		uint8* Top;
+		FMemStackBase::FChunk* SavedChunk;
+		bool bPopped;
+	};
+}
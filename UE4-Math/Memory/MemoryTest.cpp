@@ -0,0 +1,480 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MemoryTest.cpp: Parallel memory burn-in test
+=============================================================================*/
+
+#include "Memory/MemoryTest.h"
+#include "Math/UnrealMathUtility.h"
+#include "Async/ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#if PLATFORM_ALWAYS_HAS_AVX2
+#include <immintrin.h>
+#elif PLATFORM_ALWAYS_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace UE4Math
+{
+	namespace MemoryTestPrivate
+	{
+		/*-----------------------------------------------------------------------------
+			Wide words. The passes move WordsPerVector 64 bit words at a time.
+		-----------------------------------------------------------------------------*/
+
+#if PLATFORM_ALWAYS_HAS_AVX2
+		typedef __m256i FWords;
+		enum { WordsPerVector = 4 };
+
+		inline FWords LoadWords(const uint64* Ptr) { return _mm256_load_si256((const __m256i*)Ptr); }
+		inline FWords LoadWordsUnaligned(const uint64* Ptr) { return _mm256_loadu_si256((const __m256i*)Ptr); }
+		inline void StoreWords(uint64* Ptr, FWords Words) { _mm256_store_si256((__m256i*)Ptr, Words); }
+		inline void StreamWords(uint64* Ptr, FWords Words) { _mm256_stream_si256((__m256i*)Ptr, Words); }
+		inline FWords SplatWord(uint64 Word) { return _mm256_set1_epi64x((long long)Word); }
+		inline FWords AddWords(FWords A, FWords B) { return _mm256_add_epi64(A, B); }
+		inline FWords XorWords(FWords A, FWords B) { return _mm256_xor_si256(A, B); }
+		inline bool AreWordsZero(FWords Words) { return _mm256_testz_si256(Words, Words) != 0; }
+		inline void StoreFence() { _mm_sfence(); }
+#elif PLATFORM_ALWAYS_HAS_SSE2
+		typedef __m128i FWords;
+		enum { WordsPerVector = 2 };
+
+		inline FWords LoadWords(const uint64* Ptr) { return _mm_load_si128((const __m128i*)Ptr); }
+		inline FWords LoadWordsUnaligned(const uint64* Ptr) { return _mm_loadu_si128((const __m128i*)Ptr); }
+		inline void StoreWords(uint64* Ptr, FWords Words) { _mm_store_si128((__m128i*)Ptr, Words); }
+		inline void StreamWords(uint64* Ptr, FWords Words) { _mm_stream_si128((__m128i*)Ptr, Words); }
+		inline FWords SplatWord(uint64 Word) { return _mm_set1_epi64x((long long)Word); }
+		inline FWords AddWords(FWords A, FWords B) { return _mm_add_epi64(A, B); }
+		inline FWords XorWords(FWords A, FWords B) { return _mm_xor_si128(A, B); }
+		inline bool AreWordsZero(FWords Words) { return _mm_movemask_epi8(_mm_cmpeq_epi32(Words, _mm_setzero_si128())) == 0xFFFF; }
+		inline void StoreFence() { _mm_sfence(); }
+#else
+		typedef uint64 FWords;
+		enum { WordsPerVector = 1 };
+
+		inline FWords LoadWords(const uint64* Ptr) { return *(const volatile uint64*)Ptr; }
+		inline FWords LoadWordsUnaligned(const uint64* Ptr) { return *Ptr; }
+		inline void StoreWords(uint64* Ptr, FWords Words) { *(volatile uint64*)Ptr = Words; }
+		inline void StreamWords(uint64* Ptr, FWords Words) { *(volatile uint64*)Ptr = Words; }
+		inline FWords SplatWord(uint64 Word) { return Word; }
+		inline FWords AddWords(FWords A, FWords B) { return A + B; }
+		inline FWords XorWords(FWords A, FWords B) { return A ^ B; }
+		inline bool AreWordsZero(FWords Words) { return Words == 0; }
+		inline void StoreFence() {}
+#endif
+
+		enum { VectorBytes = WordsPerVector * sizeof(uint64) };
+
+		/** Threads are handed whole pages so each one first-touches its own. */
+		enum { SliceGranularity = 4096 };
+
+		/** Regions below this per thread are not worth another thread. */
+		enum { MinBytesPerThread = 4 * 1024 * 1024 };
+
+		/** Progress is published after each block of this many bytes. */
+		enum { ProgressBlockSize = 1024 * 1024 };
+		enum { ProgressBlockWords = ProgressBlockSize / sizeof(uint64) };
+
+		/** Least time between two calls of the progress callback. */
+		constexpr double ProgressInterval = 0.05;
+
+		/*-----------------------------------------------------------------------------
+			Patterns. Each one gives the word expected at an address, scalar or a vector at a time.
+		-----------------------------------------------------------------------------*/
+
+		struct FFixedPattern
+		{
+			uint64 Word;
+
+			inline uint64 Scalar(const uint64*) const { return Word; }
+			inline FWords Vector(const uint64*) const { return SplatWord(Word); }
+		};
+
+		struct FWalkingOnesPattern
+		{
+			/** Bit N set in word N. Vectors are aligned, so their lanes never wrap around the table. */
+			uint64 Table[64];
+
+			FWalkingOnesPattern()
+			{
+				for (int32 Index = 0; Index < 64; ++Index)
+				{
+					Table[Index] = 1ull << Index;
+				}
+			}
+
+			inline uint64 Scalar(const uint64* Ptr) const { return Table[((UPTRINT)Ptr >> 3) & 63]; }
+			inline FWords Vector(const uint64* Ptr) const { return LoadWordsUnaligned(&Table[((UPTRINT)Ptr >> 3) & 63]); }
+		};
+
+		struct FAddressPattern
+		{
+			FWords LaneOffsets;
+
+			FAddressPattern()
+			{
+				uint64 Offsets[WordsPerVector];
+				for (int32 Lane = 0; Lane < WordsPerVector; ++Lane)
+				{
+					Offsets[Lane] = Lane * sizeof(uint64);
+				}
+				LaneOffsets = LoadWordsUnaligned(Offsets);
+			}
+
+			inline uint64 Scalar(const uint64* Ptr) const { return (uint64)(UPTRINT)Ptr; }
+			inline FWords Vector(const uint64* Ptr) const { return AddWords(SplatWord((uint64)(UPTRINT)Ptr), LaneOffsets); }
+		};
+
+		/*-----------------------------------------------------------------------------
+			Passes over one thread's slice.
+		-----------------------------------------------------------------------------*/
+
+		/** Shared state of one test run. */
+		struct FTestContext
+		{
+			std::atomic<uint64> BytesProcessed{ 0 };
+			std::atomic<uint64> NumErrors{ 0 };
+			std::mutex ErrorsMutex;
+			std::vector<FMemoryTestError> Errors;
+			int32 MaxRecordedErrors = 0;
+
+			/** Progress is reported from the thread that started the test only. */
+			const FMemoryTestOptions* Options = nullptr;
+			std::thread::id CallingThread;
+			uint64 TotalBytes = 0;
+			std::chrono::steady_clock::time_point LastProgressTime;
+
+			void ReportError(void* Address, uint64 Expected, uint64 Actual)
+			{
+				NumErrors.fetch_add(1, std::memory_order_relaxed);
+				std::lock_guard<std::mutex> Lock(ErrorsMutex);
+				if ((int32)Errors.size() < MaxRecordedErrors)
+				{
+					Errors.push_back(FMemoryTestError{ Address, Expected, Actual });
+				}
+			}
+
+			/** Counts bytes read and written, and calls the progress callback now and then on the calling thread. */
+			void AddBytesProcessed(uint64 NumBytes)
+			{
+				BytesProcessed.fetch_add(NumBytes, std::memory_order_relaxed);
+				if (Options->Progress && std::this_thread::get_id() == CallingThread)
+				{
+					const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+					if (std::chrono::duration<double>(Now - LastProgressTime).count() >= ProgressInterval)
+					{
+						LastProgressTime = Now;
+						Options->Progress(BytesProcessed.load(std::memory_order_relaxed), TotalBytes);
+					}
+				}
+			}
+		};
+
+		/**
+		 * Splits [Begin, End) into an unaligned head, a vector aligned body and an unaligned tail.
+		 * A region that does not start or end on a 64 bit boundary also has a 32 bit word before Begin
+		 * or after End, which the first and last slices test like the original 32 bit test did.
+		 */
+		struct FSliceParts
+		{
+			uint64* Begin;
+			uint64* BodyBegin;
+			uint64* BodyEnd;
+			uint64* End;
+
+			/** 32 bit words just before Begin and at End, null when there are none. */
+			uint32* HeadWord = nullptr;
+			uint32* TailWord = nullptr;
+
+			FSliceParts(uint64* InBegin, uint64* InEnd)
+				: Begin(InBegin)
+				, End(InEnd)
+			{
+				BodyBegin = (uint64*)FMath::Min(((UPTRINT)Begin + VectorBytes - 1) & ~(UPTRINT)(VectorBytes - 1), (UPTRINT)End);
+				BodyEnd = (uint64*)FMath::Max((UPTRINT)End & ~(UPTRINT)(VectorBytes - 1), (UPTRINT)BodyBegin);
+			}
+
+			/** @return Bytes outside the vector body, the blocks of the body report their own progress. */
+			inline uint64 GetScalarBytes() const
+			{
+				return (uint64)((BodyBegin - Begin) + (End - BodyEnd)) * sizeof(uint64) + (HeadWord ? sizeof(uint32) : 0) + (TailWord ? sizeof(uint32) : 0);
+			}
+		};
+
+		/** @return The pattern's word for a 32 bit word, the half of the 64 bit word that holds it. */
+		template <typename PatternType>
+		inline uint32 GetPatternWord32(const uint32* Ptr, const PatternType& Pattern)
+		{
+			const uint64 Word = Pattern.Scalar((const uint64*)((UPTRINT)Ptr & ~(UPTRINT)(sizeof(uint64) - 1)));
+			return ((UPTRINT)Ptr & sizeof(uint32)) ? (uint32)(Word >> 32) : (uint32)Word;
+		}
+
+		template <typename PatternType>
+		void FillPass(const FSliceParts& Slice, const PatternType& Pattern, FTestContext& Context)
+		{
+			if (Slice.HeadWord)
+			{
+				*(volatile uint32*)Slice.HeadWord = GetPatternWord32(Slice.HeadWord, Pattern);
+			}
+			for (uint64* Ptr = Slice.Begin; Ptr < Slice.BodyBegin; ++Ptr)
+			{
+				*(volatile uint64*)Ptr = Pattern.Scalar(Ptr);
+			}
+			for (uint64* Block = Slice.BodyBegin; Block < Slice.BodyEnd; Block += ProgressBlockWords)
+			{
+				uint64* BlockEnd = Slice.BodyEnd - Block > ProgressBlockWords ? Block + ProgressBlockWords : Slice.BodyEnd;
+				for (uint64* Ptr = Block; Ptr < BlockEnd; Ptr += WordsPerVector)
+				{
+					// The fill is write only, streaming skips reading every line in first.
+					StreamWords(Ptr, Pattern.Vector(Ptr));
+				}
+				Context.AddBytesProcessed((uint64)(BlockEnd - Block) * sizeof(uint64));
+			}
+			for (uint64* Ptr = Slice.BodyEnd; Ptr < Slice.End; ++Ptr)
+			{
+				*(volatile uint64*)Ptr = Pattern.Scalar(Ptr);
+			}
+			if (Slice.TailWord)
+			{
+				*(volatile uint32*)Slice.TailWord = GetPatternWord32(Slice.TailWord, Pattern);
+			}
+			StoreFence();
+			Context.AddBytesProcessed(Slice.GetScalarBytes());
+		}
+
+		/** Checks every word against the pattern (or its complement) and overwrites it with the opposite. */
+		template <typename PatternType>
+		inline void CheckAndFlipScalar(uint64* Ptr, const PatternType& Pattern, uint64 Invert, FTestContext& Context)
+		{
+			const uint64 Expected = Pattern.Scalar(Ptr) ^ Invert;
+			const uint64 Actual = *(volatile uint64*)Ptr;
+			if (Actual != Expected)
+			{
+				Context.ReportError(Ptr, Expected, Actual);
+			}
+			*(volatile uint64*)Ptr = ~Expected;
+		}
+
+		template <typename PatternType>
+		inline void CheckAndFlipScalar32(uint32* Ptr, const PatternType& Pattern, uint32 Invert, FTestContext& Context)
+		{
+			const uint32 Expected = GetPatternWord32(Ptr, Pattern) ^ Invert;
+			const uint32 Actual = *(volatile uint32*)Ptr;
+			if (Actual != Expected)
+			{
+				Context.ReportError(Ptr, Expected, Actual);
+			}
+			*(volatile uint32*)Ptr = ~Expected;
+		}
+
+		template <typename PatternType>
+		inline void CheckAndFlipVector(uint64* Ptr, const PatternType& Pattern, FWords Invert, FTestContext& Context)
+		{
+			const FWords Expected = XorWords(Pattern.Vector(Ptr), Invert);
+			const FWords Actual = LoadWords(Ptr);
+			if (!AreWordsZero(XorWords(Actual, Expected)))
+			{
+				uint64 ExpectedWords[WordsPerVector];
+				uint64 ActualWords[WordsPerVector];
+				FMemory::Memcpy(ExpectedWords, &Expected, sizeof(ExpectedWords));
+				FMemory::Memcpy(ActualWords, &Actual, sizeof(ActualWords));
+				for (int32 Lane = 0; Lane < WordsPerVector; ++Lane)
+				{
+					if (ActualWords[Lane] != ExpectedWords[Lane])
+					{
+						Context.ReportError(Ptr + Lane, ExpectedWords[Lane], ActualWords[Lane]);
+					}
+				}
+			}
+			StoreWords(Ptr, XorWords(Expected, SplatWord(~0ull)));
+		}
+
+		template <typename PatternType>
+		void CheckForwardPass(const FSliceParts& Slice, const PatternType& Pattern, FTestContext& Context)
+		{
+			const FWords NoInvert = SplatWord(0);
+			if (Slice.HeadWord)
+			{
+				CheckAndFlipScalar32(Slice.HeadWord, Pattern, 0, Context);
+			}
+			for (uint64* Ptr = Slice.Begin; Ptr < Slice.BodyBegin; ++Ptr)
+			{
+				CheckAndFlipScalar(Ptr, Pattern, 0, Context);
+			}
+			for (uint64* Block = Slice.BodyBegin; Block < Slice.BodyEnd; Block += ProgressBlockWords)
+			{
+				uint64* BlockEnd = Slice.BodyEnd - Block > ProgressBlockWords ? Block + ProgressBlockWords : Slice.BodyEnd;
+				for (uint64* Ptr = Block; Ptr < BlockEnd; Ptr += WordsPerVector)
+				{
+					CheckAndFlipVector(Ptr, Pattern, NoInvert, Context);
+				}
+				Context.AddBytesProcessed((uint64)(BlockEnd - Block) * sizeof(uint64) * 2);
+			}
+			for (uint64* Ptr = Slice.BodyEnd; Ptr < Slice.End; ++Ptr)
+			{
+				CheckAndFlipScalar(Ptr, Pattern, 0, Context);
+			}
+			if (Slice.TailWord)
+			{
+				CheckAndFlipScalar32(Slice.TailWord, Pattern, 0, Context);
+			}
+			Context.AddBytesProcessed(Slice.GetScalarBytes() * 2);
+		}
+
+		template <typename PatternType>
+		void CheckBackwardPass(const FSliceParts& Slice, const PatternType& Pattern, FTestContext& Context)
+		{
+			const FWords Invert = SplatWord(~0ull);
+			if (Slice.TailWord)
+			{
+				CheckAndFlipScalar32(Slice.TailWord, Pattern, ~0u, Context);
+			}
+			for (uint64* Ptr = Slice.End; Ptr > Slice.BodyEnd;)
+			{
+				CheckAndFlipScalar(--Ptr, Pattern, ~0ull, Context);
+			}
+			for (uint64* Block = Slice.BodyEnd; Block > Slice.BodyBegin; Block -= ProgressBlockWords)
+			{
+				uint64* BlockBegin = Block - Slice.BodyBegin > ProgressBlockWords ? Block - ProgressBlockWords : Slice.BodyBegin;
+				for (uint64* Ptr = Block; Ptr > BlockBegin;)
+				{
+					Ptr -= WordsPerVector;
+					CheckAndFlipVector(Ptr, Pattern, Invert, Context);
+				}
+				Context.AddBytesProcessed((uint64)(Block - BlockBegin) * sizeof(uint64) * 2);
+			}
+			for (uint64* Ptr = Slice.BodyBegin; Ptr > Slice.Begin;)
+			{
+				CheckAndFlipScalar(--Ptr, Pattern, ~0ull, Context);
+			}
+			if (Slice.HeadWord)
+			{
+				CheckAndFlipScalar32(Slice.HeadWord, Pattern, ~0u, Context);
+			}
+			Context.AddBytesProcessed(Slice.GetScalarBytes() * 2);
+		}
+
+		/*-----------------------------------------------------------------------------
+			Threading.
+		-----------------------------------------------------------------------------*/
+
+		/**
+		 * Runs Pass on every slice, in parallel on the test's pool and the calling thread. The calling thread
+		 * reports progress while it works on its slices, and once more when the pass is over.
+		 */
+		template <typename PassType>
+		void RunPass(const std::vector<FSliceParts>& Slices, FTestContext& Context, PassType Pass)
+		{
+			ParallelFor((int32)Slices.size(), 1, [&Slices, &Pass](int32 Index)
+			{
+				Pass(Slices[Index]);
+			}, EParallelForFlags::None, Context.Options->Pool);
+
+			if (Context.Options->Progress)
+			{
+				Context.LastProgressTime = std::chrono::steady_clock::now();
+				Context.Options->Progress(Context.BytesProcessed.load(std::memory_order_relaxed), Context.TotalBytes);
+			}
+		}
+
+		template <typename PatternType>
+		void TestPattern(const std::vector<FSliceParts>& Slices, const PatternType& Pattern, FTestContext& Context)
+		{
+			// Each pass covers the whole region before the next starts, so a write through an aliased
+			// address line shows up regardless of which thread owns the other location.
+			RunPass(Slices, Context, [&Pattern, &Context](const FSliceParts& Slice) { FillPass(Slice, Pattern, Context); });
+			RunPass(Slices, Context, [&Pattern, &Context](const FSliceParts& Slice) { CheckForwardPass(Slice, Pattern, Context); });
+			RunPass(Slices, Context, [&Pattern, &Context](const FSliceParts& Slice) { CheckBackwardPass(Slice, Pattern, Context); });
+		}
+	}
+
+	bool FMath::MemoryTest(void* BaseAddress, uint32 NumBytes)
+	{
+		FMemoryTestOptions Options;
+		Options.Patterns = EMemoryTestPattern::Fixed;
+		Options.MaxRecordedErrors = 0;
+		FMemoryTestResult Result;
+		return MemoryTest(BaseAddress, NumBytes, Options, Result);
+	}
+
+	bool FMath::MemoryTest(void* BaseAddress, uint64 NumBytes, const FMemoryTestOptions& Options, FMemoryTestResult& OutResult)
+	{
+		using namespace MemoryTestPrivate;
+
+		const auto StartTime = std::chrono::steady_clock::now();
+
+		// Whole 64 bit words are tested wide, a 32 bit word left over at either end on its own.
+		const UPTRINT RegionBegin = (UPTRINT)BaseAddress;
+		const UPTRINT RegionEnd = (UPTRINT)BaseAddress + (UPTRINT)(NumBytes & ~(uint64)(sizeof(uint32) - 1));
+		uint64* First = (uint64*)((RegionBegin + sizeof(uint64) - 1) & ~(UPTRINT)(sizeof(uint64) - 1));
+		uint64* Last = (uint64*)FMath::Max(RegionEnd & ~(UPTRINT)(sizeof(uint64) - 1), (UPTRINT)First);
+		const bool bHeadWord = RegionBegin + sizeof(uint32) == (UPTRINT)First && (UPTRINT)First <= RegionEnd;
+		const bool bTailWord = (UPTRINT)Last + sizeof(uint32) == RegionEnd;
+		const uint64 NumTestBytes = (uint64)(Last - First) * sizeof(uint64);
+
+		// Split on page boundaries, each slice gets at least MinBytesPerThread.
+		FQueuedThreadPool* Pool = Options.Pool ? Options.Pool : GThreadPool;
+		int32 NumThreads = Options.NumThreads > 0 ? Options.NumThreads : (Pool ? Pool->GetNumThreads() + 1 : 1);
+		NumThreads = (int32)FMath::Max<uint64>(FMath::Min<uint64>((uint64)NumThreads, NumTestBytes / MinBytesPerThread), 1);
+
+		std::vector<FSliceParts> Slices;
+		uint64* SliceBegin = First;
+		for (int32 Index = 0; Index < NumThreads; ++Index)
+		{
+			uint64* SliceEnd = Last;
+			if (Index + 1 < NumThreads)
+			{
+				const UPTRINT Split = (UPTRINT)First + (UPTRINT)(NumTestBytes / NumThreads * (Index + 1));
+				SliceEnd = (uint64*)FMath::Max(Split & ~(UPTRINT)(SliceGranularity - 1), (UPTRINT)SliceBegin);
+			}
+			Slices.emplace_back(SliceBegin, SliceEnd);
+			SliceBegin = SliceEnd;
+		}
+		Slices.front().HeadWord = bHeadWord ? (uint32*)RegionBegin : nullptr;
+		Slices.back().TailWord = bTailWord ? (uint32*)Last : nullptr;
+
+		// Fill writes the region once, both checks read and write it.
+		uint32 NumPatterns = 0;
+		NumPatterns += (Options.Patterns & EMemoryTestPattern::Fixed) ? 2 : 0;
+		NumPatterns += (Options.Patterns & EMemoryTestPattern::WalkingOnes) ? 1 : 0;
+		NumPatterns += (Options.Patterns & EMemoryTestPattern::AddressInAddress) ? 1 : 0;
+		const uint64 NumEdgeBytes = (bHeadWord ? sizeof(uint32) : 0) + (bTailWord ? sizeof(uint32) : 0);
+
+		FTestContext Context;
+		Context.MaxRecordedErrors = FMath::Max(Options.MaxRecordedErrors, 0);
+		Context.Options = &Options;
+		Context.CallingThread = std::this_thread::get_id();
+		Context.TotalBytes = (NumTestBytes + NumEdgeBytes) * 5 * NumPatterns;
+		Context.LastProgressTime = StartTime;
+
+		if (Options.Patterns & EMemoryTestPattern::Fixed)
+		{
+			TestPattern(Slices, FFixedPattern{ 0xdeadbeefdeadbeefull }, Context);
+			TestPattern(Slices, FFixedPattern{ 0x1337c0de1337c0deull }, Context);
+		}
+		if (Options.Patterns & EMemoryTestPattern::WalkingOnes)
+		{
+			TestPattern(Slices, FWalkingOnesPattern(), Context);
+		}
+		if (Options.Patterns & EMemoryTestPattern::AddressInAddress)
+		{
+			TestPattern(Slices, FAddressPattern(), Context);
+		}
+
+		std::sort(Context.Errors.begin(), Context.Errors.end(), [](const FMemoryTestError& A, const FMemoryTestError& B)
+		{
+			return A.Address < B.Address;
+		});
+
+		OutResult.Errors = std::move(Context.Errors);
+		OutResult.NumErrors = Context.NumErrors.load();
+		OutResult.BytesProcessed = Context.BytesProcessed.load();
+		OutResult.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTime).count();
+		return OutResult.NumErrors == 0;
+	}
+}
@@ -0,0 +1,79 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "Misc/CoreMiscDefines.h"
+
+namespace UE4Math
+{
+	class FQueuedThreadPool;
+
+	/** Patterns written by FMath::MemoryTest. Each pattern is checked, then checked again as its complement. */
+	namespace EMemoryTestPattern
+	{
+		enum Type
+		{
+			/** The two fixed words of the original test, 0xdeadbeef and 0x1337c0de. */
+			Fixed = 1 << 0,
+
+			/** A single set bit walking through each 64 bit word, catches stuck and coupled data lines. */
+			WalkingOnes = 1 << 1,
+
+			/** Every word holds its own address, catches address lines that alias two locations. */
+			AddressInAddress = 1 << 2,
+
+			All = Fixed | WalkingOnes | AddressInAddress,
+		};
+	}
+
+	/** A word that did not read back what was written. */
+	struct FMemoryTestError
+	{
+		void* Address;
+		uint64 Expected;
+		uint64 Actual;
+	};
+
+	struct FMemoryTestOptions
+	{
+		/** Combination of EMemoryTestPattern flags. */
+		uint32 Patterns = EMemoryTestPattern::All;
+
+		/** Slices the region is split into, 0 for one per thread of the pool plus the calling thread. Small regions use fewer. */
+		int32 NumThreads = 0;
+
+		/** Pool the slices run on, GThreadPool if null. Without a pool the whole test runs on the calling thread. */
+		FQueuedThreadPool* Pool = nullptr;
+
+		/** Failures beyond this many are counted but not recorded. */
+		int32 MaxRecordedErrors = 256;
+
+		/**
+		 * Called from the calling thread while it works on its share of the region and after every pass,
+		 * with the bytes read and written so far and the total the test will touch.
+		 */
+		std::function<void(uint64 BytesProcessed, uint64 TotalBytes)> Progress;
+	};
+
+	struct FMemoryTestResult
+	{
+		/** Failing words in address order, at most MaxRecordedErrors of them. */
+		std::vector<FMemoryTestError> Errors;
+
+		/** Total number of failing reads, including the ones not recorded. */
+		uint64 NumErrors = 0;
+
+		/** Bytes read and written over all passes. */
+		uint64 BytesProcessed = 0;
+
+		double Seconds = 0.0;
+
+		/** @return Read and write throughput in bytes per second. */
+		inline double GetBytesPerSecond() const
+		{
+			return Seconds > 0.0 ? (double)BytesProcessed / Seconds : 0.0;
+		}
+	};
+}
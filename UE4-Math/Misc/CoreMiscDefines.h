@@ -4,6 +4,58 @@
 
 #define ensure(           InExpression                ) (!!(InExpression))
 
+#ifndef PLATFORM_WINDOWS
+#if defined(_WIN32)
+#define PLATFORM_WINDOWS 1
+#else
+#define PLATFORM_WINDOWS 0
+#endif
+#endif
+
+// All supported targets (Win32/x64) are little endian.
+#ifndef PLATFORM_LITTLE_ENDIAN
+#define PLATFORM_LITTLE_ENDIAN 1
+#endif
+
+// Instruction sets the compiler is allowed to assume (x64 always has SSE2, AVX2/FMA come from /arch:AVX2 or -mavx2 -mfma).
+#ifndef PLATFORM_ALWAYS_HAS_SSE2
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PLATFORM_ALWAYS_HAS_SSE2 1
+#else
+#define PLATFORM_ALWAYS_HAS_SSE2 0
+#endif
+#endif
+
+#ifndef PLATFORM_ALWAYS_HAS_AVX2
+#if defined(__AVX2__)
+#define PLATFORM_ALWAYS_HAS_AVX2 1
+#else
+#define PLATFORM_ALWAYS_HAS_AVX2 0
+#endif
+#endif
+
+#ifndef PLATFORM_ALWAYS_HAS_FMA3
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define PLATFORM_ALWAYS_HAS_FMA3 1
+#else
+#define PLATFORM_ALWAYS_HAS_FMA3 0
+#endif
+#endif
+
+// True while the enclosing constexpr function is evaluated at compile time. Lets constexpr constructors
+// build constants without running their runtime only checks (NaN diagnostics, stats).
+#ifndef UE_IS_CONSTANT_EVALUATED
+#define UE_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+
+#ifndef GCC_ALIGN
+#if defined(__GNUC__) || defined(__clang__)
+#define GCC_ALIGN(n) __attribute__((aligned(n)))
+#else
+#define GCC_ALIGN(n)
+#endif
+#endif
+
 namespace UE4Math
 {
 	enum { INDEX_NONE = -1 };
@@ -25,4 +77,7 @@ namespace UE4Math
 	typedef  int32_t int32;
 	typedef  int16_t int16;
 	typedef  int8_t  int8;
+
+	typedef  uintptr_t UPTRINT;
+	typedef  intptr_t  PTRINT;
 }
@@ -0,0 +1,82 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/Crc.h"
+#include <string.h>
+
+namespace UE4Math
+{
+	namespace CrcPrivate
+	{
+		struct FCrcTables
+		{
+			uint32 Tables[8][256];
+		};
+
+		/** Builds the slicing-by-8 tables. */
+		constexpr FCrcTables MakeCrcTables()
+		{
+			FCrcTables Result{};
+			for (uint32 Index = 0; Index < 256; ++Index)
+			{
+				uint32 CRC = Index;
+				for (int32 Bit = 0; Bit < 8; ++Bit)
+				{
+					CRC = (CRC >> 1) ^ (0xEDB88320u & (0u - (CRC & 1)));
+				}
+				Result.Tables[0][Index] = CRC;
+			}
+			for (uint32 Index = 0; Index < 256; ++Index)
+			{
+				for (int32 Slice = 1; Slice < 8; ++Slice)
+				{
+					const uint32 Prev = Result.Tables[Slice - 1][Index];
+					Result.Tables[Slice][Index] = (Prev >> 8) ^ Result.Tables[0][Prev & 0xFF];
+				}
+			}
+			return Result;
+		}
+
+		/** Generated at compile time, so static initializers in other files may hash before this one runs. */
+		constexpr FCrcTables GCrcTables = MakeCrcTables();
+	}
+
+	const uint32 (&FCrc::CRCTablesSB8)[8][256] = CrcPrivate::GCrcTables.Tables;
+
+	uint32 FCrc::MemCrc32(const void* InData, int64 Length, uint32 CRC)
+	{
+		const uint8* Data = (const uint8*)InData;
+		CRC = ~CRC;
+
+		// Align to 4 bytes before switching to the sliced loop.
+		for (; Length > 0 && ((UPTRINT)Data & 3); --Length)
+		{
+			CRC = (CRC >> 8) ^ CRCTablesSB8[0][(CRC ^ *Data++) & 0xFF];
+		}
+
+		for (; Length >= 8; Length -= 8)
+		{
+			uint32 One;
+			uint32 Two;
+			memcpy(&One, Data, 4);
+			memcpy(&Two, Data + 4, 4);
+			One ^= CRC;
+			Data += 8;
+			CRC =
+				CRCTablesSB8[7][One & 0xFF] ^
+				CRCTablesSB8[6][(One >> 8) & 0xFF] ^
+				CRCTablesSB8[5][(One >> 16) & 0xFF] ^
+				CRCTablesSB8[4][One >> 24] ^
+				CRCTablesSB8[3][Two & 0xFF] ^
+				CRCTablesSB8[2][(Two >> 8) & 0xFF] ^
+				CRCTablesSB8[1][(Two >> 16) & 0xFF] ^
+				CRCTablesSB8[0][Two >> 24];
+		}
+
+		for (; Length > 0; --Length)
+		{
+			CRC = (CRC >> 8) ^ CRCTablesSB8[0][(CRC ^ *Data++) & 0xFF];
+		}
+
+		return ~CRC;
+	}
+}
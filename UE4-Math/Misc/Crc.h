@@ -0,0 +1,36 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+//#include "CoreTypes.h"
+#include "Misc/CoreMiscDefines.h"
+
+namespace UE4Math
+{
+	/**
+	 * CRC hash generation for different types of input data
+	 **/
+	struct FCrc
+	{
+		/** lookup table with precalculated CRC values - slicing by 8 implementation */
+		static const uint32 (&CRCTablesSB8)[8][256];
+
+		/**
+		 * Generates CRC hash of the memory area (standard CRC-32, reflected 0xEDB88320 polynomial).
+		 * Calls can be chained by passing the previous result as CRC to hash a stream in pieces.
+		 *
+		 * @param Data Memory to hash.
+		 * @param Length Number of bytes.
+		 * @param CRC Result of the previous call when hashing a stream, 0 to start.
+		 * @return The CRC of all bytes hashed so far.
+		 */
+		static uint32 MemCrc32(const void* Data, int64 Length, uint32 CRC = 0);
+
+		/** generates CRC hash of the element */
+		template <typename T>
+		static uint32 TypeCrc32(const T& Data, uint32 CRC = 0)
+		{
+			return MemCrc32(&Data, sizeof(T), CRC);
+		}
+	};
+}
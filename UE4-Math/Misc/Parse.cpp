@@ -0,0 +1,133 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/Parse.h"
+#include "Math/Vector.h"
+#include <charconv>
+
+namespace UE4Math
+{
+	namespace ParsePrivate
+	{
+		inline bool IsNameChar(char C)
+		{
+			return (C >= 'a' && C <= 'z') || (C >= 'A' && C <= 'Z') || (C >= '0' && C <= '9') || C == '_';
+		}
+
+		inline bool IsBlank(char C)
+		{
+			return C == ' ' || C == '\t';
+		}
+
+		/** Returns the text following the first standalone occurrence of Match, or null. */
+		inline const char* FindValueStart(std::string_view Stream, std::string_view Match)
+		{
+			for (size_t Pos = Stream.find(Match); Pos != std::string_view::npos; Pos = Stream.find(Match, Pos + 1))
+			{
+				if (Pos == 0 || !IsNameChar(Stream[Pos - 1]))
+				{
+					return Stream.data() + Pos + Match.size();
+				}
+			}
+			return nullptr;
+		}
+
+		/** from_chars does not accept a leading '+', which printf style writers emit. */
+		template <typename T>
+		inline const char* ParseNumber(const char* First, const char* Last, T& Value)
+		{
+			if (First < Last && *First == '+')
+			{
+				++First;
+			}
+			const std::from_chars_result Result = std::from_chars(First, Last, Value);
+			return Result.ec == std::errc() ? Result.ptr : nullptr;
+		}
+
+		template <typename T>
+		inline bool ParseValue(std::string_view Stream, std::string_view Match, T& Value)
+		{
+			const char* Start = FindValueStart(Stream, Match);
+			return Start && ParseNumber(Start, Stream.data() + Stream.size(), Value) != nullptr;
+		}
+	}
+
+	bool FParse::Value(std::string_view Stream, std::string_view Match, float& Value)
+	{
+		return ParsePrivate::ParseValue(Stream, Match, Value);
+	}
+
+	bool FParse::Value(std::string_view Stream, std::string_view Match, double& Value)
+	{
+		return ParsePrivate::ParseValue(Stream, Match, Value);
+	}
+
+	bool FParse::Value(std::string_view Stream, std::string_view Match, int32& Value)
+	{
+		return ParsePrivate::ParseValue(Stream, Match, Value);
+	}
+
+	bool FParse::Floats(std::string_view& Stream, float* OutValues, int32 Count)
+	{
+		const char* Cur = Stream.data();
+		const char* Last = Cur + Stream.size();
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			while (Cur < Last && (ParsePrivate::IsBlank(*Cur) || (Index > 0 && *Cur == ',')))
+			{
+				++Cur;
+			}
+			Cur = ParsePrivate::ParseNumber(Cur, Last, OutValues[Index]);
+			if (!Cur)
+			{
+				return false;
+			}
+		}
+		Stream.remove_prefix((size_t)(Cur - Stream.data()));
+		return true;
+	}
+
+	bool FParse::VectorLines(std::string_view Buffer, std::vector<FVector>& OutVectors, int64* OutErrorLine)
+	{
+		// Lines are usually around 30 characters, reserving up front avoids most regrowth for large exports.
+		OutVectors.reserve(OutVectors.size() + Buffer.size() / 32);
+
+		int64 LineNumber = 0;
+		while (!Buffer.empty())
+		{
+			++LineNumber;
+			const size_t LineEnd = Buffer.find('\n');
+			std::string_view Line = Buffer.substr(0, LineEnd);
+			Buffer.remove_prefix(LineEnd == std::string_view::npos ? Buffer.size() : LineEnd + 1);
+
+			while (!Line.empty() && (ParsePrivate::IsBlank(Line.back()) || Line.back() == '\r'))
+			{
+				Line.remove_suffix(1);
+			}
+			while (!Line.empty() && ParsePrivate::IsBlank(Line.front()))
+			{
+				Line.remove_prefix(1);
+			}
+			if (Line.empty())
+			{
+				continue;
+			}
+
+			float Components[3];
+			if (!Floats(Line, Components, 3) || !Line.empty())
+			{
+				if (OutErrorLine)
+				{
+					*OutErrorLine = LineNumber;
+				}
+				return false;
+			}
+			OutVectors.emplace_back(Components[0], Components[1], Components[2]);
+		}
+
+		if (OutErrorLine)
+		{
+			*OutErrorLine = 0;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,51 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+//#include "CoreTypes.h"
+#include "Misc/CoreMiscDefines.h"
+#include "Math/MathFwd.h"
+#include <string_view>
+#include <vector>
+
+namespace UE4Math
+{
+	/**
+	 * Locale independent, allocation free parsing helpers built on std::from_chars.
+	 */
+	struct FParse
+	{
+		/**
+		 * Finds "Match" in Stream and parses the number directly after it, e.g. Value("X=1 Y=2", "Y=", Y).
+		 * A match only counts at the start of Stream or after a character that cannot be part of a name,
+		 * so "X=" does not match inside "MaxX=".
+		 *
+		 * @return true if Match was found and followed by a valid number.
+		 */
+		static bool Value(std::string_view Stream, std::string_view Match, float& Value);
+		static bool Value(std::string_view Stream, std::string_view Match, double& Value);
+		static bool Value(std::string_view Stream, std::string_view Match, int32& Value);
+
+		/**
+		 * Parses Count numbers separated by commas and/or blanks from the front of Stream.
+		 *
+		 * @param Stream Text to read from, advanced past the last number on success.
+		 * @param OutValues Receives the numbers.
+		 * @param Count Number of values to read.
+		 * @return true if all values were read.
+		 */
+		static bool Floats(std::string_view& Stream, float* OutValues, int32 Count);
+
+		/**
+		 * Parses one vector per line, written as three numbers separated by commas and/or blanks (CSV or
+		 * whitespace separated exports). Blank lines are skipped and both LF and CRLF line ends are accepted.
+		 * Parsing stops at the first malformed line; vectors before it are kept.
+		 *
+		 * @param Buffer Text to parse.
+		 * @param OutVectors Parsed vectors are appended here.
+		 * @param OutErrorLine If not null, receives the 1 based line number of the malformed line, or 0.
+		 * @return true if the whole buffer was parsed.
+		 */
+		static bool VectorLines(std::string_view Buffer, std::vector<FVector>& OutVectors, int64* OutErrorLine = nullptr);
+	};
+}
@@ -0,0 +1,190 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+//#include "CoreTypes.h"
+#include "Misc/CoreMiscDefines.h"
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <string.h>
+
+namespace UE4Math
+{
+	/**
+	 * Appends text to a caller provided character buffer without allocating.
+	 *
+	 * Numbers are written with std::to_chars, floats in the shortest form that parses back to the same
+	 * value, independent of the current locale. Output that does not fit is dropped and the builder is
+	 * flagged as overflowed, the buffer always stays null terminated.
+	 *
+	 * @see TStringBuilder
+	 */
+	class FStringBuilderBase
+	{
+	public:
+
+		/**
+		 * @param InBuffer Storage to write into.
+		 * @param InCapacity Size of InBuffer in characters, including the null terminator.
+		 */
+		FStringBuilderBase(char* InBuffer, int32 InCapacity)
+			: Base(InBuffer)
+			, Cur(InBuffer)
+			, End(InBuffer + InCapacity - 1)
+			, bOverflow(false)
+		{
+			*Cur = '\0';
+		}
+
+		inline FStringBuilderBase& Append(std::string_view Text)
+		{
+			const size_t Count = (size_t)(End - Cur) < Text.size() ? (size_t)(End - Cur) : Text.size();
+			memcpy(Cur, Text.data(), Count);
+			Cur += Count;
+			*Cur = '\0';
+			bOverflow |= Count != Text.size();
+			return *this;
+		}
+
+		inline FStringBuilderBase& Append(const char* Text)
+		{
+			return Append(std::string_view(Text));
+		}
+
+		inline FStringBuilderBase& AppendChar(char Char)
+		{
+			if (Cur < End)
+			{
+				*Cur++ = Char;
+				*Cur = '\0';
+			}
+			else
+			{
+				bOverflow = true;
+			}
+			return *this;
+		}
+
+		inline FStringBuilderBase& Append(float Value)
+		{
+			return AppendNumber(Value);
+		}
+
+		inline FStringBuilderBase& Append(double Value)
+		{
+			return AppendNumber(Value);
+		}
+
+		inline FStringBuilderBase& Append(int32 Value)
+		{
+			return AppendNumber(Value);
+		}
+
+		inline FStringBuilderBase& Append(uint32 Value)
+		{
+			return AppendNumber(Value);
+		}
+
+		inline FStringBuilderBase& Append(int64 Value)
+		{
+			return AppendNumber(Value);
+		}
+
+		inline FStringBuilderBase& Append(uint64 Value)
+		{
+			return AppendNumber(Value);
+		}
+
+		inline FStringBuilderBase& Append(bool Value)
+		{
+			return Append(Value ? "true" : "false");
+		}
+
+		/** Appends anything that has an Append overload. */
+		template <typename T>
+		inline FStringBuilderBase& operator<<(const T& Value)
+		{
+			return Append(Value);
+		}
+
+		/** Empties the builder so the storage can be reused. */
+		inline void Reset()
+		{
+			Cur = Base;
+			*Cur = '\0';
+			bOverflow = false;
+		}
+
+		/** Removes characters from the end. */
+		inline void RemoveSuffix(int32 Count)
+		{
+			Cur = (Cur - Base) > Count ? Cur - Count : Base;
+			*Cur = '\0';
+		}
+
+		/** @return Number of characters written. */
+		inline int32 Len() const { return (int32)(Cur - Base); }
+
+		/** @return The null terminated text. */
+		inline const char* operator*() const { return Base; }
+
+		/** @return The text as a view into the builder storage. */
+		inline std::string_view ToView() const { return std::string_view(Base, (size_t)(Cur - Base)); }
+
+		/** @return A copy of the text. This allocates, prefer ToView where possible. */
+		inline std::string ToString() const { return std::string(Base, (size_t)(Cur - Base)); }
+
+		/** @return true if some output was dropped because the buffer was full. */
+		inline bool HasOverflowed() const { return bOverflow; }
+
+	private:
+
+		template <typename T>
+		inline FStringBuilderBase& AppendNumber(T Value)
+		{
+			const std::to_chars_result Result = std::to_chars(Cur, End, Value);
+			if (Result.ec == std::errc())
+			{
+				Cur = Result.ptr;
+			}
+			else
+			{
+				bOverflow = true;
+			}
+			*Cur = '\0';
+			return *this;
+		}
+
+		FStringBuilderBase(const FStringBuilderBase&) = delete;
+		FStringBuilderBase& operator=(const FStringBuilderBase&) = delete;
+
+		char* Base;
+		char* Cur;
+		char* End;
+		bool bOverflow;
+	};
+
+
+	/**
+	 * A string builder with inline storage for BufferSize - 1 characters.
+	 *
+	 * Usage:
+	 *     TStringBuilder<128> Builder;
+	 *     Vector.AppendString(Builder);
+	 *     puts(*Builder);
+	 */
+	template <int32 BufferSize>
+	class TStringBuilder : public FStringBuilderBase
+	{
+	public:
+
+		TStringBuilder()
+			: FStringBuilderBase(Buffer, BufferSize)
+		{ }
+
+	private:
+
+		char Buffer[BufferSize];
+	};
+}
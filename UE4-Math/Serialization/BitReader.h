@@ -0,0 +1,143 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+//#include "CoreTypes.h"
+//#include "Serialization/Archive.h"
+#include "Math/UnrealMathUtility.h"
+
+namespace UE4Math
+{
+	/**
+	 * Reads a stream of bits produced by FBitWriter.
+	 *
+	 * The reader does not own the memory. Reading past the end of the stream returns zero bits
+	 * and sets the error flag, in the same spirit as FArchive::IsError.
+	 */
+	struct FBitReader
+	{
+	public:
+
+		/**
+		 * Creates a reader over a packed bit stream.
+		 *
+		 * @param InData Pointer to the packed bits.
+		 * @param InNumBits Number of valid bits in the stream.
+		 */
+		FBitReader(const uint8* InData, int64 InNumBits)
+			: Data(InData)
+			, Num(InNumBits)
+			, Pos(0)
+			, bError(false)
+		{ }
+
+	public:
+
+		/** @return The next bit in the stream. */
+		inline uint8 ReadBit()
+		{
+			return (uint8)ReadBits(1);
+		}
+
+		/**
+		 * Reads the next NumBits bits from the stream.
+		 *
+		 * @param NumBits Number of bits to read (0-32).
+		 * @return The bits, right aligned.
+		 */
+		inline uint32 ReadBits(uint32 NumBits)
+		{
+			if (NumBits == 0)
+			{
+				return 0;
+			}
+			if (Pos + NumBits > Num)
+			{
+				bError = true;
+				Pos = Num;
+				return 0;
+			}
+
+			const int64 ByteIndex = Pos >> 3;
+			const int64 NumBytes = (Num + 7) >> 3;
+			uint64 Word = 0;
+			if (ByteIndex + (int64)sizeof(uint64) <= NumBytes)
+			{
+				FMemory::Memcpy(&Word, Data + ByteIndex, sizeof(Word));
+			}
+			else
+			{
+				// Tail of the stream, gather byte by byte so we never read past the buffer.
+				for (int64 Index = ByteIndex; Index < NumBytes; ++Index)
+				{
+					Word |= (uint64)Data[Index] << ((Index - ByteIndex) * 8);
+				}
+			}
+
+			const uint64 Mask = (NumBits >= 32) ? 0xFFFFFFFFull : ((1ull << NumBits) - 1);
+			const uint32 Result = (uint32)((Word >> (Pos & 7)) & Mask);
+			Pos += NumBits;
+			return Result;
+		}
+
+		/**
+		 * Reads a run of bits into memory (LSB first).
+		 *
+		 * @param Dest Memory to write the bits to.
+		 * @param LengthBits Number of bits to read.
+		 */
+		void SerializeBits(void* Dest, int64 LengthBits)
+		{
+			uint8* DestBytes = (uint8*)Dest;
+			int64 BitIndex = 0;
+			for (; BitIndex + 8 <= LengthBits; BitIndex += 8)
+			{
+				DestBytes[BitIndex >> 3] = (uint8)ReadBits(8);
+			}
+			if (BitIndex < LengthBits)
+			{
+				DestBytes[BitIndex >> 3] = (uint8)ReadBits((uint32)(LengthBits - BitIndex));
+			}
+		}
+
+	public:
+
+		/** @return true if a read went past the end of the stream. */
+		inline bool IsError() const
+		{
+			return bError;
+		}
+
+		/** @return Number of bits consumed so far. */
+		inline int64 GetPosBits() const
+		{
+			return Pos;
+		}
+
+		/** @return Number of bits left to read. */
+		inline int64 GetBitsLeft() const
+		{
+			return Num - Pos;
+		}
+
+		/** @return true if all bits have been consumed. */
+		inline bool AtEnd() const
+		{
+			return Pos >= Num;
+		}
+
+	private:
+
+		/** Packed bits, not owned. */
+		const uint8* Data;
+
+		/** Number of valid bits in Data. */
+		int64 Num;
+
+		/** Read position in bits. */
+		int64 Pos;
+
+		/** Set when a read overran the stream. */
+		bool bError;
+	};
+}
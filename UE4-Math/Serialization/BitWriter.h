@@ -0,0 +1,135 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+//#include "CoreTypes.h"
+//#include "Serialization/Archive.h"
+#include "Math/UnrealMathUtility.h"
+#include <vector>
+
+namespace UE4Math
+{
+	/**
+	 * Writes a stream of bits into a growable byte buffer.
+	 *
+	 * Bits are packed starting at the least significant bit of each byte, which matches the layout
+	 * expected by FBitReader. Values up to 32 bits wide are written with a single unaligned 64 bit
+	 * read-modify-write, so packing many small fields stays cheap.
+	 */
+	struct FBitWriter
+	{
+	public:
+
+		/** Default constructor (empty stream). */
+		FBitWriter()
+			: Num(0)
+		{ }
+
+		/**
+		 * Creates an empty stream with space reserved for the given number of bits.
+		 *
+		 * @param InMaxBits Number of bits to reserve.
+		 */
+		explicit FBitWriter(int64 InMaxBits)
+			: Num(0)
+		{
+			Buffer.reserve((size_t)((InMaxBits + 7) >> 3) + sizeof(uint64));
+		}
+
+	public:
+
+		/**
+		 * Appends a single bit to the stream.
+		 *
+		 * @param In The bit to write, only the lowest bit is used.
+		 */
+		inline void WriteBit(uint8 In)
+		{
+			WriteBits(In & 1, 1);
+		}
+
+		/**
+		 * Appends the lowest NumBits bits of a value to the stream.
+		 *
+		 * @param Value The value to write.
+		 * @param NumBits Number of bits to write (0-32).
+		 */
+		inline void WriteBits(uint32 Value, uint32 NumBits)
+		{
+			if (NumBits == 0)
+			{
+				return;
+			}
+
+			// Keep a full word of zeroed slack past the write position so we can always touch 8 bytes.
+			const size_t ByteIndex = (size_t)(Num >> 3);
+			if (ByteIndex + sizeof(uint64) > Buffer.size())
+			{
+				Buffer.resize(FMath::Max<size_t>(Buffer.size() * 2, ByteIndex + sizeof(uint64) * 2), 0);
+			}
+
+			const uint64 Mask = (NumBits >= 32) ? 0xFFFFFFFFull : ((1ull << NumBits) - 1);
+			uint64 Word;
+			FMemory::Memcpy(&Word, &Buffer[ByteIndex], sizeof(Word));
+			Word |= ((uint64)Value & Mask) << (Num & 7);
+			FMemory::Memcpy(&Buffer[ByteIndex], &Word, sizeof(Word));
+
+			Num += NumBits;
+		}
+
+		/**
+		 * Appends a run of bits from memory to the stream.
+		 *
+		 * @param Src Memory to read the bits from (LSB first).
+		 * @param LengthBits Number of bits to write.
+		 */
+		void SerializeBits(const void* Src, int64 LengthBits)
+		{
+			const uint8* SrcBytes = (const uint8*)Src;
+			int64 BitIndex = 0;
+			for (; BitIndex + 8 <= LengthBits; BitIndex += 8)
+			{
+				WriteBits(SrcBytes[BitIndex >> 3], 8);
+			}
+			if (BitIndex < LengthBits)
+			{
+				WriteBits(SrcBytes[BitIndex >> 3], (uint32)(LengthBits - BitIndex));
+			}
+		}
+
+		/** Discards all written bits while keeping the allocation. */
+		void Reset()
+		{
+			FMemory::Memzero(Buffer.data(), Buffer.size());
+			Num = 0;
+		}
+
+	public:
+
+		/** @return Pointer to the packed bits. */
+		inline const uint8* GetData() const
+		{
+			return Buffer.data();
+		}
+
+		/** @return Number of bits written so far. */
+		inline int64 GetNumBits() const
+		{
+			return Num;
+		}
+
+		/** @return Number of bytes needed to hold the written bits. */
+		inline int64 GetNumBytes() const
+		{
+			return (Num + 7) >> 3;
+		}
+
+	private:
+
+		/** Packed bits, always zero past Num. */
+		std::vector<uint8> Buffer;
+
+		/** Number of bits written. */
+		int64 Num;
+	};
+}
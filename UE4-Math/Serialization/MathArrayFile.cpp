@@ -0,0 +1,236 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MathArrayFile.cpp: Binary, memory mappable arrays of math types
+=============================================================================*/
+
+#include "Serialization/MathArrayFile.h"
+
+#if PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace UE4Math
+{
+	/*-----------------------------------------------------------------------------
+		FMathArrayHeader
+	-----------------------------------------------------------------------------*/
+
+	bool FMathArrayHeader::IsValid(uint64 TotalSize) const
+	{
+		if (Magic != MagicValue || Version != CurrentVersion || ElementSize == 0)
+		{
+			return false;
+		}
+		if (Alignment == 0 || !FMath::IsPowerOfTwo(Alignment) || (PayloadOffset % Alignment) != 0 || PayloadOffset < sizeof(FMathArrayHeader))
+		{
+			return false;
+		}
+		if (PayloadOffset > TotalSize || Count > (TotalSize - PayloadOffset) / ElementSize)
+		{
+			return false;
+		}
+		return true;
+	}
+
+	/*-----------------------------------------------------------------------------
+		FMathArrayFileWriter
+	-----------------------------------------------------------------------------*/
+
+	FMathArrayFileWriter::FMathArrayFileWriter()
+		: File(nullptr)
+		, bError(false)
+	{
+		FMemory::Memzero(Header);
+	}
+
+	FMathArrayFileWriter::~FMathArrayFileWriter()
+	{
+		Close();
+	}
+
+	bool FMathArrayFileWriter::Open(const char* Filename, uint16 TypeTag, uint32 ElementSize, uint32 Alignment)
+	{
+		Close();
+
+		File = fopen(Filename, "wb");
+		if (!File)
+		{
+			return false;
+		}
+
+		const uint32 PayloadAlignment = FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(Alignment, 16));
+
+		FMemory::Memzero(Header);
+		Header.Magic = FMathArrayHeader::MagicValue;
+		Header.Version = FMathArrayHeader::CurrentVersion;
+		Header.TypeTag = TypeTag;
+		Header.ElementSize = ElementSize;
+		Header.Alignment = PayloadAlignment;
+		Header.PayloadOffset = ((uint32)sizeof(FMathArrayHeader) + PayloadAlignment - 1) & ~(PayloadAlignment - 1);
+		bError = false;
+
+		// Provisional header plus zero padding up to the payload, patched in Close.
+		uint8 Padding[256] = { 0 };
+		bError |= fwrite(&Header, sizeof(Header), 1, File) != 1;
+		for (uint32 Remaining = Header.PayloadOffset - sizeof(Header); Remaining > 0;)
+		{
+			const uint32 Chunk = FMath::Min<uint32>(Remaining, sizeof(Padding));
+			bError |= fwrite(Padding, 1, Chunk, File) != Chunk;
+			Remaining -= Chunk;
+		}
+		return !bError;
+	}
+
+	bool FMathArrayFileWriter::WriteElements(const void* Bytes, int64 Count)
+	{
+		if (!File || Count <= 0)
+		{
+			return File != nullptr;
+		}
+
+		const size_t NumBytes = (size_t)Count * Header.ElementSize;
+		if (fwrite(Bytes, 1, NumBytes, File) != NumBytes)
+		{
+			bError = true;
+			return false;
+		}
+		Header.Checksum = FCrc::MemCrc32(Bytes, (int64)NumBytes, Header.Checksum);
+		Header.Count += (uint64)Count;
+		return true;
+	}
+
+	bool FMathArrayFileWriter::Close()
+	{
+		if (!File)
+		{
+			return false;
+		}
+
+		bError |= fseek(File, 0, SEEK_SET) != 0;
+		bError |= fwrite(&Header, sizeof(Header), 1, File) != 1;
+		bError |= fclose(File) != 0;
+		File = nullptr;
+		return !bError;
+	}
+
+	/*-----------------------------------------------------------------------------
+		FMappedMathArray
+	-----------------------------------------------------------------------------*/
+
+	FMappedMathArray::FMappedMathArray()
+		: MappedBase(nullptr)
+		, MappedSize(0)
+		, FileHandle(nullptr)
+		, MappingHandle(nullptr)
+	{
+	}
+
+	FMappedMathArray::~FMappedMathArray()
+	{
+		Close();
+	}
+
+	bool FMappedMathArray::Open(const char* Filename, bool bVerifyChecksum)
+	{
+		Close();
+
+#if PLATFORM_WINDOWS
+		HANDLE File = CreateFileA(Filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (File == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		FileHandle = File;
+
+		LARGE_INTEGER FileSize;
+		if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart < (LONGLONG)sizeof(FMathArrayHeader))
+		{
+			Close();
+			return false;
+		}
+		MappedSize = (uint64)FileSize.QuadPart;
+
+		HANDLE Mapping = CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!Mapping)
+		{
+			Close();
+			return false;
+		}
+		MappingHandle = Mapping;
+
+		MappedBase = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		const int File = open(Filename, O_RDONLY);
+		if (File < 0)
+		{
+			return false;
+		}
+
+		struct stat FileStat;
+		if (fstat(File, &FileStat) != 0 || FileStat.st_size < (off_t)sizeof(FMathArrayHeader))
+		{
+			close(File);
+			return false;
+		}
+		MappedSize = (uint64)FileStat.st_size;
+
+		void* Mapping = mmap(nullptr, (size_t)MappedSize, PROT_READ, MAP_SHARED, File, 0);
+		// The mapping keeps its own reference to the file.
+		close(File);
+		MappedBase = (Mapping == MAP_FAILED) ? nullptr : Mapping;
+#endif
+
+		if (!MappedBase || !GetHeader().IsValid(MappedSize) || (bVerifyChecksum && !VerifyChecksum()))
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void FMappedMathArray::Close()
+	{
+#if PLATFORM_WINDOWS
+		if (MappedBase)
+		{
+			UnmapViewOfFile(MappedBase);
+		}
+		if (MappingHandle)
+		{
+			CloseHandle((HANDLE)MappingHandle);
+		}
+		if (FileHandle)
+		{
+			CloseHandle((HANDLE)FileHandle);
+		}
+#else
+		if (MappedBase)
+		{
+			munmap(MappedBase, (size_t)MappedSize);
+		}
+#endif
+		MappedBase = nullptr;
+		MappedSize = 0;
+		FileHandle = nullptr;
+		MappingHandle = nullptr;
+	}
+
+	bool FMappedMathArray::VerifyChecksum() const
+	{
+		if (!IsOpen())
+		{
+			return false;
+		}
+		const FMathArrayHeader& Header = GetHeader();
+		const uint8* Payload = (const uint8*)MappedBase + Header.PayloadOffset;
+		return FCrc::MemCrc32(Payload, (int64)(Header.Count * Header.ElementSize)) == Header.Checksum;
+	}
+}
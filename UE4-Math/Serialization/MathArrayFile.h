@@ -0,0 +1,379 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+//#include "CoreTypes.h"
+#include "Math/UnrealMath.h"
+#include "Math/Color.h"
+#include "Misc/Crc.h"
+#include <stdio.h>
+
+namespace UE4Math
+{
+	static_assert(PLATFORM_LITTLE_ENDIAN, "Math array files are little endian and mapped in place, big endian hosts are not supported.");
+
+	/** Element types that can be stored in a math array file. Values are part of the file format, do not reorder. */
+	namespace EMathArrayType
+	{
+		enum Type : uint16
+		{
+			Unknown = 0,
+			Vector = 1,
+			Vector4 = 2,
+			Quat = 3,
+			Matrix = 4,
+			Box = 5,
+			Plane = 6,
+			Color = 7,
+			LinearColor = 8,
+			Vector2D = 9,
+			InterpCurvePointFloat = 16,
+			InterpCurvePointVector2D = 17,
+			InterpCurvePointVector = 18,
+			InterpCurvePointQuat = 19,
+			InterpCurvePointTwoVectors = 20,
+			InterpCurvePointLinearColor = 21,
+		};
+	}
+
+	/**
+	 * Traits describing how a type is stored in a math array file.
+	 *
+	 * Specializations provide the type tag. Types with padding bytes also provide Canonicalize, which copies an
+	 * element with its padding zeroed so the payload (and therefore the checksum) is deterministic.
+	 */
+	template <typename T>
+	struct TMathArrayTypeTraits
+	{
+		enum { Tag = EMathArrayType::Unknown };
+
+		static inline void Canonicalize(T& Dest, const T& Src)
+		{
+			FMemory::Memcpy(&Dest, &Src, sizeof(T));
+		}
+	};
+
+#define DECLARE_MATH_ARRAY_TYPE(InType, InTag) \
+	template <> struct TMathArrayTypeTraits<InType> \
+	{ \
+		enum { Tag = EMathArrayType::InTag }; \
+		static inline void Canonicalize(InType& Dest, const InType& Src) { FMemory::Memcpy(&Dest, &Src, sizeof(InType)); } \
+	};
+
+	DECLARE_MATH_ARRAY_TYPE(FVector, Vector)
+	DECLARE_MATH_ARRAY_TYPE(FVector4, Vector4)
+	DECLARE_MATH_ARRAY_TYPE(FQuat, Quat)
+	DECLARE_MATH_ARRAY_TYPE(FMatrix, Matrix)
+	DECLARE_MATH_ARRAY_TYPE(FPlane, Plane)
+	DECLARE_MATH_ARRAY_TYPE(FColor, Color)
+	DECLARE_MATH_ARRAY_TYPE(FLinearColor, LinearColor)
+	DECLARE_MATH_ARRAY_TYPE(FVector2D, Vector2D)
+	DECLARE_MATH_ARRAY_TYPE(FInterpCurvePoint<float>, InterpCurvePointFloat)
+	DECLARE_MATH_ARRAY_TYPE(FInterpCurvePoint<FVector2D>, InterpCurvePointVector2D)
+	DECLARE_MATH_ARRAY_TYPE(FInterpCurvePoint<FVector>, InterpCurvePointVector)
+	DECLARE_MATH_ARRAY_TYPE(FInterpCurvePoint<FQuat>, InterpCurvePointQuat)
+	DECLARE_MATH_ARRAY_TYPE(FInterpCurvePoint<FTwoVectors>, InterpCurvePointTwoVectors)
+	DECLARE_MATH_ARRAY_TYPE(FInterpCurvePoint<FLinearColor>, InterpCurvePointLinearColor)
+
+#undef DECLARE_MATH_ARRAY_TYPE
+
+	/** FBox carries three padding bytes after IsValid. */
+	template <> struct TMathArrayTypeTraits<FBox>
+	{
+		enum { Tag = EMathArrayType::Box };
+
+		static inline void Canonicalize(FBox& Dest, const FBox& Src)
+		{
+			FMemory::Memzero(&Dest, sizeof(FBox));
+			Dest.Min = Src.Min;
+			Dest.Max = Src.Max;
+			Dest.IsValid = Src.IsValid;
+		}
+	};
+
+
+	/**
+	 * Fixed size header at the start of every math array file. All fields are little endian.
+	 *
+	 * The payload starts at PayloadOffset, which is a multiple of Alignment, and holds Count tightly packed
+	 * elements of ElementSize bytes each, laid out exactly as in memory so they can be mapped in place.
+	 */
+	struct FMathArrayHeader
+	{
+		/** Identifies the file format, always MagicValue. */
+		uint32 Magic;
+
+		/** Format version, currently CurrentVersion. */
+		uint16 Version;
+
+		/** Element type, one of EMathArrayType. */
+		uint16 TypeTag;
+
+		/** sizeof() the element type when written. */
+		uint32 ElementSize;
+
+		/** Alignment of the payload in bytes (power of two). */
+		uint32 Alignment;
+
+		/** Number of elements in the payload. */
+		uint64 Count;
+
+		/** Byte offset of the payload from the start of the file. */
+		uint32 PayloadOffset;
+
+		/** FCrc::MemCrc32 of the payload bytes. */
+		uint32 Checksum;
+
+		enum : uint32 { MagicValue = 0x414D4555 /* "UEMA" */ };
+		enum : uint16 { CurrentVersion = 1 };
+
+		/**
+		 * Checks the header is well formed and fits in a buffer of the given size.
+		 *
+		 * @param TotalSize Size in bytes of the file or buffer the header was read from.
+		 * @return true if the header can be trusted to address the payload.
+		 */
+		bool IsValid(uint64 TotalSize) const;
+	};
+
+	static_assert(sizeof(FMathArrayHeader) == 32, "FMathArrayHeader is part of the file format.");
+
+
+	/**
+	 * A typed, read only view over elements stored elsewhere (usually a mapped file).
+	 */
+	template <typename T>
+	struct TMathArrayView
+	{
+	public:
+
+		TMathArrayView()
+			: Data(nullptr)
+			, Count(0)
+		{ }
+
+		TMathArrayView(const T* InData, int64 InCount)
+			: Data(InData)
+			, Count(InCount)
+		{ }
+
+		inline const T& operator[](int64 Index) const
+		{
+			return Data[Index];
+		}
+
+		inline const T* GetData() const { return Data; }
+		inline int64 Num() const { return Count; }
+		inline bool IsEmpty() const { return Count == 0; }
+
+		inline const T* begin() const { return Data; }
+		inline const T* end() const { return Data + Count; }
+
+	private:
+
+		const T* Data;
+		int64 Count;
+	};
+
+
+	/**
+	 * Untyped streaming writer for math array files. Use TMathArrayWriter instead of this directly.
+	 *
+	 * The header is written with a zero count on Open, payload bytes are appended as they arrive and the
+	 * checksum is accumulated on the fly, then Close patches the final count and checksum into the header.
+	 */
+	class FMathArrayFileWriter
+	{
+	public:
+
+		FMathArrayFileWriter();
+		~FMathArrayFileWriter();
+
+		/**
+		 * Creates the file and writes a provisional header.
+		 *
+		 * @param Filename Path of the file to create (overwritten if it exists).
+		 * @param TypeTag Element type tag, one of EMathArrayType.
+		 * @param ElementSize sizeof() the element type.
+		 * @param Alignment Payload alignment in bytes, rounded up to a power of two of at least 16.
+		 * @return true on success.
+		 */
+		bool Open(const char* Filename, uint16 TypeTag, uint32 ElementSize, uint32 Alignment);
+
+		/**
+		 * Appends whole elements to the payload.
+		 *
+		 * @param Bytes Element bytes, already canonicalized.
+		 * @param Count Number of elements in Bytes.
+		 * @return true on success.
+		 */
+		bool WriteElements(const void* Bytes, int64 Count);
+
+		/**
+		 * Writes the final header and closes the file.
+		 *
+		 * @return true if every write since Open succeeded.
+		 */
+		bool Close();
+
+		/** @return true between a successful Open and Close. */
+		inline bool IsOpen() const { return File != nullptr; }
+
+		/** @return Number of elements written so far. */
+		inline int64 Num() const { return (int64)Header.Count; }
+
+	private:
+
+		FMathArrayFileWriter(const FMathArrayFileWriter&) = delete;
+		FMathArrayFileWriter& operator=(const FMathArrayFileWriter&) = delete;
+
+		FILE* File;
+		FMathArrayHeader Header;
+		bool bError;
+	};
+
+
+	/**
+	 * Streams elements of one math type into a math array file.
+	 *
+	 * Elements are staged in fixed size chunks so padding can be zeroed without an allocation per call.
+	 */
+	template <typename T>
+	class TMathArrayWriter
+	{
+		static_assert(TMathArrayTypeTraits<T>::Tag != EMathArrayType::Unknown, "Type is not supported by math array files.");
+
+	public:
+
+		/**
+		 * @param InAlignment Payload alignment in bytes, 64 keeps mapped elements cache line aligned.
+		 */
+		explicit TMathArrayWriter(uint32 InAlignment = 64)
+			: Alignment(InAlignment)
+		{ }
+
+		/** Creates the file. @see FMathArrayFileWriter::Open */
+		bool Open(const char* Filename)
+		{
+			return Writer.Open(Filename, (uint16)TMathArrayTypeTraits<T>::Tag, (uint32)sizeof(T), FMath::Max<uint32>(Alignment, (uint32)alignof(T)));
+		}
+
+		/**
+		 * Appends elements to the file.
+		 *
+		 * @param Elements Elements to write.
+		 * @param Count Number of elements.
+		 * @return true on success.
+		 */
+		bool Write(const T* Elements, int64 Count)
+		{
+			bool bOk = true;
+			while (Count > 0)
+			{
+				const int32 ChunkCount = (int32)FMath::Min<int64>(Count, StagingCount);
+				for (int32 Index = 0; Index < ChunkCount; ++Index)
+				{
+					TMathArrayTypeTraits<T>::Canonicalize(Staging[Index], Elements[Index]);
+				}
+				bOk &= Writer.WriteElements(Staging, ChunkCount);
+				Elements += ChunkCount;
+				Count -= ChunkCount;
+			}
+			return bOk;
+		}
+
+		/** Appends one element to the file. */
+		bool Write(const T& Element)
+		{
+			return Write(&Element, 1);
+		}
+
+		/** Finalizes the header and closes the file. */
+		bool Close()
+		{
+			return Writer.Close();
+		}
+
+		/** @return Number of elements written so far. */
+		inline int64 Num() const
+		{
+			return Writer.Num();
+		}
+
+	private:
+
+		enum { StagingCount = (16 * 1024) / sizeof(T) > 0 ? (16 * 1024) / sizeof(T) : 1 };
+
+		FMathArrayFileWriter Writer;
+		T Staging[StagingCount];
+		uint32 Alignment;
+	};
+
+
+	/**
+	 * Maps a math array file into memory read only and hands out typed views over it without copying.
+	 */
+	class FMappedMathArray
+	{
+	public:
+
+		FMappedMathArray();
+		~FMappedMathArray();
+
+		/**
+		 * Maps a file and validates its header.
+		 *
+		 * @param Filename Path of the file.
+		 * @param bVerifyChecksum If true, hashes the whole payload (touching every page) and fails on mismatch.
+		 * @return true if the file was mapped and its header is valid.
+		 */
+		bool Open(const char* Filename, bool bVerifyChecksum = false);
+
+		/** Unmaps the file. Views obtained from this object become invalid. */
+		void Close();
+
+		/** @return true if a file is mapped. */
+		inline bool IsOpen() const { return MappedBase != nullptr; }
+
+		/** @return The header of the mapped file. Only valid while open. */
+		inline const FMathArrayHeader& GetHeader() const { return *(const FMathArrayHeader*)MappedBase; }
+
+		/** @return true if the payload hashes to the checksum stored in the header. */
+		bool VerifyChecksum() const;
+
+		/**
+		 * Returns a view over the payload.
+		 *
+		 * @return The elements, or an empty view if nothing is mapped or the file holds a different type.
+		 */
+		template <typename T>
+		TMathArrayView<T> GetView() const
+		{
+			if (!IsOpen())
+			{
+				return TMathArrayView<T>();
+			}
+			const FMathArrayHeader& Header = GetHeader();
+			if (Header.TypeTag != (uint16)TMathArrayTypeTraits<T>::Tag || Header.ElementSize != sizeof(T))
+			{
+				return TMathArrayView<T>();
+			}
+			return TMathArrayView<T>((const T*)((const uint8*)MappedBase + Header.PayloadOffset), (int64)Header.Count);
+		}
+
+	private:
+
+		FMappedMathArray(const FMappedMathArray&) = delete;
+		FMappedMathArray& operator=(const FMappedMathArray&) = delete;
+
+		/** Start of the mapping, the header lives here. */
+		void* MappedBase;
+
+		/** Size of the mapping in bytes. */
+		uint64 MappedSize;
+
+		/** Platform file and mapping handles. */
+		void* FileHandle;
+		void* MappingHandle;
+	};
+}
@@ -0,0 +1,151 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MathStats.cpp: Counters and cycle timers for the math library
+=============================================================================*/
+
+#include "Stats/MathStats.h"
+#include "Misc/StringBuilder.h"
+#include <algorithm>
+
+namespace UE4Math
+{
+	namespace MathStatsPrivate
+	{
+		/** Head of the list of registered stats, in reverse registration order. */
+		inline FMathStat*& GetFirstStat()
+		{
+			static FMathStat* First = nullptr;
+			return First;
+		}
+	}
+
+	DEFINE_MATH_COUNTER(MatrixInverseNil)
+	DEFINE_MATH_COUNTER(MatrixInverseSingular)
+	DEFINE_MATH_COUNTER(MatrixInverseFastInvalid)
+	DEFINE_MATH_COUNTER(QuatNormalizeFallback)
+
+	DEFINE_MATH_COUNTER(NaNVector)
+	DEFINE_MATH_COUNTER(NaNVector2D)
+	DEFINE_MATH_COUNTER(NaNVector4)
+	DEFINE_MATH_COUNTER(NaNRotator)
+	DEFINE_MATH_COUNTER(NaNQuat)
+	DEFINE_MATH_COUNTER(NaNBoxSphereBounds)
+	DEFINE_MATH_COUNTER(NaNValidationFailed)
+
+	DEFINE_MATH_CYCLE_STAT(MatrixMultiplyBatch)
+	DEFINE_MATH_COUNTER(MatrixMultiplyBatchElements)
+	DEFINE_MATH_CYCLE_STAT(MatrixInverseBatch)
+	DEFINE_MATH_COUNTER(MatrixInverseBatchElements)
+	DEFINE_MATH_CYCLE_STAT(Matrix3x4Batch)
+	DEFINE_MATH_COUNTER(Matrix3x4BatchElements)
+	DEFINE_MATH_CYCLE_STAT(VectorBatch)
+	DEFINE_MATH_COUNTER(VectorBatchElements)
+	DEFINE_MATH_CYCLE_STAT(BoundsBatch)
+	DEFINE_MATH_COUNTER(BoundsBatchElements)
+	DEFINE_MATH_CYCLE_STAT(ShapeQueryBatch)
+	DEFINE_MATH_COUNTER(ShapeQueryBatchElements)
+	DEFINE_MATH_CYCLE_STAT(ClipBatch)
+	DEFINE_MATH_COUNTER(ClipBatchElements)
+
+	DEFINE_MATH_CYCLE_STAT(SegmentTriangleIntersection)
+	DEFINE_MATH_CYCLE_STAT(GJKQuery)
+	DEFINE_MATH_COUNTER(GJKQueryIterations)
+	DEFINE_MATH_CYCLE_STAT(EPAQuery)
+	DEFINE_MATH_COUNTER(EPAQueryIterations)
+	DEFINE_MATH_CYCLE_STAT(ConvexHull2D)
+	DEFINE_MATH_COUNTER(ConvexHull2DPoints)
+	DEFINE_MATH_CYCLE_STAT(OcclusionRaster)
+	DEFINE_MATH_COUNTER(OcclusionRasterTriangles)
+	DEFINE_MATH_CYCLE_STAT(ClusterBuild)
+	DEFINE_MATH_COUNTER(ClusterBuildVolumes)
+	DEFINE_MATH_CYCLE_STAT(MeshBVHBuild)
+	DEFINE_MATH_COUNTER(MeshBVHBuildTriangles)
+
+	FMathStat::FMathStat(const char* InName, EMathStatType::Type InType)
+		: Name(InName)
+		, Type(InType)
+		, Next(MathStatsPrivate::GetFirstStat())
+	{
+		MathStatsPrivate::GetFirstStat() = this;
+	}
+
+	uint32 FMathStat::GetThreadSlot()
+	{
+		static std::atomic<uint32> NextSlot{ 0 };
+		static thread_local uint32 Slot = NextSlot.fetch_add(1, std::memory_order_relaxed) % NumSlots;
+		return Slot;
+	}
+
+	FMathStatSnapshot FMathStat::GetSnapshot() const
+	{
+		FMathStatSnapshot Result = { Name, Type, 0, 0 };
+		for (const FSlot& Slot : Slots)
+		{
+			Result.Count += Slot.Count.load(std::memory_order_relaxed);
+			Result.Cycles += Slot.Cycles.load(std::memory_order_relaxed);
+		}
+		return Result;
+	}
+
+	void FMathStat::Reset()
+	{
+		for (FSlot& Slot : Slots)
+		{
+			Slot.Count.store(0, std::memory_order_relaxed);
+			Slot.Cycles.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	void FMathStats::GetSnapshot(std::vector<FMathStatSnapshot>& OutStats)
+	{
+		const size_t FirstIndex = OutStats.size();
+		for (const FMathStat* Stat = MathStatsPrivate::GetFirstStat(); Stat; Stat = Stat->Next)
+		{
+			OutStats.push_back(Stat->GetSnapshot());
+		}
+		std::reverse(OutStats.begin() + FirstIndex, OutStats.end());
+	}
+
+	std::string FMathStats::GetSnapshotJson()
+	{
+		std::vector<FMathStatSnapshot> Stats;
+		GetSnapshot(Stats);
+
+		TStringBuilder<4096> Json;
+		for (int32 Pass = 0; Pass < 2; ++Pass)
+		{
+			const EMathStatType::Type PassType = Pass == 0 ? EMathStatType::Counter : EMathStatType::Cycles;
+			Json << (Pass == 0 ? "{\"counters\":{" : "},\"timers\":{");
+
+			bool bFirst = true;
+			for (const FMathStatSnapshot& Stat : Stats)
+			{
+				if (Stat.Type != PassType)
+				{
+					continue;
+				}
+				Json << (bFirst ? "\"" : ",\"") << Stat.Name << "\":";
+				if (PassType == EMathStatType::Counter)
+				{
+					Json << Stat.Count;
+				}
+				else
+				{
+					Json << "{\"calls\":" << Stat.Count << ",\"cycles\":" << Stat.Cycles << "}";
+				}
+				bFirst = false;
+			}
+		}
+		Json << "}}";
+		return Json.ToString();
+	}
+
+	void FMathStats::Reset()
+	{
+		for (FMathStat* Stat = MathStatsPrivate::GetFirstStat(); Stat; Stat = Stat->Next)
+		{
+			Stat->Reset();
+		}
+	}
+}
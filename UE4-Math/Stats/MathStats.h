@@ -0,0 +1,203 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "Misc/CoreMiscDefines.h"
+
+/**
+ * Hot path instrumentation for the math library: event counters and cycle timers.
+ * Compiled in with MATH_STATS=1. Otherwise every macro below expands to nothing and the guarded
+ * conditions are not evaluated. The snapshot API stays available and returns no stats.
+ */
+#ifndef MATH_STATS
+#define MATH_STATS 0
+#endif
+
+#if MATH_STATS
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace UE4Math
+{
+	namespace EMathStatType
+	{
+		enum Type
+		{
+			/** Counts events, e.g. how often a fallback branch is taken. */
+			Counter,
+
+			/** Counts calls and the rdtsc cycles spent in them. */
+			Cycles,
+		};
+	}
+
+	/** Value of one stat at the time of FMathStats::GetSnapshot. */
+	struct FMathStatSnapshot
+	{
+		const char* Name;
+		EMathStatType::Type Type;
+		uint64 Count;
+		uint64 Cycles;
+	};
+
+	/**
+	 * A named counter or timer. Each thread adds to its own cache line sized slot with relaxed atomics,
+	 * so hot loops on several threads do not contend. Snapshots sum the slots.
+	 * Define stats at namespace scope only, they register themselves during static initialization.
+	 */
+	class FMathStat
+	{
+	public:
+		enum { NumSlots = 64 };
+
+		FMathStat(const char* InName, EMathStatType::Type InType);
+
+		FMathStat(const FMathStat&) = delete;
+		FMathStat& operator=(const FMathStat&) = delete;
+
+		inline void Add(uint64 InCount)
+		{
+			Slots[GetThreadSlot()].Count.fetch_add(InCount, std::memory_order_relaxed);
+		}
+
+		inline void AddCycles(uint64 InCycles)
+		{
+			FSlot& Slot = Slots[GetThreadSlot()];
+			Slot.Count.fetch_add(1, std::memory_order_relaxed);
+			Slot.Cycles.fetch_add(InCycles, std::memory_order_relaxed);
+		}
+
+		FMathStatSnapshot GetSnapshot() const;
+		void Reset();
+
+	private:
+		friend struct FMathStats;
+
+		struct alignas(64) FSlot
+		{
+			std::atomic<uint64> Count{ 0 };
+			std::atomic<uint64> Cycles{ 0 };
+		};
+
+		/** @return Slot of the calling thread, assigned round robin on first use. */
+		static uint32 GetThreadSlot();
+
+		const char* Name;
+		EMathStatType::Type Type;
+		FMathStat* Next;
+		FSlot Slots[NumSlots];
+	};
+
+	/** Access to every registered stat. */
+	struct FMathStats
+	{
+		/** Appends the current value of every stat, in registration order. */
+		static void GetSnapshot(std::vector<FMathStatSnapshot>& OutStats);
+
+		/**
+		 * Returns every stat as a JSON object, e.g.
+		 * {"counters":{"MatrixInverseSingular":3},"timers":{"SegmentTriangleIntersection":{"calls":10,"cycles":4200}}}
+		 */
+		static std::string GetSnapshotJson();
+
+		/** Sets every stat back to zero. Increments racing with the reset may be lost. */
+		static void Reset();
+	};
+
+#if MATH_STATS
+	/** Adds the cycles spent between construction and destruction to a timer stat. */
+	class FScopeMathCycleCounter
+	{
+	public:
+		explicit FScopeMathCycleCounter(FMathStat& InStat)
+			: Stat(InStat)
+			, StartCycles(__rdtsc())
+		{
+		}
+
+		~FScopeMathCycleCounter()
+		{
+			Stat.AddCycles(__rdtsc() - StartCycles);
+		}
+
+	private:
+		FMathStat& Stat;
+		uint64 StartCycles;
+	};
+#endif
+
+	/*-----------------------------------------------------------------------------
+		Stats of the math library. Defined in MathStats.cpp.
+	-----------------------------------------------------------------------------*/
+
+#if MATH_STATS
+#define DECLARE_MATH_STAT(StatName)					extern FMathStat MathStat_##StatName;
+#define DEFINE_MATH_COUNTER(StatName)				FMathStat MathStat_##StatName(#StatName, EMathStatType::Counter);
+#define DEFINE_MATH_CYCLE_STAT(StatName)			FMathStat MathStat_##StatName(#StatName, EMathStatType::Cycles);
+#define INC_MATH_COUNTER(StatName)					UE4Math::MathStat_##StatName.Add(1)
+#define INC_MATH_COUNTER_BY(StatName, Amount)		UE4Math::MathStat_##StatName.Add((uint64)(Amount))
+#define INC_MATH_COUNTER_IF(StatName, Condition)	do { if (Condition) { UE4Math::MathStat_##StatName.Add(1); } } while (0)
+#define SCOPE_MATH_CYCLE_COUNTER(StatName)			UE4Math::FScopeMathCycleCounter MathCycleCounter_##StatName(UE4Math::MathStat_##StatName)
+#else
+#define DECLARE_MATH_STAT(StatName)
+#define DEFINE_MATH_COUNTER(StatName)
+#define DEFINE_MATH_CYCLE_STAT(StatName)
+#define INC_MATH_COUNTER(StatName)
+#define INC_MATH_COUNTER_BY(StatName, Amount)
+#define INC_MATH_COUNTER_IF(StatName, Condition)
+#define SCOPE_MATH_CYCLE_COUNTER(StatName)
+#endif
+
+	// Degenerate input branches
+	DECLARE_MATH_STAT(MatrixInverseNil)
+	DECLARE_MATH_STAT(MatrixInverseSingular)
+	DECLARE_MATH_STAT(MatrixInverseFastInvalid)
+	DECLARE_MATH_STAT(QuatNormalizeFallback)
+
+	// DiagnosticCheckNaN hits, counted even when ENABLE_NAN_DIAGNOSTIC is off
+	DECLARE_MATH_STAT(NaNVector)
+	DECLARE_MATH_STAT(NaNVector2D)
+	DECLARE_MATH_STAT(NaNVector4)
+	DECLARE_MATH_STAT(NaNRotator)
+	DECLARE_MATH_STAT(NaNQuat)
+	DECLARE_MATH_STAT(NaNBoxSphereBounds)
+	DECLARE_MATH_STAT(NaNValidationFailed)
+
+	// Batch kernels, the counters hold the number of elements processed
+	DECLARE_MATH_STAT(MatrixMultiplyBatch)
+	DECLARE_MATH_STAT(MatrixMultiplyBatchElements)
+	DECLARE_MATH_STAT(MatrixInverseBatch)
+	DECLARE_MATH_STAT(MatrixInverseBatchElements)
+	DECLARE_MATH_STAT(Matrix3x4Batch)
+	DECLARE_MATH_STAT(Matrix3x4BatchElements)
+	DECLARE_MATH_STAT(VectorBatch)
+	DECLARE_MATH_STAT(VectorBatchElements)
+	DECLARE_MATH_STAT(BoundsBatch)
+	DECLARE_MATH_STAT(BoundsBatchElements)
+	DECLARE_MATH_STAT(ShapeQueryBatch)
+	DECLARE_MATH_STAT(ShapeQueryBatchElements)
+	DECLARE_MATH_STAT(ClipBatch)
+	DECLARE_MATH_STAT(ClipBatchElements)
+
+	// Queries
+	DECLARE_MATH_STAT(SegmentTriangleIntersection)
+	DECLARE_MATH_STAT(GJKQuery)
+	DECLARE_MATH_STAT(GJKQueryIterations)
+	DECLARE_MATH_STAT(EPAQuery)
+	DECLARE_MATH_STAT(EPAQueryIterations)
+	DECLARE_MATH_STAT(ConvexHull2D)
+	DECLARE_MATH_STAT(ConvexHull2DPoints)
+	DECLARE_MATH_STAT(OcclusionRaster)
+	DECLARE_MATH_STAT(OcclusionRasterTriangles)
+	DECLARE_MATH_STAT(ClusterBuild)
+	DECLARE_MATH_STAT(ClusterBuildVolumes)
+	DECLARE_MATH_STAT(MeshBVHBuild)
+	DECLARE_MATH_STAT(MeshBVHBuildTriangles)
+}
@@ -0,0 +1,255 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	BoxSphereBoundsTests.cpp: FSphere and FBoxSphereBounds tests
+=============================================================================*/
+
+#include "Tests/MathTests.h"
+#include "Math/BoxSphereBounds.h"
+#include "Math/Matrix3x4.h"
+#include "Math/Quat.h"
+#include "Math/Plane.h"
+#include <vector>
+
+namespace UE4Math
+{
+	namespace BoxSphereBoundsTestsPrivate
+	{
+		/** Counts with odd remainders and around the batch split size, so every way a batch can end is covered. */
+		const int32 BatchCounts[] = { 0, 1, 2, 3, 7, 31, 1023, 1024, 1025, 2047, 2049, 4097 };
+
+		/** Transformed bounds are a few multiply-adds away from the scalar ones, relative to their size. */
+		constexpr float Tolerance = 1.e-4f;
+
+		FBoxSphereBounds GetRandomBounds(MathTests::FTestRandom& Random)
+		{
+			const FVector Origin = Random.GetVector(-1000.0f, 1000.0f);
+			const FVector Extent = Random.GetVector(0.0f, 100.0f);
+			// Bounds built from points often have a sphere smaller than the box's.
+			return FBoxSphereBounds(Origin, Extent, Extent.Size() * Random.GetRange(0.5f, 1.0f));
+		}
+
+		FMatrix GetRandomMatrix(MathTests::FTestRandom& Random)
+		{
+			const FQuat Rotation(Random.GetUnitVector(), Random.GetRange(-PI, PI));
+			const FVector Scale = Random.GetVector(0.25f, 4.0f);
+			return FMatrix(Rotation.GetAxisX() * Scale.X, Rotation.GetAxisY() * Scale.Y, Rotation.GetAxisZ() * Scale.Z, Random.GetVector(-500.0f, 500.0f));
+		}
+
+		bool BoundsEqual(const FBoxSphereBounds& A, const FBoxSphereBounds& B)
+		{
+			const float Scale = FMath::Max(1.0f, A.Origin.GetAbsMax() + A.SphereRadius);
+			return A.Origin.Equals(B.Origin, Scale * Tolerance)
+				&& A.BoxExtent.Equals(B.BoxExtent, Scale * Tolerance)
+				&& FMath::IsNearlyEqual(A.SphereRadius, B.SphereRadius, Scale * Tolerance);
+		}
+
+		int32 TestTransformBatch()
+		{
+			int32 NumFailures = 0;
+			MathTests::FTestRandom Random(1);
+
+			for (const int32 Count : BatchCounts)
+			{
+				std::vector<FBoxSphereBounds> In(Count);
+				std::vector<FMatrix3x4> Transforms(Count);
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					In[Index] = GetRandomBounds(Random);
+					Transforms[Index] = FMatrix3x4(GetRandomMatrix(Random));
+				}
+				const FMatrix Shared = GetRandomMatrix(Random);
+
+				std::vector<FBoxSphereBounds> PerBounds(Count);
+				std::vector<FBoxSphereBounds> BySharedMatrix(Count);
+				FBoxSphereBounds::TransformBatch(In.data(), Transforms.data(), PerBounds.data(), Count);
+				FBoxSphereBounds::TransformBatch(In.data(), Shared, BySharedMatrix.data(), Count);
+
+				int32 NumMismatches = 0;
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					NumMismatches += BoundsEqual(PerBounds[Index], In[Index].TransformBy(Transforms[Index])) ? 0 : 1;
+					NumMismatches += BoundsEqual(BySharedMatrix[Index], In[Index].TransformBy(Shared)) ? 0 : 1;
+				}
+				MATH_TEST_CHECK(NumMismatches == 0);
+
+				// Out may alias In.
+				std::vector<FBoxSphereBounds> InPlace = In;
+				FBoxSphereBounds::TransformBatch(InPlace.data(), Shared, InPlace.data(), Count);
+				NumMismatches = 0;
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					NumMismatches += BoundsEqual(InPlace[Index], BySharedMatrix[Index]) ? 0 : 1;
+				}
+				MATH_TEST_CHECK(NumMismatches == 0);
+			}
+			return NumFailures;
+		}
+
+		int32 TestUnionBatch()
+		{
+			int32 NumFailures = 0;
+			MathTests::FTestRandom Random(2);
+
+			for (const int32 Count : BatchCounts)
+			{
+				std::vector<FBoxSphereBounds> Bounds(Count);
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					Bounds[Index] = GetRandomBounds(Random);
+				}
+
+				const FBoxSphereBounds Batch = FBoxSphereBounds::UnionBatch(Bounds.data(), Count);
+				if (Count == 0)
+				{
+					MATH_TEST_CHECK(BoundsEqual(Batch, FBoxSphereBounds(ForceInit)));
+					continue;
+				}
+
+				FBoxSphereBounds Folded = Bounds[0];
+				for (int32 Index = 1; Index < Count; ++Index)
+				{
+					Folded = Folded + Bounds[Index];
+				}
+
+				// The box does not depend on the order of the unions.
+				const float Scale = FMath::Max(1.0f, Folded.Origin.GetAbsMax() + Folded.SphereRadius);
+				MATH_TEST_CHECK(Batch.Origin.Equals(Folded.Origin, Scale * Tolerance));
+				MATH_TEST_CHECK(Batch.BoxExtent.Equals(Folded.BoxExtent, Scale * Tolerance));
+
+				// A single union uses the same sphere formula, longer folds differ as their centers move.
+				if (Count == 2)
+				{
+					MATH_TEST_CHECK(FMath::IsNearlyEqual(Batch.SphereRadius, Folded.SphereRadius, Scale * Tolerance));
+				}
+
+				// Every sphere is inside the result's, unless that one was clamped to the sphere around the box.
+				int32 NumOutside = 0;
+				if (Batch.SphereRadius < Batch.BoxExtent.Size() - Scale * Tolerance)
+				{
+					for (int32 Index = 0; Index < Count; ++Index)
+					{
+						NumOutside += (Bounds[Index].Origin - Batch.Origin).Size() + Bounds[Index].SphereRadius <= Batch.SphereRadius + Scale * Tolerance ? 0 : 1;
+					}
+				}
+				MATH_TEST_CHECK(NumOutside == 0);
+			}
+			return NumFailures;
+		}
+	}
+
+	namespace BoxSphereBoundsTestsPrivate
+	{
+		/**
+		 * A frustum looking down +X with a 90 degree field of view, from X = 1 to X = 100. Like every frustum the
+		 * predicates take, its planes point out: PlaneDot is positive outside.
+		 */
+		void GetFrustumPlanes(FPlane OutPlanes[6])
+		{
+			OutPlanes[0] = FPlane(FVector(1.0f, 0.0f, 0.0f), FVector(-1.0f, 0.0f, 0.0f));
+			OutPlanes[1] = FPlane(FVector(100.0f, 0.0f, 0.0f), FVector(1.0f, 0.0f, 0.0f));
+			OutPlanes[2] = FPlane(FVector::ZeroVector, FVector(-1.0f, 1.0f, 0.0f).GetUnsafeNormal());
+			OutPlanes[3] = FPlane(FVector::ZeroVector, FVector(-1.0f, -1.0f, 0.0f).GetUnsafeNormal());
+			OutPlanes[4] = FPlane(FVector::ZeroVector, FVector(-1.0f, 0.0f, 1.0f).GetUnsafeNormal());
+			OutPlanes[5] = FPlane(FVector::ZeroVector, FVector(-1.0f, 0.0f, -1.0f).GetUnsafeNormal());
+		}
+
+		/** Sphere against sphere and frustum, with radii and distances exact in float so touching is exact. */
+		int32 TestSphereIntersects()
+		{
+			int32 NumFailures = 0;
+
+			const FSphere Sphere(FVector(1.0f, 2.0f, 3.0f), 1.0f);
+			MATH_TEST_CHECK(Sphere.Intersects(FSphere(FVector(4.0f, 2.0f, 3.0f), 2.0f)));
+			MATH_TEST_CHECK(!Sphere.Intersects(FSphere(FVector(4.0f, 2.0f, 3.0f), 1.5f)));
+			MATH_TEST_CHECK(!FSphere(FVector(4.0f, 2.0f, 3.0f), 1.5f).Intersects(Sphere));
+			MATH_TEST_CHECK(Sphere.Intersects(FSphere(FVector(1.25f, 2.0f, 3.0f), 0.25f)));
+			MATH_TEST_CHECK(FSphere(FVector(1.25f, 2.0f, 3.0f), 0.25f).Intersects(Sphere));
+			MATH_TEST_CHECK(Sphere.Intersects(Sphere));
+
+			FPlane Planes[6];
+			GetFrustumPlanes(Planes);
+			MATH_TEST_CHECK(FSphere(FVector(50.0f, 0.0f, 0.0f), 1.0f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(FSphere(FVector(50.0f, 10.0f, -10.0f), 1000.0f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(FSphere(FVector(0.5f, 0.0f, 0.0f), 0.5f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(!FSphere(FVector(0.25f, 0.0f, 0.0f), 0.5f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(FSphere(FVector(104.0f, 0.0f, 0.0f), 4.0f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(!FSphere(FVector(105.0f, 0.0f, 0.0f), 4.0f).IntersectsFrustum(Planes, 6));
+
+			// Beside the field of view, one and two units from the side plane.
+			const FVector Side = FVector(-1.0f, 1.0f, 0.0f).GetUnsafeNormal();
+			MATH_TEST_CHECK(FSphere(FVector(50.0f, 50.0f, 0.0f) + Side * 1.0f, 1.5f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(!FSphere(FVector(50.0f, 50.0f, 0.0f) + Side * 2.0f, 1.5f).IntersectsFrustum(Planes, 6));
+
+			// With the planes turned inward, a sphere in the middle of the frustum is outside all of them.
+			FPlane InwardPlanes[6];
+			for (int32 Index = 0; Index < 6; ++Index)
+			{
+				InwardPlanes[Index] = Planes[Index].Flip();
+			}
+			MATH_TEST_CHECK(!FSphere(FVector(50.0f, 0.0f, 0.0f), 1.0f).IntersectsFrustum(InwardPlanes, 6));
+			return NumFailures;
+		}
+
+		/** Bounds against bounds, spheres and frustums, with a sphere looser than the box so the two tests disagree. */
+		int32 TestBoundsIntersects()
+		{
+			int32 NumFailures = 0;
+
+			const FBoxSphereBounds Bounds(FVector::ZeroVector, FVector(1.0f), 3.0f);
+
+			// Spheres and boxes touching, apart and one inside the other.
+			MATH_TEST_CHECK(FBoxSphereBounds::SpheresIntersect(Bounds, FBoxSphereBounds(FVector(5.0f, 0.0f, 0.0f), FVector(1.0f), 2.0f)));
+			MATH_TEST_CHECK(!FBoxSphereBounds::SpheresIntersect(Bounds, FBoxSphereBounds(FVector(5.5f, 0.0f, 0.0f), FVector(1.0f), 2.0f)));
+			MATH_TEST_CHECK(FBoxSphereBounds::SpheresIntersect(Bounds, FBoxSphereBounds(FVector(0.5f), FVector(0.25f), 0.5f)));
+			MATH_TEST_CHECK(FBoxSphereBounds::BoxesIntersect(Bounds, FBoxSphereBounds(FVector(2.0f, 0.0f, 0.0f), FVector(1.0f), 2.0f)));
+			MATH_TEST_CHECK(FBoxSphereBounds::BoxesIntersect(Bounds, FBoxSphereBounds(FVector(2.0f, 2.0f, 2.0f), FVector(1.0f), 2.0f)));
+			MATH_TEST_CHECK(!FBoxSphereBounds::BoxesIntersect(Bounds, FBoxSphereBounds(FVector(2.5f, 0.0f, 0.0f), FVector(1.0f), 2.0f)));
+			MATH_TEST_CHECK(FBoxSphereBounds::BoxesIntersect(Bounds, FBoxSphereBounds(FVector(0.5f), FVector(0.25f), 0.5f)));
+			MATH_TEST_CHECK(FBoxSphereBounds::BoxesIntersect(FBoxSphereBounds(FVector(0.5f), FVector(0.25f), 0.5f), Bounds));
+
+			// Both the bounding sphere and the box have to touch.
+			MATH_TEST_CHECK(Bounds.Intersects(FSphere(FVector(1.5f, 0.0f, 0.0f), 0.5f)));
+			MATH_TEST_CHECK(!Bounds.Intersects(FSphere(FVector(1.75f, 0.0f, 0.0f), 0.5f)));
+			MATH_TEST_CHECK(!Bounds.Intersects(FSphere(FVector(1.5f, 1.5f, 0.0f), 0.5f)));
+			MATH_TEST_CHECK(!FBoxSphereBounds(FVector::ZeroVector, FVector(1.0f), 1.0f).Intersects(FSphere(FVector(1.5f, 1.5f, 0.0f), 1.0f)));
+			MATH_TEST_CHECK(Bounds.Intersects(FSphere(FVector(0.5f, 0.0f, 0.0f), 0.25f)));
+			MATH_TEST_CHECK(Bounds.Intersects(FSphere(FVector::ZeroVector, 100.0f)));
+
+			FPlane Planes[6];
+			GetFrustumPlanes(Planes);
+			MATH_TEST_CHECK(Bounds.IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(!FBoxSphereBounds(FVector(-0.5f, 0.0f, 0.0f), FVector(1.0f), 3.0f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(FBoxSphereBounds(FVector(50.0f, 0.0f, 0.0f), FVector(1.0f), 3.0f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(FBoxSphereBounds(FVector(50.0f), FVector(1000.0f), 2000.0f).IntersectsFrustum(Planes, 6));
+
+			// A unit box reaches 1.41 out along the side plane's normal. Only the box reaches the plane, then both,
+			// then only the sphere.
+			const FVector Side = FVector(-1.0f, 1.0f, 0.0f).GetUnsafeNormal();
+			const FVector Beside = FVector(50.0f, 50.0f, 0.0f) + Side * 1.25f;
+			MATH_TEST_CHECK(!FBoxSphereBounds(Beside, FVector(1.0f), 1.0f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(FBoxSphereBounds(Beside, FVector(1.0f), 2.0f).IntersectsFrustum(Planes, 6));
+			MATH_TEST_CHECK(!FBoxSphereBounds(Beside, FVector(0.5f), 2.0f).IntersectsFrustum(Planes, 6));
+
+			FPlane InwardPlanes[6];
+			for (int32 Index = 0; Index < 6; ++Index)
+			{
+				InwardPlanes[Index] = Planes[Index].Flip();
+			}
+			MATH_TEST_CHECK(!FBoxSphereBounds(FVector(50.0f, 0.0f, 0.0f), FVector(1.0f), 3.0f).IntersectsFrustum(InwardPlanes, 6));
+			return NumFailures;
+		}
+	}
+
+	int32 MathTests::RunBoxSphereBoundsTests()
+	{
+		using namespace BoxSphereBoundsTestsPrivate;
+
+		int32 NumFailures = 0;
+		NumFailures += TestTransformBatch();
+		NumFailures += TestUnionBatch();
+		NumFailures += TestSphereIntersects();
+		NumFailures += TestBoundsIntersects();
+		return NumFailures;
+	}
+}
@@ -0,0 +1,61 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	CapsuleShapeTests.cpp: FCapsuleShape sweep tests
+=============================================================================*/
+
+#include "Tests/MathTests.h"
+#include "Math/CapsuleShape.h"
+#include "Math/Box.h"
+
+namespace UE4Math
+{
+	namespace CapsuleShapeTestsPrivate
+	{
+		/**
+		 * Sweeps over millions of units through the middle of a box. Far from the origin each conservative
+		 * advancement step is below float precision and the sweep runs out of steps short of the contact
+		 * tolerance, which has to be reported as a hit at the last step rather than let the capsule tunnel.
+		 */
+		int32 TestLongSweeps()
+		{
+			int32 NumFailures = 0;
+			MathTests::FTestRandom Random(11);
+
+			const FBox Box(FVector(-50.0f), FVector(50.0f));
+			int32 NumMissed = 0;
+			int32 NumWrongTime = 0;
+			for (int32 Index = 0; Index < 256; ++Index)
+			{
+				const float Distance = Random.GetRange(1.e3f, 1.e7f);
+				const FVector Direction = Random.GetUnitVector();
+				const FVector Target = Random.GetVector(-40.0f, 40.0f);
+				const FCapsuleShape Capsule(Target - Direction * Distance * 0.5f, Random.GetRange(1.0f, 60.0f), Random.GetUnitVector(), Random.GetRange(0.0f, 100.0f));
+
+				float Time;
+				FVector Normal;
+				if (!Capsule.SweepBox(Direction * Distance, Box, Time, Normal))
+				{
+					++NumMissed;
+					continue;
+				}
+
+				// The capsule reaches Target halfway, and touches the box at most its size plus the capsule's earlier.
+				const float Reach = Box.GetExtent().Size() + Capsule.Radius + Capsule.Length * 0.5f;
+				NumWrongTime += Time <= 0.5f + KINDA_SMALL_NUMBER && Time >= 0.5f - Reach / Distance - KINDA_SMALL_NUMBER ? 0 : 1;
+			}
+			MATH_TEST_CHECK(NumMissed == 0);
+			MATH_TEST_CHECK(NumWrongTime == 0);
+			return NumFailures;
+		}
+	}
+
+	int32 MathTests::RunCapsuleShapeTests()
+	{
+		using namespace CapsuleShapeTestsPrivate;
+
+		int32 NumFailures = 0;
+		NumFailures += TestLongSweeps();
+		return NumFailures;
+	}
+}
@@ -0,0 +1,187 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	ConvexQueriesTests.cpp: EPA penetration tests
+=============================================================================*/
+
+#include "Tests/MathTests.h"
+#include "Math/ConvexQueries.h"
+#include "Math/Quat.h"
+
+namespace UE4Math
+{
+	namespace ConvexQueriesTestsPrivate
+	{
+		/** EPA stops once it is within a relative 1e-4 of the boundary, the checks allow some rounding on top. */
+		constexpr float DepthTolerance = 1.e-3f;
+
+		/** @return Depth of two overlapping boxes, the smallest overlap along an axis, and that axis in OutAxis. */
+		float GetBoxDepth(const FBox& A, const FBox& B, int32& OutAxis)
+		{
+			float Depth = BIG_NUMBER;
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				const float Overlap = FMath::Min(A.Max[Axis] - B.Min[Axis], B.Max[Axis] - A.Min[Axis]);
+				if (Overlap < Depth)
+				{
+					Depth = Overlap;
+					OutAxis = Axis;
+				}
+			}
+			return Depth;
+		}
+
+		/** @return Depth of two overlapping oriented boxes, the smallest overlap over the 15 separating axis candidates. */
+		float GetOrientedBoxDepth(const FOrientedBox& A, const FOrientedBox& B)
+		{
+			const FVector AxesA[3] = { A.AxisX, A.AxisY, A.AxisZ };
+			const FVector AxesB[3] = { B.AxisX, B.AxisY, B.AxisZ };
+
+			FVector Axes[15];
+			int32 NumAxes = 0;
+			for (int32 Index = 0; Index < 3; ++Index)
+			{
+				Axes[NumAxes++] = AxesA[Index];
+				Axes[NumAxes++] = AxesB[Index];
+			}
+			for (int32 IndexA = 0; IndexA < 3; ++IndexA)
+			{
+				for (int32 IndexB = 0; IndexB < 3; ++IndexB)
+				{
+					const FVector Cross = AxesA[IndexA] ^ AxesB[IndexB];
+					if (Cross.SizeSquared() > KINDA_SMALL_NUMBER)
+					{
+						Axes[NumAxes++] = Cross.GetUnsafeNormal();
+					}
+				}
+			}
+
+			float Depth = BIG_NUMBER;
+			for (int32 Index = 0; Index < NumAxes; ++Index)
+			{
+				float MinA, MaxA, MinB, MaxB;
+				A.Project(Axes[Index], MinA, MaxA);
+				B.Project(Axes[Index], MinB, MaxB);
+				Depth = FMath::Min(Depth, FMath::Min(MaxA - MinB, MaxB - MinA));
+			}
+			return Depth;
+		}
+
+		FOrientedBox GetRandomOrientedBox(MathTests::FTestRandom& Random, const FQuat& Rotation, const FVector& Center)
+		{
+			FOrientedBox Box;
+			Box.Center = Center;
+			Box.AxisX = Rotation.GetAxisX();
+			Box.AxisY = Rotation.GetAxisY();
+			Box.AxisZ = Rotation.GetAxisZ();
+			Box.ExtentX = Random.GetRange(0.5f, 2.0f);
+			Box.ExtentY = Random.GetRange(0.5f, 2.0f);
+			Box.ExtentZ = Random.GetRange(0.5f, 2.0f);
+			return Box;
+		}
+
+		/** Counts a result that is off the expected depth, or whose deepest points do not match it. */
+		int32 CountWrongResult(bool bOverlapping, const FPenetrationResult& Result, float ExpectedDepth)
+		{
+			const float Tolerance = DepthTolerance * FMath::Max(1.0f, ExpectedDepth);
+			return bOverlapping
+				&& FMath::IsNearlyEqual(Result.Depth, ExpectedDepth, Tolerance)
+				&& (Result.PointA - Result.PointB).Equals(Result.Normal * Result.Depth, Tolerance) ? 0 : 1;
+		}
+
+		/**
+		 * A pair of boxes whose Minkowski difference has many coplanar points. A fan triangle EPA built on them
+		 * used to be flat, and EPA stopped on a face it had already removed with a depth of 1.568 instead of 1.740.
+		 */
+		int32 TestCoplanarBoxes()
+		{
+			int32 NumFailures = 0;
+
+			const FBox A(FVector(-1.95491815f, -2.21499085f, -2.04848742f), FVector(2.33895087f, 0.556983232f, 0.443500519f));
+			const FBox B(FVector(-2.37447953f, -1.18299818f, -1.72967744f), FVector(1.78387427f, 3.2578783f, 0.688747406f));
+
+			int32 Axis;
+			const float Depth = GetBoxDepth(A, B, Axis);
+			FPenetrationResult Result;
+			const bool bOverlapping = FConvexQueries::EPAPenetration(FConvexSupport(A), FConvexSupport(B), Result);
+			MATH_TEST_CHECK(CountWrongResult(bOverlapping, Result, Depth) == 0);
+			MATH_TEST_CHECK(FMath::IsNearlyEqual(FMath::Abs(Result.Normal[Axis]), 1.0f, DepthTolerance));
+			return NumFailures;
+		}
+
+		int32 TestRandomBoxes()
+		{
+			int32 NumFailures = 0;
+			MathTests::FTestRandom Random(5);
+
+			int32 NumWrong = 0;
+			int32 NumWrongNormals = 0;
+			for (int32 Index = 0; Index < 4096; ++Index)
+			{
+				const FVector CenterA = Random.GetVector(-1.0f, 1.0f);
+				const FVector CenterB = CenterA + Random.GetVector(-2.0f, 2.0f);
+				const FVector ExtentA = Random.GetVector(0.5f, 2.5f);
+				const FVector ExtentB = Random.GetVector(0.5f, 2.5f);
+				const FBox A(CenterA - ExtentA, CenterA + ExtentA);
+				const FBox B(CenterB - ExtentB, CenterB + ExtentB);
+
+				int32 Axis;
+				const float Depth = GetBoxDepth(A, B, Axis);
+				if (Depth <= 0.01f)
+				{
+					continue;
+				}
+
+				FPenetrationResult Result;
+				const bool bOverlapping = FConvexQueries::EPAPenetration(FConvexSupport(A), FConvexSupport(B), Result);
+				NumWrong += CountWrongResult(bOverlapping, Result, Depth);
+				NumWrongNormals += FMath::Abs(Result.Normal[Axis]) >= 1.0f - DepthTolerance ? 0 : 1;
+			}
+			MATH_TEST_CHECK(NumWrong == 0);
+
+			// A tie between two axes may pick either of them.
+			MATH_TEST_CHECK(NumWrongNormals <= 4);
+			return NumFailures;
+		}
+
+		/** Oriented boxes, a third of them with the same rotation so their faces and edges are parallel. */
+		int32 TestRandomOrientedBoxes()
+		{
+			int32 NumFailures = 0;
+			MathTests::FTestRandom Random(3);
+
+			int32 NumWrong = 0;
+			for (int32 Index = 0; Index < 4096; ++Index)
+			{
+				const FQuat RotationA(Random.GetUnitVector(), Random.GetRange(-PI, PI));
+				const FQuat RotationB = Index % 3 == 0 ? RotationA : FQuat(Random.GetUnitVector(), Random.GetRange(-PI, PI));
+				const FVector CenterA = Random.GetVector(-1.0f, 1.0f);
+				const FOrientedBox A = GetRandomOrientedBox(Random, RotationA, CenterA);
+				const FOrientedBox B = GetRandomOrientedBox(Random, RotationB, CenterA + Random.GetVector(-2.0f, 2.0f));
+
+				const float Depth = GetOrientedBoxDepth(A, B);
+				if (Depth <= 0.01f)
+				{
+					continue;
+				}
+
+				FPenetrationResult Result;
+				const bool bOverlapping = FConvexQueries::EPAPenetration(FConvexSupport(A), FConvexSupport(B), Result);
+				NumWrong += CountWrongResult(bOverlapping, Result, Depth);
+			}
+			MATH_TEST_CHECK(NumWrong == 0);
+			return NumFailures;
+		}
+	}
+
+	int32 MathTests::RunConvexQueriesTests()
+	{
+		using namespace ConvexQueriesTestsPrivate;
+
+		int32 NumFailures = 0;
+		NumFailures += TestCoplanarBoxes();
+		NumFailures += TestRandomBoxes();
+		NumFailures += TestRandomOrientedBoxes();
+		return NumFailures;
+	}
+}
@@ -0,0 +1,45 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	MathTests.cpp: Test runner
+=============================================================================*/
+
+#include "Tests/MathTests.h"
+#include "Async/QueuedThreadPool.h"
+#include <cstdio>
+
+namespace UE4Math
+{
+	namespace MathTests
+	{
+		void ReportFailure(const char* Expression, const char* File, int32 Line, int32& NumFailures)
+		{
+			printf("%s(%d): check failed: %s\n", File, Line, Expression);
+			++NumFailures;
+		}
+
+		int32 RunAllTests()
+		{
+			FQueuedThreadPool* OwnedPool = nullptr;
+			if (!GThreadPool)
+			{
+				OwnedPool = FQueuedThreadPool::Allocate(3);
+				GThreadPool = OwnedPool;
+			}
+
+			int32 NumFailures = 0;
+			NumFailures += RunBoxSphereBoundsTests();
+			NumFailures += RunCapsuleShapeTests();
+			NumFailures += RunConvexQueriesTests();
+			NumFailures += RunSoftwareOcclusionTests();
+			NumFailures += RunTriangleMeshBVHTests();
+
+			if (OwnedPool)
+			{
+				GThreadPool = nullptr;
+				delete OwnedPool;
+			}
+			return NumFailures;
+		}
+	}
+}
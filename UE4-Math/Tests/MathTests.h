@@ -0,0 +1,95 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "Math/UnrealMathUtility.h"
+#include "Math/Vector.h"
+
+namespace UE4Math
+{
+	/**
+	 * Regression tests of the math library. Each Run function returns its number of failed checks, and
+	 * prints every failure with its file and line.
+	 */
+	namespace MathTests
+	{
+		/** Prints a failed check and counts it. */
+		void ReportFailure(const char* Expression, const char* File, int32 Line, int32& NumFailures);
+
+		/** Batch transforms and unions against the scalar TransformBy and operator+, and the intersection predicates. */
+		int32 RunBoxSphereBoundsTests();
+
+		/** Sweeps that run out of conservative advancement steps. */
+		int32 RunCapsuleShapeTests();
+
+		/** EPA penetration depths of boxes against their analytic depths. */
+		int32 RunConvexQueriesTests();
+
+		/** Occlusion buffer depths against the occluders' planes, and boxes around the occluders. */
+		int32 RunSoftwareOcclusionTests();
+
+		/** Batch closest point queries against the scalar query on equidistant triangles. */
+		int32 RunTriangleMeshBVHTests();
+
+		/**
+		 * Runs every test. Batch code only splits its work with a pool, so a small one is set as
+		 * GThreadPool for the duration when there is none.
+		 *
+		 * @return Number of failed checks.
+		 */
+		int32 RunAllTests();
+
+		/** Small linear congruential generator, so a failing case reproduces from run to run. */
+		struct FTestRandom
+		{
+			uint32 Seed;
+
+			explicit FTestRandom(uint32 InSeed)
+				: Seed(InSeed)
+			{ }
+
+			/** @return A float in [0, 1). */
+			inline float GetFraction()
+			{
+				Seed = Seed * 196314165u + 907633515u;
+				return (float)(Seed >> 8) * (1.0f / 16777216.0f);
+			}
+
+			inline float GetRange(float Min, float Max)
+			{
+				return Min + (Max - Min) * GetFraction();
+			}
+
+			inline FVector GetVector(float Min, float Max)
+			{
+				const float X = GetRange(Min, Max);
+				const float Y = GetRange(Min, Max);
+				const float Z = GetRange(Min, Max);
+				return FVector(X, Y, Z);
+			}
+
+			/** @return A random unit vector. */
+			inline FVector GetUnitVector()
+			{
+				FVector Result;
+				do
+				{
+					Result = GetVector(-1.0f, 1.0f);
+				}
+				while (Result.SizeSquared() < 0.01f || Result.SizeSquared() > 1.0f);
+				return Result.GetUnsafeNormal();
+			}
+		};
+	}
+}
+
+/** Checks an expression inside a test function that counts its failures in a local NumFailures. */
+#define MATH_TEST_CHECK(Expression) \
+	do \
+	{ \
+		if (!(Expression)) \
+		{ \
+			UE4Math::MathTests::ReportFailure(#Expression, __FILE__, __LINE__, NumFailures); \
+		} \
+	} \
+	while (0)
@@ -0,0 +1,152 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	SoftwareOcclusionTests.cpp: FSoftwareOcclusionBuffer depth and visibility tests
+=============================================================================*/
+
+#include "Tests/MathTests.h"
+#include "Math/SoftwareOcclusion.h"
+#include "Math/Plane.h"
+
+namespace UE4Math
+{
+	namespace SoftwareOcclusionTestsPrivate
+	{
+		enum { BufferSize = 256 };
+
+		/**
+		 * A 90 degree projection looking down +X, with Y to the right and Z up on screen. W is the world X, so a
+		 * point (X, X * ScreenX, X * ScreenY) lands on the normalized screen position (ScreenX, ScreenY).
+		 */
+		FMatrix GetViewProjectionMatrix()
+		{
+			return FMatrix(
+				FPlane(0.0f, 0.0f, 0.0f, 1.0f),
+				FPlane(1.0f, 0.0f, 0.0f, 0.0f),
+				FPlane(0.0f, 1.0f, 0.0f, 0.0f),
+				FPlane(0.0f, 0.0f, 1.0f, 0.0f));
+		}
+
+		/**
+		 * Adds a quad covering the screen on the plane X = Distance + Slope * Y, so its depth 1 / W is
+		 * (1 - Slope * ScreenX) / Distance.
+		 */
+		void AddScreenQuad(FSoftwareOcclusionBuffer& Buffer, float Distance, float Slope)
+		{
+			FVector Vertices[4];
+			for (int32 Corner = 0; Corner < 4; ++Corner)
+			{
+				const float ScreenX = Corner & 1 ? 1.5f : -1.5f;
+				const float ScreenY = Corner & 2 ? 1.5f : -1.5f;
+				const float W = Distance / (1.0f - Slope * ScreenX);
+				Vertices[Corner] = FVector(W, W * ScreenX, W * ScreenY);
+			}
+			const int32 Indices[6] = { 0, 1, 2, 2, 1, 3 };
+			Buffer.AddOccluder(Vertices, 4, Indices, 6);
+		}
+
+		/** @return A box of the given half size around the point at distance W along the ray through a screen position. */
+		FBox GetBoxOnRay(float ScreenX, float ScreenY, float W, float HalfSize)
+		{
+			const FVector Center(W, W * ScreenX, W * ScreenY);
+			return FBox(Center - FVector(HalfSize), Center + FVector(HalfSize));
+		}
+
+		/**
+		 * Draws a steeply slanted occluder and checks every pixel holds at most the plane's depth anywhere on its
+		 * square. Sampling the depth at pixel centers only is half a pixel's slope too close, which lets the HiZ
+		 * hide what pokes through the occluder within that half pixel.
+		 */
+		int32 TestConservativeDepth()
+		{
+			int32 NumFailures = 0;
+
+			const float Distance = 100.0f;
+			const float Slope = 0.6f;
+			FSoftwareOcclusionBuffer Buffer(BufferSize, BufferSize);
+			Buffer.BeginFrame(GetViewProjectionMatrix());
+			AddScreenQuad(Buffer, Distance, Slope);
+			Buffer.FinishOccluders();
+
+			// Depth falls to the right, so the farthest point of a pixel is on its right edge.
+			const float DepthPerPixel = Slope * 2.0f / (BufferSize * Distance);
+			int32 NumTooClose = 0;
+			int32 NumTooFar = 0;
+			for (int32 Y = 0; Y < BufferSize; ++Y)
+			{
+				for (int32 X = 0; X < BufferSize; ++X)
+				{
+					const float RightEdgeX = (X + 1.0f) * 2.0f / BufferSize - 1.0f;
+					const float FarthestDepth = (1.0f - Slope * RightEdgeX) / Distance;
+					const float Depth = Buffer.GetDepth(X, Y);
+					NumTooClose += Depth > FarthestDepth * (1.0f + 1.e-5f) ? 1 : 0;
+					NumTooFar += Depth < FarthestDepth - DepthPerPixel ? 1 : 0;
+				}
+			}
+			MATH_TEST_CHECK(NumTooClose == 0);
+			MATH_TEST_CHECK(NumTooFar == 0);
+
+			// Nothing over the coarser levels may be closer than the pixels below.
+			const int32 Level = FSoftwareOcclusionBuffer::NumTileLevels - 1;
+			const int32 LevelSize = BufferSize >> Level;
+			for (int32 Y = 0; Y < LevelSize; ++Y)
+			{
+				for (int32 X = 0; X < LevelSize; ++X)
+				{
+					const float RightEdgeX = (X + 1.0f) * 2.0f / LevelSize - 1.0f;
+					MATH_TEST_CHECK(Buffer.GetDepth(X, Y, Level) <= (1.0f - Slope * RightEdgeX) / Distance * (1.0f + 1.e-5f));
+				}
+			}
+			return NumFailures;
+		}
+
+		/** Boxes behind, in front of and through a facing and a slanted occluder. */
+		int32 TestVisibility()
+		{
+			int32 NumFailures = 0;
+			MathTests::FTestRandom Random(48);
+
+			const float Distance = 100.0f;
+			const float Slopes[2] = { 0.0f, 0.6f };
+			for (float Slope : Slopes)
+			{
+				FSoftwareOcclusionBuffer Buffer(BufferSize, BufferSize);
+				Buffer.BeginFrame(GetViewProjectionMatrix());
+				AddScreenQuad(Buffer, Distance, Slope);
+				Buffer.FinishOccluders();
+
+				int32 NumOccludedVisible = 0;
+				int32 NumFrontHidden = 0;
+				int32 NumThroughHidden = 0;
+				for (int32 Index = 0; Index < 256; ++Index)
+				{
+					const float ScreenX = Random.GetRange(-0.9f, 0.9f);
+					const float ScreenY = Random.GetRange(-0.9f, 0.9f);
+					const float HalfSize = Random.GetRange(0.01f, 2.0f);
+					const float OccluderW = Distance / (1.0f - Slope * ScreenX);
+
+					// Behind by a few times the box's size, and in front by the same margin.
+					NumOccludedVisible += Buffer.IsVisible(GetBoxOnRay(ScreenX, ScreenY, OccluderW * 1.2f + HalfSize * 4.0f, HalfSize)) ? 1 : 0;
+					NumFrontHidden += Buffer.IsVisible(GetBoxOnRay(ScreenX, ScreenY, OccluderW * 0.8f - HalfSize * 4.0f, HalfSize)) ? 0 : 1;
+
+					// A box mostly behind the occluder that pokes through it by a hundredth of its size.
+					NumThroughHidden += Buffer.IsVisible(GetBoxOnRay(ScreenX, ScreenY, OccluderW + HalfSize * 0.99f, HalfSize)) ? 0 : 1;
+				}
+				MATH_TEST_CHECK(NumOccludedVisible == 0);
+				MATH_TEST_CHECK(NumFrontHidden == 0);
+				MATH_TEST_CHECK(NumThroughHidden == 0);
+			}
+			return NumFailures;
+		}
+	}
+
+	int32 MathTests::RunSoftwareOcclusionTests()
+	{
+		using namespace SoftwareOcclusionTestsPrivate;
+
+		int32 NumFailures = 0;
+		NumFailures += TestConservativeDepth();
+		NumFailures += TestVisibility();
+		return NumFailures;
+	}
+}
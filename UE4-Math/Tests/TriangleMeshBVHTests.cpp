@@ -0,0 +1,99 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+/*=============================================================================
+	TriangleMeshBVHTests.cpp: FTriangleMeshBVH batch query tests
+=============================================================================*/
+
+#include "Tests/MathTests.h"
+#include "Math/TriangleMeshBVH.h"
+#include <vector>
+
+namespace UE4Math
+{
+	namespace TriangleMeshBVHTestsPrivate
+	{
+		/** @return Whether two results are the same, bit for bit. */
+		bool IsSameResult(const FMeshClosestPoint& A, const FMeshClosestPoint& B)
+		{
+			return A.TriangleIndex == B.TriangleIndex && A.Distance == B.Distance && A.Point == B.Point && A.BarycentricCoords == B.BarycentricCoords;
+		}
+
+		/**
+		 * Queries a flat grid above its vertices, edges and cell centers, where up to six triangles are at exactly
+		 * the same distance. The batch starts each query from the previous point's triangle and the scalar query
+		 * from the root, so both must break ties the same way whatever the order of the points and however the
+		 * batch is split.
+		 */
+		int32 TestGridTies()
+		{
+			int32 NumFailures = 0;
+			MathTests::FTestRandom Random(50);
+
+			enum { GridSize = 32 };
+			std::vector<FVector> Vertices;
+			for (int32 Y = 0; Y <= GridSize; ++Y)
+			{
+				for (int32 X = 0; X <= GridSize; ++X)
+				{
+					Vertices.push_back(FVector((float)X, (float)Y, 0.0f));
+				}
+			}
+			std::vector<int32> Indices;
+			for (int32 Y = 0; Y < GridSize; ++Y)
+			{
+				for (int32 X = 0; X < GridSize; ++X)
+				{
+					const int32 V00 = Y * (GridSize + 1) + X;
+					const int32 V10 = V00 + 1;
+					const int32 V01 = V00 + GridSize + 1;
+					const int32 V11 = V01 + 1;
+					const int32 Quad[6] = { V00, V10, V11, V00, V11, V01 };
+					Indices.insert(Indices.end(), Quad, Quad + 6);
+				}
+			}
+			const FTriangleMeshBVH BVH(Vertices.data(), (int32)Vertices.size(), Indices.data(), (int32)Indices.size());
+
+			// Half integer coordinates lie above vertices, edges and cell centers, points outside the grid are closest
+			// to its border edges and corners.
+			enum { NumPoints = 8192 };
+			std::vector<FVector> Points(NumPoints);
+			for (FVector& Point : Points)
+			{
+				Point.X = FMath::FloorToFloat(Random.GetRange(-4.0f, GridSize + 4.0f) * 2.0f) * 0.5f;
+				Point.Y = FMath::FloorToFloat(Random.GetRange(-4.0f, GridSize + 4.0f) * 2.0f) * 0.5f;
+				Point.Z = FMath::FloorToFloat(Random.GetRange(-4.0f, 4.0f) * 2.0f) * 0.5f;
+			}
+
+			std::vector<FMeshClosestPoint> Expected(NumPoints);
+			for (int32 Index = 0; Index < NumPoints; ++Index)
+			{
+				BVH.FindClosestPoint(Points[Index], Expected[Index]);
+			}
+
+			// Offsetting the batch moves every warm start to a different previous point.
+			const int32 Offsets[3] = { 0, 1, 777 };
+			for (int32 Offset : Offsets)
+			{
+				std::vector<FMeshClosestPoint> Results(NumPoints - Offset);
+				BVH.FindClosestPointBatch(Points.data() + Offset, Results.data(), NumPoints - Offset);
+
+				int32 NumDifferent = 0;
+				for (int32 Index = 0; Index < NumPoints - Offset; ++Index)
+				{
+					NumDifferent += IsSameResult(Results[Index], Expected[Index + Offset]) ? 0 : 1;
+				}
+				MATH_TEST_CHECK(NumDifferent == 0);
+			}
+			return NumFailures;
+		}
+	}
+
+	int32 MathTests::RunTriangleMeshBVHTests()
+	{
+		using namespace TriangleMeshBVHTestsPrivate;
+
+		int32 NumFailures = 0;
+		NumFailures += TestGridTies();
+		return NumFailures;
+	}
+}
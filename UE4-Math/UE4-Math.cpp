@@ -2,13 +2,18 @@
 //
 
 #include <iostream>
-#include "Math/Quat.h"
+#include "Tests/MathTests.h"
 
 int main()
 {
-    auto q1 = UE4Math::FQuat(0.3, 0.3, 0.3, 0.3);
-    auto q2 = UE4Math::FQuat(0.4, 0.4, 0.4, 0.4);
-    std::cout << "Hello World!\n";
+    const int NumFailures = UE4Math::MathTests::RunAllTests();
+    if (NumFailures != 0)
+    {
+        std::cout << NumFailures << " math test checks failed.\n";
+        return 1;
+    }
+    std::cout << "All math tests passed.\n";
+    return 0;
 }
 
 // Run program: Ctrl + F5 or Debug > Start Without Debugging menu